@@ -6,7 +6,6 @@
 */
 
 #include "PluginEditor.h"
-#include "BinaryData.h"
 #include "PluginProcessor.h"
 #include <iostream>
 
@@ -17,35 +16,102 @@
 VT2WImageKnob::VT2WImageKnob() { setRepaintsOnMouseActivity(true); }
 VT2WImageKnob::~VT2WImageKnob() {}
 
-void VT2WImageKnob::setImage(const juce::Image &image) {
-  knobImage = image;
+void VT2WImageKnob::setImage(VT2WImageResources::Id id) {
+  imageId = id;
+  knobBounds = imageResources->getOriginalBounds(id);
+  knobImage =
+      renderCacheEnabled ? juce::Image() : imageResources->getOriginal(id);
+  scaledKnobImage = {};
+  cachedFrameValid = false;
   repaint();
 }
 
 void VT2WImageKnob::paint(juce::Graphics &g) {
+  if (knobBounds.isEmpty())
+    return;
+
+  const VT2WPaintStats::Scope timing(paintStats);
+
+  float normalizedValue =
+      static_cast<float>((value - minValue) / (maxValue - minValue));
+  float angle = startAngle + normalizedValue * (endAngle - startAngle);
+
+  if (!renderCacheEnabled) {
+    paintUncached(g, angle);
+    return;
+  }
+
   auto bounds = getLocalBounds().toFloat();
   auto centre = bounds.getCentre();
 
-  if (knobImage.isValid()) {
-    float normalizedValue =
-        static_cast<float>((value - minValue) / (maxValue - minValue));
-    float angle = startAngle + normalizedValue * (endAngle - startAngle);
+  // 物理ピクセルでのサイズ (Retina / Windows のスケーリング込み)
+  const float pixelScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+  const float knobSize = juce::jmin(bounds.getWidth(), bounds.getHeight());
+  const float scale = knobSize / static_cast<float>(knobBounds.getWidth());
+  const int width = juce::jmax(
+      1, juce::roundToInt(knobBounds.getWidth() * scale * pixelScale));
+  const int height = juce::jmax(
+      1, juce::roundToInt(knobBounds.getHeight() * scale * pixelScale));
+
+  // サイズかスケールが変わった時だけ縮小し直す
+  if (scaledKnobImage.getWidth() != width ||
+      scaledKnobImage.getHeight() != height) {
+    scaledKnobImage = imageResources->getScaled(imageId, width, height);
+    cachedFrame = juce::Image(juce::Image::ARGB, width, height, true);
+    cachedFrameValid = false;
+  }
 
-    float knobSize = juce::jmin(bounds.getWidth(), bounds.getHeight());
-    float scale = knobSize / static_cast<float>(knobImage.getWidth());
+  // 角度が変わった時だけ、縮小済みの画像を回転して描き直す
+  if (!cachedFrameValid || angle != cachedAngle) {
+    cachedFrame.clear(cachedFrame.getBounds());
+    juce::Graphics frame(cachedFrame);
+    frame.drawImageTransformed(
+        scaledKnobImage,
+        juce::AffineTransform::rotation(angle, width / 2.0f, height / 2.0f),
+        false);
+    cachedAngle = angle;
+    cachedFrameValid = true;
+  }
 
-    // 透過PNGを使用するため、追加のクリッピングは不要
+  // 物理ピクセルで 1:1 になるように置く
+  g.drawImageTransformed(
+      cachedFrame,
+      juce::AffineTransform::scale(1.0f / pixelScale)
+          .translated(centre.x - width / (2.0f * pixelScale),
+                      centre.y - height / (2.0f * pixelScale)),
+      false);
+}
 
-    juce::AffineTransform transform =
-        juce::AffineTransform::rotation(
-            angle, static_cast<float>(knobImage.getWidth()) / 2.0f,
-            static_cast<float>(knobImage.getHeight()) / 2.0f)
-            .scaled(scale)
-            .translated(centre.x - (knobImage.getWidth() * scale) / 2.0f,
-                        centre.y - (knobImage.getHeight() * scale) / 2.0f);
+void VT2WImageKnob::paintUncached(juce::Graphics &g, float angle) {
+  auto bounds = getLocalBounds().toFloat();
+  auto centre = bounds.getCentre();
 
-    g.drawImageTransformed(knobImage, transform, false);
-  }
+  float knobSize = juce::jmin(bounds.getWidth(), bounds.getHeight());
+  float scale = knobSize / static_cast<float>(knobImage.getWidth());
+
+  // 透過PNGを使用するため、追加のクリッピングは不要
+
+  juce::AffineTransform transform =
+      juce::AffineTransform::rotation(
+          angle, static_cast<float>(knobImage.getWidth()) / 2.0f,
+          static_cast<float>(knobImage.getHeight()) / 2.0f)
+          .scaled(scale)
+          .translated(centre.x - (knobImage.getWidth() * scale) / 2.0f,
+                      centre.y - (knobImage.getHeight() * scale) / 2.0f);
+
+  g.drawImageTransformed(knobImage, transform, false);
+}
+
+void VT2WImageKnob::setRenderCacheEnabled(bool shouldBeEnabled) {
+  renderCacheEnabled = shouldBeEnabled;
+
+  // 元画像はキャッシュ無効の間だけ持つ
+  knobImage = renderCacheEnabled ? juce::Image()
+                                 : imageResources->getOriginal(imageId);
+  scaledKnobImage = {};
+  cachedFrame = {};
+  cachedFrameValid = false;
+  repaint();
 }
 
 void VT2WImageKnob::resized() {}
@@ -100,25 +166,283 @@ void VT2WImageKnob::mouseWheelMove(const juce::MouseEvent &,
   setValue(value + delta);
 }
 
+//==============================================================================
+// VT2WDiagnosticsOverlay
+//==============================================================================
+
+VT2WDiagnosticsOverlay::VT2WDiagnosticsOverlay(VT2WWhiteProcessor &p)
+    : processor(p) {}
+
+void VT2WDiagnosticsOverlay::visibilityChanged() {
+  if (isVisible()) {
+    timerCallback();
+    startTimerHz(10);
+  } else {
+    stopTimer();
+  }
+}
+
+void VT2WDiagnosticsOverlay::setPaintStats(VT2WPaintStats *background,
+                                           VT2WPaintStats *knobs) {
+  backgroundStats = background;
+  knobStats = knobs;
+}
+
+void VT2WDiagnosticsOverlay::timerCallback() {
+  snapshot = processor.getBlockTimer().getSnapshot();
+  qualityLevel = processor.getQualityLevel();
+
+  // paint 時間は 1 秒ごとの平均 (オーバーレイ自身の再描画も含まれる)
+  if (++ticksSincePaintStats >= 10) {
+    ticksSincePaintStats = 0;
+    if (backgroundStats != nullptr) {
+      backgroundMicroseconds = backgroundStats->getAverageMicroseconds();
+      backgroundStats->clear();
+    }
+    if (knobStats != nullptr) {
+      knobMicroseconds = knobStats->getAverageMicroseconds();
+      knobStats->clear();
+    }
+  }
+
+  repaint();
+}
+
+void VT2WDiagnosticsOverlay::mouseDown(const juce::MouseEvent &event) {
+  if (event.mods.isAltDown()) {
+    setVisible(false);
+  } else if (event.mods.isShiftDown()) {
+    renderCacheEnabled = !renderCacheEnabled;
+    if (onRenderCacheToggled)
+      onRenderCacheToggled(renderCacheEnabled);
+  } else {
+    processor.resetBlockTimer();
+  }
+}
+
+void VT2WDiagnosticsOverlay::paint(juce::Graphics &g) {
+  auto bounds = getLocalBounds().toFloat();
+  g.setColour(juce::Colours::black.withAlpha(0.8f));
+  g.fillRoundedRectangle(bounds, 6.0f);
+
+  auto area = getLocalBounds().reduced(10);
+  auto percent = [](float load) {
+    return juce::String(load * 100.0f, 1) + "%";
+  };
+
+  g.setColour(juce::Colours::white);
+  g.setFont(13.0f);
+  g.drawText("CPU (block time / real-time budget)", area.removeFromTop(18),
+             juce::Justification::left);
+  g.drawText("p50 " + percent(snapshot.p50) + "   p99 " +
+                 percent(snapshot.p99) + "   max " + percent(snapshot.max) +
+                 "   peak " + percent(snapshot.peak),
+             area.removeFromTop(18), juce::Justification::left);
+  g.drawText("over budget " + juce::String(snapshot.recentOverBudget) + " / " +
+                 juce::String(snapshot.numBlocks) + " recent, " +
+                 juce::String((juce::int64)snapshot.overBudgetBlocks) + " / " +
+                 juce::String((juce::int64)snapshot.totalBlocks) + " total",
+             area.removeFromTop(18), juce::Justification::left);
+  g.drawText(qualityLevel == 0
+                 ? juce::String("auto quality: full")
+                 : "auto quality: -" + juce::String(qualityLevel) + " step(s)",
+             area.removeFromTop(18), juce::Justification::left);
+  g.drawText("GUI paint (cache " +
+                 juce::String(renderCacheEnabled ? "on" : "off") +
+                 ") background " + juce::String(backgroundMicroseconds, 1) +
+                 "us   knob " + juce::String(knobMicroseconds, 1) + "us",
+             area.removeFromTop(18), juce::Justification::left);
+  g.drawText("shared images " +
+                 juce::String(imageResources->getMemoryBytes() / 1.0e6, 1) +
+                 " MB (all instances)",
+             area.removeFromTop(18), juce::Justification::left);
+
+  // ヒストグラム (横軸は負荷率の対数、縦軸は件数の対数)
+  area.removeFromTop(6);
+  const auto graph = area.toFloat();
+  const float binWidth = graph.getWidth() / VT2WBlockTimer::kNumBins;
+
+  uint32_t maxCount = 1;
+  for (auto count : snapshot.counts)
+    maxCount = std::max(maxCount, count);
+  const float scale = 1.0f / std::log1p(float(maxCount));
+
+  for (int bin = 0; bin < VT2WBlockTimer::kNumBins; ++bin) {
+    if (snapshot.counts[bin] == 0)
+      continue;
+
+    const float height =
+        graph.getHeight() * std::log1p(float(snapshot.counts[bin])) * scale;
+    g.setColour(bin >= VT2WBlockTimer::kBudgetBin
+                    ? juce::Colours::red
+                    : juce::Colours::lightgreen);
+    g.fillRect(graph.getX() + bin * binWidth, graph.getBottom() - height,
+               std::max(binWidth - 1.0f, 1.0f), height);
+  }
+
+  // 予算 (100%) の位置
+  const float budgetX = graph.getX() + VT2WBlockTimer::kBudgetBin * binWidth;
+  g.setColour(juce::Colours::red.withAlpha(0.7f));
+  g.drawVerticalLine(juce::roundToInt(budgetX), graph.getY(),
+                     graph.getBottom());
+}
+
+//==============================================================================
+// VT2WMeterStrip
+//==============================================================================
+
+VT2WMeterStrip::VT2WMeterStrip(VT2WWhiteProcessor &p) : processor(p) {
+  // メイクアップは 0dB (補正無し) が空のバー。音が来るまでは空で始める
+  bars[Makeup].level = bars[Makeup].peak = 0.0f;
+
+  setInterceptsMouseClicks(false, false);
+  startTimerHz(kRefreshHz);
+}
+
+VT2WMeterStrip::~VT2WMeterStrip() { stopTimer(); }
+
+void VT2WMeterStrip::resized() {
+  auto area = getLocalBounds().reduced(8);
+  area.removeFromBottom(16); // ラベル
+  const int width = area.getWidth() / kNumBars;
+
+  for (auto &bar : bars) {
+    bar.bounds = area.removeFromLeft(width).reduced(6, 0);
+    bar.drawnHeight = -1;
+    bar.drawnPeak = -1;
+  }
+}
+
+void VT2WMeterStrip::timerCallback() {
+  // 前回から溜まった分を読み切る (ピークは最大、RMS はパワーの平均)
+  VT2WMeterFrame frame;
+  float inputPeak = 0.0f, outputPeak = 0.0f, envelope = 0.0f;
+  float makeupGain = 1.0f;
+  double inputPower = 0.0, outputPower = 0.0;
+  int numSamples = 0;
+
+  while (processor.popMeterFrame(frame)) {
+    inputPeak = std::max(inputPeak, frame.inputPeak);
+    outputPeak = std::max(outputPeak, frame.outputPeak);
+    inputPower += double(frame.inputRms) * frame.inputRms * frame.numSamples;
+    outputPower +=
+        double(frame.outputRms) * frame.outputRms * frame.numSamples;
+    envelope = std::max(envelope, frame.envelope);
+    makeupGain = frame.makeupGain;
+    numSamples += frame.numSamples;
+  }
+
+  auto decibels = [](double gain) {
+    return juce::Decibels::gainToDecibels((float)gain, kMinDecibels);
+  };
+
+  const double scale = numSamples > 0 ? 1.0 / numSamples : 0.0;
+  updateBar(bars[Input], decibels(std::sqrt(inputPower * scale)),
+            decibels(inputPeak));
+  updateBar(bars[Output], decibels(std::sqrt(outputPower * scale)),
+            decibels(outputPeak));
+  updateBar(bars[Envelope], decibels(envelope), decibels(envelope));
+
+  // 止まっている間 (ブロックが来ない) はメイクアップを前の値のまま
+  const float makeup =
+      numSamples > 0 ? decibels(makeupGain) : bars[Makeup].level;
+  updateBar(bars[Makeup], makeup, makeup);
+}
+
+void VT2WMeterStrip::updateBar(BarState &bar, float levelDecibels,
+                               float peakDecibels) {
+  const bool makeup = &bar == &bars[Makeup];
+  const float fall = kFallDecibelsPerSecond / kRefreshHz;
+
+  if (makeup) {
+    bar.level = bar.peak = levelDecibels;
+  } else {
+    bar.level = std::max(levelDecibels, bar.level - fall);
+    bar.peak = std::max({peakDecibels, bar.level, bar.peak - fall});
+  }
+
+  const int height = getHeightFor(bar, bar.level, makeup);
+  const int peak = getHeightFor(bar, bar.peak, makeup);
+
+  if (height != bar.drawnHeight || peak != bar.drawnPeak) {
+    bar.drawnHeight = height;
+    bar.drawnPeak = peak;
+    repaint(bar.bounds);
+  }
+}
+
+int VT2WMeterStrip::getHeightFor(const BarState &bar, float decibels,
+                                 bool makeup) const {
+  // MAKEUP は上から下へ (減衰量)、それ以外は下から上へ
+  const float proportion =
+      makeup ? -decibels / kMakeupRangeDecibels
+             : (decibels - kMinDecibels) / (kMaxDecibels - kMinDecibels);
+  return juce::roundToInt(juce::jlimit(0.0f, 1.0f, proportion) *
+                          bar.bounds.getHeight());
+}
+
+void VT2WMeterStrip::paint(juce::Graphics &g) {
+  g.setColour(juce::Colours::black.withAlpha(0.55f));
+  g.fillRoundedRectangle(getLocalBounds().toFloat(), 6.0f);
+
+  static const char *const labels[] = {"IN", "OUT", "ENV", "MAKEUP"};
+  const int zeroHeight = getHeightFor(bars[Input], 0.0f, false);
+
+  for (int index = 0; index < kNumBars; ++index) {
+    const auto &bar = bars[index];
+    const auto &bounds = bar.bounds;
+
+    g.setColour(juce::Colours::white.withAlpha(0.08f));
+    g.fillRect(bounds);
+
+    if (index == Makeup) {
+      g.setColour(juce::Colours::orange);
+      g.fillRect(bounds.withHeight(std::max(bar.drawnHeight, 0)));
+    } else {
+      g.setColour(index == Envelope ? juce::Colours::skyblue
+                                    : juce::Colours::lightgreen);
+      const int height = std::max(bar.drawnHeight, 0);
+      g.fillRect(bounds.withTop(bounds.getBottom() - height));
+
+      // ピークホールドと 0dBFS の位置
+      g.setColour(bar.peak > 0.0f ? juce::Colours::red
+                                  : juce::Colours::white);
+      g.fillRect(bounds.getX(),
+                 bounds.getBottom() - std::max(bar.drawnPeak, 1),
+                 bounds.getWidth(), 1);
+      g.setColour(juce::Colours::white.withAlpha(0.4f));
+      g.fillRect(bounds.getX(), bounds.getBottom() - zeroHeight,
+                 bounds.getWidth(), 1);
+    }
+
+    g.setColour(juce::Colours::white.withAlpha(0.8f));
+    g.setFont(11.0f);
+    g.drawText(labels[index],
+               juce::Rectangle<int>(bounds.getX() - 6, bounds.getBottom() + 2,
+                                    bounds.getWidth() + 12, 14),
+               juce::Justification::centred);
+  }
+}
+
 //==============================================================================
 // VT2WWhiteEditor
 //==============================================================================
 
 VT2WWhiteEditor::VT2WWhiteEditor(VT2WWhiteProcessor &p)
-    : AudioProcessorEditor(&p), audioProcessor(p) {
+    : AudioProcessorEditor(&p), audioProcessor(p), meterStrip(p),
+      diagnosticsOverlay(p) {
 
   loadImages();
 
   // ウィンドウサイズを設定
   // 背景画像に合わせて自動設定
-  if (backgroundImage.isValid()) {
-    setSize(backgroundImage.getWidth(), backgroundImage.getHeight());
+  if (!backgroundBounds.isEmpty()) {
+    setSize(backgroundBounds.getWidth(), backgroundBounds.getHeight());
   } else {
     setSize(800, 600); // フォールバック
   }
 
   // Driveノブ
-  driveKnob.setImage(knobImage);
   driveKnob.setLabel("DRIVE");
   driveKnob.setRange(0.0, 100.0, 0.1);
   driveKnob.setValue(0.0);
@@ -126,7 +450,6 @@ VT2WWhiteEditor::VT2WWhiteEditor(VT2WWhiteProcessor &p)
   addAndMakeVisible(driveKnob);
 
   // Mixノブ
-  mixKnob.setImage(knobImage);
   mixKnob.setLabel("MIX");
   mixKnob.setRange(0.0, 100.0, 1.0);
   mixKnob.setValue(100.0);
@@ -166,6 +489,27 @@ VT2WWhiteEditor::VT2WWhiteEditor(VT2WWhiteProcessor &p)
   // 初期値反映
   driveKnob.setValue(driveSlider.getValue() * 10.0, juce::dontSendNotification);
   mixKnob.setValue(mixSlider.getValue(), juce::dontSendNotification);
+
+  // メーター (2 つのノブの間)
+  addAndMakeVisible(meterStrip);
+
+  // paint 時間の計測 (診断オーバーレイに表示)
+  driveKnob.setPaintStats(&knobPaintStats);
+  mixKnob.setPaintStats(&knobPaintStats);
+
+  // 診断オーバーレイ (Alt + クリックで表示)
+  diagnosticsOverlay.setPaintStats(&backgroundPaintStats, &knobPaintStats);
+  diagnosticsOverlay.onRenderCacheToggled = [this](bool enabled) {
+    renderCacheEnabled = enabled;
+    backgroundImage = enabled ? juce::Image()
+                              : imageResources->getOriginal(
+                                    VT2WImageResources::Id::Background);
+    scaledBackgroundImage = {};
+    driveKnob.setRenderCacheEnabled(enabled);
+    mixKnob.setRenderCacheEnabled(enabled);
+    repaint();
+  };
+  addChildComponent(diagnosticsOverlay);
 }
 
 VT2WWhiteEditor::~VT2WWhiteEditor() {
@@ -174,23 +518,40 @@ VT2WWhiteEditor::~VT2WWhiteEditor() {
 }
 
 void VT2WWhiteEditor::loadImages() {
-  // BinaryData名は CMakeLists.txt の juce_add_binary_data
-  // で指定されたファイル名に基づく
-  backgroundImage = juce::ImageCache::getFromMemory(
-      VT2WData::background_jpg, VT2WData::background_jpgSize);
-
-  // 新しいノブ画像 (PNG透過あり) をロード
-  knobImage = juce::ImageCache::getFromMemory(VT2WData::knob_png,
-                                              VT2WData::knob_pngSize);
-
-  // ノブにセット
-  driveKnob.setImage(knobImage);
-  mixKnob.setImage(knobImage);
+  // デコードと縮小はプロセス内で共有し、元画像は縮小後に捨てる
+  // (VT2WImageResources)。ここでは大きさだけを取る
+  backgroundBounds =
+      imageResources->getOriginalBounds(VT2WImageResources::Id::Background);
+
+  // ノブ画像 (PNG透過あり)
+  driveKnob.setImage(VT2WImageResources::Id::Knob);
+  mixKnob.setImage(VT2WImageResources::Id::Knob);
 }
 
 void VT2WWhiteEditor::paint(juce::Graphics &g) {
-  if (backgroundImage.isValid()) {
+  const VT2WPaintStats::Scope timing(&backgroundPaintStats);
+
+  if (backgroundImage.isValid() && !renderCacheEnabled) {
     g.drawImage(backgroundImage, getLocalBounds().toFloat());
+  } else if (!backgroundBounds.isEmpty()) {
+    // ウィンドウサイズか画面のスケールが変わった時だけ縮小し直す
+    const float pixelScale =
+        g.getInternalContext().getPhysicalPixelScaleFactor();
+    const int width = juce::jmax(1, juce::roundToInt(getWidth() * pixelScale));
+    const int height =
+        juce::jmax(1, juce::roundToInt(getHeight() * pixelScale));
+
+    if (scaledBackgroundImage.getWidth() != width ||
+        scaledBackgroundImage.getHeight() != height ||
+        scaledBackgroundScale != pixelScale) {
+      scaledBackgroundImage = imageResources->getScaled(
+          VT2WImageResources::Id::Background, width, height);
+      scaledBackgroundScale = pixelScale;
+    }
+
+    g.drawImageTransformed(scaledBackgroundImage,
+                           juce::AffineTransform::scale(1.0f / pixelScale),
+                           false);
   } else {
     g.drawText("Background Image Not Found", getLocalBounds(),
                juce::Justification::centred);
@@ -207,4 +568,16 @@ void VT2WWhiteEditor::resized() {
   // MIX: Center(809, 626)
   mixKnob.setSize(knobSize, knobSize);
   mixKnob.setCentrePosition(809, 626);
+
+  // メーター: 2 つのノブの間 (DRIVE の右端 319 〜 MIX の左端 706)
+  meterStrip.setBounds(392, 546, 240, 160);
+
+  diagnosticsOverlay.setBounds(16, 16, 420, 216);
+}
+
+void VT2WWhiteEditor::mouseDown(const juce::MouseEvent &event) {
+  if (event.mods.isAltDown()) {
+    diagnosticsOverlay.setVisible(!diagnosticsOverlay.isVisible());
+    diagnosticsOverlay.toFront(false);
+  }
 }
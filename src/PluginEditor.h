@@ -8,10 +8,57 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include "VT2WImageResources.h"
+
+#include <chrono>
+
+//==============================================================================
+/**
+ * paint の所要時間の集計 (メッセージスレッドのみ)
+ * 診断オーバーレイで描画キャッシュの有無を比較するのに使う。
+ */
+struct VT2WPaintStats {
+  double totalSeconds = 0.0;
+  int count = 0;
+
+  double getAverageMicroseconds() const {
+    return count > 0 ? totalSeconds * 1.0e6 / count : 0.0;
+  }
+
+  void clear() { *this = {}; }
+
+  /** スコープを抜けるまでの時間を 1 回分として積む */
+  class Scope {
+  public:
+    explicit Scope(VT2WPaintStats *owner)
+        : stats(owner), start(std::chrono::steady_clock::now()) {}
+
+    ~Scope() {
+      if (stats != nullptr) {
+        stats->totalSeconds += std::chrono::duration<double>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+        ++stats->count;
+      }
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    VT2WPaintStats *stats;
+    std::chrono::steady_clock::time_point start;
+  };
+};
 
 //==============================================================================
 /**
  * 画像ベースのノブ
+ *
+ * 元画像 (500px) を毎回回転・縮小すると重いので、表示サイズ x 画面の
+ * スケールに縮小した画像 (VT2WImageResources で全インスタンス共有) を使い、
+ * 最後に描いた角度のフレームもキャッシュする。
+ * 値が変わらない再描画 (マウスオーバーなど) は 1:1 の転送だけになる。
  */
 class VT2WImageKnob : public juce::Component {
 public:
@@ -21,7 +68,8 @@ public:
   void paint(juce::Graphics &g) override;
   void resized() override;
 
-  void setImage(const juce::Image &knobImage);
+  /** 共有リソースの画像 id を使う */
+  void setImage(VT2WImageResources::Id imageId);
   void setRange(double min, double max, double interval = 0.0);
   void
   setValue(double newValue,
@@ -31,6 +79,12 @@ public:
   void setLabel(const juce::String &labelText);
   void setRotationRange(float startAngleRadians, float endAngleRadians);
 
+  /** 描画キャッシュの有効 / 無効 (無効時は元画像から毎回描く。比較用) */
+  void setRenderCacheEnabled(bool shouldBeEnabled);
+
+  /** paint の時間を積む先 (nullptr なら計測しない) */
+  void setPaintStats(VT2WPaintStats *stats) { paintStats = stats; }
+
   std::function<void()> onValueChange;
 
 private:
@@ -41,7 +95,21 @@ private:
   void mouseWheelMove(const juce::MouseEvent &event,
                       const juce::MouseWheelDetails &wheel) override;
 
-  juce::Image knobImage;
+  /** 元画像を回転・縮小して直接描く (キャッシュ無効時) */
+  void paintUncached(juce::Graphics &g, float angle);
+
+  juce::SharedResourcePointer<VT2WImageResources> imageResources;
+  VT2WImageResources::Id imageId = VT2WImageResources::Id::Knob;
+  juce::Rectangle<int> knobBounds; // 元画像の大きさ
+  juce::Image knobImage;           // 元画像 (キャッシュ無効の間だけ持つ)
+
+  // 描画キャッシュ (物理ピクセル単位)
+  bool renderCacheEnabled = true;
+  juce::Image scaledKnobImage; // 表示サイズに縮小した元画像 (共有)
+  juce::Image cachedFrame;     // cachedAngle で回転済み
+  float cachedAngle = 0.0f;
+  bool cachedFrameValid = false;
+  VT2WPaintStats *paintStats = nullptr;
 
   double value = 0.0;
   double minValue = 0.0;
@@ -58,6 +126,97 @@ private:
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VT2WImageKnob)
 };
 
+//==============================================================================
+/**
+ * 診断オーバーレイ (processBlock の負荷率)
+ *
+ * プロセッサーの VT2WBlockTimer を 10Hz で読み、p50 / p99 / max と
+ * 予算超過の数、ヒストグラムを表示する。表示中だけタイマーを回す。
+ * クリックで統計をリセット、Alt (Option) + クリックで閉じる。
+ * エディターの paint 時間 (背景・ノブ) も 1 秒ごとの平均で表示し、
+ * Shift + クリックで描画キャッシュを切り替えて比較できる。
+ * 共有画像 (VT2WImageResources) が保持しているメモリ量も表示する。
+ */
+class VT2WDiagnosticsOverlay : public juce::Component, private juce::Timer {
+public:
+  explicit VT2WDiagnosticsOverlay(VT2WWhiteProcessor &processor);
+
+  void paint(juce::Graphics &g) override;
+  void visibilityChanged() override;
+
+  /** エディターの paint 時間の集計元 */
+  void setPaintStats(VT2WPaintStats *background, VT2WPaintStats *knobs);
+
+  /** Shift + クリックで呼ばれる (引数は新しいキャッシュの状態) */
+  std::function<void(bool)> onRenderCacheToggled;
+
+private:
+  void timerCallback() override;
+  void mouseDown(const juce::MouseEvent &event) override;
+
+  VT2WWhiteProcessor &processor;
+  VT2WBlockTimer::Snapshot snapshot;
+  int qualityLevel = 0;
+
+  VT2WPaintStats *backgroundStats = nullptr;
+  VT2WPaintStats *knobStats = nullptr;
+  double backgroundMicroseconds = 0.0;
+  double knobMicroseconds = 0.0;
+  int ticksSincePaintStats = 0;
+  bool renderCacheEnabled = true;
+
+  juce::SharedResourcePointer<VT2WImageResources> imageResources;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VT2WDiagnosticsOverlay)
+};
+
+//==============================================================================
+/**
+ * メーター (入力・出力レベル、トランジェントのエンベロープ、メイクアップゲイン)
+ *
+ * プロセッサーのメーター FIFO を 30Hz のタイマーで読み切り、表示が
+ * 1px 以上変わったバーの領域だけを再描画する。IN / OUT は RMS のバーと
+ * ピークホールドの線、ENV はエンベロープ、MAKEUP は 0dB からの減衰量。
+ */
+class VT2WMeterStrip : public juce::Component, private juce::Timer {
+public:
+  explicit VT2WMeterStrip(VT2WWhiteProcessor &processor);
+  ~VT2WMeterStrip() override;
+
+  void paint(juce::Graphics &g) override;
+  void resized() override;
+
+private:
+  enum Bar { Input, Output, Envelope, Makeup, kNumBars };
+
+  static constexpr int kRefreshHz = 30;
+  static constexpr float kMinDecibels = -60.0f;
+  static constexpr float kMaxDecibels = 6.0f;
+  static constexpr float kMakeupRangeDecibels = 6.0f;
+  static constexpr float kFallDecibelsPerSecond = 24.0f;
+
+  struct BarState {
+    float level = kMinDecibels; // 表示中の値 (dB)
+    float peak = kMinDecibels;  // ピークホールド (dB)
+    int drawnHeight = -1;       // 前回描いたバーの高さ (px)
+    int drawnPeak = -1;
+    juce::Rectangle<int> bounds;
+  };
+
+  void timerCallback() override;
+
+  /** 表示する値を落下付きで更新し、変わっていればその領域だけ再描画 */
+  void updateBar(BarState &bar, float levelDecibels, float peakDecibels);
+
+  /** dB をバーの高さ (px) に */
+  int getHeightFor(const BarState &bar, float decibels, bool makeup) const;
+
+  VT2WWhiteProcessor &processor;
+  BarState bars[kNumBars];
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VT2WMeterStrip)
+};
+
 //==============================================================================
 /**
  * メインエディター
@@ -71,12 +230,26 @@ public:
   void paint(juce::Graphics &) override;
   void resized() override;
 
+  /** 背景を Alt (Option) + クリックで診断オーバーレイを切り替える */
+  void mouseDown(const juce::MouseEvent &event) override;
+
 private:
   VT2WWhiteProcessor &audioProcessor;
 
-  // 画像
-  juce::Image backgroundImage;
-  juce::Image knobImage;
+  // 画像 (デコード・縮小はプロセス内で共有し、最後のエディターが閉じると解放)
+  juce::SharedResourcePointer<VT2WImageResources> imageResources;
+  juce::Rectangle<int> backgroundBounds; // 元画像の大きさ
+  juce::Image backgroundImage; // 元画像 (キャッシュ無効の間だけ持つ)
+
+  // 表示サイズ x 画面のスケールに縮小済みの背景
+  // (サイズ・スケールが変わる時だけ取り直す)
+  bool renderCacheEnabled = true;
+  juce::Image scaledBackgroundImage;
+  float scaledBackgroundScale = 0.0f;
+
+  // paint 時間 (診断オーバーレイに表示)
+  VT2WPaintStats backgroundPaintStats;
+  VT2WPaintStats knobPaintStats;
 
   // ノブ
   VT2WImageKnob driveKnob;
@@ -86,6 +259,12 @@ private:
   juce::Slider driveSlider;
   juce::Slider mixSlider;
 
+  // メーター
+  VT2WMeterStrip meterStrip;
+
+  // 診断オーバーレイ (既定は非表示)
+  VT2WDiagnosticsOverlay diagnosticsOverlay;
+
   // パラメータアタッチメント
   std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>
       driveAttachment;
@@ -13,35 +13,6 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
-#include <cmath>
-
-//==============================================================================
-// VT-2W White 定数定義
-namespace VT2WConstants {
-// サチュレーション - クリーンでHi-Fi
-constexpr float kSaturationCoeffMax = 0.8f; // 少し上げる (0.5 -> 0.8)
-constexpr float kSaturationKnee =
-    0.90f; // 少しだけ早く効くように (0.95 -> 0.90)
-
-// 倍音生成 - 聴感上の「太さ」を強化
-constexpr float kHarmonic2ndAmount = 0.15f; // アナログ感を強める (0.08 -> 0.15)
-constexpr float kHarmonic3rdAmount =
-    0.04f; // 極小だが少し存在感を出す (0.02 -> 0.04)
-
-// トランジェント - 輪郭を明瞭にする
-constexpr float kTransientAmountMax =
-    0.20f; // 歪みに負けない輪郭 (0.15 -> 0.20)
-constexpr float kEnvelopeAttack = 0.002f;
-constexpr float kEnvelopeRelease = 0.100f;
-
-// パラメータ範囲
-constexpr float kDriveMin = 0.0f;
-constexpr float kDriveMax = 10.0f;
-constexpr float kDriveDefault = 0.0f;
-constexpr float kMixMin = 0.0f;
-constexpr float kMixMax = 100.0f;
-constexpr float kMixDefault = 100.0f;
-} // namespace VT2WConstants
 
 //==============================================================================
 VT2WWhiteProcessor::VT2WWhiteProcessor()
@@ -49,13 +20,30 @@ VT2WWhiteProcessor::VT2WWhiteProcessor()
           BusesProperties()
               .withInput("Input", juce::AudioChannelSet::stereo(), true)
               .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-      parameters(*this, nullptr, juce::Identifier("VT2WWhite"),
+      parameters(*this, nullptr,
+                 juce::Identifier(VT2WParameters::kStateType),
                  createParameterLayout()) {
-  driveParameter = parameters.getRawParameterValue("drive");
-  mixParameter = parameters.getRawParameterValue("mix");
+  using namespace VT2WParameters;
+
+  driveParameter = parameters.getRawParameterValue(kDrive);
+  mixParameter = parameters.getRawParameterValue(kMix);
+  qualityParameter = parameters.getRawParameterValue(kQuality);
+  oversamplingParameter = parameters.getRawParameterValue(kOversampling);
+  oversamplingFilterParameter =
+      parameters.getRawParameterValue(kOversamplingFilter);
+  adaaParameter = parameters.getRawParameterValue(kAdaa);
+  linkParameter = parameters.getRawParameterValue(kLink);
+  adaptiveParameter = parameters.getRawParameterValue(kAdaptive);
+  modelParameter = parameters.getRawParameterValue(kModel);
+  morphParameter = parameters.getRawParameterValue(kMorph);
+
+  publishBank();
+
+  // 遅延の変化は設定を変えた時だけなので、報告はこの間隔で十分
+  startTimerHz(kLatencyPollHz);
 }
 
-VT2WWhiteProcessor::~VT2WWhiteProcessor() {}
+VT2WWhiteProcessor::~VT2WWhiteProcessor() { stopTimer(); }
 
 //==============================================================================
 juce::AudioProcessorValueTreeState::ParameterLayout
@@ -64,7 +52,7 @@ VT2WWhiteProcessor::createParameterLayout() {
 
   // Drive パラメータ
   params.push_back(std::make_unique<juce::AudioParameterFloat>(
-      juce::ParameterID{"drive", 1}, "Drive",
+      juce::ParameterID{VT2WParameters::kDrive, 1}, "Drive",
       juce::NormalisableRange<float>(VT2WConstants::kDriveMin,
                                      VT2WConstants::kDriveMax, 0.1f),
       VT2WConstants::kDriveDefault,
@@ -72,12 +60,56 @@ VT2WWhiteProcessor::createParameterLayout() {
 
   // Mix パラメータ
   params.push_back(std::make_unique<juce::AudioParameterFloat>(
-      juce::ParameterID{"mix", 1}, "Mix",
+      juce::ParameterID{VT2WParameters::kMix, 1}, "Mix",
       juce::NormalisableRange<float>(VT2WConstants::kMixMin,
                                      VT2WConstants::kMixMax, 1.0f),
       VT2WConstants::kMixDefault,
       juce::AudioParameterFloatAttributes().withLabel("%")));
 
+  // Quality パラメータ (tanh 近似の段階)
+  // Eco: トラッキング向けの軽量カーブ / Reference: 最終バウンス用の厳密 tanh
+  params.push_back(std::make_unique<juce::AudioParameterChoice>(
+      juce::ParameterID{VT2WParameters::kQuality, 1}, "Quality",
+      juce::StringArray{"Eco", "Standard", "Reference"},
+      static_cast<int>(VT2WSaturationQuality::Standard)));
+
+  // Oversampling パラメータ (選択肢の番号 = 倍率の log2)
+  params.push_back(std::make_unique<juce::AudioParameterChoice>(
+      juce::ParameterID{VT2WParameters::kOversampling, 1}, "Oversampling",
+      juce::StringArray{"1x", "2x", "4x", "8x"}, 1));
+
+  // オーバーサンプリングのフィルター
+  // IIR: 低レイテンシ・低負荷 / Linear Phase FIR: 位相を崩さない
+  params.push_back(std::make_unique<juce::AudioParameterChoice>(
+      juce::ParameterID{VT2WParameters::kOversamplingFilter, 1}, "OS Filter",
+      juce::StringArray{"IIR", "Linear Phase FIR"},
+      static_cast<int>(VT2WOversamplingFilter::PolyphaseIIR)));
+
+  // ADAA (サチュレーション・倍音段の折り返しを内部レートのまま抑える)
+  params.push_back(std::make_unique<juce::AudioParameterBool>(
+      juce::ParameterID{VT2WParameters::kAdaa, 1}, "ADAA", false));
+
+  // Link (全チャンネルで 1 本のエンベロープを共有し、定位を揺らさない)
+  params.push_back(std::make_unique<juce::AudioParameterBool>(
+      juce::ParameterID{VT2WParameters::kLink, 1}, "Link", false));
+
+  // Auto Quality (CPU 負荷が高い時だけ品質を下げる。バウンス中は常に設定どおり)
+  params.push_back(std::make_unique<juce::AudioParameterBool>(
+      juce::ParameterID{VT2WParameters::kAdaptive, 1}, "Auto Quality", false));
+
+  // Model (White: クリーン / Hi-Fi、Black: 密度を足してまとめる)
+  params.push_back(std::make_unique<juce::AudioParameterChoice>(
+      juce::ParameterID{VT2WParameters::kModel, 1}, "Model",
+      juce::StringArray{"White", "Black"},
+      static_cast<int>(VT2WModel::White)));
+
+  // Morph (選んでいる A/B スロットから他方へ寄せる。Drive / Mix は連続、
+  // 他の項目は 50% で切り替える)
+  params.push_back(std::make_unique<juce::AudioParameterFloat>(
+      juce::ParameterID{VT2WParameters::kMorph, 1}, "Morph",
+      juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f,
+      juce::AudioParameterFloatAttributes().withLabel("%")));
+
   return {params.begin(), params.end()};
 }
 
@@ -89,32 +121,133 @@ const juce::String VT2WWhiteProcessor::getName() const {
 bool VT2WWhiteProcessor::acceptsMidi() const { return false; }
 bool VT2WWhiteProcessor::producesMidi() const { return false; }
 bool VT2WWhiteProcessor::isMidiEffect() const { return false; }
-double VT2WWhiteProcessor::getTailLengthSeconds() const { return 0.0; }
+double VT2WWhiteProcessor::getTailLengthSeconds() const {
+  return tailLengthSeconds.load();
+}
+
+int VT2WWhiteProcessor::getNumPrograms() {
+  return VT2WPresets::getNumFactoryPresets();
+}
 
-int VT2WWhiteProcessor::getNumPrograms() { return 1; }
-int VT2WWhiteProcessor::getCurrentProgram() { return 0; }
-void VT2WWhiteProcessor::setCurrentProgram(int) {}
-const juce::String VT2WWhiteProcessor::getProgramName(int) { return {}; }
+int VT2WWhiteProcessor::getCurrentProgram() {
+  const std::lock_guard<std::recursive_mutex> lock(bankLock);
+  return presetBank.getProgram();
+}
+
+void VT2WWhiteProcessor::setCurrentProgram(int index) {
+  const std::lock_guard<std::recursive_mutex> lock(bankLock);
+  recallSettings(presetBank.selectProgram(index), morphParameter->load());
+}
+
+const juce::String VT2WWhiteProcessor::getProgramName(int index) {
+  if (index < 0 || index >= VT2WPresets::getNumFactoryPresets())
+    return {};
+
+  return VT2WPresets::getFactoryPreset(index).name;
+}
+
+// ファクトリープリセットの名前は変えられない
 void VT2WWhiteProcessor::changeProgramName(int, const juce::String &) {}
 
+//==============================================================================
+void VT2WWhiteProcessor::selectSlot(int slot) {
+  const std::lock_guard<std::recursive_mutex> lock(bankLock);
+  if (slot != presetBank.getSelectedSlot())
+    recallSettings(presetBank.selectSlot(slot, getSettings()),
+                   morphParameter->load());
+}
+
+int VT2WWhiteProcessor::getSelectedSlot() const {
+  const std::lock_guard<std::recursive_mutex> lock(bankLock);
+  return presetBank.getSelectedSlot();
+}
+
+void VT2WWhiteProcessor::copyToOtherSlot() {
+  const std::lock_guard<std::recursive_mutex> lock(bankLock);
+  presetBank.copyToOther(getSettings());
+  publishBank();
+}
+
+void VT2WWhiteProcessor::recallSettings(const VT2WSettings &settings,
+                                        float morph) {
+  // 先に設定一式と Morph を公開してからパラメータを書き換え、Morph も
+  // 書き終えたら解除する
+  bankSnapshot.write({settings, presetBank.getOther(), morph, true});
+  recallGeneration.fetch_add(1);
+  setParameterValues(settings);
+
+  if (auto *parameter = parameters.getParameter(VT2WParameters::kMorph)) {
+    const float normalised = parameter->convertTo0to1(morph);
+    if (parameter->getValue() != normalised)
+      parameter->setValueNotifyingHost(normalised);
+  }
+
+  publishBank();
+}
+
+void VT2WWhiteProcessor::publishBank() {
+  bankSnapshot.write({VT2WSettings(), presetBank.getOther(), 0.0f, false});
+}
+
 //==============================================================================
 void VT2WWhiteProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
-  currentSampleRate = sampleRate;
+  // 目標値を先に入れておくと、prepare でスムージングが目標値から始まる
+  applySettings();
+  engine.prepare(sampleRate, samplesPerBlock,
+                 std::max(getTotalNumInputChannels(), 1));
+
+  // prepareToPlay はオーディオスレッドの外なので、ここではすぐに報告する
+  setLatencySamples(engine.getLatencySamples());
+}
+
+VT2WSettings VT2WWhiteProcessor::getSettings() const {
+  return VT2WParameters::makeSettings(
+      driveParameter->load(), mixParameter->load(), qualityParameter->load(),
+      oversamplingParameter->load(), oversamplingFilterParameter->load(),
+      adaaParameter->load(), linkParameter->load(), adaptiveParameter->load(),
+      modelParameter->load());
+}
 
-  // スムージング設定
-  smoothedDrive.reset(sampleRate, 0.05); // 少しゆっくり追従
-  smoothedMix.reset(sampleRate, 0.05);
+void VT2WWhiteProcessor::applySettings() {
+  // Drive / Mix の変化はエンジンのスムージング、構造の変化は
+  // エンジンのクロスフェードで繋がる
+  const uint32_t generation = recallGeneration.load();
+  const auto &bank = bankSnapshot.read();
+  auto current = bank.target;
+  float morph = bank.morph;
+
+  if (!bank.recalling) {
+    current = getSettings();
+    morph = morphParameter->load();
+
+    // 読んでいる途中で呼び出しが始まった: 書きかけのパラメータが
+    // 混ざっているかもしれないので、このブロックは前の設定のまま
+    // (次のブロックで公開された一式を使う)
+    if (recallGeneration.load() != generation)
+      return;
+  }
+
+  engine.applySettings(
+      VT2WPresets::interpolate(current, bank.other, morph / 100.0f));
+
+  engineLatency.store(engine.getLatencySamples(), std::memory_order_relaxed);
+
+  if (getSampleRate() > 0.0)
+    tailLengthSeconds.store(engine.getTailLengthSamples() / getSampleRate());
+}
 
-  envelopeL = 0.0f;
-  envelopeR = 0.0f;
+void VT2WWhiteProcessor::timerCallback() {
+  const int latency = engineLatency.load(std::memory_order_relaxed);
+  if (latency != getLatencySamples())
+    setLatencySamples(latency);
 }
 
 void VT2WWhiteProcessor::releaseResources() {}
 
 bool VT2WWhiteProcessor::isBusesLayoutSupported(
     const BusesLayout &layouts) const {
-  if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono() &&
-      layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+  // モノラル / ステレオからイマーシブ (7.1.4 など) まで、入出力が同じなら可
+  if (layouts.getMainOutputChannelSet().isDisabled())
     return false;
 
   if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
@@ -126,8 +259,21 @@ bool VT2WWhiteProcessor::isBusesLayoutSupported(
 //==============================================================================
 void VT2WWhiteProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                       juce::MidiBuffer &midiMessages) {
-  juce::ScopedNoDenormals noDenormals;
   juce::ignoreUnused(midiMessages);
+  processSamples(buffer);
+}
+
+void VT2WWhiteProcessor::processBlock(juce::AudioBuffer<double> &buffer,
+                                      juce::MidiBuffer &midiMessages) {
+  juce::ignoreUnused(midiMessages);
+  processSamples(buffer);
+}
+
+template <typename Sample>
+void VT2WWhiteProcessor::processSamples(juce::AudioBuffer<Sample> &buffer) {
+  juce::ScopedNoDenormals noDenormals;
+  const VT2WBlockTimer::Scope timing(blockTimer, buffer.getNumSamples(),
+                                     getSampleRate());
 
   auto totalNumInputChannels = getTotalNumInputChannels();
   auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -135,124 +281,27 @@ void VT2WWhiteProcessor::processBlock(juce::AudioBuffer<float> &buffer,
   for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
     buffer.clear(i, 0, buffer.getNumSamples());
 
-  float drive = *driveParameter;
-  float mix = *mixParameter / 100.0f;
-
-  smoothedDrive.setTargetValue(drive);
-  smoothedMix.setTargetValue(mix);
-
-  auto *channelDataL = buffer.getWritePointer(0);
-  auto *channelDataR =
-      totalNumInputChannels > 1 ? buffer.getWritePointer(1) : nullptr;
-
-  for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
-    float currentDrive = smoothedDrive.getNextValue();
-    float currentMix = smoothedMix.getNextValue();
-
-    float dryL = channelDataL[sample];
-    float dryR = channelDataR ? channelDataR[sample] : dryL;
-
-    // クリーンブースト
-    // Driveマックスでも+6dB程度に抑える（歪みより質感重視）
-    float preDriveGain =
-        1.0f + (currentDrive / VT2WConstants::kDriveMax) * 1.0f;
-
-    // === L ch ===
-    float wetL = dryL * preDriveGain;
-    wetL = processSaturation(wetL, currentDrive);
-    wetL += processHarmonics(dryL * preDriveGain, currentDrive);
-    wetL = processTransient(wetL, envelopeL, currentDrive);
-    wetL *= calculateMakeupGain(currentDrive);
-
-    // === R ch ===
-    float wetR = dryR;
-    if (channelDataR != nullptr) {
-      wetR = dryR * preDriveGain;
-      wetR = processSaturation(wetR, currentDrive);
-      wetR += processHarmonics(dryR * preDriveGain, currentDrive);
-      wetR = processTransient(wetR, envelopeR, currentDrive);
-      wetR *= calculateMakeupGain(currentDrive);
-    } else {
-      wetR = wetL;
-    }
-
-    // Mix (Dry/Wet)
-    channelDataL[sample] = dryL * (1.0f - currentMix) + wetL * currentMix;
-    if (channelDataR != nullptr)
-      channelDataR[sample] = dryR * (1.0f - currentMix) + wetR * currentMix;
-  }
-}
-
-//==============================================================================
-// DSP Implementations
-
-float VT2WWhiteProcessor::processSaturation(float input, float drive) {
-  if (std::abs(input) < 0.0001f)
-    return input;
-
-  float normalizedDrive = drive / VT2WConstants::kDriveMax;
-
-  // 質感（太さ）を出すためのS字カーブ
-  // k をもう少し積極的にし、高域の明瞭度を保つために cubic だけではなく tanh
-  // 的な 挙動を少し混ぜる
-  float k = 0.12f * normalizedDrive;
-  float out = input - k * (input * input * input);
-
-  // 安全のためのリミッティング（Hi-Fiさを損なわない程度）
-  return std::tanh(out * (1.0f + 0.1f * normalizedDrive)) /
-         (1.0f + 0.1f * normalizedDrive);
-}
-
-float VT2WWhiteProcessor::processHarmonics(float input, float drive) {
-  float normalizedDrive = drive / VT2WConstants::kDriveMax;
-
-  // 非対称な歪みによる2次倍音付加
-  // DCオフセットは極小量なので、ここでは簡略化しつつ効果を高める
-  float h2 = (input * std::abs(input)) * VT2WConstants::kHarmonic2ndAmount *
-             normalizedDrive;
-  float h3 = (input * input * input) * VT2WConstants::kHarmonic3rdAmount *
-             normalizedDrive;
+  applySettings();
 
-  return h2 - h3; // 2次（太さ）と3次（エッジ）の組み合わせ
-}
+  // 直前のブロックの負荷で品質の段を決める (バウンス中・決定的モードでは
+  // 常にレベル 0)
+  engine.setDeterministic(deterministic.load(std::memory_order_relaxed));
+  engine.setRealtime(!isNonRealtime());
+  engine.reportLoad(blockTimer.getLastLoad(), buffer.getNumSamples());
 
-float VT2WWhiteProcessor::processTransient(float input, float &envelope,
-                                           float drive) {
-  // トランジェント保護
-  // アタック部分の歪みを避けるために、アタック時に少しゲインを下げるのではなく
-  // 逆にアタックをクリアにするために少し強調する?
-  // 「音の輪郭と解像度が向上」 -> アタック強調 (Expander的な)
-
-  float absInput = std::abs(input);
-
-  float attackCoeff = 1.0f - std::exp(-1.0f / (float(currentSampleRate) *
-                                               VT2WConstants::kEnvelopeAttack));
-  float releaseCoeff =
-      1.0f - std::exp(-1.0f / (float(currentSampleRate) *
-                               VT2WConstants::kEnvelopeRelease));
-
-  if (absInput > envelope)
-    envelope = envelope + attackCoeff * (absInput - envelope);
-  else
-    envelope = envelope + releaseCoeff * (absInput - envelope);
-
-  float normalizedDrive = drive / VT2WConstants::kDriveMax;
-  float amount = VT2WConstants::kTransientAmountMax * normalizedDrive;
-
-  // エンベロープの変化率が高い（アタック）時に少しブースト
-  // 簡易実装として、入力とエンベロープの差分を加算
-  float transient = absInput - envelope;
-  if (transient > 0) {
-    // アタック成分
-    return input + input * (transient * amount * 2.0f);
-  }
+  VT2WMeterFrame meter;
+  meter.numSamples = buffer.getNumSamples();
+  VT2WMetering::measure(buffer.getArrayOfReadPointers(), totalNumInputChannels,
+                        meter.numSamples, meter.inputPeak, meter.inputRms);
 
-  return input;
-}
+  engine.process(buffer.getArrayOfWritePointers(), totalNumInputChannels,
+                 buffer.getNumSamples());
 
-float VT2WWhiteProcessor::calculateMakeupGain(float drive) {
-  // ブースト分を少し下げる
-  return 1.0f / (1.0f + (drive / VT2WConstants::kDriveMax) * 0.5f);
+  VT2WMetering::measure(buffer.getArrayOfReadPointers(), totalNumInputChannels,
+                        meter.numSamples, meter.outputPeak, meter.outputRms);
+  meter.envelope = engine.getEnvelopeLevel();
+  meter.makeupGain = engine.getMakeupGain();
+  meterFifo.push(meter);
 }
 
 //==============================================================================
@@ -264,18 +313,40 @@ juce::AudioProcessorEditor *VT2WWhiteProcessor::createEditor() {
 
 //==============================================================================
 void VT2WWhiteProcessor::getStateInformation(juce::MemoryBlock &destData) {
-  auto state = parameters.copyState();
-  std::unique_ptr<juce::XmlElement> xml(state.createXml());
-  copyXmlToBinary(*xml, destData);
+  // パラメータの値とバンクの状態を固定長のバイナリに (XML・ValueTree を
+  // 経由しない)
+  const std::lock_guard<std::recursive_mutex> lock(bankLock);
+  VT2WStateFormat::BankState bank;
+  bank.other = presetBank.getOther();
+  bank.morph = morphParameter->load();
+  bank.selectedSlot = presetBank.getSelectedSlot();
+  bank.program = presetBank.getProgram();
+
+  const auto data = VT2WStateFormat::write(getSettings(), bank);
+  destData.replaceAll(data.data(), data.size());
 }
 
 void VT2WWhiteProcessor::setStateInformation(const void *data,
                                              int sizeInBytes) {
-  std::unique_ptr<juce::XmlElement> xmlState(
-      getXmlFromBinary(data, sizeInBytes));
-  if (xmlState.get() != nullptr)
-    if (xmlState->hasTagName(parameters.state.getType()))
-      parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+  // バイナリ形式と以前の版の XML の両方を読む
+  VT2WSettings settings;
+  VT2WStateFormat::BankState bank;
+  if (!VT2WParameters::readStateBlob(data, sizeInBytes, settings, &bank))
+    return;
+
+  const std::lock_guard<std::recursive_mutex> lock(bankLock);
+  presetBank.restore(bank.other, bank.selectedSlot, bank.program);
+  recallSettings(settings, bank.morph);
+}
+
+void VT2WWhiteProcessor::setParameterValues(const VT2WSettings &settings) {
+  // 値が変わるパラメータだけを書き換える (ValueTree は作り直さない)
+  for (const auto &[id, value] : VT2WParameters::getParameterValues(settings))
+    if (auto *parameter = parameters.getParameter(id)) {
+      const float normalised = parameter->convertTo0to1(value);
+      if (parameter->getValue() != normalised)
+        parameter->setValueNotifyingHost(normalised);
+    }
 }
 
 //==============================================================================
@@ -10,6 +10,15 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_audio_utils/juce_audio_utils.h>
 
+#include "VT2WParameters.h"
+#include "dsp/VT2WAdaptiveEngine.h"
+#include "dsp/VT2WBlockTimer.h"
+#include "dsp/VT2WMetering.h"
+#include "dsp/VT2WPresetBank.h"
+#include "dsp/VT2WStateFormat.h"
+
+#include <mutex>
+
 //==============================================================================
 /**
  * VT-2W White Processor
@@ -17,7 +26,7 @@
  * 超低歪ソリッドステート回路をベースにした精密サチュレーションモデル。
  * 「音を壊さず、質感だけを足す」Clean / Hi-Fi / Transparent 設計。
  */
-class VT2WWhiteProcessor : public juce::AudioProcessor {
+class VT2WWhiteProcessor : public juce::AudioProcessor, private juce::Timer {
 public:
   //==============================================================================
   VT2WWhiteProcessor();
@@ -31,6 +40,10 @@ public:
 
   void processBlock(juce::AudioBuffer<float> &, juce::MidiBuffer &) override;
 
+  /** 64bit のミックスエンジンからは変換無しで double のまま処理する */
+  bool supportsDoublePrecisionProcessing() const override { return true; }
+  void processBlock(juce::AudioBuffer<double> &, juce::MidiBuffer &) override;
+
   //==============================================================================
   juce::AudioProcessorEditor *createEditor() override;
   bool hasEditor() const override;
@@ -44,6 +57,7 @@ public:
   double getTailLengthSeconds() const override;
 
   //==============================================================================
+  // プログラム = ファクトリープリセット (VT2WPresets)
   int getNumPrograms() override;
   int getCurrentProgram() override;
   void setCurrentProgram(int index) override;
@@ -58,6 +72,46 @@ public:
   // パラメータアクセス
   juce::AudioProcessorValueTreeState &getParameters() { return parameters; }
 
+  /**
+   * processBlock の処理時間 (予算に対する負荷率のヒストグラム)
+   * getSnapshot はどのスレッドからでも呼べる。
+   */
+  const VT2WBlockTimer &getBlockTimer() const { return blockTimer; }
+  void resetBlockTimer() { blockTimer.requestReset(); }
+
+  /**
+   * A / B スロット (メッセージスレッドから呼ぶ)
+   * 切り替えると今の値を元のスロットに残し、切り替え先の値を呼び出す。
+   * パラメータ Morph は選んでいるスロットから他方へ寄せる量。
+   */
+  void selectSlot(int slot);
+  int getSelectedSlot() const;
+  void copyToOtherSlot();
+
+  /**
+   * Auto Quality で下げている段数 (0 = 設定どおり)。
+   * どのスレッドからでも読める
+   */
+  int getQualityLevel() const { return engine.getLevel(); }
+
+  /**
+   * 決定的モード (既定は無効。どのスレッドからでも呼べる)
+   * 有効な間は、同じ入力と設定ならカーネルの ISA・ホストのブロック長・
+   * ビルド環境に依らずビット単位で同じ出力になる (VT2WWhiteEngine::
+   * setDeterministic)。Auto Quality は止まる。レンダーファームでの
+   * 書き出しの照合や回帰テスト向け。
+   */
+  void setDeterministic(bool shouldBeDeterministic) {
+    deterministic.store(shouldBeDeterministic);
+  }
+  bool isDeterministic() const { return deterministic.load(); }
+
+  /**
+   * メーターの値をブロック単位で 1 つ取り出す (読み手はエディター 1 つだけ)
+   * オーディオスレッドは wait-free の FIFO に積むだけで、満杯なら捨てる。
+   */
+  bool popMeterFrame(VT2WMeterFrame &frame) { return meterFifo.pop(frame); }
+
 private:
   //==============================================================================
   // パラメータ
@@ -65,44 +119,77 @@ private:
 
   std::atomic<float> *driveParameter = nullptr;
   std::atomic<float> *mixParameter = nullptr;
+  std::atomic<float> *qualityParameter = nullptr;
+  std::atomic<float> *oversamplingParameter = nullptr;
+  std::atomic<float> *oversamplingFilterParameter = nullptr;
+  std::atomic<float> *adaaParameter = nullptr;
+  std::atomic<float> *linkParameter = nullptr;
+  std::atomic<float> *adaptiveParameter = nullptr;
+  std::atomic<float> *modelParameter = nullptr;
+  std::atomic<float> *morphParameter = nullptr;
 
   //==============================================================================
-  // DSP状態
-  double currentSampleRate = 44100.0;
+  // プリセットと A/B スロット (メッセージスレッド側、bankLock で守る。
+  // ホストがパラメータの通知の中から状態を読むことがあるので再入できる)
+  VT2WPresetBank presetBank;
+  mutable std::recursive_mutex bankLock;
 
-  // エンベロープフォロワー（トランジェント追従用）
-  float envelopeL = 0.0f;
-  float envelopeR = 0.0f;
+  // オーディオスレッドへはバンクの状態を丸ごと公開する (ロック・確保無し)
+  VT2WTripleBuffer<VT2WBankSnapshot> bankSnapshot;
 
-  // スムージング
-  juce::SmoothedValue<float> smoothedDrive;
-  juce::SmoothedValue<float> smoothedMix;
+  // 呼び出しを始める度に増やす (オーディオスレッドがパラメータを読んでいる
+  // 途中で呼び出しが始まったことに気付くため)
+  std::atomic<uint32_t> recallGeneration{0};
 
   //==============================================================================
-  // DSP処理関数
+  // DSP処理 (JUCE 非依存のエンジンに委譲。Auto Quality の切り替えも含む)
+  VT2WAdaptiveEngine engine;
 
-  /**
-   * クリーンサチュレーション
-   * ソリッドステート的な応答で、非常に歪み感の少ない飽和
-   */
-  float processSaturation(float input, float drive);
+  // ブロック毎の処理時間 (オーディオスレッドが書き、UI などが読む)
+  VT2WBlockTimer blockTimer;
 
-  /**
-   * 微小倍音付加
-   * デジタル的な冷たさを除去する程度の極小量
-   */
-  float processHarmonics(float input, float drive);
+  // メーター (オーディオスレッド -> エディター)
+  VT2WMeterFifo meterFifo;
+
+  // オーバーサンプリングのフィルター余韻 (ホストからはどのスレッドでも読まれる)
+  std::atomic<double> tailLengthSeconds{0.0};
+
+  // エンジンのレイテンシ (オーディオスレッドが書き、ホストへの報告は
+  // メッセージスレッドのタイマーから。setLatencySamples はホストに
+  // 同期で通知するのでオーディオスレッドからは呼ばない)
+  std::atomic<int> engineLatency{0};
+  static constexpr int kLatencyPollHz = 10;
+
+  // 決定的モード (どのスレッドからでも書け、オーディオスレッドが反映する)
+  std::atomic<bool> deterministic{false};
+
+  /** 現在のパラメータ値 (オーディオスレッドから呼べる) */
+  VT2WSettings getSettings() const;
 
   /**
-   * トランジェント保護
-   * ほぼそのまま保持し、輪郭だけを整える
+   * パラメータ (呼び出し中はバンクの値) と Morph の相手を補間して
+   * エンジンに反映し、遅延とテール長を公開する
    */
-  float processTransient(float input, float &envelope, float drive);
+  void applySettings();
+
+  /** 公開された遅延が変わっていればホストに報告する (メッセージスレッド) */
+  void timerCallback() override;
+
+  /** 状態の復元: 値が変わるパラメータだけをホストに通知して書き換える */
+  void setParameterValues(const VT2WSettings &settings);
 
   /**
-   * ゲイン補償
+   * 設定一式と Morph を呼び出す (bankLock を持って呼ぶ)
+   * パラメータを書き換えている間も、オーディオスレッドは公開した
+   * 設定一式と Morph を使うので、途中の組み合わせは鳴らない。
    */
-  float calculateMakeupGain(float drive);
+  void recallSettings(const VT2WSettings &settings, float morph);
+
+  /** 呼び出し中でない状態を公開する (bankLock を持って呼ぶ) */
+  void publishBank();
+
+  /** processBlock の本体 (float / double 共通) */
+  template <typename Sample> void processSamples(juce::AudioBuffer<Sample> &);
 
   //==============================================================================
   // パラメータレイアウト作成
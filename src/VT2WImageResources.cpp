@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Shared Image Resources Implementation
+  ==============================================================================
+*/
+
+#include "VT2WImageResources.h"
+#include "BinaryData.h"
+
+//==============================================================================
+juce::Image VT2WImageResources::getOriginal(Id id) {
+  auto &image = originals[static_cast<int>(id)];
+
+  if (!image.isValid()) {
+    // BinaryData名は CMakeLists.txt の juce_add_binary_data
+    // で指定されたファイル名に基づく
+    if (id == Id::Background)
+      image = juce::ImageFileFormat::loadFrom(VT2WData::background_jpg,
+                                              VT2WData::background_jpgSize);
+    else
+      image = juce::ImageFileFormat::loadFrom(VT2WData::knob_png,
+                                              VT2WData::knob_pngSize);
+
+    originalBounds[static_cast<int>(id)] = image.getBounds();
+  }
+
+  return image;
+}
+
+juce::Rectangle<int> VT2WImageResources::getOriginalBounds(Id id) {
+  // 大きさだけが要る時もデコードは 1 回 (直後の getScaled が使って捨てる)
+  if (originalBounds[static_cast<int>(id)].isEmpty())
+    getOriginal(id);
+
+  return originalBounds[static_cast<int>(id)];
+}
+
+juce::Image VT2WImageResources::getScaled(Id id, int width, int height) {
+  purgeUnused();
+
+  for (const auto &entry : scaled)
+    if (entry.id == id && entry.image.getWidth() == width &&
+        entry.image.getHeight() == height)
+      return entry.image;
+
+  juce::Image result;
+  {
+    auto original = getOriginal(id);
+    if (!original.isValid() ||
+        (width == original.getWidth() && height == original.getHeight()))
+      return original;
+
+    scaled.push_back({id, original.rescaled(
+                              width, height,
+                              juce::Graphics::highResamplingQuality)});
+    result = scaled.back().image;
+  }
+
+  // 縮小画像ができたら元画像は要らない
+  releaseOriginal(id);
+  return result;
+}
+
+void VT2WImageResources::releaseOriginal(Id id) {
+  auto &image = originals[static_cast<int>(id)];
+  if (image.isValid() && image.getReferenceCount() <= 1)
+    image = {};
+}
+
+void VT2WImageResources::purgeUnused() {
+  // 参照がこのキャッシュだけなら、もう表示しているエディターは無い
+  scaled.erase(std::remove_if(scaled.begin(), scaled.end(),
+                              [](const Scaled &entry) {
+                                return entry.image.getReferenceCount() <= 1;
+                              }),
+               scaled.end());
+}
+
+size_t VT2WImageResources::getMemoryBytes() const {
+  auto bytes = [](const juce::Image &image) {
+    if (!image.isValid())
+      return size_t(0);
+    const int pixelStride = image.getFormat() == juce::Image::RGB ? 3 : 4;
+    return size_t(image.getWidth()) * size_t(image.getHeight()) * pixelStride;
+  };
+
+  size_t total = 0;
+  for (const auto &image : originals)
+    total += bytes(image);
+  for (const auto &entry : scaled)
+    total += bytes(entry.image);
+  return total;
+}
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Shared Image Resources
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <vector>
+
+//==============================================================================
+/**
+ * エディターの画像 (背景・ノブ) をプロセス内の全インスタンスで共有する
+ *
+ * juce::SharedResourcePointer<VT2WImageResources> で持つ。最初のエディターが
+ * 開いた時に作られ、最後のエディターが閉じると画像ごと解放される
+ * (juce::ImageCache と違い、エディターが無い間はメモリに残らない)。
+ *
+ * 元画像は要求された時に BinaryData からデコードし、縮小画像を作り終えて
+ * どのエディターも参照していなければすぐに捨てる (表示に要るのは縮小画像
+ * だけ。サイズやスケールが変わった時はデコードし直す)。縮小画像は同じ
+ * サイズならインスタンス間で同じものを返し、どのエディターも使っていない
+ * サイズ (参照がキャッシュだけのもの) は次の要求時に捨てる。
+ * メッセージスレッドからのみ使う。
+ */
+class VT2WImageResources {
+public:
+  enum class Id { Background, Knob };
+  static constexpr int kNumImages = 2;
+
+  VT2WImageResources() = default;
+
+  /**
+   * 元の解像度の画像 (持っていなければデコードする)
+   * 呼び出し側が持っている間は捨てない。キャッシュ無効時の比較描画用。
+   */
+  juce::Image getOriginal(Id id);
+
+  /** 元画像の大きさ (初回だけデコードして覚える。読めなければ空) */
+  juce::Rectangle<int> getOriginalBounds(Id id);
+
+  /** width x height に縮小した画像 (元と同じサイズなら元画像そのもの) */
+  juce::Image getScaled(Id id, int width, int height);
+
+  /** 保持している画像の合計バイト数 (ARGB / RGB のピクセル分) */
+  size_t getMemoryBytes() const;
+
+private:
+  /** どのエディターも参照していない縮小画像を捨てる */
+  void purgeUnused();
+
+  /** 元画像をどのエディターも参照していなければ捨てる */
+  void releaseOriginal(Id id);
+
+  struct Scaled {
+    Id id;
+    juce::Image image;
+  };
+
+  juce::Image originals[kNumImages];
+  juce::Rectangle<int> originalBounds[kNumImages];
+  std::vector<Scaled> scaled;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VT2WImageResources)
+};
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Parameter IDs / State Reading Implementation
+  ==============================================================================
+*/
+
+#include "VT2WParameters.h"
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace VT2WParameters {
+
+VT2WSettings makeSettings(float drive, float mix, float quality,
+                          float oversampling, float oversamplingFilter,
+                          float adaa, float link, float adaptive,
+                          float model) {
+  VT2WSettings settings;
+  settings.drive = juce::jlimit(VT2WConstants::kDriveMin,
+                                VT2WConstants::kDriveMax, drive);
+  settings.mix =
+      juce::jlimit(VT2WConstants::kMixMin, VT2WConstants::kMixMax, mix);
+  settings.quality = static_cast<VT2WSaturationQuality>(
+      juce::jlimit(0, 2, juce::roundToInt(quality)));
+  settings.oversamplingLog2 = juce::jlimit(
+      0, VT2WOversampler::kMaxFactorLog2, juce::roundToInt(oversampling));
+  settings.oversamplingFilter = static_cast<VT2WOversamplingFilter>(
+      juce::jlimit(0, 1, juce::roundToInt(oversamplingFilter)));
+  settings.adaa = adaa >= 0.5f;
+  settings.link = link >= 0.5f;
+  settings.adaptive = adaptive >= 0.5f;
+  settings.model =
+      static_cast<VT2WModel>(juce::jlimit(0, 1, juce::roundToInt(model)));
+  return settings;
+}
+
+std::array<ParameterValue, kNumParameters>
+getParameterValues(const VT2WSettings &settings) {
+  auto flag = [](bool value) { return value ? 1.0f : 0.0f; };
+  return {{{kDrive, settings.drive},
+           {kMix, settings.mix},
+           {kQuality, (float)static_cast<int>(settings.quality)},
+           {kOversampling, (float)settings.oversamplingLog2},
+           {kOversamplingFilter,
+            (float)static_cast<int>(settings.oversamplingFilter)},
+           {kAdaa, flag(settings.adaa)},
+           {kLink, flag(settings.link)},
+           {kAdaptive, flag(settings.adaptive)},
+           {kModel, (float)static_cast<int>(settings.model)}}};
+}
+
+VT2WSettings readSettings(const juce::ValueTree &state) {
+  // APVTS は <PARAM id="..." value="..."/> を子に持つ (値はホスト単位)
+  auto value = [&state](const char *id, float fallback) {
+    auto param = state.getChildWithProperty("id", juce::String(id));
+    return param.isValid() ? (float)param.getProperty("value", fallback)
+                           : fallback;
+  };
+
+  // オーバーサンプリングの無かった版のセッションは 1x のまま呼び出す
+  // (新しいインスタンスの既定値 2x にすると音とレイテンシが変わる)
+  const VT2WSettings defaults;
+  return makeSettings(
+      value(kDrive, defaults.drive), value(kMix, defaults.mix),
+      value(kQuality, (float)static_cast<int>(defaults.quality)),
+      value(kOversampling, (float)kLegacyOversamplingLog2),
+      value(kOversamplingFilter,
+            (float)static_cast<int>(defaults.oversamplingFilter)),
+      value(kAdaa, defaults.adaa ? 1.0f : 0.0f),
+      value(kLink, defaults.link ? 1.0f : 0.0f),
+      value(kAdaptive, defaults.adaptive ? 1.0f : 0.0f),
+      value(kModel, (float)static_cast<int>(defaults.model)));
+}
+
+bool readStateBlob(const void *data, int sizeInBytes, VT2WSettings &settings,
+                   VT2WStateFormat::BankState *bank) {
+  if (VT2WStateFormat::isBinary(data, sizeInBytes))
+    return VT2WStateFormat::read(data, sizeInBytes, settings, bank) ==
+           VT2WStateFormat::Status::Ok;
+
+  // 以前の版 (APVTS の状態を XML にしたもの)
+  auto xml = juce::AudioProcessor::getXmlFromBinary(data, sizeInBytes);
+  if (xml == nullptr || !xml->hasTagName(kStateType))
+    return false;
+
+  settings = readSettings(juce::ValueTree::fromXml(*xml));
+  if (bank != nullptr) {
+    *bank = {};
+    bank->other = settings;
+  }
+  return true;
+}
+
+} // namespace VT2WParameters
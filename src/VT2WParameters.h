@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Parameter IDs / State Reading
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_data_structures/juce_data_structures.h>
+
+#include "dsp/VT2WSettings.h"
+#include "dsp/VT2WStateFormat.h"
+
+#include <array>
+
+//==============================================================================
+/**
+ * パラメータ ID と、保存された状態から VT2WSettings への変換
+ *
+ * プラグイン (VT2WWhiteProcessor) とオフラインレンダラー (EA_VT_2W_Render) で
+ * 共有する。ID は保存データの互換性のため変更しない。
+ */
+namespace VT2WParameters {
+constexpr const char *kStateType = "VT2WWhite";
+
+// Drive / Mix はプラグインではブロックの先頭で反映する (JUCE 8 はホストの
+// パラメータキューの時刻を渡さない)。サンプル単位の反映 (VT2WAutomation.h)
+// はオフラインレンダラーの --automation だけ
+constexpr const char *kDrive = "drive";
+constexpr const char *kMix = "mix";
+constexpr const char *kQuality = "quality";
+constexpr const char *kOversampling = "oversampling";
+constexpr const char *kOversamplingFilter = "oversamplingFilter";
+constexpr const char *kAdaa = "adaa";
+constexpr const char *kLink = "link";
+constexpr const char *kAdaptive = "adaptive";
+constexpr const char *kModel = "model";
+constexpr const char *kMorph = "morph"; // VT2WSettings には含めない (A/B 用)
+
+/**
+ * パラメータの値 (ホスト単位: Choice は番号、Bool は 0/1) から設定を作る
+ * プラグインのオーディオスレッドからも呼ぶので確保しない
+ */
+VT2WSettings makeSettings(float drive, float mix, float quality,
+                          float oversampling, float oversamplingFilter,
+                          float adaa, float link, float adaptive,
+                          float model);
+
+/** パラメータ ID と値 (ホスト単位) */
+struct ParameterValue {
+  const char *id;
+  float value;
+};
+
+constexpr int kNumParameters = 9;
+
+/** 設定をパラメータの値の並びに戻す (makeSettings の逆、確保しない) */
+std::array<ParameterValue, kNumParameters>
+getParameterValues(const VT2WSettings &settings);
+
+/** Oversampling パラメータの無い (それより前の版の) 状態での倍率 (1x) */
+constexpr int kLegacyOversamplingLog2 = 0;
+
+/**
+ * AudioProcessorValueTreeState の状態から設定を読む。無い項目は既定値
+ * (Oversampling だけは kLegacyOversamplingLog2)
+ */
+VT2WSettings readSettings(const juce::ValueTree &state);
+
+/**
+ * getStateInformation が書いたデータから設定を読む
+ * バイナリ形式 (VT2WStateFormat.h) と、以前の版が書いた XML の両方を読める。
+ * VT-2W White の状態でない (または壊れている) なら false を返し、
+ * settings / bank は変更しない。A/B スロットの無いデータでは、bank は
+ * 両方のスロットが同じ値で Morph 0 になる。
+ */
+bool readStateBlob(const void *data, int sizeInBytes, VT2WSettings &settings,
+                   VT2WStateFormat::BankState *bank = nullptr);
+} // namespace VT2WParameters
@@ -0,0 +1,453 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Adaptive Quality Engine Implementation
+  ==============================================================================
+*/
+
+#include "VT2WAdaptiveEngine.h"
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+VT2WAdaptiveEngine::VT2WAdaptiveEngine() { applySettings(userSettings); }
+
+void VT2WAdaptiveEngine::prepare(double newSampleRate, int newMaximumBlockSize,
+                                 int newNumChannels) {
+  sampleRate = newSampleRate;
+  maximumBlockSize = std::max(newMaximumBlockSize, 1);
+  numChannels = std::max(newNumChannels, 1);
+
+  for (auto &slot : slots) {
+    slot.engine.prepare(sampleRate, maximumBlockSize, numChannels);
+    slot.padLine.assign((size_t)numChannels * kMaxPadSamples, 0.0);
+    slot.padPosition = 0;
+  }
+
+  auto allocate = [this](auto &scratch) {
+    scratch.data.assign((size_t)numChannels * maximumBlockSize, 0);
+    scratch.pointers.assign(numChannels, nullptr);
+    scratch.span.assign(numChannels, nullptr);
+    scratch.subBlock.assign(numChannels, nullptr);
+    for (int ch = 0; ch < numChannels; ++ch)
+      scratch.pointers[ch] =
+          scratch.data.data() + (size_t)ch * maximumBlockSize;
+  };
+  allocate(floatScratch);
+  allocate(doubleScratch);
+
+  // 止まっている間に始まった切り替えは、フェードせずに切り替え先へ移る
+  // (applySettings は prepare の前にも呼ばれる)
+  fadeLength = std::max(1, (int)std::lround(kCrossfadeSeconds * sampleRate));
+  finishCrossfade();
+
+  // モデルのテールは基本レートのサンプル数なので取り直す
+  tailSamples = latencyProbe.getTailSamples() +
+                VT2WModels::getTailSamples(userSettings.model, sampleRate);
+
+  smoothedLoad = 0.0f;
+  secondsSinceSwitch = 0.0;
+  secondsBelowStepUp = 0.0;
+  measuringCostRatio = false;
+  std::fill(std::begin(costRatios), std::end(costRatios), 0.0f);
+}
+
+void VT2WAdaptiveEngine::reset() {
+  finishCrossfade();
+
+  for (auto &slot : slots) {
+    slot.engine.reset();
+    std::fill(slot.padLine.begin(), slot.padLine.end(), 0.0);
+    slot.padPosition = 0;
+  }
+}
+
+bool VT2WAdaptiveEngine::setKernel(VT2WKernelIsa isa) {
+  const bool supported = slots[0].engine.setKernel(isa);
+  slots[1].engine.setKernel(isa);
+  return supported;
+}
+
+//==============================================================================
+VT2WSettings VT2WAdaptiveEngine::getLevelSettings(const VT2WSettings &settings,
+                                                  int level) {
+  auto result = settings;
+
+  // 音への影響が小さいものから順に軽くする
+  for (int step = 0; step < level; ++step) {
+    if (result.quality == VT2WSaturationQuality::Reference)
+      result.quality = VT2WSaturationQuality::Standard;
+    else if (result.oversamplingLog2 > 0)
+      --result.oversamplingLog2;
+    else if (result.quality == VT2WSaturationQuality::Standard)
+      result.quality = VT2WSaturationQuality::Eco;
+    else
+      break;
+  }
+
+  return result;
+}
+
+int VT2WAdaptiveEngine::getNumLevels(const VT2WSettings &settings) {
+  int numSteps = settings.oversamplingLog2;
+  if (settings.quality == VT2WSaturationQuality::Reference)
+    numSteps += 2;
+  else if (settings.quality == VT2WSaturationQuality::Standard)
+    numSteps += 1;
+
+  return numSteps + 1;
+}
+
+//==============================================================================
+bool VT2WAdaptiveEngine::hasSameStructure(const VT2WSettings &a,
+                                          const VT2WSettings &b) {
+  return a.model == b.model && a.quality == b.quality &&
+         a.oversamplingLog2 == b.oversamplingLog2 &&
+         a.oversamplingFilter == b.oversamplingFilter && a.adaa == b.adaa &&
+         a.link == b.link;
+}
+
+void VT2WAdaptiveEngine::applySettings(const VT2WSettings &settings) {
+  const bool restructure =
+      maximumBlockSize > 0 && !hasSameStructure(settings, userSettings);
+  userSettings = settings;
+  numLevels = getNumLevels(settings);
+
+  // レベル 0 のレイテンシ (VT2WWhiteEngine::setAdaaEnabled と同じ遅延を足す)
+  latencyProbe.setMode(settings.oversamplingLog2, settings.oversamplingFilter);
+  const bool adaa = settings.adaa && VT2WModels::supportsAdaa(settings.model);
+  latencyProbe.setProcessingDelay(adaa ? 0.5 : 0.0);
+  latencySamples = latencyProbe.getLatencySamples();
+  tailSamples = latencyProbe.getTailSamples() +
+                VT2WModels::getTailSamples(settings.model, sampleRate);
+
+  // フェード中に構造が変わったら、そのフェードが終わってから切り替える
+  // (鳴っている 2 つのエンジンは途中でリセットしない)
+  if (restructure && fadeRemaining > 0)
+    pendingRestructure = true;
+  if (pendingRestructure)
+    return;
+
+  // モデルやオーバーサンプリングが変わる時 (プリセットの呼び出しなど) は、
+  // 前の構造のエンジンを鳴らしたまま新しい構造のエンジンへクロスフェードする
+  if (restructure) {
+    restructuring = true;
+    startCrossfade(std::min(slots[active].level, numLevels - 1), true);
+    return;
+  }
+
+  // ドライブなどの変更は両方のエンジンに入れておく (フェード中も揃う)。
+  // 構造のクロスフェード中は、消えていく側を前の構造のまま残す
+  if (!restructuring)
+    configure(slots[active], std::min(slots[active].level, numLevels - 1));
+  auto &other = slots[1 - active];
+  configure(other, std::min(other.level, numLevels - 1));
+
+  if (!canAdapt())
+    startCrossfade(0);
+}
+
+void VT2WAdaptiveEngine::setRealtime(bool isRealtime) {
+  realtime = isRealtime;
+
+  // バウンスはクリックを気にしなくてよいので、最初のサンプルからレベル 0
+  if (!realtime) {
+    jumpToLevelZero();
+    return;
+  }
+
+  if (!canAdapt())
+    startCrossfade(0);
+}
+
+void VT2WAdaptiveEngine::setDeterministic(bool shouldBeDeterministic) {
+  if (shouldBeDeterministic == deterministic)
+    return;
+
+  deterministic = shouldBeDeterministic;
+  for (auto &slot : slots)
+    slot.engine.setDeterministic(deterministic);
+
+  if (!canAdapt())
+    startCrossfade(0);
+}
+
+void VT2WAdaptiveEngine::finishCrossfade() {
+  // フェード中なら切り替え先にそのまま移る
+  if (fadeRemaining > 0) {
+    active = 1 - active;
+    fadeRemaining = 0;
+  }
+  restructuring = false;
+
+  // 待っていた構造の変更はフェードせずに反映する
+  if (pendingRestructure) {
+    pendingRestructure = false;
+    const int level = canAdapt() ? std::min(slots[active].level, numLevels - 1)
+                                 : 0;
+    configure(slots[active], level);
+    currentLevel.store(level);
+  }
+}
+
+void VT2WAdaptiveEngine::jumpToLevelZero() {
+  // レベル 0 のまま、またはレベル 0 へのフェード中ならそのまま続ける
+  const bool fadingToZero = fadeRemaining > 0 && slots[1 - active].level == 0;
+  if (slots[active].level == 0 && (fadeRemaining == 0 || fadingToZero))
+    return;
+
+  if (fadingToZero)
+    active = 1 - active;
+  fadeRemaining = 0;
+  restructuring = false;
+
+  if (slots[active].level != 0 || pendingRestructure) {
+    pendingRestructure = false;
+    configure(slots[active], 0);
+  }
+
+  secondsSinceSwitch = 0.0;
+  secondsBelowStepUp = 0.0;
+  measuringCostRatio = false;
+  currentLevel.store(0);
+}
+
+void VT2WAdaptiveEngine::configure(Slot &slot, int level) {
+  slot.engine.applySettings(getLevelSettings(userSettings, level));
+  slot.level = level;
+
+  const int pad = std::clamp(
+      latencySamples - slot.engine.getLatencySamples(), 0, kMaxPadSamples);
+  if (pad != slot.pad) {
+    slot.pad = pad;
+    slot.padPosition = 0;
+    std::fill(slot.padLine.begin(), slot.padLine.end(), 0.0);
+  }
+}
+
+void VT2WAdaptiveEngine::startCrossfade(int level, bool force) {
+  level = std::clamp(level, 0, numLevels - 1);
+
+  if (fadeRemaining > 0 || (level == slots[active].level && !force))
+    return;
+
+  // 待機側のエンジンを新しいレベルにして、無音の状態から始める
+  auto &next = slots[1 - active];
+  configure(next, level);
+  next.engine.reset();
+  next.engine.skipSmoothing();
+  std::fill(next.padLine.begin(), next.padLine.end(), 0.0);
+  next.padPosition = 0;
+
+  // prepare 前なら即座に切り替える
+  if (maximumBlockSize == 0) {
+    active = 1 - active;
+    restructuring = false;
+  } else
+    fadeRemaining = fadeLength;
+
+  secondsSinceSwitch = 0.0;
+  secondsBelowStepUp = 0.0;
+  currentLevel.store(level);
+}
+
+//==============================================================================
+void VT2WAdaptiveEngine::reportLoad(float load, int numSamples) {
+  if (!canAdapt()) {
+    startCrossfade(0);
+    return;
+  }
+
+  // フェード中は 2 つ分処理しているので判定に使わない
+  if (fadeRemaining > 0 || numSamples <= 0)
+    return;
+
+  const double seconds = numSamples / sampleRate;
+  const float alpha = (float)(1.0 - std::exp(-seconds / kLoadTimeConstant));
+  smoothedLoad += alpha * (load - smoothedLoad);
+
+  secondsSinceSwitch += seconds;
+  if (secondsSinceSwitch < kMinDwellSeconds)
+    return;
+
+  const int level = slots[active].level;
+
+  // 下げた後の負荷が落ち着いたら、その段のコスト比を覚えておく
+  if (measuringCostRatio && level > 0) {
+    costRatios[level - 1] = std::clamp(
+        loadBeforeStepDown / std::max(smoothedLoad, 1.0e-3f), 1.0f, 16.0f);
+    measuringCostRatio = false;
+  }
+
+  if ((smoothedLoad > kStepDownLoad || load >= 1.0f) &&
+      level + 1 < numLevels) {
+    loadBeforeStepDown = std::max(smoothedLoad, load);
+    measuringCostRatio = true;
+    startCrossfade(level + 1);
+    return;
+  }
+
+  if (level == 0)
+    return;
+
+  const float ratio =
+      costRatios[level - 1] > 0.0f ? costRatios[level - 1] : kDefaultCostRatio;
+
+  if (smoothedLoad * ratio < kStepUpLoad) {
+    secondsBelowStepUp += seconds;
+    if (secondsBelowStepUp >= kStepUpHoldSeconds)
+      startCrossfade(level - 1);
+  } else {
+    secondsBelowStepUp = 0.0;
+  }
+}
+
+//==============================================================================
+void VT2WAdaptiveEngine::process(float *const *channels, int numActive,
+                                 int numSamples) {
+  processSamples(channels, numActive, numSamples);
+}
+
+void VT2WAdaptiveEngine::process(double *const *channels, int numActive,
+                                 int numSamples) {
+  processSamples(channels, numActive, numSamples);
+}
+
+void VT2WAdaptiveEngine::process(float *const *channels, int numActive,
+                                 int numSamples,
+                                 const VT2WParameterEvents &events) {
+  processEvents(channels, numActive, numSamples, events);
+}
+
+void VT2WAdaptiveEngine::process(double *const *channels, int numActive,
+                                 int numSamples,
+                                 const VT2WParameterEvents &events) {
+  processEvents(channels, numActive, numSamples, events);
+}
+
+template <typename Sample>
+void VT2WAdaptiveEngine::processEvents(Sample *const *channels, int numActive,
+                                       int numSamples,
+                                       const VT2WParameterEvents &events) {
+  numActive = std::min(numActive, numChannels);
+  auto &span = getScratch<Sample>().span;
+
+  VT2WAutomation::split(
+      events, numSamples,
+      [&](int start, int length) {
+        for (int ch = 0; ch < numActive; ++ch)
+          span[ch] = channels[ch] + start;
+        processSamples(span.data(), numActive, length);
+      },
+      [this](const VT2WParameterEvent &event) {
+        // 後からクロスフェードで切り替えるエンジンも同じ目標値になるよう、
+        // ユーザーの設定にも入れておく
+        using namespace VT2WConstants;
+        if (event.parameter == VT2WAutomatedParameter::Drive)
+          userSettings.drive = std::clamp(event.value, kDriveMin, kDriveMax);
+        else
+          userSettings.mix = std::clamp(event.value, kMixMin, kMixMax);
+
+        for (auto &slot : slots)
+          slot.engine.applyEvent(event);
+      });
+}
+
+template <typename Sample>
+void VT2WAdaptiveEngine::processSamples(Sample *const *channels, int numActive,
+                                        int numSamples) {
+  numActive = std::min(numActive, numChannels);
+  if (numActive <= 0 || maximumBlockSize == 0)
+    return;
+
+  // 作業バッファは prepare の最大ブロック長分なので時間方向だけに分割する
+  // (全チャンネルを一度に通さないとスムーサーやフェードが余分に進む)
+  if (numSamples <= maximumBlockSize) {
+    processBlock(channels, numActive, numSamples);
+    return;
+  }
+
+  auto &subBlock = getScratch<Sample>().subBlock;
+  for (int offset = 0; offset < numSamples; offset += maximumBlockSize) {
+    const int length = std::min(maximumBlockSize, numSamples - offset);
+    for (int ch = 0; ch < numActive; ++ch)
+      subBlock[ch] = channels[ch] + offset;
+    processBlock(subBlock.data(), numActive, length);
+  }
+}
+
+template <typename Sample>
+void VT2WAdaptiveEngine::processBlock(Sample *const *channels, int numActive,
+                                      int numSamples) {
+  auto &current = slots[active];
+
+  if (fadeRemaining == 0) {
+    processSlot(current, channels, numActive, numSamples);
+    return;
+  }
+
+  // フェード中は同じ入力を両方に通す
+  auto &next = slots[1 - active];
+  auto &scratch = getScratch<Sample>();
+  for (int ch = 0; ch < numActive; ++ch)
+    std::copy(channels[ch], channels[ch] + numSamples, scratch.pointers[ch]);
+
+  processSlot(current, channels, numActive, numSamples);
+  processSlot(next, scratch.pointers.data(), numActive, numSamples);
+
+  // 相関の高い信号同士なので等ゲインの直線フェード
+  const int fadeDone = fadeLength - fadeRemaining;
+  const int numFading = std::min(numSamples, fadeRemaining);
+  const float step = 1.0f / (float)fadeLength;
+
+  for (int ch = 0; ch < numActive; ++ch) {
+    Sample *out = channels[ch];
+    const Sample *in = scratch.pointers[ch];
+
+    for (int i = 0; i < numFading; ++i) {
+      const Sample gain = (Sample)(fadeDone + i + 1) * step;
+      out[i] += gain * (in[i] - out[i]);
+    }
+    std::copy(in + numFading, in + numSamples, out + numFading);
+  }
+
+  fadeRemaining -= numFading;
+  if (fadeRemaining == 0) {
+    active = 1 - active;
+    restructuring = false;
+
+    // フェード中に来た構造の変更をここから始める
+    if (pendingRestructure) {
+      pendingRestructure = false;
+      restructuring = true;
+      startCrossfade(std::min(slots[active].level, numLevels - 1), true);
+    }
+  }
+}
+
+template <typename Sample>
+void VT2WAdaptiveEngine::processSlot(Slot &slot, Sample *const *channels,
+                                     int numActive, int numSamples) {
+  slot.engine.process(channels, numActive, numSamples);
+
+  if (slot.pad == 0)
+    return;
+
+  // レベル 0 とのレイテンシの差を遅延で埋める
+  for (int ch = 0; ch < numActive; ++ch) {
+    double *line = slot.padLine.data() + (size_t)ch * kMaxPadSamples;
+    Sample *io = channels[ch];
+    int position = slot.padPosition;
+
+    for (int i = 0; i < numSamples; ++i) {
+      const Sample sample = io[i];
+      io[i] = (Sample)line[position];
+      line[position] = sample;
+      if (++position == slot.pad)
+        position = 0;
+    }
+  }
+
+  slot.padPosition = (int)((slot.padPosition + (long)numSamples) % slot.pad);
+}
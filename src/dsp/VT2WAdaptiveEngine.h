@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Adaptive Quality Engine (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "VT2WOversampler.h"
+#include "VT2WSettings.h"
+#include "VT2WWhiteEngine.h"
+
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
+//==============================================================================
+/**
+ * CPU 負荷に応じて処理の重さを自動で下げる VT2WWhiteEngine のラッパー
+ *
+ * ユーザーの設定をレベル 0 とし、レベルを 1 つ下げるごとに
+ * Reference -> Standard、オーバーサンプリングを 1 段ずつ、最後に Eco の順で
+ * 軽くする (getLevelSettings)。直前のブロックの負荷率 (reportLoad) を
+ * 平滑化し、kStepDownLoad を超えたら 1 段下げ、上げた後の予測負荷が
+ * kStepUpLoad 未満の状態が kStepUpHoldSeconds 続いたら 1 段上げる。
+ * 予測には実際に下げた時の負荷の比 (段ごとのコスト比) を使うので、
+ * 上げた直後にまた下げる往復が起きにくい。
+ *
+ * 切り替えは prepare で確保済みのエンジン 2 つの間のクロスフェード
+ * (kCrossfadeSeconds) で行い、オーディオスレッドでは確保しない。
+ * レイテンシは常にレベル 0 の値を報告し、軽いレベルは差の分を遅延させて
+ * 揃える (オーバーサンプリングを下げてもレイテンシは増えない)。
+ *
+ * 自動モードが無効、非リアルタイム (バウンス)、または決定的モードの時は
+ * 常にレベル 0 で、その場合の出力は VT2WWhiteEngine 単体と同じ。
+ *
+ * prepare の後にモデル・品質・オーバーサンプリングなどの構造が変わった時も
+ * 同じクロスフェードで切り替える (プリセットや A/B の呼び出しでクリックを
+ * 出さない)。フェード中に来た構造の変更は、そのフェードが終わってから
+ * 次のフェードで切り替える。Drive / Mix だけの変更はエンジンの
+ * スムージングに任せる。
+ */
+class VT2WAdaptiveEngine {
+public:
+  //==============================================================================
+  static constexpr double kCrossfadeSeconds = 0.02;
+  static constexpr double kLoadTimeConstant = 0.3; // 負荷の平滑化 (秒)
+  static constexpr float kStepDownLoad = 0.7f;
+  static constexpr float kStepUpLoad = 0.6f; // 上げた後の予測負荷
+  static constexpr double kMinDwellSeconds = 1.0; // 切り替え後は判定しない
+  static constexpr double kStepUpHoldSeconds = 3.0;
+  static constexpr float kDefaultCostRatio = 2.0f; // 未計測の段のコスト比
+  static constexpr int kMaxLevels = 6;
+  static constexpr int kMaxPadSamples = 256;
+
+  VT2WAdaptiveEngine();
+
+  /** 両方のエンジンと作業バッファをここで確保する */
+  void prepare(double sampleRate, int maximumBlockSize, int numChannels = 2);
+  void reset();
+
+  /**
+   * ユーザーの設定 (レベル 0) を反映する
+   * settings.adaptive が偽ならレベル 0 に戻す。prepare の前に呼ぶと
+   * スムージングは最初から目標値で始まる。構造が変わる場合は
+   * kCrossfadeSeconds のクロスフェードで切り替える。
+   */
+  void applySettings(const VT2WSettings &settings);
+
+  /**
+   * 非リアルタイム (バウンス中) なら常にレベル 0
+   * 下げていた場合や下げるフェードの途中でも、フェードせずにすぐ戻す。
+   */
+  void setRealtime(bool isRealtime);
+
+  /**
+   * 両方のエンジンの決定的モード (VT2WWhiteEngine::setDeterministic)
+   * 負荷で出力が変わらないよう、有効な間は常にレベル 0。
+   */
+  void setDeterministic(bool shouldBeDeterministic);
+  bool isDeterministic() const { return deterministic; }
+
+  /**
+   * 直前のブロックの負荷率 (処理時間 / (numSamples / sampleRate)) を渡す
+   * process の前に毎ブロック呼ぶ。
+   */
+  void reportLoad(float load, int numSamples);
+
+  /** ブロック処理 (in-place、VT2WWhiteEngine::process と同じ) */
+  void process(float *const *channels, int numChannels, int numSamples);
+  void process(double *const *channels, int numChannels, int numSamples);
+
+  /** 変化点付きのブロック処理 (VT2WWhiteEngine と同じ。両方のエンジンに反映) */
+  void process(float *const *channels, int numChannels, int numSamples,
+               const VT2WParameterEvents &events);
+  void process(double *const *channels, int numChannels, int numSamples,
+               const VT2WParameterEvents &events);
+
+  /** 現在のレベルのエンジンの値 (VT2WWhiteEngine と同じ。メーター用) */
+  float getEnvelopeLevel() const {
+    return slots[active].engine.getEnvelopeLevel();
+  }
+  float getMakeupGain() const { return slots[active].engine.getMakeupGain(); }
+
+  /** レベル 0 のレイテンシ (レベルに依らず一定) */
+  int getLatencySamples() const { return latencySamples; }
+  int getTailLengthSamples() const { return tailSamples; }
+
+  /** 現在のレベル (0 = ユーザーの設定)。どのスレッドからでも読める */
+  int getLevel() const { return currentLevel.load(); }
+  int getNumLevels() const { return numLevels; }
+  float getSmoothedLoad() const { return smoothedLoad; }
+
+  /** ユーザーの設定から、レベル level の設定を作る */
+  static VT2WSettings getLevelSettings(const VT2WSettings &settings,
+                                       int level);
+  static int getNumLevels(const VT2WSettings &settings);
+
+  /** Drive / Mix / Auto Quality 以外 (エンジンを作り直す項目) が同じか */
+  static bool hasSameStructure(const VT2WSettings &a, const VT2WSettings &b);
+
+  /** エンジンが kernel を使うようにする (ベンチマーク・検証用) */
+  bool setKernel(VT2WKernelIsa isa);
+
+private:
+  //==============================================================================
+  struct Slot {
+    VT2WWhiteEngine engine;
+    int level = 0;
+    int pad = 0; // レベル 0 とのレイテンシ差
+    int padPosition = 0;
+    std::vector<double> padLine; // チャンネル x kMaxPadSamples (float も通す)
+  };
+
+  /** クロスフェード中に切り替え先へ入力を複製する作業バッファ */
+  template <typename Sample> struct Scratch {
+    std::vector<Sample> data;
+    std::vector<Sample *> pointers;
+    std::vector<Sample *> span;     // 変化点で分けた区間用
+    std::vector<Sample *> subBlock; // 最大ブロック長で分けた区間用
+  };
+
+  template <typename Sample> Scratch<Sample> &getScratch() {
+    if constexpr (std::is_same_v<Sample, double>)
+      return doubleScratch;
+    else
+      return floatScratch;
+  }
+
+  /** 負荷でレベルを変えてよいか (自動モード・リアルタイム・非決定的) */
+  bool canAdapt() const {
+    return userSettings.adaptive && realtime && !deterministic;
+  }
+
+  /**
+   * 途中のクロスフェードを打ち切り、切り替え先のエンジンに移る
+   * 待っている構造の変更もフェードせずに反映する。
+   */
+  void finishCrossfade();
+
+  /** フェードせずにレベル 0 のエンジンへ移る (非リアルタイム用) */
+  void jumpToLevelZero();
+
+  /** レベル level を slot に反映し、遅延の差を揃える */
+  void configure(Slot &slot, int level);
+
+  /**
+   * 目標レベルへのクロスフェードを始める (フェード中は何もしない)
+   * force なら同じレベルでも新しい設定のエンジンへ切り替える。
+   */
+  void startCrossfade(int level, bool force = false);
+
+  template <typename Sample>
+  void processSamples(Sample *const *channels, int numChannels,
+                      int numSamples);
+  template <typename Sample>
+  void processEvents(Sample *const *channels, int numChannels, int numSamples,
+                     const VT2WParameterEvents &events);
+  template <typename Sample>
+  void processSlot(Slot &slot, Sample *const *channels, int numChannels,
+                   int numSamples);
+  template <typename Sample>
+  void processBlock(Sample *const *channels, int numChannels, int numSamples);
+
+  //==============================================================================
+  Slot slots[2];
+  int active = 0;
+  int fadeLength = 1;
+  int fadeRemaining = 0;
+  bool restructuring = false;      // 構造の変更によるフェード中
+  bool pendingRestructure = false; // フェード中に来た構造の変更 (未反映)
+
+  VT2WSettings userSettings;
+  int numLevels = 1;
+  bool realtime = true;
+  bool deterministic = false;
+  double sampleRate = 44100.0;
+  int maximumBlockSize = 0;
+  int numChannels = 0;
+
+  // レイテンシの計算用 (prepare しないので確保しない)
+  VT2WOversampler latencyProbe;
+  int latencySamples = 0;
+  int tailSamples = 0;
+
+  // 負荷の判定 (オーディオスレッドのみ)
+  float smoothedLoad = 0.0f;
+  double secondsSinceSwitch = 0.0;
+  double secondsBelowStepUp = 0.0;
+  float loadBeforeStepDown = 0.0f;
+  bool measuringCostRatio = false;
+  float costRatios[kMaxLevels] = {}; // レベル l と l + 1 の負荷の比
+
+  std::atomic<int> currentLevel{0};
+
+  Scratch<float> floatScratch;
+  Scratch<double> doubleScratch;
+};
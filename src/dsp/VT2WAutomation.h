@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Sample-Accurate Parameter Events (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+//==============================================================================
+/** サンプル単位で変化点を受け取れるパラメータ (連続値のものだけ) */
+enum class VT2WAutomatedParameter { Drive, Mix };
+
+/** ブロック内のパラメータの変化点 (値はホスト単位: Drive 0-10、Mix 0-100) */
+struct VT2WParameterEvent {
+  int sampleOffset; // ブロック先頭から
+  VT2WAutomatedParameter parameter;
+  float value;
+};
+
+/** オフラインのオートメーションの変化点 (位置は信号の先頭から) */
+struct VT2WAutomationPoint {
+  int64_t position;
+  VT2WAutomatedParameter parameter;
+  float value;
+};
+
+//==============================================================================
+/**
+ * 1 ブロック分の変化点の列 (固定長、確保しない)
+ *
+ * ホストのパラメータキュー (VST3 の IParamValueQueue など) やオフラインの
+ * オートメーションから、ブロック毎に clear して積み直す。add は位置の
+ * 順に並べる (同じ位置なら後から積んだ方が後)。満杯なら捨てて false
+ * (オフラインの変化点は VT2WAutomation::forEachSpan で区間を分けて渡す)。
+ *
+ * プラグイン (JUCE 8) はホストのパラメータキューの時刻を受け取れないので、
+ * Drive / Mix をブロックの先頭で反映する。変化点の列を使うのはオフライン
+ * レンダラーとベンチマークだけ。
+ */
+class VT2WParameterEvents {
+public:
+  static constexpr int kCapacity = 512;
+
+  void clear() { numEvents = 0; }
+
+  bool add(int sampleOffset, VT2WAutomatedParameter parameter, float value) {
+    if (numEvents == kCapacity)
+      return false;
+
+    int index = numEvents++;
+    for (; index > 0 && events[index - 1].sampleOffset > sampleOffset; --index)
+      events[index] = events[index - 1];
+    events[index] = {sampleOffset, parameter, value};
+    return true;
+  }
+
+  int size() const { return numEvents; }
+  bool empty() const { return numEvents == 0; }
+  const VT2WParameterEvent *begin() const { return events; }
+  const VT2WParameterEvent *end() const { return events + numEvents; }
+
+private:
+  VT2WParameterEvent events[kCapacity] = {};
+  int numEvents = 0;
+};
+
+namespace VT2WAutomation {
+/**
+ * 変化点でブロックを分ける
+ * 区間毎に processSpan(start, length) を呼び、区間の後に apply(event) を
+ * 呼ぶ。ブロックの外の位置は端に丸める (先頭より前は最初、後ろは最後)。
+ * 各区間はそのまま通常のブロック処理に渡せるので、変化点が無い間は
+ * 高速なカーネルがそのまま使われる。
+ */
+template <typename ProcessSpan, typename Apply>
+void split(const VT2WParameterEvents &events, int numSamples,
+           ProcessSpan &&processSpan, Apply &&apply) {
+  int position = 0;
+  for (const auto &event : events) {
+    const int offset = std::clamp(event.sampleOffset, position, numSamples);
+    if (offset > position)
+      processSpan(position, offset - position);
+
+    apply(event);
+    position = offset;
+  }
+
+  if (position < numSamples)
+    processSpan(position, numSamples - position);
+}
+
+/**
+ * 時刻順の変化点 points の next 番目から、先頭位置 blockStart・長さ
+ * numSamples のブロックに入る分を events に積み、process(start, length,
+ * events) を呼ぶ (events の位置は区間の先頭から)。events が満杯になったら
+ * 入りきらなかった点の位置で区間を分けて続けるので、点を捨てず、出力は
+ * ブロック長に依らない (同じ位置に満杯を超える点が重なっても、長さ 0 の
+ * 区間で反映して進む)。next は次のブロックの最初の点まで進める。
+ */
+template <typename Process>
+void forEachSpan(const VT2WAutomationPoint *points, size_t numPoints,
+                 size_t &next, int64_t blockStart, int numSamples,
+                 VT2WParameterEvents &events, Process &&process) {
+  for (int start = 0; start < numSamples;) {
+    int end = numSamples;
+    events.clear();
+
+    for (; next < numPoints; ++next) {
+      const int64_t position = points[next].position - blockStart;
+      if (position >= numSamples)
+        break;
+
+      const int offset = (int)std::max<int64_t>(position, start);
+      if (events.size() == VT2WParameterEvents::kCapacity) {
+        end = offset;
+        break;
+      }
+      events.add(offset - start, points[next].parameter, points[next].value);
+    }
+
+    process(start, end - start, events);
+    start = end;
+  }
+}
+} // namespace VT2WAutomation
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Block Timing Histogram Implementation
+  ==============================================================================
+*/
+
+#include "VT2WBlockTimer.h"
+
+#include <algorithm>
+#include <cmath>
+
+static_assert(VT2WBlockTimer::kNumBins <= 256,
+              "window stores bin indices as uint8_t");
+
+//==============================================================================
+float VT2WBlockTimer::getBinLowerEdge(int bin) {
+  return std::exp2(float(kMinLoadLog2) + float(bin) / float(kBinsPerOctave));
+}
+
+int VT2WBlockTimer::getBin(double load) {
+  if (!(load > 0.0))
+    return 0;
+
+  const double position =
+      (std::log2(load) - kMinLoadLog2) * double(kBinsPerOctave);
+  return (int)std::clamp(std::floor(position), 0.0, double(kNumBins - 1));
+}
+
+//==============================================================================
+void VT2WBlockTimer::addBlock(double seconds, double budgetSeconds) {
+  if (resetRequested.exchange(false))
+    clear();
+
+  const double load = seconds / budgetSeconds;
+  const int bin = getBin(load);
+  lastLoad.store(float(load), std::memory_order_relaxed);
+
+  // 書き込むのはこのスレッドだけなので、読み出し側が途中の値を見ることはない
+  auto add = [](std::atomic<uint32_t> &count, int delta) {
+    count.store(count.load(std::memory_order_relaxed) + delta,
+                std::memory_order_relaxed);
+  };
+
+  if (windowCount == kWindowSize)
+    add(counts[window[windowPosition]], -1);
+  else
+    ++windowCount;
+
+  window[windowPosition] = (uint8_t)bin;
+  windowPosition = (windowPosition + 1) % kWindowSize;
+  add(counts[bin], 1);
+
+  totalBlocks.store(totalBlocks.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+  if (bin >= kBudgetBin)
+    overBudgetBlocks.store(
+        overBudgetBlocks.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+  if (float(load) > peak.load(std::memory_order_relaxed))
+    peak.store(float(load), std::memory_order_relaxed);
+}
+
+void VT2WBlockTimer::clear() {
+  for (auto &count : counts)
+    count.store(0, std::memory_order_relaxed);
+
+  totalBlocks.store(0, std::memory_order_relaxed);
+  overBudgetBlocks.store(0, std::memory_order_relaxed);
+  peak.store(0.0f, std::memory_order_relaxed);
+  windowPosition = 0;
+  windowCount = 0;
+}
+
+//==============================================================================
+VT2WBlockTimer::Snapshot VT2WBlockTimer::getSnapshot() const {
+  Snapshot snapshot;
+
+  int highestBin = -1;
+  for (int bin = 0; bin < kNumBins; ++bin) {
+    const uint32_t count = counts[bin].load(std::memory_order_relaxed);
+    snapshot.counts[bin] = count;
+    snapshot.numBlocks += (int)count;
+    if (bin >= kBudgetBin)
+      snapshot.recentOverBudget += (int)count;
+    if (count > 0)
+      highestBin = bin;
+  }
+
+  // 累積がその割合に達したビンの中央 (対数上の中点)
+  auto quantile = [&snapshot](double fraction) {
+    const double target = fraction * snapshot.numBlocks;
+    double cumulative = 0.0;
+    for (int bin = 0; bin < kNumBins; ++bin) {
+      cumulative += snapshot.counts[bin];
+      if (cumulative >= target && snapshot.counts[bin] > 0)
+        return getBinLowerEdge(bin) * std::exp2(0.5f / kBinsPerOctave);
+    }
+    return 0.0f;
+  };
+
+  if (snapshot.numBlocks > 0) {
+    snapshot.p50 = quantile(0.5);
+    snapshot.p99 = quantile(0.99);
+    snapshot.max = getBinLowerEdge(highestBin + 1);
+  }
+
+  snapshot.peak = peak.load(std::memory_order_relaxed);
+  snapshot.totalBlocks = totalBlocks.load(std::memory_order_relaxed);
+  snapshot.overBudgetBlocks = overBudgetBlocks.load(std::memory_order_relaxed);
+  return snapshot;
+}
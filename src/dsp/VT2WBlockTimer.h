@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Block Timing Histogram (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+//==============================================================================
+/**
+ * ブロック単位の処理時間の計測
+ *
+ * 1 ブロックの処理時間をリアルタイムの予算 (numSamples / sampleRate) で割った
+ * 負荷率を、対数間隔のヒストグラムに積む。直近 kWindowSize ブロック分を
+ * 保持し、古いものから差し引くので p50 / p99 / max は直近の値になる。
+ *
+ * 書き込みはオーディオスレッド 1 本だけ (addBlock / Scope)、読み出し
+ * (getSnapshot) はどのスレッドからでもよい。どちらも確保・ロックをしない。
+ * 読み出しは書き込みと同時に走るので、ブロック 1 つ分ずれることはある。
+ */
+class VT2WBlockTimer {
+public:
+  //==============================================================================
+  // ビンは 1/8 オクターブ刻みで 1/1024 (0.1%) 〜 16 倍 (1600%)
+  // 予算ちょうど (1.0) が kBudgetBin の下端になる
+  static constexpr int kBinsPerOctave = 8;
+  static constexpr int kMinLoadLog2 = -10;
+  static constexpr int kMaxLoadLog2 = 4;
+  static constexpr int kNumBins = (kMaxLoadLog2 - kMinLoadLog2) * kBinsPerOctave;
+  static constexpr int kBudgetBin = -kMinLoadLog2 * kBinsPerOctave;
+
+  /** ヒストグラムに残すブロック数 (48kHz / 256 サンプルで約 20 秒) */
+  static constexpr int kWindowSize = 4096;
+
+  /** ある時点のヒストグラムと統計 (負荷率は 1.0 = 予算の 100%) */
+  struct Snapshot {
+    int numBlocks = 0; // ウィンドウ内のブロック数
+    float p50 = 0.0f;  // ビンの中央値で返す (分解能は約 ±4%)
+    float p99 = 0.0f;
+    float max = 0.0f;  // ウィンドウ内の最大 (ビンの上端)
+    int recentOverBudget = 0; // ウィンドウ内で予算 (1.0) 以上だったブロック数
+
+    float peak = 0.0f; // リセット後の最大 (ビンに丸めない)
+    uint64_t totalBlocks = 0;
+    uint64_t overBudgetBlocks = 0; // リセット後に予算以上だったブロック数
+
+    uint32_t counts[kNumBins] = {};
+  };
+
+  //==============================================================================
+  /** processBlock の先頭に置くと、スコープを抜けるまでの時間を記録する */
+  class Scope {
+  public:
+    Scope(VT2WBlockTimer &owner, int numSamples, double sampleRate)
+        : timer(owner),
+          budgetSeconds(sampleRate > 0.0 ? numSamples / sampleRate : 0.0),
+          start(Clock::now()) {}
+
+    ~Scope() {
+      if (budgetSeconds > 0.0)
+        timer.addBlock(
+            std::chrono::duration<double>(Clock::now() - start).count(),
+            budgetSeconds);
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    VT2WBlockTimer &timer;
+    double budgetSeconds;
+    Clock::time_point start;
+  };
+
+  //==============================================================================
+  /** 1 ブロック分を記録する (オーディオスレッドのみ) */
+  void addBlock(double seconds, double budgetSeconds);
+
+  /** 直前のブロックの負荷率 (VT2WAdaptiveEngine::reportLoad に渡す) */
+  float getLastLoad() const { return lastLoad.load(std::memory_order_relaxed); }
+
+  /** 統計を消す。実際に消すのは次の addBlock (書き込み側) */
+  void requestReset() { resetRequested.store(true); }
+
+  /** 現在のヒストグラムと統計 (どのスレッドからでも呼べる) */
+  Snapshot getSnapshot() const;
+
+  /** ビン index の下端の負荷率 */
+  static float getBinLowerEdge(int bin);
+
+  /** 負荷率が入るビン */
+  static int getBin(double load);
+
+private:
+  //==============================================================================
+  void clear();
+
+  // ヒストグラム (書き込みは 1 本だけなので load + store で足す)
+  std::atomic<uint32_t> counts[kNumBins] = {};
+  std::atomic<uint64_t> totalBlocks{0};
+  std::atomic<uint64_t> overBudgetBlocks{0};
+  std::atomic<float> peak{0.0f};
+  std::atomic<float> lastLoad{0.0f};
+  std::atomic<bool> resetRequested{false};
+
+  // 直近のブロックのビン (オーディオスレッドだけが触る)
+  uint8_t window[kWindowSize] = {};
+  int windowPosition = 0;
+  int windowCount = 0;
+};
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Coefficient Cache
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "VT2WConstants.h"
+
+//==============================================================================
+/**
+ * Drive 由来の係数
+ *
+ * 各ステージがサンプル毎に行っていた drive / kDriveMax、除算、
+ * メイクアップゲインの逆数をまとめて前計算したもの。
+ * Drive の目標値が変わった時だけ fromDrive で作り直す。
+ */
+struct VT2WDriveCoefficients {
+  float normalizedDrive = 0.0f;
+  float preGain = 1.0f;       // クリーンブースト
+  float cubic = 0.0f;         // S字カーブの 3 次係数 k
+  float limit = 1.0f;         // tanh 前のゲイン
+  float inverseLimit = 1.0f;  // tanh 後のゲイン (1 / limit)
+  float harmonic2 = 0.0f;     // 2次倍音量
+  float harmonic3 = 0.0f;     // 3次倍音量
+  float transientGain = 0.0f; // トランジェント強調量 (amount * 2)
+  float makeupGain = 1.0f;
+
+  static VT2WDriveCoefficients fromDrive(float drive) {
+    VT2WDriveCoefficients c;
+    c.normalizedDrive = drive / VT2WConstants::kDriveMax;
+    c.preGain = 1.0f + c.normalizedDrive * 1.0f;
+    c.cubic = 0.12f * c.normalizedDrive;
+    c.limit = 1.0f + 0.1f * c.normalizedDrive;
+    c.inverseLimit = 1.0f / c.limit;
+    c.harmonic2 = VT2WConstants::kHarmonic2ndAmount * c.normalizedDrive;
+    c.harmonic3 = VT2WConstants::kHarmonic3rdAmount * c.normalizedDrive;
+    c.transientGain =
+        VT2WConstants::kTransientAmountMax * c.normalizedDrive * 2.0f;
+    c.makeupGain = 1.0f / (1.0f + c.normalizedDrive * 0.5f);
+    return c;
+  }
+};
+
+/**
+ * VT-2B Black の Drive 由来の係数 (DSP_DESIGN.md)
+ * 既定値は Drive 0 の値 (fromDrive(0) と同じ)
+ */
+struct VT2WBlackCoefficients {
+  float normalizedDrive = 0.0f;
+  float density = 0.0f;         // 飽和係数 k
+  float shape = 2.0f;           // 曲線形状 n
+  float harmonic2 = 0.0f;       // 2次倍音量
+  float harmonic3 = 0.0f;       // 3次倍音量
+  // ピークを丸める量
+  float transientAmount = VT2WConstants::kBlackTransientAmountMin;
+  float makeupGain = 1.0f;
+
+  static VT2WBlackCoefficients fromDrive(float drive) {
+    VT2WBlackCoefficients c;
+    c.normalizedDrive = drive / VT2WConstants::kDriveMax;
+    c.density = VT2WConstants::kBlackDensityMax * c.normalizedDrive;
+    c.shape = VT2WConstants::kBlackShapeHard +
+              (VT2WConstants::kBlackShapeSoft -
+               VT2WConstants::kBlackShapeHard) *
+                  c.normalizedDrive;
+    c.harmonic2 = VT2WConstants::kBlackHarmonic2ndAmount * c.normalizedDrive;
+    c.harmonic3 = VT2WConstants::kBlackHarmonic3rdAmount * c.normalizedDrive;
+    c.transientAmount = VT2WConstants::kBlackTransientAmountMin +
+                        (VT2WConstants::kBlackTransientAmountMax -
+                         VT2WConstants::kBlackTransientAmountMin) *
+                            c.normalizedDrive;
+    c.makeupGain = 1.0f / (1.0f + drive * 0.1f);
+    return c;
+  }
+};
+
+/**
+ * サンプルレート由来の係数 (prepare で作り直す)
+ */
+struct VT2WRateCoefficients {
+  float attack = 0.0f;
+  float release = 0.0f;
+  float peakRelease = 0.0f;  // Black のピークホールドの減衰 (毎サンプル)
+  float phaseAllpass = 0.0f; // Black の位相安定化オールパスの係数
+};
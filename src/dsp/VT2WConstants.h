@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    DSP Constants
+  ==============================================================================
+*/
+
+#pragma once
+
+//==============================================================================
+// VT-2W White 定数定義
+namespace VT2WConstants {
+// サチュレーション - クリーンでHi-Fi
+constexpr float kSaturationCoeffMax = 0.8f; // 少し上げる (0.5 -> 0.8)
+constexpr float kSaturationKnee =
+    0.90f; // 少しだけ早く効くように (0.95 -> 0.90)
+
+// 倍音生成 - 聴感上の「太さ」を強化
+constexpr float kHarmonic2ndAmount = 0.15f; // アナログ感を強める (0.08 -> 0.15)
+constexpr float kHarmonic3rdAmount =
+    0.04f; // 極小だが少し存在感を出す (0.02 -> 0.04)
+
+// トランジェント - 輪郭を明瞭にする
+constexpr float kTransientAmountMax =
+    0.20f; // 歪みに負けない輪郭 (0.15 -> 0.20)
+constexpr float kEnvelopeAttack = 0.002f;
+constexpr float kEnvelopeRelease = 0.100f;
+
+// パラメータ範囲
+constexpr float kDriveMin = 0.0f;
+constexpr float kDriveMax = 10.0f;
+constexpr float kDriveDefault = 0.0f;
+constexpr float kMixMin = 0.0f;
+constexpr float kMixMax = 100.0f;
+constexpr float kMixDefault = 100.0f;
+
+// VT-2B Black (DSP_DESIGN.md): 歪みではなく密度を足すバス向けのキャラクター
+constexpr float kBlackDensityMax = 0.3f;    // x / (1 + k|x|^n) の k
+constexpr float kBlackShapeSoft = 1.5f;     // n (Drive 最大)
+constexpr float kBlackShapeHard = 2.0f;     // n (Drive 0)
+constexpr float kBlackHarmonic2ndAmount = 0.05f;
+constexpr float kBlackHarmonic3rdAmount = 0.02f;
+constexpr float kBlackTransientAmountMin = 0.05f;
+constexpr float kBlackTransientAmountMax = 0.15f;
+constexpr float kBlackTransientThreshold = 0.5f; // ピークを丸め始める値
+constexpr float kBlackTransientKnee = 0.5f;
+constexpr double kBlackPhaseFrequency = 80.0; // 位相安定化オールパス (Hz)
+
+// 無音スリープ: 入力・エンベロープがこれ未満 (約 -100dBFS) なら無音とみなす
+constexpr float kSilenceThreshold = 1.0e-5f;
+
+// スムージング時間 (秒)
+constexpr double kSmoothingTimeSeconds = 0.05; // 少しゆっくり追従
+} // namespace VT2WConstants
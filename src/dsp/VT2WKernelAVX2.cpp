@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    AVX2 + FMA Kernel (8 lanes)
+  ==============================================================================
+*/
+
+#include "VT2WKernels.h"
+
+#if VT2W_ARCH_X86
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))),            \
+                             apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+namespace VT2WSimdAVX2 {
+
+struct V {
+  using F = __m256;
+  using M = __m256;
+  static constexpr int width = 8;
+
+  static F load(const float *p) { return _mm256_loadu_ps(p); }
+  static void store(float *p, F a) { _mm256_storeu_ps(p, a); }
+  static F set1(float a) { return _mm256_set1_ps(a); }
+  static F add(F a, F b) { return _mm256_add_ps(a, b); }
+  static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+  static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+  static F div(F a, F b) { return _mm256_div_ps(a, b); }
+  static F min(F a, F b) { return _mm256_min_ps(a, b); }
+  static F max(F a, F b) { return _mm256_max_ps(a, b); }
+  static F mulAdd(F a, F b, F c) { return _mm256_fmadd_ps(a, b, c); }
+  static F abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+  static M lt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+  static F select(M m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+  static F copySign(F mag, F sgn) {
+    const F signMask = _mm256_set1_ps(-0.0f);
+    return _mm256_or_ps(_mm256_andnot_ps(signMask, mag),
+                        _mm256_and_ps(signMask, sgn));
+  }
+  static F round(F a) {
+    return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static F pow2(F n) {
+    __m256i e =
+        _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+  }
+};
+
+/** 決定的モード用: 積和を FMA にせず、SSE2 や 1 レーンの移植版と同じ丸めにする
+ * (VT2WKernels::getDeterministicOps) */
+struct VExact : V {
+  static F mulAdd(F a, F b, F c) { return add(mul(a, b), c); }
+};
+
+} // namespace VT2WSimdAVX2
+
+#include "VT2WKernelImpl.h"
+
+namespace VT2WSimdAVX2 {
+constexpr VT2WKernelOps ops =
+    VT2WKernelImpl::makeOps<V>(VT2WKernelIsa::AVX2, "AVX2");
+constexpr VT2WKernelOps deterministicOps =
+    VT2WKernelImpl::makeOps<VExact>(VT2WKernelIsa::AVX2,
+                                    "AVX2 (deterministic)");
+} // namespace VT2WSimdAVX2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+extern const VT2WKernelOps kVT2WKernelOpsAVX2 = VT2WSimdAVX2::ops;
+extern const VT2WKernelOps kVT2WKernelOpsAVX2Deterministic =
+    VT2WSimdAVX2::deterministicOps;
+
+#endif // VT2W_ARCH_X86
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    AVX-512F Kernel (16 lanes)
+  ==============================================================================
+*/
+
+#include "VT2WKernels.h"
+
+#if VT2W_ARCH_X86
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))),             \
+                             apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+// GCC 12 の avx512fintrin.h (_mm512_undefined_*) が誤検知される
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+namespace VT2WSimdAVX512 {
+
+struct V {
+  using F = __m512;
+  using M = __mmask16;
+  static constexpr int width = 16;
+
+  static F load(const float *p) { return _mm512_loadu_ps(p); }
+  static void store(float *p, F a) { _mm512_storeu_ps(p, a); }
+  static F set1(float a) { return _mm512_set1_ps(a); }
+  static F add(F a, F b) { return _mm512_add_ps(a, b); }
+  static F sub(F a, F b) { return _mm512_sub_ps(a, b); }
+  static F mul(F a, F b) { return _mm512_mul_ps(a, b); }
+  static F div(F a, F b) { return _mm512_div_ps(a, b); }
+  static F min(F a, F b) { return _mm512_min_ps(a, b); }
+  static F max(F a, F b) { return _mm512_max_ps(a, b); }
+  static F mulAdd(F a, F b, F c) { return _mm512_fmadd_ps(a, b, c); }
+  static F abs(F a) { return _mm512_abs_ps(a); }
+  static M lt(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+  static F select(M m, F a, F b) { return _mm512_mask_blend_ps(m, b, a); }
+  static F copySign(F mag, F sgn) {
+    // AVX512F のみで使えるよう整数演算でビット操作する
+    const __m512i signMask = _mm512_set1_epi32(int(0x80000000u));
+    __m512i m = _mm512_andnot_si512(signMask, _mm512_castps_si512(mag));
+    __m512i s = _mm512_and_si512(signMask, _mm512_castps_si512(sgn));
+    return _mm512_castsi512_ps(_mm512_or_si512(m, s));
+  }
+  static F round(F a) {
+    return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT |
+                                       _MM_FROUND_NO_EXC);
+  }
+  static F pow2(F n) {
+    __m512i e =
+        _mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(e, 23));
+  }
+};
+
+/** 決定的モード用: 積和を FMA にせず、SSE2 や 1 レーンの移植版と同じ丸めにする
+ * (VT2WKernels::getDeterministicOps) */
+struct VExact : V {
+  static F mulAdd(F a, F b, F c) { return add(mul(a, b), c); }
+};
+
+} // namespace VT2WSimdAVX512
+
+#include "VT2WKernelImpl.h"
+
+namespace VT2WSimdAVX512 {
+constexpr VT2WKernelOps ops =
+    VT2WKernelImpl::makeOps<V>(VT2WKernelIsa::AVX512, "AVX-512");
+constexpr VT2WKernelOps deterministicOps =
+    VT2WKernelImpl::makeOps<VExact>(VT2WKernelIsa::AVX512,
+                                    "AVX-512 (deterministic)");
+} // namespace VT2WSimdAVX512
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+
+extern const VT2WKernelOps kVT2WKernelOpsAVX512 = VT2WSimdAVX512::ops;
+extern const VT2WKernelOps kVT2WKernelOpsAVX512Deterministic =
+    VT2WSimdAVX512::deterministicOps;
+
+#endif // VT2W_ARCH_X86
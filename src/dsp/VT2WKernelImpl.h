@@ -0,0 +1,622 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    SIMD Kernel Templates
+
+    ISA 別の翻訳単位 (VT2WKernelSSE2.cpp など) から、ターゲット属性を
+    有効にした状態でインクルードされる。V は各翻訳単位が自分の名前空間で
+    定義するベクタ型ラッパー:
+
+      V::F / V::M           ベクタ / マスク型
+      V::width              レーン数
+      load, store, set1, add, sub, mul, div, min, max, abs, lt,
+      mulAdd(a, b, c)       a * b + c (FMA のある ISA は 1 回の丸め)
+      select(m, a, b)       m ? a : b
+      copySign(mag, sgn)
+      round(x)              最近接整数 (float のまま)
+      pow2(n)               2^n (n は整数値の float)
+
+    積和はすべて mulAdd で明示する (CMakeLists.txt で暗黙の FMA の縮約を
+    切っているので、式のままの add(mul) は常に 2 回丸める)。決定的モード用の
+    テーブルは mulAdd を add(mul) にした V で実体化するので、どの ISA・
+    レーン数でも同じ演算列になり、出力がビット単位で一致する。
+
+    ODR 違反で別 ISA のコードが混ざらないよう、このヘッダーでは標準
+    ライブラリや非テンプレートの inline 関数 (VT2WDriveCoefficients::
+    fromDrive など) を呼ばない (テンプレート実体は V の名前空間ごとに
+    別シンボル)。
+  ==============================================================================
+*/
+
+#ifndef VT2W_KERNEL_IMPL_H_INCLUDED
+#define VT2W_KERNEL_IMPL_H_INCLUDED
+
+#include "VT2WCoefficients.h"
+#include "VT2WConstants.h"
+#include "VT2WKernels.h"
+
+namespace VT2WKernelImpl {
+
+//==============================================================================
+/** exp(x)  (x は [-18, 0] を想定。Cephes expf と同じ多項式) */
+template <typename V> inline typename V::F fastExp(typename V::F x) {
+  using F = typename V::F;
+
+  F fx = V::round(V::mul(x, V::set1(1.44269504088896341f)));
+  F r = V::sub(x, V::mul(fx, V::set1(0.693359375f)));
+  r = V::sub(r, V::mul(fx, V::set1(-2.12194440e-4f)));
+
+  F y = V::set1(1.9875691500e-4f);
+  y = V::mulAdd(y, r, V::set1(1.3981999507e-3f));
+  y = V::mulAdd(y, r, V::set1(8.3334519073e-3f));
+  y = V::mulAdd(y, r, V::set1(4.1665795894e-2f));
+  y = V::mulAdd(y, r, V::set1(1.6666665459e-1f));
+  y = V::mulAdd(y, r, V::set1(5.0000001201e-1f));
+  y = V::add(V::mulAdd(V::mul(y, r), r, r), V::set1(1.0f));
+
+  return V::mul(y, V::pow2(fx));
+}
+
+//==============================================================================
+// tanh 近似 (品質毎のポリシー)
+
+/**
+ * Eco: sign(x) * (1 - e) / (1 + e),  e = 2^(-2|x| log2(e))
+ *
+ * 2^y を整数部 (指数ビット) と小数部の 3 次多項式 (p(0) = 1, p(1) = 2 で
+ * 連続) に分けて求める。係数が全て正なので各演算が単調になり、近似全体が
+ * 構成上単調になる (最大誤差 ~7e-5)。
+ */
+struct TanhEco {
+  template <typename V> static typename V::F apply(typename V::F x) {
+    using F = typename V::F;
+
+    const F one = V::set1(1.0f);
+    F ax = V::min(V::abs(x), V::set1(9.0f));
+    F y = V::mul(ax, V::set1(-2.0f * 1.44269504088896341f));
+
+    // n = floor(y)
+    F n = V::round(y);
+    n = V::select(V::lt(y, n), V::sub(n, one), n);
+    F f = V::sub(y, n);
+
+    F p = V::mulAdd(f, V::set1(0.08003759667470525f),
+                    V::set1(0.22389676116148757f));
+    p = V::mulAdd(p, f, V::set1(0.6960656421638072f));
+    p = V::mulAdd(p, f, one);
+
+    F e = V::mul(p, V::pow2(n));
+    F t = V::div(V::sub(one, e), V::add(one, e));
+    return V::copySign(t, x);
+  }
+};
+
+/** Standard: sign(x) * (1 - e) / (1 + e),  e = exp(-2|x|) (最大誤差 ~2e-7) */
+struct TanhStandard {
+  template <typename V> static typename V::F apply(typename V::F x) {
+    using F = typename V::F;
+
+    const F one = V::set1(1.0f);
+    F ax = V::min(V::abs(x), V::set1(9.0f));
+    F e = fastExp<V>(V::mul(ax, V::set1(-2.0f)));
+    F t = V::div(V::sub(one, e), V::add(one, e));
+    return V::copySign(t, x);
+  }
+};
+
+//==============================================================================
+/** Drive 由来の係数のベクタ版 (VT2WDriveCoefficients::fromDrive と同じ式) */
+template <typename V> struct DriveVec {
+  using F = typename V::F;
+
+  F preGain, cubic, limit, inverseLimit, harmonic2, harmonic3, transientGain,
+      makeupGain;
+
+  /** サンプル毎に変化する Drive (スムージング中) */
+  static DriveVec fromDrive(F drive) {
+    const F one = V::set1(1.0f);
+    F normalizedDrive = V::div(drive, V::set1(VT2WConstants::kDriveMax));
+
+    DriveVec d;
+    d.preGain = V::add(one, normalizedDrive);
+    d.cubic = V::mul(V::set1(0.12f), normalizedDrive);
+    d.limit = V::add(one, V::mul(V::set1(0.1f), normalizedDrive));
+    d.inverseLimit = V::div(one, d.limit);
+    d.harmonic2 =
+        V::mul(V::set1(VT2WConstants::kHarmonic2ndAmount), normalizedDrive);
+    d.harmonic3 =
+        V::mul(V::set1(VT2WConstants::kHarmonic3rdAmount), normalizedDrive);
+    d.transientGain =
+        V::mul(V::mul(V::set1(VT2WConstants::kTransientAmountMax),
+                      normalizedDrive),
+               V::set1(2.0f));
+    d.makeupGain = V::div(
+        one, V::add(one, V::mul(normalizedDrive, V::set1(0.5f))));
+    return d;
+  }
+
+  /** ブロック内で一定の Drive (キャッシュ済み係数をブロードキャスト) */
+  static DriveVec broadcast(const VT2WDriveCoefficients &c) {
+    DriveVec d;
+    d.preGain = V::set1(c.preGain);
+    d.cubic = V::set1(c.cubic);
+    d.limit = V::set1(c.limit);
+    d.inverseLimit = V::set1(c.inverseLimit);
+    d.harmonic2 = V::set1(c.harmonic2);
+    d.harmonic3 = V::set1(c.harmonic3);
+    d.transientGain = V::set1(c.transientGain);
+    d.makeupGain = V::set1(c.makeupGain);
+    return d;
+  }
+};
+
+//==============================================================================
+/** サチュレーション + 倍音付加 (VT2WWhiteSaturation / VT2WWhiteHarmonics と
+ * 同じ式) */
+template <typename V, typename Tanh>
+inline typename V::F shapeSample(typename V::F dry, const DriveVec<V> &d) {
+  using F = typename V::F;
+
+  // クリーンブースト
+  F input = V::mul(dry, d.preGain);
+  F absInput = V::abs(input);
+  F input3 = V::mul(V::mul(input, input), input);
+
+  // S字カーブ + tanh リミッティング
+  F out = V::sub(input, V::mul(d.cubic, input3));
+  F saturated =
+      V::mul(Tanh::template apply<V>(V::mul(out, d.limit)), d.inverseLimit);
+  saturated = V::select(V::lt(absInput, V::set1(0.0001f)), input, saturated);
+
+  // 2次・3次倍音
+  F h2 = V::mul(V::mul(input, absInput), d.harmonic2);
+  F h3 = V::mul(input3, d.harmonic3);
+
+  return V::add(saturated, V::sub(h2, h3));
+}
+
+/** トランジェント強調 + ゲイン補償 + Dry/Wet ミックス */
+template <typename V>
+inline typename V::F mixSample(typename V::F dry, typename V::F wet,
+                               typename V::F envelope, const DriveVec<V> &d,
+                               typename V::F mix) {
+  using F = typename V::F;
+
+  const F one = V::set1(1.0f);
+
+  // エンベロープを超えた分 (アタック成分) だけブースト
+  F transient = V::max(V::sub(V::abs(wet), envelope), V::set1(0.0f));
+  wet = V::mulAdd(wet, V::mul(transient, d.transientGain), wet);
+
+  return V::mulAdd(V::mul(wet, d.makeupGain), mix,
+                   V::mul(dry, V::sub(one, mix)));
+}
+
+//==============================================================================
+// 端数処理: numSamples がベクタ幅の倍数でない時、残りをゼロ詰めした
+// 一時バッファ経由で 1 ベクタ分処理する
+
+template <typename V>
+inline typename V::F loadPartial(const float *source, int count) {
+  alignas(64) float tmp[V::width] = {};
+  for (int j = 0; j < count; ++j)
+    tmp[j] = source[j];
+  return V::load(tmp);
+}
+
+template <typename V>
+inline void storePartial(float *dest, typename V::F value, int count) {
+  alignas(64) float tmp[V::width];
+  V::store(tmp, value);
+  for (int j = 0; j < count; ++j)
+    dest[j] = tmp[j];
+}
+
+//==============================================================================
+// ADAA (1 次の逆導関数アンチエイリアシング)
+//
+// サチュレーション s(v) = tanh(L v) / L (v = u - c u^3) と倍音
+// h(u) = a u|u| - b u^3 を、前サンプルとの差分商 (F(x1) - F(x0)) / (x1 - x0)
+// に置き換える (F は逆導関数)。
+//
+//   s: F = ln cosh(L v) / L^2。y = L v とおくと
+//        Q = (ln cosh y1 - ln cosh y0) / (L (y1 - y0))
+//        ln cosh y = |y| + log1p(e^(-2|y|)) - ln 2 (ln 2 は差で消える)
+//      |y1 - y0| が小さいと桁落ちするので、中点の 2 次テイラー展開
+//        Q = (T - T (1 - T^2) (y1 - y0)^2 / 12) / L,  T = tanh((y0 + y1) / 2)
+//      に切り替える (閾値 kAdaaTaylorThreshold で両方の誤差が 1e-6 程度)
+//   h: 多項式なので差分商を因数分解した形で求め、割り算を使わない
+//        u^3     -> (u1 + u0)(u1^2 + u0^2) / 4
+//        u|u|    -> 同符号: sign (u1^2 + u1 u0 + u0^2) / 3
+//                   異符号: (u1^2 |u1| - u0^2 |u0|) / (3 (u1 - u0))
+//                           (|u1 - u0| >= max(|u0|, |u1|) なので安定)
+//
+// 3 次の前段 v(u) はそのまま (帯域は 3 倍までしか広がらない)。
+// 出力は入力より半サンプル遅れるので、Dry はエンジン側で 2 点平均して揃える。
+
+constexpr float kAdaaTaylorThreshold = 0.1f;
+
+/** log1p(w) (w は [0, 1])。2 atanh(w / (2 + w)) の級数で誤差 ~1e-9 */
+template <typename V> inline typename V::F log1pUnit(typename V::F w) {
+  using F = typename V::F;
+
+  F s = V::div(w, V::add(w, V::set1(2.0f)));
+  F z = V::mul(s, s);
+
+  F p = V::set1(1.0f / 17.0f);
+  p = V::mulAdd(p, z, V::set1(1.0f / 15.0f));
+  p = V::mulAdd(p, z, V::set1(1.0f / 13.0f));
+  p = V::mulAdd(p, z, V::set1(1.0f / 11.0f));
+  p = V::mulAdd(p, z, V::set1(1.0f / 9.0f));
+  p = V::mulAdd(p, z, V::set1(1.0f / 7.0f));
+  p = V::mulAdd(p, z, V::set1(1.0f / 5.0f));
+  p = V::mulAdd(p, z, V::set1(1.0f / 3.0f));
+  p = V::mulAdd(p, z, V::set1(1.0f));
+
+  return V::mul(V::add(s, s), p);
+}
+
+/** Drive がサンプル毎に変化する時の係数 */
+template <typename V> struct DriveRamp {
+  const float *drive;
+
+  DriveVec<V> at(int i) const {
+    return DriveVec<V>::fromDrive(V::load(drive + i));
+  }
+  DriveVec<V> atPartial(int i, int count) const {
+    return DriveVec<V>::fromDrive(loadPartial<V>(drive + i, count));
+  }
+};
+
+/** Drive がブロック内で一定の時の係数 */
+template <typename V> struct DriveConstant {
+  DriveVec<V> d;
+
+  DriveVec<V> at(int) const { return d; }
+  DriveVec<V> atPartial(int, int) const { return d; }
+};
+
+/** ADAA の 1 パス目: u, y, log1p(e^(-2|y|)) を求める */
+template <typename V>
+inline void adaaState(typename V::F dry, const DriveVec<V> &d,
+                      typename V::F &u, typename V::F &y, typename V::F &lg) {
+  u = V::mul(dry, d.preGain);
+  y = V::mul(V::sub(u, V::mul(d.cubic, V::mul(V::mul(u, u), u))), d.limit);
+  lg = log1pUnit<V>(fastExp<V>(
+      V::max(V::mul(V::abs(y), V::set1(-2.0f)), V::set1(-18.0f))));
+}
+
+/** ADAA の 2 パス目: 前サンプル (0) と現サンプル (1) の差分商 */
+template <typename V, typename Tanh>
+inline typename V::F adaaSample(typename V::F u0, typename V::F u1,
+                                typename V::F y0, typename V::F y1,
+                                typename V::F lg0, typename V::F lg1,
+                                const DriveVec<V> &d) {
+  using F = typename V::F;
+
+  const F zero = V::set1(0.0f);
+  const F one = V::set1(1.0f);
+  const F third = V::set1(1.0f / 3.0f);
+
+  // サチュレーション
+  F dy = V::sub(y1, y0);
+  F direct = V::div(V::add(V::sub(V::abs(y1), V::abs(y0)), V::sub(lg1, lg0)),
+                    dy);
+  F t = Tanh::template apply<V>(V::mul(V::add(y0, y1), V::set1(0.5f)));
+  F taylor = V::sub(t, V::mul(V::mul(t, V::sub(one, V::mul(t, t))),
+                              V::mul(V::mul(dy, dy), V::set1(1.0f / 12.0f))));
+  F saturated = V::mul(
+      V::select(V::lt(V::abs(dy), V::set1(kAdaaTaylorThreshold)), taylor,
+                direct),
+      d.inverseLimit);
+
+  // 3 次倍音
+  F h3 = V::mul(V::mul(V::add(u1, u0), V::add(V::mul(u1, u1), V::mul(u0, u0))),
+                V::set1(0.25f));
+
+  // 2 次倍音
+  F sameSign = V::copySign(
+      V::mul(V::add(V::add(V::mul(u1, u1), V::mul(u1, u0)), V::mul(u0, u0)),
+             third),
+      V::add(u0, u1));
+  F oppositeSign = V::div(
+      V::mul(V::sub(V::mul(V::mul(u1, u1), V::abs(u1)),
+                    V::mul(V::mul(u0, u0), V::abs(u0))),
+             third),
+      V::sub(u1, u0));
+  F h2 = V::select(V::lt(V::mul(u0, u1), zero), oppositeSign, sameSign);
+
+  return V::add(saturated,
+                V::sub(V::mul(h2, d.harmonic2), V::mul(h3, d.harmonic3)));
+}
+
+/**
+ * ADAA 版の shape。scratch に前サンプル込みの u / y / log1p 列を並べてから
+ * 1 サンプルずらして読み、差分商を求める。
+ */
+template <typename V, typename Tanh, typename Coefficients>
+void shapeBlockAdaa(const float *dry, float *wet, int numSamples,
+                    const Coefficients &coefficients, float *history,
+                    float *scratch) {
+  using F = typename V::F;
+  constexpr int W = V::width;
+
+  float *us = scratch;
+  float *ys = us + numSamples + 1;
+  float *lgs = ys + numSamples + 1;
+
+  us[0] = history[0];
+  ys[0] = history[1];
+  lgs[0] = history[2];
+
+  int i = 0;
+  for (; i + W <= numSamples; i += W) {
+    F u, y, lg;
+    adaaState<V>(V::load(dry + i), coefficients.at(i), u, y, lg);
+    V::store(us + i + 1, u);
+    V::store(ys + i + 1, y);
+    V::store(lgs + i + 1, lg);
+  }
+
+  if (const int remaining = numSamples - i; remaining > 0) {
+    F u, y, lg;
+    adaaState<V>(loadPartial<V>(dry + i, remaining),
+                 coefficients.atPartial(i, remaining), u, y, lg);
+    storePartial<V>(us + i + 1, u, remaining);
+    storePartial<V>(ys + i + 1, y, remaining);
+    storePartial<V>(lgs + i + 1, lg, remaining);
+  }
+
+  i = 0;
+  for (; i + W <= numSamples; i += W)
+    V::store(wet + i,
+             adaaSample<V, Tanh>(V::load(us + i), V::load(us + i + 1),
+                                 V::load(ys + i), V::load(ys + i + 1),
+                                 V::load(lgs + i), V::load(lgs + i + 1),
+                                 coefficients.at(i)));
+
+  if (const int remaining = numSamples - i; remaining > 0)
+    storePartial<V>(
+        wet + i,
+        adaaSample<V, Tanh>(loadPartial<V>(us + i, remaining),
+                            loadPartial<V>(us + i + 1, remaining),
+                            loadPartial<V>(ys + i, remaining),
+                            loadPartial<V>(ys + i + 1, remaining),
+                            loadPartial<V>(lgs + i, remaining),
+                            loadPartial<V>(lgs + i + 1, remaining),
+                            coefficients.atPartial(i, remaining)),
+        remaining);
+
+  history[0] = us[numSamples];
+  history[1] = ys[numSamples];
+  history[2] = lgs[numSamples];
+}
+
+//==============================================================================
+/** tanh 近似単体 */
+template <typename V, typename Tanh>
+void tanhBlock(const float *input, float *output, int numSamples) {
+  constexpr int W = V::width;
+  int i = 0;
+
+  for (; i + W <= numSamples; i += W)
+    V::store(output + i, Tanh::template apply<V>(V::load(input + i)));
+
+  if (const int remaining = numSamples - i; remaining > 0)
+    storePartial<V>(
+        output + i,
+        Tanh::template apply<V>(loadPartial<V>(input + i, remaining)),
+        remaining);
+}
+
+/** Drive がサンプル毎に変化するブロック */
+template <typename V, typename Tanh>
+void shapeBlock(const float *dry, float *wet, int numSamples,
+                const float *drive) {
+  constexpr int W = V::width;
+  int i = 0;
+
+  for (; i + W <= numSamples; i += W)
+    V::store(wet + i, shapeSample<V, Tanh>(V::load(dry + i),
+                                     DriveVec<V>::fromDrive(
+                                         V::load(drive + i))));
+
+  if (const int remaining = numSamples - i; remaining > 0)
+    storePartial<V>(wet + i,
+                    shapeSample<V, Tanh>(loadPartial<V>(dry + i, remaining),
+                                   DriveVec<V>::fromDrive(
+                                       loadPartial<V>(drive + i, remaining))),
+                    remaining);
+}
+
+/** Drive がブロック内で一定 (スムージング無し) */
+template <typename V, typename Tanh>
+void shapeBlockConstant(const float *dry, float *wet, int numSamples,
+                        const VT2WDriveCoefficients &coefficients) {
+  constexpr int W = V::width;
+  const auto d = DriveVec<V>::broadcast(coefficients);
+  int i = 0;
+
+  for (; i + W <= numSamples; i += W)
+    V::store(wet + i, shapeSample<V, Tanh>(V::load(dry + i), d));
+
+  if (const int remaining = numSamples - i; remaining > 0)
+    storePartial<V>(wet + i,
+                    shapeSample<V, Tanh>(loadPartial<V>(dry + i, remaining), d),
+                    remaining);
+}
+
+template <typename V>
+void mixBlock(float *io, const float *wet, const float *envelope,
+              int numSamples, const float *drive, const float *mix) {
+  constexpr int W = V::width;
+  int i = 0;
+
+  for (; i + W <= numSamples; i += W)
+    V::store(io + i,
+             mixSample<V>(V::load(io + i), V::load(wet + i),
+                          V::load(envelope + i),
+                          DriveVec<V>::fromDrive(V::load(drive + i)),
+                          V::load(mix + i)));
+
+  if (const int remaining = numSamples - i; remaining > 0)
+    storePartial<V>(
+        io + i,
+        mixSample<V>(loadPartial<V>(io + i, remaining),
+                     loadPartial<V>(wet + i, remaining),
+                     loadPartial<V>(envelope + i, remaining),
+                     DriveVec<V>::fromDrive(
+                         loadPartial<V>(drive + i, remaining)),
+                     loadPartial<V>(mix + i, remaining)),
+        remaining);
+}
+
+template <typename V>
+void mixBlockConstant(float *io, const float *wet, const float *envelope,
+                      int numSamples,
+                      const VT2WDriveCoefficients &coefficients, float mix) {
+  using F = typename V::F;
+  constexpr int W = V::width;
+  const auto d = DriveVec<V>::broadcast(coefficients);
+  const F mixVec = V::set1(mix);
+  int i = 0;
+
+  for (; i + W <= numSamples; i += W)
+    V::store(io + i, mixSample<V>(V::load(io + i), V::load(wet + i),
+                                  V::load(envelope + i), d, mixVec));
+
+  if (const int remaining = numSamples - i; remaining > 0)
+    storePartial<V>(io + i,
+                    mixSample<V>(loadPartial<V>(io + i, remaining),
+                                 loadPartial<V>(wet + i, remaining),
+                                 loadPartial<V>(envelope + i, remaining), d,
+                                 mixVec),
+                    remaining);
+}
+
+//==============================================================================
+// エンベロープ追従 (時間方向の再帰)
+//
+// 1 チャンネルの再帰はベクタ化できないので、チャンネルをレーンに並べて
+// W チャンネル分を 1 本の依存チェーンで進める。入力はチャンネル毎に
+// サンプルが連続しているため、W x W のタイルに転置してから回す。
+
+/** wet / envelope はチャンネル c のサンプル i が [c * stride + i] */
+template <typename V>
+void followEnvelopeBlock(const float *wet, float *envelope, float *state,
+                         int numChannels, int stride, int numSamples,
+                         float attack, float release) {
+  using F = typename V::F;
+  constexpr int W = V::width;
+  const F attackVec = V::set1(attack);
+  const F releaseVec = V::set1(release);
+
+  // 余ったレーンは使わないが、非正規化数などで遅くならないよう 0 で始める
+  alignas(64) float tile[W * W] = {};
+
+  for (int first = 0; first < numChannels; first += W) {
+    const int lanes = numChannels - first < W ? numChannels - first : W;
+    const float *source = wet + first * stride;
+    float *destination = envelope + first * stride;
+    F env = loadPartial<V>(state + first, lanes);
+
+    for (int i = 0; i < numSamples; i += W) {
+      const int count = numSamples - i < W ? numSamples - i : W;
+
+      for (int c = 0; c < lanes; ++c)
+        for (int j = 0; j < count; ++j)
+          tile[j * W + c] = source[c * stride + i + j];
+
+      for (int j = 0; j < count; ++j) {
+        const F x = V::abs(V::load(tile + j * W));
+        const F coefficient = V::select(V::lt(env, x), attackVec, releaseVec);
+        env = V::mulAdd(coefficient, V::sub(x, env), env);
+        V::store(tile + j * W, env);
+      }
+
+      for (int c = 0; c < lanes; ++c)
+        for (int j = 0; j < count; ++j)
+          destination[c * stride + i + j] = tile[j * W + c];
+    }
+
+    storePartial<V>(state + first, env, lanes);
+  }
+}
+
+/**
+ * リンク: 全チャンネルの |wet| の最大値で 1 本のエンベロープを追従し、
+ * envelope[0..numSamples) に書く。最大値はサンプル方向のベクタで求める
+ */
+template <typename V>
+void followEnvelopeLinkedBlock(const float *wet, float *envelope,
+                               float *state, int numChannels, int stride,
+                               int numSamples, float attack, float release) {
+  using F = typename V::F;
+  constexpr int W = V::width;
+  int i = 0;
+
+  for (; i + W <= numSamples; i += W) {
+    F peak = V::abs(V::load(wet + i));
+    for (int c = 1; c < numChannels; ++c)
+      peak = V::max(peak, V::abs(V::load(wet + c * stride + i)));
+    V::store(envelope + i, peak);
+  }
+
+  if (const int remaining = numSamples - i; remaining > 0) {
+    F peak = V::abs(loadPartial<V>(wet + i, remaining));
+    for (int c = 1; c < numChannels; ++c)
+      peak = V::max(peak,
+                    V::abs(loadPartial<V>(wet + c * stride + i, remaining)));
+    storePartial<V>(envelope + i, peak, remaining);
+  }
+
+  float env = *state;
+  for (int j = 0; j < numSamples; ++j) {
+    const float x = envelope[j];
+    env += (x > env ? attack : release) * (x - env);
+    envelope[j] = env;
+  }
+
+  *state = env;
+}
+
+//==============================================================================
+// 関数テーブル
+
+/** shapeBlockAdaa の Drive がサンプル毎に変化する版 (ShapeAdaaFn) */
+template <typename V, typename Tanh>
+void shapeBlockAdaaRamp(const float *dry, float *wet, int numSamples,
+                        const float *drive, float *history, float *scratch) {
+  shapeBlockAdaa<V, Tanh>(dry, wet, numSamples, DriveRamp<V>{drive}, history,
+                          scratch);
+}
+
+/** shapeBlockAdaa の Drive 一定版 (ShapeAdaaConstantFn) */
+template <typename V, typename Tanh>
+void shapeBlockAdaaConstant(const float *dry, float *wet, int numSamples,
+                            const VT2WDriveCoefficients &coefficients,
+                            float *history, float *scratch) {
+  const DriveConstant<V> drive{DriveVec<V>::broadcast(coefficients)};
+  shapeBlockAdaa<V, Tanh>(dry, wet, numSamples, drive, history, scratch);
+}
+
+/** V で実体化したカーネルのテーブル (ターゲット属性の範囲内で呼ぶ) */
+template <typename V>
+constexpr VT2WKernelOps makeOps(VT2WKernelIsa isa, const char *name) {
+  return {isa,
+          name,
+          {shapeBlock<V, TanhEco>, shapeBlock<V, TanhStandard>},
+          {shapeBlockConstant<V, TanhEco>, shapeBlockConstant<V, TanhStandard>},
+          {tanhBlock<V, TanhEco>, tanhBlock<V, TanhStandard>},
+          {shapeBlockAdaaRamp<V, TanhEco>, shapeBlockAdaaRamp<V, TanhStandard>},
+          {shapeBlockAdaaConstant<V, TanhEco>,
+           shapeBlockAdaaConstant<V, TanhStandard>},
+          followEnvelopeBlock<V>,
+          followEnvelopeLinkedBlock<V>,
+          mixBlock<V>,
+          mixBlockConstant<V>};
+}
+
+} // namespace VT2WKernelImpl
+
+#endif // VT2W_KERNEL_IMPL_H_INCLUDED
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    NEON Kernel (AArch64, 4 lanes)
+  ==============================================================================
+*/
+
+#include "VT2WKernels.h"
+
+#if VT2W_ARCH_ARM64
+
+#include <arm_neon.h>
+
+namespace VT2WSimdNEON {
+
+struct V {
+  using F = float32x4_t;
+  using M = uint32x4_t;
+  static constexpr int width = 4;
+
+  static F load(const float *p) { return vld1q_f32(p); }
+  static void store(float *p, F a) { vst1q_f32(p, a); }
+  static F set1(float a) { return vdupq_n_f32(a); }
+  static F add(F a, F b) { return vaddq_f32(a, b); }
+  static F sub(F a, F b) { return vsubq_f32(a, b); }
+  static F mul(F a, F b) { return vmulq_f32(a, b); }
+  static F div(F a, F b) { return vdivq_f32(a, b); }
+  static F min(F a, F b) { return vminq_f32(a, b); }
+  static F max(F a, F b) { return vmaxq_f32(a, b); }
+  static F mulAdd(F a, F b, F c) { return vfmaq_f32(c, a, b); }
+  static F abs(F a) { return vabsq_f32(a); }
+  static M lt(F a, F b) { return vcltq_f32(a, b); }
+  static F select(M m, F a, F b) { return vbslq_f32(m, a, b); }
+  static F copySign(F mag, F sgn) {
+    return vbslq_f32(vdupq_n_u32(0x80000000u), sgn, mag);
+  }
+  static F round(F a) { return vrndnq_f32(a); }
+  static F pow2(F n) {
+    int32x4_t e = vaddq_s32(vcvtnq_s32_f32(n), vdupq_n_s32(127));
+    return vreinterpretq_f32_s32(vshlq_n_s32(e, 23));
+  }
+};
+
+/** 決定的モード用: 積和を FMA にせず、SSE2 や 1 レーンの移植版と同じ丸めにする
+ * (VT2WKernels::getDeterministicOps) */
+struct VExact : V {
+  static F mulAdd(F a, F b, F c) { return add(mul(a, b), c); }
+};
+
+} // namespace VT2WSimdNEON
+
+#include "VT2WKernelImpl.h"
+
+namespace VT2WSimdNEON {
+constexpr VT2WKernelOps ops =
+    VT2WKernelImpl::makeOps<V>(VT2WKernelIsa::NEON, "NEON");
+constexpr VT2WKernelOps deterministicOps =
+    VT2WKernelImpl::makeOps<VExact>(VT2WKernelIsa::NEON,
+                                    "NEON (deterministic)");
+} // namespace VT2WSimdNEON
+
+extern const VT2WKernelOps kVT2WKernelOpsNEON = VT2WSimdNEON::ops;
+extern const VT2WKernelOps kVT2WKernelOpsNEONDeterministic =
+    VT2WSimdNEON::deterministicOps;
+
+#endif // VT2W_ARCH_ARM64
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    SSE2 Kernel (4 lanes)
+  ==============================================================================
+*/
+
+#include "VT2WKernels.h"
+
+#if VT2W_ARCH_X86
+
+#include <emmintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))),                 \
+                             apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+namespace VT2WSimdSSE2 {
+
+struct V {
+  using F = __m128;
+  using M = __m128;
+  static constexpr int width = 4;
+
+  static F load(const float *p) { return _mm_loadu_ps(p); }
+  static void store(float *p, F a) { _mm_storeu_ps(p, a); }
+  static F set1(float a) { return _mm_set1_ps(a); }
+  static F add(F a, F b) { return _mm_add_ps(a, b); }
+  static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+  static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+  static F div(F a, F b) { return _mm_div_ps(a, b); }
+  static F min(F a, F b) { return _mm_min_ps(a, b); }
+  static F max(F a, F b) { return _mm_max_ps(a, b); }
+  // FMA が無いので 2 回丸める (決定的モードでもこのテーブルを使う)
+  static F mulAdd(F a, F b, F c) { return add(mul(a, b), c); }
+  static F abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+  static M lt(F a, F b) { return _mm_cmplt_ps(a, b); }
+  static F select(M m, F a, F b) {
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+  }
+  static F copySign(F mag, F sgn) {
+    const F signMask = _mm_set1_ps(-0.0f);
+    return _mm_or_ps(_mm_andnot_ps(signMask, mag), _mm_and_ps(signMask, sgn));
+  }
+  static F round(F a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+  static F pow2(F n) {
+    __m128i e = _mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127));
+    return _mm_castsi128_ps(_mm_slli_epi32(e, 23));
+  }
+};
+
+} // namespace VT2WSimdSSE2
+
+#include "VT2WKernelImpl.h"
+
+namespace VT2WSimdSSE2 {
+constexpr VT2WKernelOps ops =
+    VT2WKernelImpl::makeOps<V>(VT2WKernelIsa::SSE2, "SSE2");
+} // namespace VT2WSimdSSE2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+extern const VT2WKernelOps kVT2WKernelOpsSSE2 = VT2WSimdSSE2::ops;
+
+#endif // VT2W_ARCH_X86
@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Portable Scalar Kernel (1 lane)
+  ==============================================================================
+*/
+
+#include "VT2WKernels.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// SIMD カーネルと同じテンプレートを 1 レーンで実体化したもの。決定的モードで
+// SIMD が無い (または Scalar を指定した) 時に使い、SIMD の決定的テーブルと
+// ビット単位で同じ出力になる。どの CPU でもビルドできる。
+
+namespace VT2WSimdScalar {
+
+struct V {
+  using F = float;
+  using M = bool;
+  static constexpr int width = 1;
+
+  static F load(const float *p) { return *p; }
+  static void store(float *p, F a) { *p = a; }
+  static F set1(float a) { return a; }
+  static F add(F a, F b) { return a + b; }
+  static F sub(F a, F b) { return a - b; }
+  static F mul(F a, F b) { return a * b; }
+  static F div(F a, F b) { return a / b; }
+  // SSE の minps / maxps と同じく、比較が偽なら b を返す
+  static F min(F a, F b) { return a < b ? a : b; }
+  static F max(F a, F b) { return a > b ? a : b; }
+  static F mulAdd(F a, F b, F c) { return a * b + c; }
+  static F abs(F a) { return std::fabs(a); }
+  static M lt(F a, F b) { return a < b; }
+  static F select(M m, F a, F b) { return m ? a : b; }
+  static F copySign(F mag, F sgn) { return std::copysign(mag, sgn); }
+  static F round(F a) { return std::nearbyint(a); }
+  static F pow2(F n) {
+    const uint32_t bits = uint32_t((int32_t)std::nearbyint(n) + 127) << 23;
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+  }
+};
+
+} // namespace VT2WSimdScalar
+
+#include "VT2WKernelImpl.h"
+
+namespace VT2WSimdScalar {
+constexpr VT2WKernelOps ops = VT2WKernelImpl::makeOps<V>(
+    VT2WKernelIsa::Scalar, "Scalar (deterministic)");
+} // namespace VT2WSimdScalar
+
+extern const VT2WKernelOps kVT2WKernelOpsScalarDeterministic =
+    VT2WSimdScalar::ops;
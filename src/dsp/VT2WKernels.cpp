@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Runtime ISA Dispatch
+  ==============================================================================
+*/
+
+#include "VT2WKernels.h"
+
+#if VT2W_ARCH_X86 && defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+extern const VT2WKernelOps kVT2WKernelOpsScalarDeterministic;
+
+#if VT2W_ARCH_X86
+extern const VT2WKernelOps kVT2WKernelOpsSSE2;
+extern const VT2WKernelOps kVT2WKernelOpsAVX2;
+extern const VT2WKernelOps kVT2WKernelOpsAVX2Deterministic;
+extern const VT2WKernelOps kVT2WKernelOpsAVX512;
+extern const VT2WKernelOps kVT2WKernelOpsAVX512Deterministic;
+#endif
+
+#if VT2W_ARCH_ARM64
+extern const VT2WKernelOps kVT2WKernelOpsNEON;
+extern const VT2WKernelOps kVT2WKernelOpsNEONDeterministic;
+#endif
+
+namespace {
+
+//==============================================================================
+struct CpuFeatures {
+  bool sse2 = false;
+  bool avx2 = false;
+  bool fma = false;
+  bool avx512f = false;
+  bool neon = false;
+};
+
+CpuFeatures detectCpuFeatures() {
+  CpuFeatures features;
+
+#if VT2W_ARCH_X86
+#if defined(_MSC_VER)
+  int info[4] = {};
+  __cpuid(info, 0);
+  const int maxLeaf = info[0];
+
+  __cpuid(info, 1);
+  features.sse2 = (info[3] & (1 << 26)) != 0;
+  features.fma = (info[2] & (1 << 12)) != 0;
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const bool avx = (info[2] & (1 << 28)) != 0;
+
+  // OS が YMM / ZMM レジスタを保存するかを XCR0 で確認する
+  unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+  const bool osYmm = (xcr0 & 0x6) == 0x6;
+  const bool osZmm = (xcr0 & 0xe6) == 0xe6;
+
+  if (maxLeaf >= 7) {
+    __cpuidex(info, 7, 0);
+    features.avx2 = avx && osYmm && (info[1] & (1 << 5)) != 0;
+    features.avx512f = osZmm && (info[1] & (1 << 16)) != 0;
+  }
+  features.fma = features.fma && osYmm;
+#else
+  __builtin_cpu_init();
+  features.sse2 = __builtin_cpu_supports("sse2");
+  features.avx2 = __builtin_cpu_supports("avx2");
+  features.fma = __builtin_cpu_supports("fma");
+  features.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+#endif
+
+#if VT2W_ARCH_ARM64
+  // AArch64 では Advanced SIMD は必須
+  features.neon = true;
+#endif
+
+  return features;
+}
+
+const CpuFeatures &getCpuFeatures() {
+  static const CpuFeatures features = detectCpuFeatures();
+  return features;
+}
+
+} // namespace
+
+//==============================================================================
+namespace VT2WKernels {
+
+bool isSupported(VT2WKernelIsa isa) {
+  const auto &features = getCpuFeatures();
+  (void)features;
+
+  switch (isa) {
+  case VT2WKernelIsa::Scalar:
+    return true;
+#if VT2W_ARCH_X86
+  case VT2WKernelIsa::SSE2:
+    return features.sse2;
+  case VT2WKernelIsa::AVX2:
+    return features.avx2 && features.fma;
+  case VT2WKernelIsa::AVX512:
+    return features.avx512f;
+#endif
+#if VT2W_ARCH_ARM64
+  case VT2WKernelIsa::NEON:
+    return features.neon;
+#endif
+  default:
+    return false;
+  }
+}
+
+const VT2WKernelOps *getOps(VT2WKernelIsa isa) {
+  if (!isSupported(isa))
+    return nullptr;
+
+  switch (isa) {
+#if VT2W_ARCH_X86
+  case VT2WKernelIsa::SSE2:
+    return &kVT2WKernelOpsSSE2;
+  case VT2WKernelIsa::AVX2:
+    return &kVT2WKernelOpsAVX2;
+  case VT2WKernelIsa::AVX512:
+    return &kVT2WKernelOpsAVX512;
+#endif
+#if VT2W_ARCH_ARM64
+  case VT2WKernelIsa::NEON:
+    return &kVT2WKernelOpsNEON;
+#endif
+  default:
+    return nullptr;
+  }
+}
+
+const VT2WKernelOps *getBestAvailable() {
+  static const VT2WKernelOps *best = [] {
+    const VT2WKernelIsa preference[] = {VT2WKernelIsa::AVX512,
+                                        VT2WKernelIsa::AVX2,
+                                        VT2WKernelIsa::SSE2,
+                                        VT2WKernelIsa::NEON};
+    for (auto isa : preference)
+      if (auto *ops = getOps(isa))
+        return ops;
+    return static_cast<const VT2WKernelOps *>(nullptr);
+  }();
+  return best;
+}
+
+const VT2WKernelOps *getDeterministicOps(VT2WKernelIsa isa) {
+  if (!isSupported(isa))
+    return nullptr;
+
+  switch (isa) {
+  case VT2WKernelIsa::Scalar:
+    return &kVT2WKernelOpsScalarDeterministic;
+#if VT2W_ARCH_X86
+  case VT2WKernelIsa::SSE2:
+    return &kVT2WKernelOpsSSE2;
+  case VT2WKernelIsa::AVX2:
+    return &kVT2WKernelOpsAVX2Deterministic;
+  case VT2WKernelIsa::AVX512:
+    return &kVT2WKernelOpsAVX512Deterministic;
+#endif
+#if VT2W_ARCH_ARM64
+  case VT2WKernelIsa::NEON:
+    return &kVT2WKernelOpsNEONDeterministic;
+#endif
+  default:
+    return nullptr;
+  }
+}
+
+const char *getName(VT2WKernelIsa isa) {
+  switch (isa) {
+  case VT2WKernelIsa::Scalar:
+    return "Scalar";
+  case VT2WKernelIsa::SSE2:
+    return "SSE2";
+  case VT2WKernelIsa::AVX2:
+    return "AVX2";
+  case VT2WKernelIsa::AVX512:
+    return "AVX-512";
+  case VT2WKernelIsa::NEON:
+    return "NEON";
+  }
+  return "Unknown";
+}
+
+const char *getName(VT2WSaturationQuality quality) {
+  switch (quality) {
+  case VT2WSaturationQuality::Eco:
+    return "Eco";
+  case VT2WSaturationQuality::Standard:
+    return "Standard";
+  case VT2WSaturationQuality::Reference:
+    return "Reference";
+  }
+  return "Unknown";
+}
+
+} // namespace VT2WKernels
@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    SIMD Kernels / Runtime ISA Dispatch
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "VT2WCoefficients.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||            \
+    defined(_M_IX86)
+#define VT2W_ARCH_X86 1
+#else
+#define VT2W_ARCH_X86 0
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define VT2W_ARCH_ARM64 1
+#else
+#define VT2W_ARCH_ARM64 0
+#endif
+
+//==============================================================================
+/** カーネルの命令セット */
+enum class VT2WKernelIsa { Scalar, SSE2, AVX2, AVX512, NEON };
+
+/**
+ * サチュレーション (tanh) の品質
+ *
+ * Eco       2^x の 3 次多項式による近似。最大誤差 1e-4
+ * Standard  exp ベースの近似 (Cephes expf 多項式)。最大誤差 1e-6
+ * Reference std::tanh (スカラーのリファレンス経路、libm の誤差 ~1ulp。
+ *           決定的モードでは VT2WPortableMath::tanh)
+ *
+ * Eco / Standard はどちらも単調で、SIMD カーネルで処理する。
+ */
+enum class VT2WSaturationQuality { Eco, Standard, Reference };
+
+/** SIMD カーネルが近似で処理する品質の数 (Eco, Standard) */
+constexpr int kNumApproximateQualities = 2;
+
+/**
+ * ISA 別カーネルの関数テーブル
+ *
+ * 1 チャンネル分のサンプル列をまとめて処理する。drive / mix はサンプル毎の
+ * 値の配列 (スムージング済み)。エンベロープフォロワーは時間方向の再帰なので
+ * チャンネルをレーンに並べて処理し (followEnvelope)、その値を mix に渡す。
+ *
+ * shape / shapeConstant / tanh は品質 (Eco, Standard) 毎に用意する。
+ * Standard の出力とスカラー (リファレンス) 経路との差は振幅 ±4 以内の
+ * 入力で 1e-6 以下 (kSimdTolerance, EA_VT_2W_Bench --verify で確認できる)。
+ */
+struct VT2WKernelOps {
+  VT2WKernelIsa isa;
+  const char *name;
+
+  using ShapeFn = void (*)(const float *dry, float *wet, int numSamples,
+                           const float *drive);
+  using ShapeConstantFn = void (*)(const float *dry, float *wet,
+                                   int numSamples,
+                                   const VT2WDriveCoefficients &coefficients);
+  using TanhFn = void (*)(const float *input, float *output, int numSamples);
+  using ShapeAdaaFn = void (*)(const float *dry, float *wet, int numSamples,
+                               const float *drive, float *history,
+                               float *scratch);
+  using ShapeAdaaConstantFn =
+      void (*)(const float *dry, float *wet, int numSamples,
+               const VT2WDriveCoefficients &coefficients, float *history,
+               float *scratch);
+  using EnvelopeFn = void (*)(const float *wet, float *envelope, float *state,
+                              int numChannels, int stride, int numSamples,
+                              float attack, float release);
+
+  /** wet = saturation(dry * preGain) + harmonics(dry * preGain) */
+  ShapeFn shape[kNumApproximateQualities];
+
+  /** shape の Drive 一定版 (係数はキャッシュ済みのものを使う) */
+  ShapeConstantFn shapeConstant[kNumApproximateQualities];
+
+  /** tanh 近似単体 (誤差検証・解析用) */
+  TanhFn tanh[kNumApproximateQualities];
+
+  /**
+   * shape の ADAA (1 次の逆導関数アンチエイリアシング) 版
+   * 出力は半サンプル遅れる。history はチャンネル毎の前サンプルの状態
+   * (kAdaaHistorySize 個)、scratch は adaaScratchSize(numSamples) 個の作業領域。
+   */
+  ShapeAdaaFn shapeAdaa[kNumApproximateQualities];
+
+  /** shapeAdaa の Drive 一定版 */
+  ShapeAdaaConstantFn shapeAdaaConstant[kNumApproximateQualities];
+
+  /**
+   * |wet| のエンベロープ追従 (チャンネルをベクタのレーンに並べる)
+   * wet / envelope はチャンネル c のサンプル i が [c * stride + i] にある配列、
+   * state はチャンネル毎の現在値 (numChannels 個、連続)
+   */
+  EnvelopeFn followEnvelope;
+
+  /**
+   * followEnvelope のリンク版: 全チャンネルの |wet| の最大値で 1 本の
+   * エンベロープを追従して envelope の先頭チャンネルに書く (state は 1 個)
+   */
+  EnvelopeFn followEnvelopeLinked;
+
+  /**
+   * トランジェント強調 + ゲイン補償 + Dry/Wet ミックス
+   * envelope はエンジン側で求めたサンプル毎のエンベロープ値
+   */
+  void (*mix)(float *io, const float *wet, const float *envelope,
+              int numSamples, const float *drive, const float *mix);
+
+  /** mix の Drive / Mix 一定版 */
+  void (*mixConstant)(float *io, const float *wet, const float *envelope,
+                      int numSamples,
+                      const VT2WDriveCoefficients &coefficients, float mix);
+};
+
+namespace VT2WKernels {
+/** SIMD 経路 (Standard) とスカラー経路の許容誤差 (絶対値) */
+constexpr float kSimdTolerance = 1.0e-6f;
+
+/** tanh 近似の最大絶対誤差 (品質順: Eco, Standard, Reference) */
+constexpr float kTanhMaxError[] = {1.0e-4f, 1.0e-6f, 2.0e-7f};
+
+/** 誤差・単調性を保証する入力範囲 (±)。Drive 最大で入力 ±4 の時の引数を含む */
+constexpr float kTanhVerifiedRange = 8.0f;
+
+/** ADAA の SIMD 経路 (Standard) とスカラー経路 (double) の許容誤差 */
+constexpr float kAdaaTolerance = 1.0e-5f;
+
+/**
+ * ADAA の前サンプル状態 (チャンネル毎)
+ * [0] u = dry * preGain、[1] y = L (u - c u^3)、[2] log1p(exp(-2|y|))
+ */
+constexpr int kAdaaHistorySize = 3;
+
+/** ADAA カーネルの作業領域のサイズ (float 数) */
+constexpr int adaaScratchSize(int numSamples) {
+  return kAdaaHistorySize * (numSamples + 1);
+}
+
+/** 実行中の CPU で使えるか (Scalar は常に true) */
+bool isSupported(VT2WKernelIsa isa);
+
+/** ISA のカーネル。Scalar・非対応の場合は nullptr */
+const VT2WKernelOps *getOps(VT2WKernelIsa isa);
+
+/** CPU 機能から選んだ最速のカーネル (SIMD が無ければ nullptr) */
+const VT2WKernelOps *getBestAvailable();
+
+/**
+ * 決定的モード用のカーネル (VT2WWhiteEngine::setDeterministic)
+ * 積和を FMA にしないテーブルで、どの ISA でも出力がビット単位で一致する
+ * (SSE2 は通常のテーブルと同じ)。Scalar はテンプレートを 1 レーンで
+ * 実体化した移植版で、どの CPU でも使える。非対応の ISA なら nullptr。
+ */
+const VT2WKernelOps *getDeterministicOps(VT2WKernelIsa isa);
+
+const char *getName(VT2WKernelIsa isa);
+const char *getName(VT2WSaturationQuality quality);
+} // namespace VT2WKernels
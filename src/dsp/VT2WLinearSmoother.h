@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Linear Parameter Smoother
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+/**
+ * リニアスムーザー
+ *
+ * juce::SmoothedValue<float, ValueSmoothingTypes::Linear> と同じランプ長・
+ * 終点・初期値 (0) を持つ JUCE 非依存の実装。DSP コアをホスト無しで
+ * ビルドするために使う。
+ *
+ * 値は累積加算ではなく start + step * k で求めるため、getNextValue を
+ * 1 サンプルずつ呼んでも fillRamp でまとめて生成しても同じ値になる。
+ */
+class VT2WLinearSmoother {
+public:
+  VT2WLinearSmoother() = default;
+
+  void reset(double sampleRate, double rampLengthInSeconds) noexcept {
+    stepsToTarget = (int)std::floor(rampLengthInSeconds * sampleRate);
+    setCurrentAndTargetValue(target);
+  }
+
+  void setCurrentAndTargetValue(float newValue) noexcept {
+    target = currentValue = rampStart = newValue;
+    countdown = 0;
+  }
+
+  void setTargetValue(float newValue) noexcept {
+    if (newValue == target)
+      return;
+
+    if (stepsToTarget <= 0) {
+      setCurrentAndTargetValue(newValue);
+      return;
+    }
+
+    rampStart = currentValue;
+    target = newValue;
+    countdown = stepsToTarget;
+    step = (target - currentValue) / (float)countdown;
+  }
+
+  float getNextValue() noexcept {
+    if (!isSmoothing())
+      return target;
+
+    --countdown;
+
+    if (isSmoothing())
+      currentValue = rampStart + step * (float)(stepsToTarget - countdown);
+    else
+      currentValue = target;
+
+    return currentValue;
+  }
+
+  /**
+   * 次の numSamples 個の値を dest に書き出す (getNextValue の連続呼び出しと
+   * 同じ値)。ループはコンパイラが自動ベクタ化できる形にしてある。
+   */
+  void fillRamp(float *dest, int numSamples) noexcept {
+    const int numRamp = std::min(numSamples, countdown);
+
+    if (numRamp > 0) {
+      const int stepsDone = stepsToTarget - countdown;
+      const float start = rampStart;
+      const float increment = step;
+
+      for (int i = 0; i < numRamp; ++i)
+        dest[i] = start + increment * (float)(stepsDone + i + 1);
+
+      countdown -= numRamp;
+
+      if (isSmoothing())
+        currentValue = dest[numRamp - 1];
+      else
+        dest[numRamp - 1] = currentValue = target;
+    }
+
+    for (int i = std::max(numRamp, 0); i < numSamples; ++i)
+      dest[i] = target;
+  }
+
+  bool isSmoothing() const noexcept { return countdown > 0; }
+  int getRemainingSamples() const noexcept { return countdown; }
+  float getCurrentValue() const noexcept { return currentValue; }
+  float getTargetValue() const noexcept { return target; }
+
+private:
+  float currentValue = 0.0f;
+  float target = 0.0f;
+  float rampStart = 0.0f;
+  float step = 0.0f;
+  int countdown = 0;
+  int stepsToTarget = 0;
+};
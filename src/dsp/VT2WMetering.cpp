@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Metering Implementation
+  ==============================================================================
+*/
+
+#include "VT2WMetering.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VT2WMetering {
+
+namespace {
+
+template <typename Sample>
+void measureSamples(const Sample *const *channels, int numChannels,
+                    int numSamples, float &peak, float &rms) {
+  peak = 0.0f;
+  rms = 0.0f;
+  if (numChannels <= 0 || numSamples <= 0)
+    return;
+
+  Sample maxAbs = 0;
+  double sumSquares = 0.0;
+
+  for (int ch = 0; ch < numChannels; ++ch) {
+    const Sample *samples = channels[ch];
+    Sample channelSum = 0; // ブロック内はサンプル型で足し、チャンネル毎に double へ
+
+    for (int i = 0; i < numSamples; ++i) {
+      maxAbs = std::max(maxAbs, std::abs(samples[i]));
+      channelSum += samples[i] * samples[i];
+    }
+
+    sumSquares += channelSum;
+  }
+
+  peak = (float)maxAbs;
+  rms = (float)std::sqrt(sumSquares / ((double)numChannels * numSamples));
+}
+
+} // namespace
+
+void measure(const float *const *channels, int numChannels, int numSamples,
+             float &peak, float &rms) {
+  measureSamples(channels, numChannels, numSamples, peak, rms);
+}
+
+void measure(const double *const *channels, int numChannels, int numSamples,
+             float &peak, float &rms) {
+  measureSamples(channels, numChannels, numSamples, peak, rms);
+}
+
+} // namespace VT2WMetering
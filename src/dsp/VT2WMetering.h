@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Metering (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+//==============================================================================
+/**
+ * 1 ブロック分のメーターの値 (オーディオスレッドが作り、エディターが読む)
+ * レベルはリニア (1.0 = 0dBFS)。ピークと RMS は全チャンネルをまとめた値。
+ */
+struct VT2WMeterFrame {
+  float inputPeak = 0.0f;
+  float inputRms = 0.0f;
+  float outputPeak = 0.0f;
+  float outputRms = 0.0f;
+  float envelope = 0.0f;   // トランジェント段のエンベロープ
+  float makeupGain = 1.0f; // Wet に掛かるメイクアップゲイン
+  int numSamples = 0;
+};
+
+namespace VT2WMetering {
+/** 全チャンネルのピークと RMS (確保しない) */
+void measure(const float *const *channels, int numChannels, int numSamples,
+             float &peak, float &rms);
+void measure(const double *const *channels, int numChannels, int numSamples,
+             float &peak, float &rms);
+} // namespace VT2WMetering
+
+//==============================================================================
+/**
+ * 単一の書き手・単一の読み手の固定長 FIFO (wait-free)
+ *
+ * 書き手 (オーディオスレッド) は満杯なら捨てて false を返すだけで、
+ * ロック・確保・待機をしない。読み手は溜まった分を pop で取り出す。
+ * インデックスは 32bit で回り込むが、差だけを使うので問題ない。
+ */
+template <typename Item, int Capacity> class VT2WSpscFifo {
+public:
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+  /** 書き手のみ。満杯なら何もせず false */
+  bool push(const Item &item) {
+    const uint32_t write = writeIndex.load(std::memory_order_relaxed);
+    const uint32_t read = readIndex.load(std::memory_order_acquire);
+    if (write - read == (uint32_t)Capacity) {
+      dropped.store(dropped.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+      return false;
+    }
+
+    items[write & kMask] = item;
+    writeIndex.store(write + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** 読み手のみ。空なら false */
+  bool pop(Item &item) {
+    const uint32_t read = readIndex.load(std::memory_order_relaxed);
+    const uint32_t write = writeIndex.load(std::memory_order_acquire);
+    if (read == write)
+      return false;
+
+    item = items[read & kMask];
+    readIndex.store(read + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** 満杯で捨てた数 (どのスレッドからでも読める) */
+  uint32_t getNumDropped() const {
+    return dropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr uint32_t kMask = (uint32_t)Capacity - 1;
+
+  Item items[Capacity] = {};
+  alignas(64) std::atomic<uint32_t> writeIndex{0};
+  alignas(64) std::atomic<uint32_t> readIndex{0};
+  std::atomic<uint32_t> dropped{0}; // 書き手だけが増やす
+};
+
+/** プロセッサーからエディターへのメーター用 (30Hz の読み出しで約 1 秒分) */
+using VT2WMeterFifo = VT2WSpscFifo<VT2WMeterFrame, 256>;
@@ -0,0 +1,317 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Models / Stages (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "VT2WKernels.h"
+#include "VT2WPipeline.h"
+#include "VT2WPortableMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+/** キャラクター (同じエンジン・同じパラメータで切り替える) */
+enum class VT2WModel {
+  White, // VT-2W White: クリーン / Hi-Fi、輪郭を磨く
+  Black  // VT-2B Black: 密度を足してまとめる (DSP_DESIGN.md)
+};
+
+//==============================================================================
+// VT-2W White のステージ
+
+/** クリーンブースト (Drive マックスでも +6dB 程度に抑える) */
+struct VT2WWhitePreGain : VT2WSampleStage<VT2WWhitePreGain> {
+  template <typename Sample, typename Context>
+  static Sample processSample(Sample input, int, const Context &context) {
+    return input * context.drive.preGain;
+  }
+};
+
+/**
+ * クリーンサチュレーション
+ * ソリッドステート的な応答で、非常に歪み感の少ない飽和
+ */
+struct VT2WWhiteSaturation : VT2WSampleStage<VT2WWhiteSaturation> {
+  template <typename Sample, typename Context>
+  static Sample processSample(Sample input, int, const Context &context) {
+    if (std::abs(input) < 0.0001f)
+      return input;
+
+    // 質感（太さ）を出すためのS字カーブ
+    // k をもう少し積極的にし、高域の明瞭度を保つために cubic だけではなく
+    // tanh 的な挙動を少し混ぜる
+    Sample out = input - context.drive.cubic * (input * input * input);
+
+    // 安全のためのリミッティング（Hi-Fiさを損なわない程度）
+    return Context::Math::tanh(out * context.drive.limit) *
+           context.drive.inverseLimit;
+  }
+};
+
+/**
+ * 微小倍音付加
+ * デジタル的な冷たさを除去する程度の極小量
+ */
+struct VT2WWhiteHarmonics : VT2WSampleStage<VT2WWhiteHarmonics> {
+  template <typename Sample, typename Context>
+  static Sample processSample(Sample input, int, const Context &context) {
+    // 非対称な歪みによる2次倍音付加
+    // DCオフセットは極小量なので、ここでは簡略化しつつ効果を高める
+    Sample h2 = (input * std::abs(input)) * context.drive.harmonic2;
+    Sample h3 = (input * input * input) * context.drive.harmonic3;
+
+    return h2 - h3; // 2次（太さ）と3次（エッジ）の組み合わせ
+  }
+};
+
+/**
+ * ADAA 版のサチュレーション + 倍音 (double で計算するリファレンス)
+ * 出力は半サンプル遅れる (Dry はエンジンが揃える)
+ */
+struct VT2WWhiteShapeAdaa : VT2WSampleStage<VT2WWhiteShapeAdaa> {
+  template <typename Sample, typename Context>
+  static Sample processSample(Sample input, int ch, const Context &context) {
+    const auto &c = context.drive;
+    Sample *history =
+        context.adaaHistory + ch * VT2WKernels::kAdaaHistorySize;
+
+    // ln cosh y (桁あふれしない形)
+    auto logCosh = [](double y) {
+      const double absY = std::abs(y);
+      return absY + Context::Math::log1pExp(-2.0 * absY) -
+             0.69314718055994531;
+    };
+
+    const double u0 = history[0];
+    const double u1 = input;
+    const double y0 = history[1];
+    const double y1 = c.limit * (u1 - c.cubic * (u1 * u1 * u1));
+    const double dy = y1 - y0;
+
+    // tanh(L v) / L の差分商 (差が極小なら中点の値)
+    double saturated = std::abs(dy) < 1.0e-6
+                           ? Context::Math::tanh(0.5 * (y0 + y1))
+                           : (logCosh(y1) - logCosh(y0)) / dy;
+    saturated *= c.inverseLimit;
+
+    // 倍音 (u|u| と u^3 の差分商を割り算無しの形で)
+    const double h3 = (u1 + u0) * (u1 * u1 + u0 * u0) * 0.25;
+    const double h2 =
+        u0 * u1 < 0.0
+            ? (u1 * u1 * std::abs(u1) - u0 * u0 * std::abs(u0)) /
+                  (3.0 * (u1 - u0))
+            : std::copysign((u1 * u1 + u1 * u0 + u0 * u0) / 3.0, u0 + u1);
+
+    history[0] = input;
+    history[1] = (Sample)y1;
+    history[2] = (Sample)Context::Math::log1pExp(-2.0 * std::abs(y1));
+
+    return (Sample)(saturated + h2 * c.harmonic2 - h3 * c.harmonic3);
+  }
+};
+
+/**
+ * トランジェント保護
+ * ほぼそのまま保持し、輪郭だけを整える (アタックを少し強調する)。
+ * リンク時は全チャンネルの最大値で 1 本のエンベロープを追従する。
+ */
+struct VT2WWhiteTransient {
+  /** エンベロープ追従 1 サンプル分 (level は整流済みの値) */
+  static void follow(float level, float &envelope,
+                     const VT2WRateCoefficients &rate) {
+    if (level > envelope)
+      envelope = envelope + rate.attack * (level - envelope);
+    else
+      envelope = envelope + rate.release * (level - envelope);
+  }
+
+  /** 追従済みのエンベロープでアタックを強調する */
+  template <typename Sample, typename Coefficients>
+  static Sample emphasize(Sample input, float envelope,
+                          const Coefficients &coefficients) {
+    // エンベロープの変化率が高い（アタック）時に少しブースト
+    // 簡易実装として、入力とエンベロープの差分を加算
+    Sample transient = std::abs(input) - envelope;
+    if (transient > 0)
+      return input + input * (transient * coefficients.transientGain);
+
+    return input;
+  }
+
+  template <typename Sample, typename Context>
+  static void process(Sample *frame, const Context &context) {
+    if (context.linked) {
+      Sample peak = 0;
+      for (int ch = 0; ch < context.numChannels; ++ch)
+        peak = std::max(peak, std::abs(frame[ch]));
+
+      follow((float)peak, context.envelopes[0], context.rate);
+
+      for (int ch = 0; ch < context.numChannels; ++ch)
+        frame[ch] = emphasize(frame[ch], context.envelopes[0], context.drive);
+      return;
+    }
+
+    for (int ch = 0; ch < context.numChannels; ++ch) {
+      follow((float)std::abs(frame[ch]), context.envelopes[ch], context.rate);
+      frame[ch] = emphasize(frame[ch], context.envelopes[ch], context.drive);
+    }
+  }
+};
+
+//==============================================================================
+// VT-2B Black のステージ (DSP_DESIGN.md)
+
+/** 密度増加: テープ系の飽和 x / (1 + k|x|^n) */
+struct VT2WBlackDensity : VT2WSampleStage<VT2WBlackDensity> {
+  template <typename Sample, typename Context>
+  static Sample processSample(Sample input, int, const Context &context) {
+    const Sample magnitude = std::abs(input);
+    return input / (Sample(1) + context.drive.density *
+                                    Context::Math::pow(
+                                        magnitude,
+                                        (Sample)context.drive.shape));
+  }
+};
+
+/**
+ * 低次倍音 (2次・3次) を微量足す
+ * 2次は White と同じく DC を出さない x|x| の形
+ */
+struct VT2WBlackHarmonics : VT2WSampleStage<VT2WBlackHarmonics> {
+  template <typename Sample, typename Context>
+  static Sample processSample(Sample input, int, const Context &context) {
+    const Sample h2 = (input * std::abs(input)) * context.drive.harmonic2;
+    const Sample h3 = (input * input * input) * context.drive.harmonic3;
+    return input + h2 + h3;
+  }
+};
+
+/**
+ * トランジェント整形 (Transient Shaper Lite)
+ * ピークホールドのエンベロープが閾値を超えた分だけ、ピークを微細に丸める。
+ * リンク時は全チャンネルで同じ量を掛ける (像を崩さない)。
+ */
+struct VT2WBlackTransient {
+  template <typename Sample, typename Coefficients>
+  static Sample shape(Sample input, float envelope,
+                      const Coefficients &coefficients) {
+    const float over = (envelope - VT2WConstants::kBlackTransientThreshold) /
+                       VT2WConstants::kBlackTransientKnee;
+    const float t = std::clamp(over, 0.0f, 1.0f);
+    const float reduction = t * t * (3.0f - 2.0f * t); // smoothstep
+    return input * (1.0f - reduction * coefficients.transientAmount);
+  }
+
+  static void follow(float level, float &envelope,
+                     const VT2WRateCoefficients &rate) {
+    envelope = std::max(envelope * rate.peakRelease, level);
+  }
+
+  template <typename Sample, typename Context>
+  static void process(Sample *frame, const Context &context) {
+    if (context.linked) {
+      Sample peak = 0;
+      for (int ch = 0; ch < context.numChannels; ++ch)
+        peak = std::max(peak, std::abs(frame[ch]));
+
+      follow((float)peak, context.envelopes[0], context.rate);
+
+      for (int ch = 0; ch < context.numChannels; ++ch)
+        frame[ch] = shape(frame[ch], context.envelopes[0], context.drive);
+      return;
+    }
+
+    for (int ch = 0; ch < context.numChannels; ++ch) {
+      follow((float)std::abs(frame[ch]), context.envelopes[ch], context.rate);
+      frame[ch] = shape(frame[ch], context.envelopes[ch], context.drive);
+    }
+  }
+};
+
+/**
+ * 位相安定化: 1 次オールパス y[n] = a (x[n] - y[n-1]) + x[n-1]
+ * 折点は kBlackPhaseFrequency。全チャンネルに同じ係数を掛ける。
+ */
+struct VT2WBlackPhase : VT2WSampleStage<VT2WBlackPhase> {
+  template <typename Sample, typename Context>
+  static Sample processSample(Sample input, int ch, const Context &context) {
+    Sample *history = context.phaseHistory + 2 * ch;
+    const Sample output =
+        context.rate.phaseAllpass * (input - history[1]) + history[0];
+    history[0] = input;
+    history[1] = output;
+    return output;
+  }
+};
+
+//==============================================================================
+/**
+ * モデル = Drive 由来の係数の型 + ステージの並び
+ *
+ * Stages は通常の経路、AdaaStages は ADAA 有効時の経路 (ADAA に対応しない
+ * モデルは Stages と同じ)。Dry/Wet のミックスはエンジンのループが行う。
+ */
+struct VT2WWhiteModel {
+  using Coefficients = VT2WDriveCoefficients;
+  static constexpr bool kSupportsAdaa = true;
+
+  using Stages =
+      VT2WPipeline<VT2WWhitePreGain,
+                   VT2WParallel<VT2WWhiteSaturation, VT2WWhiteHarmonics>,
+                   VT2WWhiteTransient, VT2WMakeupGain>;
+  using AdaaStages = VT2WPipeline<VT2WWhitePreGain, VT2WWhiteShapeAdaa,
+                                  VT2WWhiteTransient, VT2WMakeupGain>;
+};
+
+/**
+ * 密度増加 -> 倍音 -> トランジェント整形 -> 位相安定化 -> メイクアップ
+ * (サチュレーション曲線に閉じた逆導関数が無いので ADAA には対応しない)
+ */
+struct VT2WBlackModel {
+  using Coefficients = VT2WBlackCoefficients;
+  static constexpr bool kSupportsAdaa = false;
+
+  using Stages = VT2WPipeline<VT2WBlackDensity, VT2WBlackHarmonics,
+                              VT2WBlackTransient, VT2WBlackPhase,
+                              VT2WMakeupGain>;
+  using AdaaStages = Stages;
+};
+
+//==============================================================================
+namespace VT2WModels {
+/** ADAA の設定が効くか (効かないモデルでは遅延も足さない) */
+inline bool supportsAdaa(VT2WModel model) {
+  return model == VT2WModel::White ? VT2WWhiteModel::kSupportsAdaa
+                                   : VT2WBlackModel::kSupportsAdaa;
+}
+
+/** 折点 frequency の 1 次オールパスの係数 (libm に依らない tan で求める) */
+inline double getAllpassCoefficient(double frequency, double sampleRate) {
+  const double t = VT2WPortableMath::tan(3.14159265358979323846 *
+                            std::min(frequency / sampleRate, 0.49));
+  return (t - 1.0) / (t + 1.0);
+}
+
+/**
+ * モデルの線形ステージが入力の後に鳴らす長さ (基本レートのサンプル数、
+ * -120dB まで)。オーバーサンプラーのテールに足してホストに報告する。
+ */
+inline int getTailSamples(VT2WModel model, double sampleRate) {
+  if (model != VT2WModel::Black || sampleRate <= 0.0)
+    return 0;
+
+  const double pole = std::abs(
+      getAllpassCoefficient(VT2WConstants::kBlackPhaseFrequency, sampleRate));
+  return (int)std::ceil(std::log(1.0e-6) / std::log(pole));
+}
+
+inline const char *getName(VT2WModel model) {
+  return model == VT2WModel::White ? "White" : "Black";
+}
+} // namespace VT2WModels
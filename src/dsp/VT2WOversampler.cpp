@@ -0,0 +1,692 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Polyphase Oversampler Implementation
+  ==============================================================================
+*/
+
+#include "VT2WOversampler.h"
+#include "VT2WKernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VT2W_OVERSAMPLER_SSE2 1
+#include <emmintrin.h>
+#elif VT2W_ARCH_ARM64
+#define VT2W_OVERSAMPLER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+//==============================================================================
+// 4 レーン演算
+// SSE2 / NEON はどちらもベースライン命令なのでディスパッチ不要。
+// SIMD の無い環境 (と NEON の double) は汎用の配列版
+template <typename Sample> struct ScalarLanes {
+  struct F {
+    Sample v[4];
+  };
+
+  static F load(const Sample *p) { return {{p[0], p[1], p[2], p[3]}}; }
+  static void store(Sample *p, F a) { std::copy(a.v, a.v + 4, p); }
+  static F zero() { return {{0, 0, 0, 0}}; }
+  static F add(F a, F b) {
+    return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2],
+             a.v[3] + b.v[3]}};
+  }
+  static F sub(F a, F b) {
+    return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2],
+             a.v[3] - b.v[3]}};
+  }
+  static F mul(F a, F b) {
+    return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2],
+             a.v[3] * b.v[3]}};
+  }
+  static F duplicate(Sample a, Sample b) { return {{a, a, b, b}}; }
+  static F loadPairs(const Sample *a, const Sample *b) {
+    return {{a[0], a[1], b[0], b[1]}};
+  }
+  static void storePairs(Sample *a, Sample *b, F x) {
+    a[0] = x.v[0];
+    a[1] = x.v[1];
+    b[0] = x.v[2];
+    b[1] = x.v[3];
+  }
+  static void sumPairs(F x, Sample &a, Sample &b) {
+    a = x.v[0] + x.v[1];
+    b = x.v[2] + x.v[3];
+  }
+  static Sample sum(F x) { return (x.v[0] + x.v[1]) + (x.v[2] + x.v[3]); }
+};
+
+template <typename Sample> struct Lanes : ScalarLanes<Sample> {};
+
+#if VT2W_OVERSAMPLER_SSE2
+template <> struct Lanes<float> {
+  using F = __m128;
+
+  static F load(const float *p) { return _mm_loadu_ps(p); }
+  static void store(float *p, F a) { _mm_storeu_ps(p, a); }
+  static F zero() { return _mm_setzero_ps(); }
+  static F add(F a, F b) { return _mm_add_ps(a, b); }
+  static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+  static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+
+  /** {a, a, b, b} */
+  static F duplicate(float a, float b) { return _mm_setr_ps(a, a, b, b); }
+
+  /** {a[0], a[1], b[0], b[1]} */
+  static F loadPairs(const float *a, const float *b) {
+    return _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)a),
+                        (const __m64 *)b);
+  }
+
+  static void storePairs(float *a, float *b, F x) {
+    _mm_storel_pi((__m64 *)a, x);
+    _mm_storeh_pi((__m64 *)b, x);
+  }
+
+  /** a = x[0] + x[1], b = x[2] + x[3] */
+  static void sumPairs(F x, float &a, float &b) {
+    const F sums = _mm_add_ps(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)));
+    a = _mm_cvtss_f32(sums);
+    b = _mm_cvtss_f32(_mm_movehl_ps(sums, sums));
+  }
+
+  static float sum(F x) {
+    const F pairs = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    return _mm_cvtss_f32(
+        _mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+  }
+};
+
+/** double は 2 レーンのレジスタ 2 本 (lo = レーン 0-1、hi = レーン 2-3) */
+template <> struct Lanes<double> {
+  struct F {
+    __m128d lo, hi;
+  };
+
+  static F load(const double *p) {
+    return {_mm_loadu_pd(p), _mm_loadu_pd(p + 2)};
+  }
+  static void store(double *p, F a) {
+    _mm_storeu_pd(p, a.lo);
+    _mm_storeu_pd(p + 2, a.hi);
+  }
+  static F zero() { return {_mm_setzero_pd(), _mm_setzero_pd()}; }
+  static F add(F a, F b) {
+    return {_mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi)};
+  }
+  static F sub(F a, F b) {
+    return {_mm_sub_pd(a.lo, b.lo), _mm_sub_pd(a.hi, b.hi)};
+  }
+  static F mul(F a, F b) {
+    return {_mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi)};
+  }
+  static F duplicate(double a, double b) {
+    return {_mm_set1_pd(a), _mm_set1_pd(b)};
+  }
+  static F loadPairs(const double *a, const double *b) {
+    return {_mm_loadu_pd(a), _mm_loadu_pd(b)};
+  }
+  static void storePairs(double *a, double *b, F x) {
+    _mm_storeu_pd(a, x.lo);
+    _mm_storeu_pd(b, x.hi);
+  }
+  static void sumPairs(F x, double &a, double &b) {
+    a = _mm_cvtsd_f64(_mm_add_sd(x.lo, _mm_unpackhi_pd(x.lo, x.lo)));
+    b = _mm_cvtsd_f64(_mm_add_sd(x.hi, _mm_unpackhi_pd(x.hi, x.hi)));
+  }
+  static double sum(F x) {
+    const __m128d pairs = _mm_add_pd(x.lo, x.hi);
+    return _mm_cvtsd_f64(_mm_add_sd(pairs, _mm_unpackhi_pd(pairs, pairs)));
+  }
+};
+#elif VT2W_OVERSAMPLER_NEON
+template <> struct Lanes<float> {
+  using F = float32x4_t;
+
+  static F load(const float *p) { return vld1q_f32(p); }
+  static void store(float *p, F a) { vst1q_f32(p, a); }
+  static F zero() { return vdupq_n_f32(0.0f); }
+  static F add(F a, F b) { return vaddq_f32(a, b); }
+  static F sub(F a, F b) { return vsubq_f32(a, b); }
+  static F mul(F a, F b) { return vmulq_f32(a, b); }
+
+  static F duplicate(float a, float b) {
+    return vcombine_f32(vdup_n_f32(a), vdup_n_f32(b));
+  }
+
+  static F loadPairs(const float *a, const float *b) {
+    return vcombine_f32(vld1_f32(a), vld1_f32(b));
+  }
+
+  static void storePairs(float *a, float *b, F x) {
+    vst1_f32(a, vget_low_f32(x));
+    vst1_f32(b, vget_high_f32(x));
+  }
+
+  static void sumPairs(F x, float &a, float &b) {
+    const float32x2_t sums = vpadd_f32(vget_low_f32(x), vget_high_f32(x));
+    a = vget_lane_f32(sums, 0);
+    b = vget_lane_f32(sums, 1);
+  }
+
+  static float sum(F x) { return vaddvq_f32(x); }
+};
+#endif
+
+//==============================================================================
+// ハーフバンド IIR 係数 (楕円フィルター由来のオールパス 2 系統分解)
+// 遷移帯域幅は各段の高い方のレートに対する比率
+//   初段: 10 係数 / 遷移 0.025  -> 44.1kHz で 19.8kHz まで平坦、阻止域 -108dB
+//   2 段: 6 係数 / 遷移 0.12    -> 阻止域 -112dB
+//   3 段: 4 係数 / 遷移 0.18    -> 阻止域 -94dB
+constexpr float kIirStage0[] = {
+    0.034332750865138241f, 0.1284817903576754f,  0.26047324617986217f,
+    0.4052449616132795f,   0.54318632289530233f, 0.66346705689875463f,
+    0.76304827446439349f,  0.84402429876285934f, 0.9112315917121574f,
+    0.97084985753904651f};
+
+constexpr float kIirStage1[] = {
+    0.034527243895164733f, 0.13163507855039655f, 0.27561532380260084f,
+    0.45007523683810918f,  0.64646161470281949f, 0.87042547098933665f};
+
+constexpr float kIirStage2[] = {0.053379036964928725f, 0.20558897612802121f,
+                                0.44371079776028416f, 0.77747763544575854f};
+
+// ハーフバンド FIR (カイザー窓) の半長と β
+// 半長 M は 2^段 の倍数にして、段ごとのレイテンシを整数サンプルにしている
+//   初段: M = 64, β = 9  -> 44.1kHz で 20kHz まで ±0.0003dB、阻止域 -90dB
+//   2 段: M = 12, β = 10 -> 阻止域 -97dB
+//   3 段: M = 8,  β = 9  -> 阻止域 -88dB
+struct FirSpec {
+  int halfLength;
+  double beta;
+};
+
+constexpr FirSpec kFirSpecs[] = {{64, 9.0}, {12, 10.0}, {8, 9.0}};
+
+// テール長の基準 (-120dB)
+constexpr double kTailThreshold = 1.0e-6;
+
+//==============================================================================
+/** 0 次第 1 種変形ベッセル関数 (カイザー窓用) */
+double besselI0(double x) {
+  double sum = 1.0;
+  double term = 1.0;
+
+  for (int k = 1; term > 1.0e-12 * sum; ++k) {
+    const double ratio = x / (2.0 * k);
+    term *= ratio * ratio;
+    sum += term;
+  }
+
+  return sum;
+}
+
+/** 1 次オールパス y = a (x - y[n-1]) + x[n-1] */
+template <typename Sample>
+inline Sample allpass(Sample coefficient, Sample input, Sample &x1,
+                      Sample &y1) {
+  const Sample output = coefficient * (input - y1) + x1;
+  x1 = input;
+  y1 = output;
+  return output;
+}
+
+/** タップ数は 4 の倍数 (64 / 12 / 8)。2 本のアキュムレーターで並列に積和する */
+template <typename Sample>
+inline Sample dotProduct(const Sample *taps, const Sample *window,
+                         int length) {
+  using Lanes = ::Lanes<Sample>;
+  typename Lanes::F sum0 = Lanes::zero();
+  typename Lanes::F sum1 = Lanes::zero();
+  int i = 0;
+
+  for (; i + 8 <= length; i += 8) {
+    sum0 = Lanes::add(sum0,
+                      Lanes::mul(Lanes::load(taps + i), Lanes::load(window + i)));
+    sum1 = Lanes::add(sum1, Lanes::mul(Lanes::load(taps + i + 4),
+                                       Lanes::load(window + i + 4)));
+  }
+
+  for (; i + 4 <= length; i += 4)
+    sum0 = Lanes::add(sum0,
+                      Lanes::mul(Lanes::load(taps + i), Lanes::load(window + i)));
+
+  return Lanes::sum(Lanes::add(sum0, sum1));
+}
+
+/**
+ * 4 レーンの 1 次オールパス縦続 (係数ペア NumPairs 段)
+ * 段数をテンプレート引数にしてループを展開し、状態をレジスタに載せる。
+ * オールパスは (a x + x[n-1]) - a y[n-1] の順に計算し、サンプル間の
+ * 依存チェーンを乗算 + 減算の 2 段に縮めている。
+ */
+template <int NumPairs, typename Sample, typename Load, typename Store>
+void runAllpassCascade(const float *pairCoefficients, bool swapPaths,
+                       Sample (*x1State)[4], Sample (*y1State)[4],
+                       int numSamples, Load load, Store store) {
+  using Lanes = ::Lanes<Sample>;
+  typename Lanes::F coefficients[NumPairs];
+  typename Lanes::F x1[NumPairs];
+  typename Lanes::F y1[NumPairs];
+
+  for (int p = 0; p < NumPairs; ++p) {
+    const Sample a0 = pairCoefficients[2 * p + (swapPaths ? 1 : 0)];
+    const Sample a1 = pairCoefficients[2 * p + (swapPaths ? 0 : 1)];
+    const Sample lanes[4] = {a0, a1, a0, a1};
+    coefficients[p] = Lanes::load(lanes);
+    x1[p] = Lanes::load(x1State[p]);
+    y1[p] = Lanes::load(y1State[p]);
+  }
+
+  for (int i = 0; i < numSamples; ++i) {
+    typename Lanes::F value = load(i);
+
+    for (int p = 0; p < NumPairs; ++p) {
+      const typename Lanes::F output =
+          Lanes::sub(Lanes::add(Lanes::mul(coefficients[p], value), x1[p]),
+                     Lanes::mul(coefficients[p], y1[p]));
+      x1[p] = value;
+      y1[p] = output;
+      value = output;
+    }
+
+    store(i, value);
+  }
+
+  for (int p = 0; p < NumPairs; ++p) {
+    Lanes::store(x1State[p], x1[p]);
+    Lanes::store(y1State[p], y1[p]);
+  }
+}
+
+/** 係数ペア数 (5 / 3 / 2) で展開済みの縦続を選ぶ */
+template <typename Sample, typename Load, typename Store>
+void runAllpassLanes(const float *pairCoefficients, int numPairs,
+                     bool swapPaths, Sample (*x1State)[4],
+                     Sample (*y1State)[4], int numSamples, Load load,
+                     Store store) {
+  switch (numPairs) {
+  case 5:
+    runAllpassCascade<5>(pairCoefficients, swapPaths, x1State, y1State,
+                         numSamples, load, store);
+    break;
+  case 3:
+    runAllpassCascade<3>(pairCoefficients, swapPaths, x1State, y1State,
+                         numSamples, load, store);
+    break;
+  default:
+    runAllpassCascade<2>(pairCoefficients, swapPaths, x1State, y1State,
+                         numSamples, load, store);
+    break;
+  }
+}
+
+/** 振幅が kTailThreshold を下回るまでのサンプル数 (極の絶対値から) */
+int decaySamples(double poleMagnitude) {
+  if (poleMagnitude <= 0.0)
+    return 1;
+
+  return (int)std::ceil(std::log(kTailThreshold) / std::log(poleMagnitude));
+}
+
+} // namespace
+
+//==============================================================================
+template <typename Sample>
+const typename VT2WOversamplerT<Sample>::IirDesign
+    VT2WOversamplerT<Sample>::iirDesigns[kMaxFactorLog2] = {
+        {kIirStage0, (int)(sizeof(kIirStage0) / sizeof(float))},
+        {kIirStage1, (int)(sizeof(kIirStage1) / sizeof(float))},
+        {kIirStage2, (int)(sizeof(kIirStage2) / sizeof(float))}};
+
+template <typename Sample> VT2WOversamplerT<Sample>::VT2WOversamplerT() {
+  // ハーフバンド FIR: h[M] = 0.5、中心から偶数離れたタップは 0。
+  // 0 でない奇数番目のタップだけを、アップサンプル時のゲイン 2 を掛けて持つ
+  for (int stage = 0; stage < kMaxFactorLog2; ++stage) {
+    auto &design = firDesigns[stage];
+    const auto &spec = kFirSpecs[stage];
+    const int halfLength = spec.halfLength;
+    const double pi = 3.14159265358979323846;
+    const double windowNorm = besselI0(spec.beta);
+
+    design.halfLength = halfLength;
+
+    for (int j = 0; j < halfLength; ++j) {
+      // タップ番号 2j+1 の中心からの距離 (奇数)
+      const int k = 2 * j + 1 - halfLength;
+      const double r = (double)k / (double)halfLength;
+      const double window =
+          besselI0(spec.beta * std::sqrt(std::max(0.0, 1.0 - r * r))) /
+          windowNorm;
+      // k が奇数なので sin(pi k / 2) はちょうど ±1 (libm の sin の丸めに
+      // 依らないよう符号だけで求める)
+      const double sign = ((k - 1) / 2) % 2 == 0 ? 1.0 : -1.0;
+      const double sinc = sign / (pi * k);
+
+      design.taps[j] = (Sample)(2.0 * sinc * window);
+    }
+  }
+
+  reset();
+}
+
+template <typename Sample>
+void VT2WOversamplerT<Sample>::prepare(int newMaximumBlockSize,
+                                       int newNumChannels) {
+  maximumBlockSize = std::max(newMaximumBlockSize, 1);
+  numChannels = std::max(newNumChannels, 1);
+
+  const int numPairs = (numChannels + 1) / 2;
+  iirUpStates.resize((size_t)numPairs * kMaxFactorLog2);
+  iirDownStates.resize((size_t)numPairs * kMaxFactorLog2);
+  firStates.resize((size_t)numChannels * kMaxFactorLog2);
+  fractionalDelayStates.resize((size_t)numChannels);
+  upPointers.assign((size_t)numChannels, nullptr);
+
+  for (int stage = 0; stage < kMaxFactorLog2; ++stage)
+    stageBuffers[stage].assign(
+        (size_t)numChannels * maximumBlockSize << (stage + 1), Sample(0));
+
+  updateLatency();
+  reset();
+}
+
+template <typename Sample>
+void VT2WOversamplerT<Sample>::reset() {
+  std::fill(iirUpStates.begin(), iirUpStates.end(), IirState{});
+  std::fill(iirDownStates.begin(), iirDownStates.end(), IirState{});
+  std::fill(firStates.begin(), firStates.end(), FirState{});
+  std::fill(fractionalDelayStates.begin(), fractionalDelayStates.end(),
+            FractionalDelayState{});
+}
+
+template <typename Sample>
+void VT2WOversamplerT<Sample>::setMode(int newFactorLog2,
+                                       VT2WOversamplingFilter newFilter) {
+  newFactorLog2 = std::clamp(newFactorLog2, 0, kMaxFactorLog2);
+
+  if (newFactorLog2 == factorLog2 && newFilter == filter)
+    return;
+
+  factorLog2 = newFactorLog2;
+  filter = newFilter;
+
+  updateLatency();
+  reset();
+}
+
+template <typename Sample>
+void VT2WOversamplerT<Sample>::setProcessingDelay(double internalSamples) {
+  if (internalSamples == processingDelay)
+    return;
+
+  processingDelay = internalSamples;
+
+  updateLatency();
+  reset();
+}
+
+template <typename Sample>
+void VT2WOversamplerT<Sample>::updateLatency() {
+  latencySamples = 0;
+  tailSamples = 0;
+  useFractionalDelay = false;
+  fractionalDelayCoefficient = 0;
+
+  if (factorLog2 == 0 && processingDelay == 0.0)
+    return;
+
+  if (factorLog2 > 0 && filter == VT2WOversamplingFilter::LinearPhaseFIR) {
+    // アップ・ダウンとも高い側のレートで M サンプル遅れる。
+    // 内部処理の遅延は 1/4 サンプル以下になるので直線位相を優先して足さない
+    for (int stage = 0; stage < factorLog2; ++stage)
+      latencySamples += firDesigns[stage].halfLength >> stage;
+
+    // 直線位相なのでプリリンギングとポストリンギングが対称
+    tailSamples = 2 * latencySamples;
+    return;
+  }
+
+  // IIR: 1 次オールパス (a + z^-2) / (1 + a z^-2) の DC 群遅延は
+  // 2 (1 - a) / (1 + a) (高い側のレート)。ハーフバンドの群遅延は
+  // 2 系統の平均 + 0.5 サンプル。ダウンサンプルは奇数側の位相で取り出すので
+  // 1 サンプル (高い側のレート) 早い
+  double latency = processingDelay / (double)getFactor();
+  int ringing = 0;
+
+  for (int stage = 0; stage < factorLog2; ++stage) {
+    const auto &design = iirDesigns[stage];
+    double pathDelay = 0.0;
+
+    for (int c = 0; c < design.numCoefficients; ++c) {
+      const double a = design.coefficients[c];
+      pathDelay += 2.0 * (1.0 - a) / (1.0 + a);
+    }
+
+    const double groupDelay = (pathDelay + 1.0) * 0.5;
+    latency += (2.0 * groupDelay - 1.0) / (double)(2 << stage);
+
+    // 一番遅い極 (最大係数) の減衰。アップとダウンの 2 回分
+    const double slowestPole = design.coefficients[design.numCoefficients - 1];
+    ringing += 2 * ((decaySamples(slowestPole) + (1 << stage) - 1) >> stage);
+  }
+
+  // 端数は Thiran オールパス (遅延 0.5〜1.5 で安定) で埋めて整数にする
+  latencySamples = (int)std::ceil(latency);
+  double fraction = (double)latencySamples - latency;
+
+  if (fraction < 0.5) {
+    ++latencySamples;
+    fraction += 1.0;
+  }
+
+  const double coefficient = (1.0 - fraction) / (1.0 + fraction);
+  fractionalDelayCoefficient = (Sample)coefficient;
+  useFractionalDelay = true;
+
+  tailSamples =
+      latencySamples + ringing + decaySamples(std::abs(coefficient));
+}
+
+//==============================================================================
+template <typename Sample>
+const Sample *VT2WOversamplerT<Sample>::push(DelayLine &line, Sample sample) {
+  line.position =
+      (line.position == 0 ? kMaxFirHalfLength : line.position) - 1;
+  line.data[line.position] = sample;
+  line.data[line.position + kMaxFirHalfLength] = sample;
+  return line.data + line.position;
+}
+
+template <typename Sample>
+Sample *const *VT2WOversamplerT<Sample>::processUp(const Sample *const *input,
+                                                   int numActive,
+                                                   int numSamples) {
+  numActive = std::min(numActive, numChannels);
+
+  for (int stage = 0; stage < factorLog2; ++stage) {
+    const int length = numSamples << stage;
+
+    if (filter == VT2WOversamplingFilter::PolyphaseIIR) {
+      // 2 チャンネルずつ。奇数個の最後は R に L を入れて結果を捨てる
+      for (int ch = 0; ch < numActive; ch += 2) {
+        const bool hasRight = ch + 1 < numActive;
+        const Sample *sourceL =
+            stage > 0 ? getStageBuffer(ch, stage - 1) : input[ch];
+        const Sample *sourceR =
+            !hasRight ? sourceL
+                      : (stage > 0 ? getStageBuffer(ch + 1, stage - 1)
+                                   : input[ch + 1]);
+
+        upsampleIir(iirUpStates[(size_t)(ch / 2) * kMaxFactorLog2 + stage],
+                    stage, sourceL, sourceR, getStageBuffer(ch, stage),
+                    hasRight ? getStageBuffer(ch + 1, stage) : nullptr,
+                    length);
+      }
+      continue;
+    }
+
+    for (int ch = 0; ch < numActive; ++ch)
+      upsampleFir(stage, firStates[(size_t)ch * kMaxFactorLog2 + stage],
+                  stage > 0 ? getStageBuffer(ch, stage - 1) : input[ch],
+                  getStageBuffer(ch, stage), length);
+  }
+
+  for (int ch = 0; ch < numActive; ++ch)
+    upPointers[ch] = factorLog2 > 0 ? getStageBuffer(ch, factorLog2 - 1)
+                                    : const_cast<Sample *>(input[ch]);
+
+  return upPointers.data();
+}
+
+template <typename Sample>
+void VT2WOversamplerT<Sample>::processDown(Sample *const *output,
+                                           int numActive, int numSamples) {
+  numActive = std::min(numActive, numChannels);
+
+  for (int stage = factorLog2 - 1; stage >= 0; --stage) {
+    const int length = numSamples << stage;
+
+    if (filter == VT2WOversamplingFilter::PolyphaseIIR) {
+      for (int ch = 0; ch < numActive; ch += 2) {
+        const bool hasRight = ch + 1 < numActive;
+        const Sample *sourceL = getStageBuffer(ch, stage);
+        const Sample *sourceR =
+            hasRight ? getStageBuffer(ch + 1, stage) : sourceL;
+        Sample *destinationL =
+            stage > 0 ? getStageBuffer(ch, stage - 1) : output[ch];
+        Sample *destinationR =
+            !hasRight ? nullptr
+                      : (stage > 0 ? getStageBuffer(ch + 1, stage - 1)
+                                   : output[ch + 1]);
+
+        downsampleIir(iirDownStates[(size_t)(ch / 2) * kMaxFactorLog2 + stage],
+                      stage, sourceL, sourceR, destinationL, destinationR,
+                      length);
+      }
+      continue;
+    }
+
+    for (int ch = 0; ch < numActive; ++ch)
+      downsampleFir(stage, firStates[(size_t)ch * kMaxFactorLog2 + stage],
+                    getStageBuffer(ch, stage),
+                    stage > 0 ? getStageBuffer(ch, stage - 1) : output[ch],
+                    length);
+  }
+
+  if (!useFractionalDelay)
+    return;
+
+  for (int ch = 0; ch < numActive; ++ch) {
+    auto &state = fractionalDelayStates[ch];
+    Sample x1 = state.x1;
+    Sample y1 = state.y1;
+    Sample *data = output[ch];
+
+    for (int i = 0; i < numSamples; ++i)
+      data[i] = allpass(fractionalDelayCoefficient, data[i], x1, y1);
+
+    state.x1 = x1;
+    state.y1 = y1;
+  }
+}
+
+//==============================================================================
+// numSamples はいずれも各段の低い側のレートでのサンプル数
+//
+// IIR は (係数ペア) x (L/R) の 4 レーンで回す。系統 0 と系統 1 は同じ
+// 段数なので、1 サンプルあたり numCoefficients / 2 回のベクタ演算で済む。
+
+template <typename Sample>
+void VT2WOversamplerT<Sample>::upsampleIir(IirState &state, int stage,
+                                           const Sample *inputL,
+                                           const Sample *inputR,
+                                           Sample *outputL, Sample *outputR,
+                                           int numSamples) {
+  using Lanes = ::Lanes<Sample>;
+  const auto &design = iirDesigns[stage];
+  Sample discard[2];
+
+  // レーン {L0, L1, R0, R1} = 系統 {0, 1, 0, 1}
+  // 系統 0 が偶数番目、系統 1 が奇数番目の出力
+  runAllpassLanes(
+      design.coefficients, design.numCoefficients / 2, false, state.x1,
+      state.y1, numSamples,
+      [&](int i) { return Lanes::duplicate(inputL[i], inputR[i]); },
+      [&](int i, typename Lanes::F value) {
+        Lanes::storePairs(outputL + 2 * i,
+                          outputR != nullptr ? outputR + 2 * i : discard,
+                          value);
+      });
+}
+
+template <typename Sample>
+void VT2WOversamplerT<Sample>::downsampleIir(IirState &state, int stage,
+                                             const Sample *inputL,
+                                             const Sample *inputR,
+                                             Sample *outputL, Sample *outputR,
+                                             int numSamples) {
+  using Lanes = ::Lanes<Sample>;
+  const auto &design = iirDesigns[stage];
+  Sample discard;
+
+  // 偶数番目の入力を系統 1、奇数番目を系統 0 に通す (奇数側の位相で間引く)
+  // ので、レーン {L0, L1, R0, R1} = 系統 {1, 0, 1, 0}
+  runAllpassLanes(
+      design.coefficients, design.numCoefficients / 2, true, state.x1,
+      state.y1, numSamples,
+      [&](int i) { return Lanes::loadPairs(inputL + 2 * i, inputR + 2 * i); },
+      [&](int i, typename Lanes::F value) {
+        Sample sumL, sumR;
+        Lanes::sumPairs(value, sumL, sumR);
+        outputL[i] = Sample(0.5) * sumL;
+        (outputR != nullptr ? outputR[i] : discard) = Sample(0.5) * sumR;
+      });
+}
+
+template <typename Sample>
+void VT2WOversamplerT<Sample>::upsampleFir(int stage, FirState &state,
+                                           const Sample *input, Sample *output,
+                                           int numSamples) const {
+  const auto &design = firDesigns[stage];
+  const int halfLength = design.halfLength;
+
+  // 偶数番目の出力は中心タップ (2 * 0.5) だけなので M/2 サンプル前の入力
+  for (int i = 0; i < numSamples; ++i) {
+    const Sample *window = push(state.up, input[i]);
+    output[2 * i] = window[halfLength / 2];
+    output[2 * i + 1] = dotProduct(design.taps, window, halfLength);
+  }
+}
+
+template <typename Sample>
+void VT2WOversamplerT<Sample>::downsampleFir(int stage, FirState &state,
+                                             const Sample *input,
+                                             Sample *output,
+                                             int numSamples) const {
+  const auto &design = firDesigns[stage];
+  const int halfLength = design.halfLength;
+
+  // y[n] = 0.5 * (v[2n - M] + Σ taps[j] v[2n - 2j - 1])
+  // 偶数・奇数サンプルを別の遅延線に分け、積和を連続アクセスにする
+  for (int i = 0; i < numSamples; ++i) {
+    const Sample *even = push(state.downEven, input[2 * i]);
+    const Sample *odd = state.downOdd.data + state.downOdd.position;
+
+    output[i] = Sample(0.5) * (even[halfLength / 2] +
+                               dotProduct(design.taps, odd, halfLength));
+
+    push(state.downOdd, input[2 * i + 1]);
+  }
+}
+
+//==============================================================================
+template class VT2WOversamplerT<float>;
+template class VT2WOversamplerT<double>;
@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Polyphase Oversampler (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//==============================================================================
+/** オーバーサンプリングのフィルター方式 */
+enum class VT2WOversamplingFilter {
+  PolyphaseIIR,  // オールパス 2 系統のハーフバンド IIR (低レイテンシ・低負荷)
+  LinearPhaseFIR // カイザー窓ハーフバンド FIR (直線位相)
+};
+
+//==============================================================================
+/**
+ * ポリフェーズ・ハーフバンド・オーバーサンプラー
+ *
+ * 2 倍のハーフバンド段を 1〜3 段重ねて 2x / 4x / 8x を作る。各段は
+ * ポリフェーズ分解してあり、低いレート側で係数を掛けるので無駄な
+ * ゼロ乗算が無い。2 段目以降は元の帯域から遷移帯を広く取れるため、
+ * 初段より短いフィルターで済ませている。
+ *
+ * バッファと状態は prepare で最大倍率 (8x) ・チャンネル数分を確保するので、
+ * setMode による倍率やフィルターの切り替えはオーディオスレッドから呼んでも
+ * 確保しない。IIR はチャンネルを 2 つずつ組にして 4 レーンで処理する。
+ *
+ * レイテンシは常に整数サンプルになるようにしてある (FIR は段ごとに
+ * 整数、IIR は低域の群遅延の端数を 1 次 Thiran オールパスで埋める)。
+ *
+ * Sample (float / double) はバッファと状態の型。係数の設計は共通なので
+ * レイテンシとテール長はどちらも同じになる。実体は .cpp で明示的に
+ * インスタンス化している。
+ */
+template <typename Sample> class VT2WOversamplerT {
+public:
+  //==============================================================================
+  static constexpr int kMaxFactorLog2 = 3;
+
+  VT2WOversamplerT();
+
+  /**
+   * 1 回の processUp / processDown で扱う最大サンプル数 (基本レート) と
+   * 最大チャンネル数
+   */
+  void prepare(int maximumBlockSize, int numChannels);
+  void reset();
+
+  /** 倍率 (2 の log2 で 0-3) とフィルター方式を切り替える。状態はリセットする */
+  void setMode(int factorLog2, VT2WOversamplingFilter filter);
+
+  int getFactorLog2() const { return factorLog2; }
+  int getFactor() const { return 1 << factorLog2; }
+  VT2WOversamplingFilter getFilter() const { return filter; }
+  int getMaximumBlockSize() const { return maximumBlockSize; }
+  int getNumChannels() const { return numChannels; }
+
+  /**
+   * 内部レートの処理自体が持つ遅延 (内部レートのサンプル数、ADAA の半サンプル
+   * など)。IIR / 1x ではこれも含めて整数サンプルに揃えて報告する。
+   */
+  void setProcessingDelay(double internalSamples);
+
+  /** processUp / processDown を通す必要があるか (倍率 > 1 か端数遅延がある) */
+  bool isActive() const { return factorLog2 > 0 || useFractionalDelay; }
+
+  /** アップ + ダウンで増える遅延 (基本レートのサンプル数) */
+  int getLatencySamples() const { return latencySamples; }
+
+  /** 入力が止まってからフィルターの応答が -120dB 以下になるまでのサンプル数 */
+  int getTailSamples() const { return tailSamples; }
+
+  //==============================================================================
+  /**
+   * input (numSamples <= maximumBlockSize、numChannels <= prepare した数)
+   * をアップサンプルし、numSamples * getFactor() サンプルの内部バッファを返す。
+   * 返したバッファはそのまま in-place で加工してよい。
+   */
+  Sample *const *processUp(const Sample *const *input, int numChannels,
+                           int numSamples);
+
+  /** processUp が返したバッファをダウンサンプルして output に書き出す */
+  void processDown(Sample *const *output, int numChannels, int numSamples);
+
+private:
+  //==============================================================================
+  static constexpr int kMaxIirCoefficients = 10;
+  static constexpr int kMaxFirHalfLength = 64;
+
+  /**
+   * ハーフバンド IIR 1 段分の係数 (偶数番目が系統 0、奇数番目が系統 1)
+   * 2 系統 x 2 チャンネルを 4 レーンで同時に回すため、係数の数は偶数
+   */
+  struct IirDesign {
+    const float *coefficients; // 設計値を float で持ち、両方の型で共有する
+    int numCoefficients;
+  };
+
+  /** ハーフバンド FIR 1 段分。0 でないタップ (奇数番目、2 倍済み) だけ持つ */
+  struct FirDesign {
+    int halfLength = 0;
+    alignas(16) Sample taps[kMaxFirHalfLength] = {};
+  };
+
+  /**
+   * 1 次オールパスの状態 (係数ペアごとに 4 レーン)
+   * レーンは L 系統 0, L 系統 1, R 系統 0, R 系統 1
+   */
+  struct IirState {
+    Sample x1[kMaxIirCoefficients / 2][4];
+    Sample y1[kMaxIirCoefficients / 2][4];
+  };
+
+  /** 連続読み出しできるように 2 重に書き込む遅延線 (window[0] が最新) */
+  struct DelayLine {
+    Sample data[2 * kMaxFirHalfLength];
+    int position;
+  };
+
+  struct FirState {
+    DelayLine up;
+    DelayLine downEven;
+    DelayLine downOdd;
+  };
+
+  struct FractionalDelayState {
+    Sample x1;
+    Sample y1;
+  };
+
+  void updateLatency();
+
+  /** 段 stage (2^(stage+1) 倍レート) のチャンネル ch のバッファ */
+  Sample *getStageBuffer(int ch, int stage) {
+    return stageBuffers[stage].data() +
+           ((std::size_t)ch * maximumBlockSize << (stage + 1));
+  }
+
+  /** 遅延線に 1 サンプル書き込み、最新サンプルから並んだ窓を返す */
+  static const Sample *push(DelayLine &line, Sample sample);
+
+  // IIR はチャンネル 2 つを同時に処理する
+  // (相方が無い時は inputR = inputL、outputR = null)
+  void upsampleIir(IirState &state, int stage, const Sample *inputL,
+                   const Sample *inputR, Sample *outputL, Sample *outputR,
+                   int numSamples);
+  void downsampleIir(IirState &state, int stage, const Sample *inputL,
+                     const Sample *inputR, Sample *outputL, Sample *outputR,
+                     int numSamples);
+  void upsampleFir(int stage, FirState &state, const Sample *input,
+                   Sample *output, int numSamples) const;
+  void downsampleFir(int stage, FirState &state, const Sample *input,
+                     Sample *output, int numSamples) const;
+
+  static const IirDesign iirDesigns[kMaxFactorLog2];
+  FirDesign firDesigns[kMaxFactorLog2];
+
+  //==============================================================================
+  int factorLog2 = 0;
+  VT2WOversamplingFilter filter = VT2WOversamplingFilter::PolyphaseIIR;
+  int maximumBlockSize = 0;
+  int numChannels = 0;
+  double processingDelay = 0.0;
+
+  int latencySamples = 0;
+  int tailSamples = 0;
+  Sample fractionalDelayCoefficient = 0;
+  bool useFractionalDelay = false;
+
+  // 状態はすべて prepare で確保する
+  // IIR はチャンネルの組 (0-1, 2-3, ...) x 段、FIR はチャンネル x 段の順
+  std::vector<IirState> iirUpStates;
+  std::vector<IirState> iirDownStates;
+  std::vector<FirState> firStates;
+  std::vector<FractionalDelayState> fractionalDelayStates;
+
+  // stageBuffers[s] は 2^(s+1) 倍レートのバッファ (チャンネル順に連続)
+  std::vector<Sample> stageBuffers[kMaxFactorLog2];
+  std::vector<Sample *> upPointers;
+};
+
+using VT2WOversampler = VT2WOversamplerT<float>;
+using VT2WOversamplerDouble = VT2WOversamplerT<double>;
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Stage Pipeline (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "VT2WCoefficients.h"
+
+//==============================================================================
+/**
+ * ステージに渡す 1 フレーム (全チャンネルの 1 サンプル) 分の値と状態
+ *
+ * 状態はエンジンが持ち (リセットやスリープをまとめて扱うため)、
+ * 各ステージは必要なものだけを使う。Coefficients はモデルの Drive 由来の係数、
+ * MathPolicy は超越関数の実装 (VT2WLibmMath / VT2WPortableMathPolicy)。
+ */
+template <typename Sample, typename Coefficients, typename MathPolicy>
+struct VT2WStageContext {
+  using Math = MathPolicy;
+
+  const Coefficients &drive;        // スムージング中は毎サンプル作り直す
+  const VT2WRateCoefficients &rate; // 内部レート由来
+  int numChannels;
+  bool linked;          // エンベロープを全チャンネルで 1 本にする
+  float *envelopes;     // チャンネル毎 (リンク時は先頭だけを使う)
+  Sample *adaaHistory;  // チャンネル毎に VT2WKernels::kAdaaHistorySize 個
+  Sample *phaseHistory; // チャンネル毎に 2 個 (x[n-1], y[n-1])
+};
+
+//==============================================================================
+/**
+ * ステージの並び (コンパイル時のリスト)
+ *
+ * ステージは static な process(Sample *frame, const Context &) を持つ型で、
+ * frame (チャンネル数分の Wet) をその場で書き換える。processFrame は
+ * 並びの順に展開されてインライン化されるので、エンジンのサンプルループ 1 本に
+ * 全ステージが融合し、仮想呼び出しもモデルによる分岐も無い。
+ */
+template <typename... Stages> struct VT2WPipeline {
+  template <typename Sample, typename Context>
+  static void processFrame(Sample *frame, const Context &context) {
+    (Stages::process(frame, context), ...);
+  }
+};
+
+/**
+ * チャンネル毎に独立なステージの基底 (CRTP)
+ * Stage::processSample(x, ch, context) を全チャンネルに掛ける。
+ */
+template <typename Stage> struct VT2WSampleStage {
+  template <typename Sample, typename Context>
+  static void process(Sample *frame, const Context &context) {
+    for (int ch = 0; ch < context.numChannels; ++ch)
+      frame[ch] = Stage::processSample(frame[ch], ch, context);
+  }
+};
+
+/** 同じ入力を各ステージに通して和を取る (チャンネル毎に独立なステージのみ) */
+template <typename... Stages>
+struct VT2WParallel : VT2WSampleStage<VT2WParallel<Stages...>> {
+  template <typename Sample, typename Context>
+  static Sample processSample(Sample input, int ch, const Context &context) {
+    return (Stages::processSample(input, ch, context) + ...);
+  }
+};
+
+/** モデル共通: Wet にメイクアップゲインを掛ける */
+struct VT2WMakeupGain : VT2WSampleStage<VT2WMakeupGain> {
+  template <typename Sample, typename Context>
+  static Sample processSample(Sample input, int, const Context &context) {
+    return input * context.drive.makeupGain;
+  }
+};
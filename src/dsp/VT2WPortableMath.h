@@ -0,0 +1,195 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Portable Math (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+
+//==============================================================================
+/**
+ * libm に依らない超越関数 (double)
+ *
+ * std::exp / std::tanh などの結果は libm の実装 (glibc の FMA 版の自動選択、
+ * MSVC の CRT、macOS の libm) で最後のビットが変わる。ここでは四則演算と、
+ * 結果が一意に決まる関数 (nearbyint / ldexp / frexp) だけで計算するので、
+ * FMA の縮約を切ったビルド (CMakeLists.txt) ならどの環境でも同じビットになる。
+ * 精度は double で数 ulp (float に丸めればほぼ正しく丸めた値)。
+ *
+ * 決定的モード (VT2WWhiteEngine::setDeterministic) のリファレンス経路と、
+ * prepare で求める係数 (エンベロープ・オールパス) に使う。
+ */
+namespace VT2WPortableMath {
+
+// ln 2 の上位 (下位 32bit が 0 なので n ln2Hi は丸めなし) と残り (fdlibm)
+constexpr double kLn2Hi = 6.93147180369123816490e-01;
+constexpr double kLn2Lo = 1.90821492927058770002e-10;
+constexpr double kInvLn2 = 1.44269504088896338700e+00;
+
+/** 1/k! (k = 0..kNumExpTerms-1)。定数畳み込みで求める */
+constexpr int kNumExpTerms = 14;
+
+struct ExpCoefficients {
+  double values[kNumExpTerms] = {};
+
+  constexpr ExpCoefficients() {
+    values[0] = 1.0;
+    for (int k = 1; k < kNumExpTerms; ++k)
+      values[k] = values[k - 1] / k;
+  }
+};
+
+constexpr ExpCoefficients kExpCoefficients;
+
+/** e^r - 1 (|r| <= ln2 / 2)。13 次のテイラー級数 */
+inline double expm1Reduced(double r) {
+  double p = kExpCoefficients.values[kNumExpTerms - 1];
+  for (int k = kNumExpTerms - 2; k >= 1; --k)
+    p = p * r + kExpCoefficients.values[k];
+  return p * r;
+}
+
+/** e^x (x = n ln2 + r に分け、2^n は ldexp で掛ける) */
+inline double exp(double x) {
+  if (x != x)
+    return x;
+  if (x < -746.0)
+    return 0.0;
+  if (x > 710.0)
+    return HUGE_VAL;
+
+  const double n = std::nearbyint(x * kInvLn2);
+  const double r = (x - n * kLn2Hi) - n * kLn2Lo;
+  return std::ldexp(1.0 + expm1Reduced(r), (int)n);
+}
+
+/** e^x - 1 (0 付近でも相対誤差を保つ) */
+inline double expm1(double x) {
+  if (std::abs(x) <= 0.5 * kLn2Hi)
+    return expm1Reduced(x);
+  return exp(x) - 1.0;
+}
+
+/** tanh(x) = sign(x) (-e / (2 + e)),  e = expm1(-2|x|) */
+inline double tanh(double x) {
+  const double a = std::abs(x);
+  if (a > 22.0)
+    return std::copysign(1.0, x);
+
+  const double e = expm1(-2.0 * a);
+  return std::copysign(-e / (2.0 + e), x);
+}
+
+/** 2 / (2k + 1) (k = 0..kNumAtanhTerms-1) */
+constexpr int kNumAtanhTerms = 20;
+
+struct AtanhCoefficients {
+  double values[kNumAtanhTerms] = {};
+
+  constexpr AtanhCoefficients() {
+    for (int k = 0; k < kNumAtanhTerms; ++k)
+      values[k] = 2.0 / (2 * k + 1);
+  }
+};
+
+constexpr AtanhCoefficients kAtanhCoefficients;
+
+/** 2 atanh(s) = 2 (s + s^3/3 + s^5/5 + ...) (|s| <= 1/3) */
+inline double atanhSeries2(double s) {
+  const double z = s * s;
+  double p = kAtanhCoefficients.values[kNumAtanhTerms - 1];
+  for (int k = kNumAtanhTerms - 2; k >= 0; --k)
+    p = p * z + kAtanhCoefficients.values[k];
+  return p * s;
+}
+
+/** log(1 + w) (w は [0, 1]) */
+inline double log1pUnit(double w) { return atanhSeries2(w / (2.0 + w)); }
+
+/** log(x) (x > 0 の有限値)。x = 2^e m (m は [sqrt(1/2), sqrt(2))) に分ける */
+inline double log(double x) {
+  int e = 0;
+  double m = std::frexp(x, &e);
+  if (m < 0.70710678118654752440) {
+    m *= 2.0;
+    --e;
+  }
+
+  const double logM = atanhSeries2((m - 1.0) / (m + 1.0));
+  return e * kLn2Hi + (e * kLn2Lo + logM);
+}
+
+/** x^y (x >= 0、y > 0。0^y = 0) */
+inline double pow(double x, double y) {
+  if (x == 0.0)
+    return 0.0;
+  return exp(y * log(x));
+}
+
+/** sin / cos の級数の係数 (-1)^k / (2k+1)! と (-1)^k / (2k)! */
+constexpr int kNumTrigTerms = 14;
+
+struct TrigCoefficients {
+  double sine[kNumTrigTerms] = {};
+  double cosine[kNumTrigTerms] = {};
+
+  constexpr TrigCoefficients() {
+    double inverseFactorial = 1.0; // 1/(2k)!
+    for (int k = 0; k < kNumTrigTerms; ++k) {
+      const double sign = k % 2 == 0 ? 1.0 : -1.0;
+      cosine[k] = sign * inverseFactorial;
+      sine[k] = sign * inverseFactorial / (2 * k + 1);
+      inverseFactorial /= (2.0 * k + 1.0) * (2.0 * k + 2.0);
+    }
+  }
+};
+
+constexpr TrigCoefficients kTrigCoefficients;
+
+/** tan(x) = sin(x) / cos(x) (|x| は ~1.54 まで。オールパスの設計用) */
+inline double tan(double x) {
+  const double z = x * x;
+  double sine = kTrigCoefficients.sine[kNumTrigTerms - 1];
+  double cosine = kTrigCoefficients.cosine[kNumTrigTerms - 1];
+
+  for (int k = kNumTrigTerms - 2; k >= 0; --k) {
+    sine = sine * z + kTrigCoefficients.sine[k];
+    cosine = cosine * z + kTrigCoefficients.cosine[k];
+  }
+
+  return x * sine / cosine;
+}
+
+} // namespace VT2WPortableMath
+
+//==============================================================================
+/**
+ * リファレンス経路 (VT2WModels.h のステージ) が使う超越関数
+ * VT2WStageContext::Math として渡し、ステージは Context::Math を呼ぶ。
+ */
+
+/** 通常: 標準ライブラリ (速く、環境毎に最後のビットが変わり得る) */
+struct VT2WLibmMath {
+  template <typename T> static T tanh(T x) { return std::tanh(x); }
+  template <typename T> static T pow(T x, T y) { return std::pow(x, y); }
+
+  /** log1p(exp(x)) (x <= 0) */
+  static double log1pExp(double x) { return std::log1p(std::exp(x)); }
+};
+
+/** 決定的モード: VT2WPortableMath (どの環境でも同じビット) */
+struct VT2WPortableMathPolicy {
+  template <typename T> static T tanh(T x) {
+    return (T)VT2WPortableMath::tanh((double)x);
+  }
+  template <typename T> static T pow(T x, T y) {
+    return (T)VT2WPortableMath::pow((double)x, (double)y);
+  }
+
+  static double log1pExp(double x) {
+    return VT2WPortableMath::log1pUnit(VT2WPortableMath::exp(x));
+  }
+};
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Preset Bank / A-B Snapshots Implementation
+  ==============================================================================
+*/
+
+#include "VT2WPresetBank.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace VT2WPresets {
+
+namespace {
+
+VT2WSettings makePreset(VT2WModel model, float drive, float mix) {
+  VT2WSettings settings;
+  settings.model = model;
+  settings.drive = drive;
+  settings.mix = mix;
+  return settings;
+}
+
+// README.md / DSP_DESIGN.md の用途別の目安 (Drive は 0-10 の単位)
+const VT2WPreset kFactoryPresets[] = {
+    {"Default", VT2WSettings{}},
+    {"White - Mastering", makePreset(VT2WModel::White, 1.5f, 30.0f)},
+    {"White - Vocal Bus", makePreset(VT2WModel::White, 4.0f, 60.0f)},
+    {"White - Drum Bus", makePreset(VT2WModel::White, 6.0f, 70.0f)},
+    {"White - Guitar DI", makePreset(VT2WModel::White, 5.0f, 80.0f)},
+    {"White - Piano", makePreset(VT2WModel::White, 2.5f, 50.0f)},
+    {"Black - Drum Bus", makePreset(VT2WModel::Black, 4.0f, 70.0f)},
+    {"Black - Stem Mix", makePreset(VT2WModel::Black, 2.5f, 50.0f)},
+    {"Black - Master", makePreset(VT2WModel::Black, 1.5f, 40.0f)},
+    {"Black - Vocal Bus", makePreset(VT2WModel::Black, 3.0f, 60.0f)},
+};
+
+} // namespace
+
+int getNumFactoryPresets() { return (int)std::size(kFactoryPresets); }
+
+const VT2WPreset &getFactoryPreset(int index) {
+  return kFactoryPresets[std::clamp(index, 0, getNumFactoryPresets() - 1)];
+}
+
+VT2WSettings interpolate(const VT2WSettings &a, const VT2WSettings &b,
+                         float position) {
+  if (!(position > 0.0f))
+    return a;
+  if (position >= 1.0f)
+    return b;
+
+  auto result = position < 0.5f ? a : b;
+  result.drive = a.drive + position * (b.drive - a.drive);
+  result.mix = a.mix + position * (b.mix - a.mix);
+  return result;
+}
+
+} // namespace VT2WPresets
+
+//==============================================================================
+VT2WSettings VT2WPresetBank::selectSlot(int slot, const VT2WSettings &current) {
+  slot = std::clamp(slot, 0, kNumSlots - 1);
+  slots[selectedSlot] = current;
+  selectedSlot = slot;
+  return slots[slot];
+}
+
+void VT2WPresetBank::copyToOther(const VT2WSettings &current) {
+  slots[1 - selectedSlot] = current;
+}
+
+VT2WSettings VT2WPresetBank::selectProgram(int index) {
+  program = std::clamp(index, 0, VT2WPresets::getNumFactoryPresets() - 1);
+  return VT2WPresets::getFactoryPreset(program).settings;
+}
+
+void VT2WPresetBank::restore(const VT2WSettings &other, int selected,
+                             int programIndex) {
+  selectedSlot = std::clamp(selected, 0, kNumSlots - 1);
+  slots[1 - selectedSlot] = other;
+  program =
+      std::clamp(programIndex, 0, VT2WPresets::getNumFactoryPresets() - 1);
+}
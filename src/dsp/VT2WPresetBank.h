@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Preset Bank / A-B Snapshots (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "VT2WSettings.h"
+
+#include <atomic>
+#include <cstdint>
+
+//==============================================================================
+/** ファクトリープリセット (README の用途別の目安) */
+struct VT2WPreset {
+  const char *name;
+  VT2WSettings settings;
+};
+
+namespace VT2WPresets {
+int getNumFactoryPresets();
+
+/** index は 0 から getNumFactoryPresets() - 1 (範囲外は丸める) */
+const VT2WPreset &getFactoryPreset(int index);
+
+/**
+ * a から b へ position (0-1) だけ寄せた設定
+ * Drive / Mix は直線で補間し、切り替えしかできない項目 (モデル・品質・
+ * オーバーサンプリングなど) は 0.5 で b に切り替える。
+ */
+VT2WSettings interpolate(const VT2WSettings &a, const VT2WSettings &b,
+                         float position);
+} // namespace VT2WPresets
+
+//==============================================================================
+/**
+ * 単一の書き手・単一の読み手のトリプルバッファ (wait-free)
+ *
+ * 書き手は空いているバッファに値を書き、中間のバッファとインデックスを
+ * 交換して公開する。読み手は新しい値がある時だけ中間と交換するので、
+ * 常に最後に公開された値を丸ごと読める (途中まで書かれた値は見えない)。
+ * どちらもロック・確保・待機をしない。
+ */
+template <typename T> class VT2WTripleBuffer {
+public:
+  static_assert(std::atomic<uint8_t>::is_always_lock_free,
+                "the exchange must be lock-free");
+
+  /** 書き手のみ */
+  void write(const T &value) {
+    buffers[backIndex] = value;
+    const uint8_t previous = middle.exchange(uint8_t(backIndex | kDirty),
+                                             std::memory_order_acq_rel);
+    backIndex = previous & kIndexMask;
+  }
+
+  /** 読み手のみ。最後に公開された値 (まだ無ければ T{}) */
+  const T &read() {
+    if (middle.load(std::memory_order_relaxed) & kDirty) {
+      const uint8_t previous =
+          middle.exchange(uint8_t(frontIndex), std::memory_order_acq_rel);
+      frontIndex = previous & kIndexMask;
+    }
+    return buffers[frontIndex];
+  }
+
+private:
+  static constexpr uint8_t kIndexMask = 3;
+  static constexpr uint8_t kDirty = 4; // 中間のバッファが未読
+
+  T buffers[3] = {};
+  int backIndex = 0;  // 書き手だけが使う
+  int frontIndex = 2; // 読み手だけが使う
+  alignas(64) std::atomic<uint8_t> middle{1};
+};
+
+//==============================================================================
+/**
+ * オーディオスレッドに渡すバンクの状態 (VT2WTripleBuffer で丸ごと公開する)
+ *
+ * recalling の間は、パラメータの代わりに target と morph を使う。
+ * プリセットの呼び出しはパラメータを 1 つずつ書き換えるので、途中の
+ * 組み合わせが 1 ブロックでも鳴らないようにしている。other はモーフィングの
+ * 相手 (選んでいない方のスロット)。
+ */
+struct VT2WBankSnapshot {
+  VT2WSettings target;
+  VT2WSettings other;
+  float morph = 0.0f; // recalling の間の Morph (0-100%)
+  bool recalling = false;
+};
+
+//==============================================================================
+/**
+ * A / B の 2 スロットとプログラム番号 (メッセージスレッド側の状態)
+ *
+ * 選んでいるスロットの値は常にホストのパラメータで、スロットに
+ * 残っているのは最後に離れた時の値。切り替えると今のパラメータを
+ * 元のスロットに残し、切り替え先の値を返す (呼び出し側がパラメータに
+ * 書き戻す)。Morph は今の値から他方のスロットへ寄せる量。
+ */
+class VT2WPresetBank {
+public:
+  static constexpr int kNumSlots = 2;
+
+  /** スロット slot に切り替え、呼び出す設定を返す */
+  VT2WSettings selectSlot(int slot, const VT2WSettings &current);
+
+  /** 今の値を他方のスロットに写す (A -> B / B -> A) */
+  void copyToOther(const VT2WSettings &current);
+
+  /** ファクトリープリセットを選び、呼び出す設定を返す */
+  VT2WSettings selectProgram(int index);
+
+  int getSelectedSlot() const { return selectedSlot; }
+  int getProgram() const { return program; }
+  const VT2WSettings &getOther() const { return slots[1 - selectedSlot]; }
+
+  /** 状態の復元 (other は選んでいない方のスロット) */
+  void restore(const VT2WSettings &other, int selected, int programIndex);
+
+private:
+  VT2WSettings slots[kNumSlots];
+  int selectedSlot = 0;
+  int program = 0;
+};
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Segment-Parallel Offline Renderer Implementation
+  ==============================================================================
+*/
+
+#include "VT2WSegmentRenderer.h"
+#include "VT2WWhiteEngine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/** メモリ上の入力 (区間の読み出しはコピーするだけ) */
+class MemorySource : public VT2WSegmentRenderer::Source {
+public:
+  MemorySource(const float *const *channels) : input(channels) {}
+
+  bool read(float *const *channels, int numChannels, int64_t position,
+            int numSamples) override {
+    for (int ch = 0; ch < numChannels; ++ch)
+      std::copy(input[ch] + position, input[ch] + position + numSamples,
+                channels[ch]);
+    return true;
+  }
+
+private:
+  const float *const *input;
+};
+
+} // namespace
+
+//==============================================================================
+VT2WSegmentRenderer::VT2WSegmentRenderer(const VT2WSettings &newSettings,
+                                         double newSampleRate,
+                                         int newNumChannels, int newBlockSize)
+    : settings(newSettings), sampleRate(newSampleRate),
+      numChannels(std::max(newNumChannels, 1)),
+      blockSize(std::max(newBlockSize, 1)) {
+  VT2WWhiteEngine engine;
+  engine.applySettings(settings);
+  engine.prepare(sampleRate, blockSize, numChannels);
+  latencySamples = engine.getLatencySamples();
+
+  // エンベロープの初期値の差が kWarmUpDecay 倍になるまで (内部レート)
+  const double internalRate = sampleRate * (1 << settings.oversamplingLog2);
+  const double release =
+      1.0 - std::exp(-1.0 / (internalRate * VT2WConstants::kEnvelopeRelease));
+  const double envelopeSamples =
+      std::log(kWarmUpDecay) / std::log(1.0 - release);
+
+  // エンベロープへの入力自体もフィルターの余韻が消えてから正しくなる
+  warmUpSamples = (int64_t)std::ceil(envelopeSamples * sampleRate /
+                                     internalRate) +
+                  engine.getTailLengthSamples() + latencySamples;
+}
+
+//==============================================================================
+bool VT2WSegmentRenderer::renderSegment(Source &source, int64_t totalLength,
+                                        int64_t start, int64_t length,
+                                        float *const *output) const {
+  // プラグイン・逐次レンダーと同じ順番: 設定 -> prepare
+  VT2WWhiteEngine engine;
+  engine.applySettings(settings);
+  engine.prepare(sampleRate, blockSize, numChannels);
+
+  // warm-up の間の出力と、レイテンシ分の出力は捨てる
+  const int64_t inputStart = std::max<int64_t>(0, start - warmUpSamples);
+  int64_t toSkip = start - inputStart + latencySamples;
+  int64_t position = inputStart;
+  int64_t written = 0;
+
+  std::vector<float> buffer((size_t)numChannels * blockSize);
+  std::vector<float *> channels(numChannels);
+  for (int ch = 0; ch < numChannels; ++ch)
+    channels[ch] = buffer.data() + (size_t)ch * blockSize;
+
+  while (written < length) {
+    const int numToRead =
+        (int)std::min<int64_t>(std::max<int64_t>(totalLength - position, 0),
+                               blockSize);
+
+    // 入力の終端より後ろは無音 (レイテンシ分の出力を押し出す)
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    if (numToRead > 0 &&
+        !source.read(channels.data(), numChannels, position, numToRead))
+      return false;
+    position += numToRead;
+
+    engine.process(channels.data(), numChannels, blockSize);
+
+    const int skip = (int)std::min<int64_t>(toSkip, blockSize);
+    toSkip -= skip;
+    const int numToWrite =
+        (int)std::min<int64_t>(blockSize - skip, length - written);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+      std::copy(channels[ch] + skip, channels[ch] + skip + numToWrite,
+                output[ch] + written);
+    written += numToWrite;
+  }
+
+  return true;
+}
+
+bool VT2WSegmentRenderer::render(const float *const *input,
+                                 float *const *output, int64_t numSamples,
+                                 int numThreads, int64_t segmentLength) const {
+  numThreads = std::max(numThreads, 1);
+
+  if (segmentLength <= 0)
+    segmentLength = std::max(getMinimumSegmentLength(),
+                             (numSamples + 4 * numThreads - 1) /
+                                 (4 * numThreads));
+
+  const int64_t numSegments =
+      std::max<int64_t>(1, (numSamples + segmentLength - 1) / segmentLength);
+  numThreads = (int)std::min<int64_t>(numThreads, numSegments);
+
+  // 空いたスレッドが次の区間を取る
+  std::atomic<int64_t> nextSegment{0};
+  std::atomic<bool> succeeded{true};
+
+  auto work = [&] {
+    MemorySource source(input);
+    std::vector<float *> destination(numChannels);
+
+    for (int64_t index = nextSegment++; index < numSegments;
+         index = nextSegment++) {
+      const int64_t start = index * segmentLength;
+      const int64_t length = std::min(segmentLength, numSamples - start);
+
+      for (int ch = 0; ch < numChannels; ++ch)
+        destination[ch] = output[ch] + start;
+
+      if (!renderSegment(source, numSamples, start, length,
+                         destination.data()))
+        succeeded = false;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < numThreads; ++i)
+    threads.emplace_back(work);
+  work();
+  for (auto &thread : threads)
+    thread.join();
+
+  return succeeded;
+}
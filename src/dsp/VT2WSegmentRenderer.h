@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Segment-Parallel Offline Renderer (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "VT2WSettings.h"
+
+#include <cstdint>
+
+//==============================================================================
+/**
+ * 1 本の長い音声を区間に分けて複数スレッドで処理するオフラインレンダラー
+ *
+ * 設定が一定ならスムージングは最初から目標値なので、前のサンプルに依存する
+ * 状態はエンベロープフォロワー・オーバーサンプラーのフィルター・ADAA の
+ * 前サンプルだけになる。各区間はその warm-up 分前の入力から新しいエンジンで
+ * 処理を始め、状態が逐次処理の値に収束してから出力を使う。
+ *
+ * エンベロープの更新 e' = e + c (level - e) は e について傾きが 1 - c 以下
+ * (c は attack / release の小さい方 = release) なので、初期値の差は
+ * N サンプルで (1 - c)^N 倍以下になる。warm-up はこれが kWarmUpDecay 以下に
+ * なる長さに、オーバーサンプラーの余韻 (-120dB) を足したもの。
+ * 逐次処理との差は kSegmentTolerance 以下 (EA_VT_2W_Bench --verify で確認)。
+ *
+ * 出力はレイテンシを補正済み (入力と同じ時刻・同じ長さ)。先頭の区間は
+ * 逐次処理とまったく同じ計算になる。
+ */
+class VT2WSegmentRenderer {
+public:
+  //==============================================================================
+  /** 区間の初期状態の差が warm-up の間に縮む割合 */
+  static constexpr double kWarmUpDecay = 1.0e-7;
+
+  /** 逐次処理に対する最大絶対誤差 (-100dBFS) */
+  static constexpr float kSegmentTolerance = 1.0e-5f;
+
+  /**
+   * 入力の読み出し元
+   * renderSegment を呼ぶスレッドごとに別のインスタンスを渡す。
+   */
+  class Source {
+  public:
+    virtual ~Source() = default;
+
+    /** position から numSamples 分を読む (範囲は常に入力の長さの内側) */
+    virtual bool read(float *const *channels, int numChannels,
+                      int64_t position, int numSamples) = 0;
+  };
+
+  VT2WSegmentRenderer(const VT2WSettings &settings, double sampleRate,
+                      int numChannels, int blockSize = 4096);
+
+  /** 区間の前に余分に処理するサンプル数 */
+  int64_t getWarmUpSamples() const { return warmUpSamples; }
+
+  /** warm-up の割合が 1/8 以下になる区間の長さ */
+  int64_t getMinimumSegmentLength() const { return 8 * warmUpSamples; }
+
+  int getLatencySamples() const { return latencySamples; }
+  int getNumChannels() const { return numChannels; }
+
+  /**
+   * 補正済み出力の [start, start + length) を output (length サンプル) に書き出す
+   * totalLength は入力全体の長さ (それ以降は無音として扱う)。
+   * 状態を持たないので、Source が別なら複数スレッドから同時に呼んでよい。
+   */
+  bool renderSegment(Source &source, int64_t totalLength, int64_t start,
+                     int64_t length, float *const *output) const;
+
+  /**
+   * メモリ上の入力全体を区間に分けて numThreads 本で処理する
+   * segmentLength が 0 ならスレッドあたり 4 区間程度 (最小長以上) に分ける。
+   * numThreads = 1、segmentLength >= numSamples なら逐次処理と同じ。
+   */
+  bool render(const float *const *input, float *const *output,
+              int64_t numSamples, int numThreads,
+              int64_t segmentLength = 0) const;
+
+private:
+  //==============================================================================
+  VT2WSettings settings;
+  double sampleRate;
+  int numChannels;
+  int blockSize;
+
+  int64_t warmUpSamples = 0;
+  int latencySamples = 0;
+};
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Engine Settings (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "VT2WConstants.h"
+#include "VT2WKernels.h"
+#include "VT2WModels.h"
+#include "VT2WOversampler.h"
+
+//==============================================================================
+/**
+ * プラグインのパラメータ一式 (ホストから見える単位のまま)
+ *
+ * プラグインとオフラインレンダラーはどちらもこの構造体を
+ * VT2WWhiteEngine::applySettings に渡す。パラメータからエンジンへの
+ * 変換を 1 か所にまとめ、同じ設定なら同じ出力になるようにしている。
+ * 既定値はパラメータレイアウトの既定値と同じ。
+ */
+struct VT2WSettings {
+  float drive = VT2WConstants::kDriveDefault; // 0-10
+  float mix = VT2WConstants::kMixDefault;     // 0-100 (%)
+  VT2WModel model = VT2WModel::White;
+  VT2WSaturationQuality quality = VT2WSaturationQuality::Standard;
+  int oversamplingLog2 = 1; // 0-3 = 1x / 2x / 4x / 8x
+  VT2WOversamplingFilter oversamplingFilter =
+      VT2WOversamplingFilter::PolyphaseIIR;
+  bool adaa = false;
+  bool link = false;
+  bool adaptive = false; // CPU 負荷で品質を自動で下げる (VT2WAdaptiveEngine)
+};
+
+inline bool operator==(const VT2WSettings &a, const VT2WSettings &b) {
+  return a.drive == b.drive && a.mix == b.mix && a.model == b.model &&
+         a.quality == b.quality && a.oversamplingLog2 == b.oversamplingLog2 &&
+         a.oversamplingFilter == b.oversamplingFilter && a.adaa == b.adaa &&
+         a.link == b.link && a.adaptive == b.adaptive;
+}
+
+inline bool operator!=(const VT2WSettings &a, const VT2WSettings &b) {
+  return !(a == b);
+}
@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Binary State Format Implementation
+  ==============================================================================
+*/
+
+#include "VT2WStateFormat.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace VT2WStateFormat {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = {'V', 'T', '2', 'S'};
+
+enum Flags : uint8_t { kFlagAdaa = 1, kFlagLink = 2, kFlagAdaptive = 4 };
+
+void writeU16(uint8_t *dest, uint16_t value) {
+  dest[0] = uint8_t(value);
+  dest[1] = uint8_t(value >> 8);
+}
+
+void writeU32(uint8_t *dest, uint32_t value) {
+  for (int i = 0; i < 4; ++i)
+    dest[i] = uint8_t(value >> (8 * i));
+}
+
+void writeFloat(uint8_t *dest, float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  writeU32(dest, bits);
+}
+
+uint16_t readU16(const uint8_t *source) {
+  return uint16_t(source[0] | (source[1] << 8));
+}
+
+uint32_t readU32(const uint8_t *source) {
+  uint32_t value = 0;
+  for (int i = 0; i < 4; ++i)
+    value |= uint32_t(source[i]) << (8 * i);
+  return value;
+}
+
+float readFloat(const uint8_t *source) {
+  const uint32_t bits = readU32(source);
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/** 範囲外は丸め、NaN は fallback */
+float clampFloat(float value, float low, float high, float fallback) {
+  return value == value ? std::clamp(value, low, high) : fallback;
+}
+
+/** 版 1 のペイロード (16 バイト) と同じ並びで設定を書く */
+void writeSettings(uint8_t *payload, const VT2WSettings &settings) {
+  writeFloat(payload, settings.drive);
+  writeFloat(payload + 4, settings.mix);
+  payload[8] = uint8_t(settings.quality);
+  payload[9] = uint8_t(settings.oversamplingLog2);
+  payload[10] = uint8_t(settings.oversamplingFilter);
+  payload[11] = uint8_t((settings.adaa ? kFlagAdaa : 0) |
+                        (settings.link ? kFlagLink : 0) |
+                        (settings.adaptive ? kFlagAdaptive : 0));
+  payload[12] = uint8_t(settings.model);
+}
+
+VT2WSettings readSettings(const uint8_t *payload) {
+  const VT2WSettings defaults;
+  VT2WSettings result;
+  result.drive = clampFloat(readFloat(payload), VT2WConstants::kDriveMin,
+                            VT2WConstants::kDriveMax, defaults.drive);
+  result.mix = clampFloat(readFloat(payload + 4), VT2WConstants::kMixMin,
+                          VT2WConstants::kMixMax, defaults.mix);
+  result.quality = static_cast<VT2WSaturationQuality>(
+      std::min<int>(payload[8], (int)VT2WSaturationQuality::Reference));
+  result.oversamplingLog2 =
+      std::min<int>(payload[9], VT2WOversampler::kMaxFactorLog2);
+  result.oversamplingFilter = static_cast<VT2WOversamplingFilter>(
+      std::min<int>(payload[10], 1));
+  result.adaa = (payload[11] & kFlagAdaa) != 0;
+  result.link = (payload[11] & kFlagLink) != 0;
+  result.adaptive = (payload[11] & kFlagAdaptive) != 0;
+  result.model = static_cast<VT2WModel>(std::min<int>(payload[12], 1));
+  return result;
+}
+
+/** CRC-32 のバイト単位のテーブル (コンパイル時に作る) */
+struct ChecksumTable {
+  uint32_t entries[256] = {};
+
+  constexpr ChecksumTable() {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int bit = 0; bit < 8; ++bit)
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      entries[i] = c;
+    }
+  }
+};
+
+constexpr ChecksumTable kChecksumTable;
+
+} // namespace
+
+//==============================================================================
+uint32_t computeChecksum(const uint8_t *data, int sizeInBytes) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (int i = 0; i < sizeInBytes; ++i)
+    crc = kChecksumTable.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  return crc ^ 0xFFFFFFFFu;
+}
+
+Data write(const VT2WSettings &settings, const BankState &bank) {
+  Data data{};
+  std::memcpy(data.data(), kMagic, sizeof(kMagic));
+  writeU16(data.data() + 4, kVersion);
+  writeU16(data.data() + 6, kPayloadSizeV2);
+
+  uint8_t *payload = data.data() + kHeaderSize;
+  writeSettings(payload, settings);
+  writeSettings(payload + kPayloadSizeV1, bank.other);
+  writeFloat(payload + 32, bank.morph);
+  payload[36] = uint8_t(bank.selectedSlot);
+  payload[37] = uint8_t(bank.program);
+
+  writeU32(data.data() + kHeaderSize + kPayloadSizeV2,
+           computeChecksum(data.data(), kHeaderSize + kPayloadSizeV2));
+  return data;
+}
+
+bool isBinary(const void *data, int sizeInBytes) {
+  return data != nullptr && sizeInBytes >= (int)sizeof(kMagic) &&
+         std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+Status read(const void *data, int sizeInBytes, VT2WSettings &settings,
+            BankState *bank) {
+  if (!isBinary(data, sizeInBytes))
+    return Status::NotBinary;
+
+  const auto *bytes = static_cast<const uint8_t *>(data);
+  if (sizeInBytes < kHeaderSize)
+    return Status::Truncated;
+
+  // 版に依らずヘッダーのサイズで囲んだ範囲がチェックサムの対象
+  const int version = readU16(bytes + 4);
+  const int payloadSize = readU16(bytes + 6);
+  const int checkedSize = kHeaderSize + payloadSize;
+  if (sizeInBytes < checkedSize + kChecksumSize)
+    return Status::Truncated;
+
+  if (readU32(bytes + checkedSize) != computeChecksum(bytes, checkedSize))
+    return Status::BadChecksum;
+
+  // その版より短いペイロードは作らないので、壊れているのと同じ扱い
+  if (version < 1 || payloadSize < kPayloadSizeV1 ||
+      (version >= 2 && payloadSize < kPayloadSizeV2))
+    return Status::BadChecksum;
+
+  const uint8_t *payload = bytes + kHeaderSize;
+  const VT2WSettings result = readSettings(payload);
+
+  if (bank != nullptr) {
+    BankState bankResult;
+    if (version >= 2) {
+      bankResult.other = readSettings(payload + kPayloadSizeV1);
+      bankResult.morph = clampFloat(readFloat(payload + 32), 0.0f, 100.0f,
+                                    0.0f);
+      bankResult.selectedSlot = std::min<int>(payload[36], 1);
+      bankResult.program = payload[37];
+    } else {
+      bankResult.other = result;
+    }
+    *bank = bankResult;
+  }
+
+  settings = result;
+  return Status::Ok;
+}
+
+} // namespace VT2WStateFormat
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Binary State Format (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "VT2WSettings.h"
+
+#include <array>
+#include <cstdint>
+
+//==============================================================================
+/**
+ * プラグインの状態のバイナリ形式 (getStateInformation / setStateInformation)
+ *
+ * パラメータの値 (ホスト単位) だけを固定長で並べ、XML と ValueTree を
+ * 経由せずに読み書きする。セッションを開くと全インスタンスが状態を
+ * 読み直すので、1 インスタンスあたりの確保と解析を無くしている。
+ *
+ *   0  'V' 'T' '2' 'S'
+ *   4  uint16 版 (kVersion)
+ *   6  uint16 ペイロードのバイト数
+ *   8  ペイロード (版 2 は 40 バイト、下記)
+ *   .. uint32 CRC-32 (先頭からペイロードの最後まで)
+ *
+ * 版 1 のペイロード: float32 Drive, float32 Mix, uint8 Quality,
+ * uint8 Oversampling (log2), uint8 OS Filter, uint8 フラグ (bit0 ADAA,
+ * bit1 Link, bit2 Auto Quality), uint8 Model, 予約 3 バイト (0)。
+ * 版 2 で足した項目: 選んでいない方の A/B スロット (版 1 と同じ 16 バイト),
+ * float32 Morph (%), uint8 選んでいるスロット, uint8 プログラム番号,
+ * 予約 2 バイト (0)。
+ *
+ * 数値はすべてリトルエンディアン。新しい版はペイロードの末尾にだけ項目を
+ * 足すので、古い読み手も知っている項目までは読める (無い項目は既定値)。
+ */
+namespace VT2WStateFormat {
+constexpr int kVersion = 2;
+constexpr int kHeaderSize = 8;
+constexpr int kPayloadSizeV1 = 16;
+constexpr int kPayloadSizeV2 = 40;
+constexpr int kChecksumSize = 4;
+constexpr int kSize = kHeaderSize + kPayloadSizeV2 + kChecksumSize;
+
+using Data = std::array<uint8_t, kSize>;
+
+enum class Status {
+  Ok,
+  NotBinary,  // マジックが違う (旧形式の XML など)
+  Truncated,  // 長さが足りない
+  BadChecksum // 壊れている
+};
+
+/** A/B スロットとプリセットの状態 (VT2WPresetBank とパラメータ Morph) */
+struct BankState {
+  VT2WSettings other;   // 選んでいない方のスロット
+  float morph = 0.0f;   // 0-100 (%)
+  int selectedSlot = 0; // 0 = A, 1 = B
+  int program = 0;      // ファクトリープリセットの番号
+};
+
+/** 設定をバイナリにする (確保しない) */
+Data write(const VT2WSettings &settings, const BankState &bank = {});
+
+/** 先頭がこの形式のマジックか (中身は確かめない) */
+bool isBinary(const void *data, int sizeInBytes);
+
+/**
+ * バイナリから設定を読む (確保しない)
+ * Ok 以外では settings / bank を変更しない。範囲外の値は範囲内に丸める。
+ * 版 1 のデータでは、bank は両方のスロットが同じ値で Morph 0 になる。
+ */
+Status read(const void *data, int sizeInBytes, VT2WSettings &settings,
+            BankState *bank = nullptr);
+
+/** CRC-32 (IEEE 802.3、zlib と同じ値) */
+uint32_t computeChecksum(const uint8_t *data, int sizeInBytes);
+} // namespace VT2WStateFormat
@@ -0,0 +1,686 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    DSP Engine Implementation
+  ==============================================================================
+*/
+
+#include "VT2WWhiteEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+//==============================================================================
+VT2WWhiteEngine::VT2WWhiteEngine() {
+  if (const auto *best = VT2WKernels::getBestAvailable())
+    kernelIsa = best->isa;
+  updateKernelOps();
+
+  allocateChannels(2);
+  reset();
+}
+
+void VT2WWhiteEngine::prepare(double sampleRate, int maximumBlockSize,
+                              int newNumChannels) {
+  currentSampleRate = sampleRate;
+
+  allocateChannels(newNumChannels);
+  floatState.oversampler.prepare(maximumBlockSize, numChannels);
+  doubleState.oversampler.prepare(maximumBlockSize, numChannels);
+  updateInternalRate();
+
+  reset();
+}
+
+void VT2WWhiteEngine::allocateChannels(int newNumChannels) {
+  numChannels = std::max(newNumChannels, 1);
+
+  envelopes.assign(numChannels, 0.0f);
+  wetValues.assign((size_t)numChannels * kChunkSize, 0.0f);
+  envelopeValues.assign((size_t)numChannels * kChunkSize, 0.0f);
+
+  auto allocate = [this](auto &state) {
+    state.adaaHistory.assign(
+        (size_t)numChannels * VT2WKernels::kAdaaHistorySize, 0);
+    state.dryHistory.assign(numChannels, 0);
+    state.phaseHistory.assign((size_t)numChannels * 2, 0);
+    state.referenceWet.assign(numChannels, 0);
+    state.subBlock.assign(numChannels, nullptr);
+    state.eventSpan.assign(numChannels, nullptr);
+  };
+  allocate(floatState);
+  allocate(doubleState);
+}
+
+void VT2WWhiteEngine::updateInternalRate() {
+  internalSampleRate = currentSampleRate * floatState.oversampler.getFactor();
+
+  // エンベロープ係数 (内部レートのみに依存)。決定的モードでも同じ値に
+  // なるよう、libm ではなく VT2WPortableMath で求める
+  auto decay = [this](float seconds) {
+    return (float)VT2WPortableMath::exp(
+        -1.0f / (float(internalSampleRate) * seconds));
+  };
+  rateCoefficients.attack = 1.0f - decay(VT2WConstants::kEnvelopeAttack);
+  rateCoefficients.release = 1.0f - decay(VT2WConstants::kEnvelopeRelease);
+
+  // Black のピークホールドの減衰と位相安定化オールパス
+  rateCoefficients.peakRelease = decay(VT2WConstants::kEnvelopeRelease);
+  rateCoefficients.phaseAllpass = (float)VT2WModels::getAllpassCoefficient(
+      VT2WConstants::kBlackPhaseFrequency, internalSampleRate);
+
+  // スムージング設定 (ランプの秒数は倍率に依らず同じ)
+  smoothedDrive.reset(internalSampleRate,
+                      VT2WConstants::kSmoothingTimeSeconds);
+  smoothedMix.reset(internalSampleRate, VT2WConstants::kSmoothingTimeSeconds);
+}
+
+void VT2WWhiteEngine::reset() {
+  std::fill(envelopes.begin(), envelopes.end(), 0.0f);
+  resetHistory();
+  floatState.oversampler.reset();
+  doubleState.oversampler.reset();
+
+  sleeping = false;
+  silentSamples = 0;
+}
+
+void VT2WWhiteEngine::setSleepEnabled(bool shouldBeEnabled) {
+  sleepEnabled = shouldBeEnabled;
+  if (!sleepEnabled)
+    sleeping = false;
+}
+
+void VT2WWhiteEngine::setOversampling(int factorLog2,
+                                      VT2WOversamplingFilter filter) {
+  if (factorLog2 == getOversamplingFactorLog2() &&
+      filter == getOversamplingFilter())
+    return;
+
+  floatState.oversampler.setMode(factorLog2, filter);
+  doubleState.oversampler.setMode(factorLog2, filter);
+  updateInternalRate();
+
+  std::fill(envelopes.begin(), envelopes.end(), 0.0f);
+  resetHistory();
+}
+
+void VT2WWhiteEngine::setEnvelopeLinked(bool shouldBeLinked) {
+  if (shouldBeLinked == envelopeLinked)
+    return;
+
+  // リンク中は先頭の値だけが進むので、解除時は全チャンネルをそこから始める
+  if (envelopeLinked)
+    std::fill(envelopes.begin(), envelopes.end(), envelopes[0]);
+
+  envelopeLinked = shouldBeLinked;
+}
+
+void VT2WWhiteEngine::setAdaaEnabled(bool shouldBeEnabled) {
+  if (shouldBeEnabled == adaaEnabled)
+    return;
+
+  adaaEnabled = shouldBeEnabled;
+  resetHistory();
+  updateProcessingDelay();
+}
+
+void VT2WWhiteEngine::setModel(VT2WModel newModel) {
+  if (newModel == model)
+    return;
+
+  model = newModel;
+
+  // エンベロープの意味 (追従の仕方) がモデルで違うので最初から
+  std::fill(envelopes.begin(), envelopes.end(), 0.0f);
+  resetHistory();
+  updateProcessingDelay();
+}
+
+void VT2WWhiteEngine::updateProcessingDelay() {
+  // 差分商の出力は内部レートで半サンプル遅れる
+  const double delay = isAdaaActive() ? 0.5 : 0.0;
+  floatState.oversampler.setProcessingDelay(delay);
+  doubleState.oversampler.setProcessingDelay(delay);
+}
+
+void VT2WWhiteEngine::resetHistory() {
+  resetWetHistory();
+  std::fill(floatState.dryHistory.begin(), floatState.dryHistory.end(), 0.0f);
+  std::fill(doubleState.dryHistory.begin(), doubleState.dryHistory.end(), 0.0);
+}
+
+void VT2WWhiteEngine::resetWetHistory() {
+  // u = y = 0 の時 log1p(exp(0)) = ln 2
+  auto resetState = [this](auto &state) {
+    for (int ch = 0; ch < numChannels; ++ch) {
+      auto *history =
+          state.adaaHistory.data() + ch * VT2WKernels::kAdaaHistorySize;
+      using Sample = std::remove_pointer_t<decltype(history)>;
+      history[0] = 0;
+      history[1] = 0;
+      history[2] = (Sample)0.69314718055994531;
+    }
+    std::fill(state.phaseHistory.begin(), state.phaseHistory.end(), 0);
+  };
+  resetState(floatState);
+  resetState(doubleState);
+}
+
+void VT2WWhiteEngine::setTargets(float drive, float mix) {
+  if (drive != smoothedDrive.getTargetValue()) {
+    driveCoefficients = VT2WDriveCoefficients::fromDrive(drive);
+    blackCoefficients = VT2WBlackCoefficients::fromDrive(drive);
+  }
+
+  smoothedDrive.setTargetValue(drive);
+  smoothedMix.setTargetValue(mix);
+}
+
+void VT2WWhiteEngine::skipSmoothing() {
+  smoothedDrive.setCurrentAndTargetValue(smoothedDrive.getTargetValue());
+  smoothedMix.setCurrentAndTargetValue(smoothedMix.getTargetValue());
+}
+
+void VT2WWhiteEngine::applySettings(const VT2WSettings &settings) {
+  setQuality(settings.quality);
+  setModel(settings.model);
+  setOversampling(settings.oversamplingLog2, settings.oversamplingFilter);
+  setAdaaEnabled(settings.adaa);
+  setEnvelopeLinked(settings.link);
+  setTargets(settings.drive, settings.mix / 100.0f);
+}
+
+float VT2WWhiteEngine::getEnvelopeLevel() const {
+  if (envelopeLinked)
+    return envelopes[0];
+
+  return *std::max_element(envelopes.begin(), envelopes.end());
+}
+
+float VT2WWhiteEngine::getMakeupGain() const {
+  const float drive = smoothedDrive.getCurrentValue();
+
+  if (model == VT2WModel::Black)
+    return getModelCoefficients<VT2WBlackModel>(drive).makeupGain;
+
+  return getDriveCoefficients(drive).makeupGain;
+}
+
+VT2WDriveCoefficients VT2WWhiteEngine::getDriveCoefficients(float drive) const {
+  return smoothedDrive.isSmoothing() ? VT2WDriveCoefficients::fromDrive(drive)
+                                     : driveCoefficients;
+}
+
+template <typename Model>
+typename Model::Coefficients
+VT2WWhiteEngine::getModelCoefficients(float drive) const {
+  if constexpr (std::is_same_v<Model, VT2WBlackModel>)
+    return smoothedDrive.isSmoothing() ? VT2WBlackCoefficients::fromDrive(drive)
+                                       : blackCoefficients;
+  else
+    return getDriveCoefficients(drive);
+}
+
+bool VT2WWhiteEngine::setKernel(VT2WKernelIsa isa) {
+  if (!VT2WKernels::isSupported(isa))
+    return false;
+
+  kernelIsa = isa;
+  updateKernelOps();
+  return true;
+}
+
+void VT2WWhiteEngine::setDeterministic(bool shouldBeDeterministic) {
+  deterministic = shouldBeDeterministic;
+  updateKernelOps();
+
+  if (deterministic)
+    sleeping = false;
+}
+
+void VT2WWhiteEngine::updateKernelOps() {
+  kernelOps = deterministic ? VT2WKernels::getDeterministicOps(kernelIsa)
+                            : VT2WKernels::getOps(kernelIsa);
+}
+
+//==============================================================================
+void VT2WWhiteEngine::process(float *const *channels, int numActive,
+                              int numSamples) {
+  processBlock(channels, numActive, numSamples);
+}
+
+void VT2WWhiteEngine::process(double *const *channels, int numActive,
+                              int numSamples) {
+  processBlock(channels, numActive, numSamples);
+}
+
+void VT2WWhiteEngine::process(float *const *channels, int numActive,
+                              int numSamples,
+                              const VT2WParameterEvents &events) {
+  processEvents(channels, numActive, numSamples, events);
+}
+
+void VT2WWhiteEngine::process(double *const *channels, int numActive,
+                              int numSamples,
+                              const VT2WParameterEvents &events) {
+  processEvents(channels, numActive, numSamples, events);
+}
+
+void VT2WWhiteEngine::applyEvent(const VT2WParameterEvent &event) {
+  using namespace VT2WConstants;
+
+  if (event.parameter == VT2WAutomatedParameter::Drive)
+    setTargets(std::clamp(event.value, kDriveMin, kDriveMax),
+               smoothedMix.getTargetValue());
+  else
+    setTargets(smoothedDrive.getTargetValue(),
+               std::clamp(event.value, kMixMin, kMixMax) / 100.0f);
+}
+
+template <typename Sample>
+void VT2WWhiteEngine::processEvents(Sample *const *channels, int numActive,
+                                    int numSamples,
+                                    const VT2WParameterEvents &events) {
+  numActive = std::min(numActive, numChannels);
+  auto &span = getState<Sample>().eventSpan;
+
+  VT2WAutomation::split(
+      events, numSamples,
+      [&](int start, int length) {
+        for (int ch = 0; ch < numActive; ++ch)
+          span[ch] = channels[ch] + start;
+        processBlock(span.data(), numActive, length);
+      },
+      [this](const VT2WParameterEvent &event) { applyEvent(event); });
+}
+
+template <typename Sample>
+void VT2WWhiteEngine::processBlock(Sample *const *channels, int numActive,
+                                   int numSamples) {
+  numActive = std::min(numActive, numChannels);
+  if (numActive <= 0)
+    return;
+
+  // 無音スリープ: 閾値以上の入力が来たらこのブロックから処理を再開する
+  // (判定がブロック単位なので、決定的モードでは使わない)
+  if (sleepEnabled && !deterministic) {
+    if (!isSilent(channels, numActive, numSamples)) {
+      sleeping = false;
+      silentSamples = 0;
+    } else {
+      silentSamples = (int)std::min<int64_t>(
+          (int64_t)silentSamples + numSamples, std::numeric_limits<int>::max());
+
+      if (sleeping) {
+        // 寝ている間の変更は、起きた時にランプさせず目標値から始める
+        skipSmoothing();
+
+        // Wet は止めたまま、Dry だけを Mix の分通す (Mix 100% なら無音)
+        if (smoothedMix.getTargetValue() >= 1.0f) {
+          for (int ch = 0; ch < numActive; ++ch)
+            std::fill(channels[ch], channels[ch] + numSamples, Sample(0));
+        } else {
+          processOversampled(channels, numActive, numSamples,
+                             [this](auto *const *io, int n, int length) {
+                               processDry(io, n, length);
+                             });
+        }
+        return;
+      }
+    }
+  }
+
+  processOversampled(channels, numActive, numSamples,
+                     [this](auto *const *io, int n, int length) {
+                       processInternal(io, n, length);
+                     });
+  updateSleep();
+}
+
+template <typename Sample, typename Process>
+void VT2WWhiteEngine::processOversampled(Sample *const *channels,
+                                         int numActive, int numSamples,
+                                         Process &&process) {
+  auto &state = getState<Sample>();
+  auto &oversampler = state.oversampler;
+  const int maximumBlockSize = oversampler.getMaximumBlockSize();
+
+  if (!oversampler.isActive() || maximumBlockSize == 0) {
+    process(channels, numActive, numSamples);
+    return;
+  }
+
+  // prepare で確保した長さを超えるブロックは分割する
+  const int factorLog2 = oversampler.getFactorLog2();
+
+  for (int offset = 0; offset < numSamples; offset += maximumBlockSize) {
+    const int length = std::min(maximumBlockSize, numSamples - offset);
+
+    for (int ch = 0; ch < numActive; ++ch)
+      state.subBlock[ch] = channels[ch] + offset;
+
+    auto *upsampled =
+        oversampler.processUp(state.subBlock.data(), numActive, length);
+    process(upsampled, numActive, length << factorLog2);
+    oversampler.processDown(state.subBlock.data(), numActive, length);
+  }
+}
+
+template <typename Sample>
+void VT2WWhiteEngine::processDry(Sample *const *channels, int numActive,
+                                 int numSamples) {
+  auto &state = getState<Sample>();
+  const Sample gain = Sample(1.0f - smoothedMix.getTargetValue());
+  const bool adaa = isAdaaActive();
+
+  for (int ch = 0; ch < numActive; ++ch) {
+    Sample *io = channels[ch];
+
+    if (!adaa) {
+      for (int i = 0; i < numSamples; ++i)
+        io[i] *= gain;
+      continue;
+    }
+
+    // 起きている時と同じく ADAA の半サンプル遅延に揃える
+    Sample previous = state.dryHistory[ch];
+    for (int i = 0; i < numSamples; ++i) {
+      const Sample dry = io[i];
+      io[i] = gain * (Sample(0.5) * (dry + previous));
+      previous = dry;
+    }
+    state.dryHistory[ch] = previous;
+  }
+}
+
+template <typename Sample>
+bool VT2WWhiteEngine::isSilent(const Sample *const *channels, int numActive,
+                               int numSamples) {
+  // 音がある時は最初の数サンプルで抜ける
+  for (int ch = 0; ch < numActive; ++ch)
+    for (int i = 0; i < numSamples; ++i)
+      if (!(std::abs(channels[ch][i]) < VT2WConstants::kSilenceThreshold))
+        return false;
+
+  return true;
+}
+
+void VT2WWhiteEngine::updateSleep() {
+  if (!sleepEnabled || deterministic || sleeping ||
+      silentSamples <= getTailLengthSamples())
+    return;
+
+  if (smoothedDrive.isSmoothing() || smoothedMix.isSmoothing())
+    return;
+
+  for (float envelope : envelopes)
+    if (envelope >= VT2WConstants::kSilenceThreshold)
+      return;
+
+  // テールは出し終えているので、Wet の残りの状態 (閾値未満) を捨てて止める
+  // (Dry の経路は寝ている間も通すので、オーバーサンプラーと Dry の
+  // 前サンプルは残す)
+  std::fill(envelopes.begin(), envelopes.end(), 0.0f);
+  resetWetHistory();
+  sleeping = true;
+}
+
+void VT2WWhiteEngine::processInternal(float *const *channels, int numActive,
+                                      int numSamples) {
+  if (kernelOps == nullptr || quality == VT2WSaturationQuality::Reference ||
+      model != VT2WModel::White) {
+    processReference(channels, numActive, numSamples);
+    return;
+  }
+
+  // ランプの終わりでチャンクを切り、ランプ用と静止用のカーネルの境目を
+  // ブロックの分け方に依らずランプの終点に揃える
+  for (int offset = 0; offset < numSamples;) {
+    int length = std::min(kChunkSize, numSamples - offset);
+    for (const auto *smoother : {&smoothedDrive, &smoothedMix})
+      if (smoother->isSmoothing())
+        length = std::min(length, smoother->getRemainingSamples());
+
+    processChunk(channels, numActive, offset, length);
+    offset += length;
+  }
+}
+
+void VT2WWhiteEngine::processInternal(double *const *channels, int numActive,
+                                      int numSamples) {
+  processReference(channels, numActive, numSamples);
+}
+
+void VT2WWhiteEngine::processChunk(float *const *channels, int numActive,
+                                   int offset, int numSamples) {
+  // パラメータが静止している時 (ミックス中の大半) は、Drive 由来の項を
+  // すべてキャッシュから取り、ループ内ではブロードキャストするだけにする
+  const bool driveConstant = !smoothedDrive.isSmoothing();
+  const bool mixConstant = !smoothedMix.isSmoothing();
+  const int tier = static_cast<int>(quality);
+
+  if (adaaEnabled) {
+    if (!driveConstant)
+      smoothedDrive.fillRamp(driveValues, numSamples);
+
+    for (int ch = 0; ch < numActive; ++ch) {
+      float *history =
+          floatState.adaaHistory.data() + ch * VT2WKernels::kAdaaHistorySize;
+
+      if (driveConstant)
+        kernelOps->shapeAdaaConstant[tier](channels[ch] + offset,
+                                           getWetValues(ch), numSamples,
+                                           driveCoefficients, history,
+                                           adaaScratch);
+      else
+        kernelOps->shapeAdaa[tier](channels[ch] + offset, getWetValues(ch),
+                                   numSamples, driveValues, history,
+                                   adaaScratch);
+
+      averageDry(channels[ch] + offset, numSamples,
+                 floatState.dryHistory[ch]);
+    }
+  } else if (driveConstant) {
+    for (int ch = 0; ch < numActive; ++ch)
+      kernelOps->shapeConstant[tier](channels[ch] + offset, getWetValues(ch),
+                                     numSamples, driveCoefficients);
+  } else {
+    smoothedDrive.fillRamp(driveValues, numSamples);
+
+    for (int ch = 0; ch < numActive; ++ch)
+      kernelOps->shape[tier](channels[ch] + offset, getWetValues(ch),
+                             numSamples, driveValues);
+  }
+
+  followEnvelope(numActive, numSamples);
+
+  // リンク時は全チャンネルが先頭のエンベロープを共有する
+  const bool linked = envelopeLinked && numActive > 1;
+
+  if (driveConstant && mixConstant) {
+    const float mix = smoothedMix.getTargetValue();
+
+    for (int ch = 0; ch < numActive; ++ch)
+      kernelOps->mixConstant(channels[ch] + offset, getWetValues(ch),
+                             getEnvelopeValues(linked ? 0 : ch), numSamples,
+                             driveCoefficients, mix);
+    return;
+  }
+
+  // どちらかがランプ中: 一定側は同じ値で埋めてサンプル毎のカーネルを使う
+  if (driveConstant)
+    std::fill(driveValues, driveValues + numSamples,
+              smoothedDrive.getTargetValue());
+
+  smoothedMix.fillRamp(mixValues, numSamples);
+
+  for (int ch = 0; ch < numActive; ++ch)
+    kernelOps->mix(channels[ch] + offset, getWetValues(ch),
+                   getEnvelopeValues(linked ? 0 : ch), numSamples, driveValues,
+                   mixValues);
+}
+
+void VT2WWhiteEngine::averageDry(float *io, int numSamples, float &history) {
+  float previous = history;
+
+  for (int i = 0; i < numSamples; ++i) {
+    const float current = io[i];
+    io[i] = 0.5f * (current + previous);
+    previous = current;
+  }
+
+  history = previous;
+}
+
+void VT2WWhiteEngine::followEnvelope(int numActive, int numSamples) {
+  const float attack = rateCoefficients.attack;
+  const float release = rateCoefficients.release;
+
+  if (envelopeLinked && numActive > 1) {
+    kernelOps->followEnvelopeLinked(wetValues.data(), envelopeValues.data(),
+                                    envelopes.data(), numActive, kChunkSize,
+                                    numSamples, attack, release);
+    return;
+  }
+
+  // 3 チャンネル以上はチャンネルをレーンに並べて SIMD で回す
+  if (numActive > 2) {
+    kernelOps->followEnvelope(wetValues.data(), envelopeValues.data(),
+                              envelopes.data(), numActive, kChunkSize,
+                              numSamples, attack, release);
+    return;
+  }
+
+  float envL = envelopes[0];
+  const float *wetL = getWetValues(0);
+  float *outL = getEnvelopeValues(0);
+
+  if (numActive < 2) {
+    for (int i = 0; i < numSamples; ++i) {
+      float absInput = std::abs(wetL[i]);
+      envL += (absInput > envL ? attack : release) * (absInput - envL);
+      outL[i] = envL;
+    }
+
+    envelopes[0] = envL;
+    return;
+  }
+
+  // L/R の再帰を同じループで回し、依存チェーンを 2 本並列にする
+  // (2 チャンネルだと転置のコストの方が大きいのでスカラーのまま)
+  float envR = envelopes[1];
+  const float *wetR = getWetValues(1);
+  float *outR = getEnvelopeValues(1);
+
+  for (int i = 0; i < numSamples; ++i) {
+    float absL = std::abs(wetL[i]);
+    float absR = std::abs(wetR[i]);
+    envL += (absL > envL ? attack : release) * (absL - envL);
+    envR += (absR > envR ? attack : release) * (absR - envR);
+    outL[i] = envL;
+    outR[i] = envR;
+  }
+
+  envelopes[0] = envL;
+  envelopes[1] = envR;
+}
+
+template <typename Sample>
+void VT2WWhiteEngine::processReference(Sample *const *channels, int numActive,
+                                       int numSamples) {
+  if (deterministic)
+    selectPipeline<VT2WPortableMathPolicy>(channels, numActive, numSamples);
+  else
+    selectPipeline<VT2WLibmMath>(channels, numActive, numSamples);
+}
+
+template <typename Math, typename Sample>
+void VT2WWhiteEngine::selectPipeline(Sample *const *channels, int numActive,
+                                     int numSamples) {
+  // モデルと ADAA の組み合わせごとに展開済みのループを選ぶ (ブロックに 1 回)
+  if (model == VT2WModel::Black)
+    processPipeline<VT2WBlackModel, false, Math>(channels, numActive,
+                                                 numSamples);
+  else if (isAdaaActive())
+    processPipeline<VT2WWhiteModel, true, Math>(channels, numActive,
+                                                numSamples);
+  else
+    processPipeline<VT2WWhiteModel, false, Math>(channels, numActive,
+                                                 numSamples);
+}
+
+template <typename Model, bool Adaa, typename Math, typename Sample>
+void VT2WWhiteEngine::processPipeline(Sample *const *channels, int numActive,
+                                      int numSamples) {
+  using Stages = std::conditional_t<Adaa, typename Model::AdaaStages,
+                                    typename Model::Stages>;
+  using Context =
+      VT2WStageContext<Sample, typename Model::Coefficients, Math>;
+
+  auto &state = getState<Sample>();
+  const bool linked = envelopeLinked && numActive > 1;
+
+  // Mix (Dry/Wet)。ADAA の半サンプル遅延に Dry を揃える
+  auto mixSample = [&state](int ch, Sample dry, Sample wet, float mix) {
+    if constexpr (Adaa) {
+      const Sample previous = state.dryHistory[ch];
+      state.dryHistory[ch] = dry;
+      dry = Sample(0.5) * (dry + previous);
+    }
+    return dry * (1.0f - mix) + wet * mix;
+  };
+
+  // パラメータが静止していてリンクも無い時 (ミックス中の大半) は、
+  // チャンネル毎に全サンプルを 1 本のループで処理する (状態がレジスタに載る)
+  if (!linked && !smoothedDrive.isSmoothing() && !smoothedMix.isSmoothing()) {
+    const auto coefficients =
+        getModelCoefficients<Model>(smoothedDrive.getTargetValue());
+    const float mix = smoothedMix.getTargetValue();
+
+    for (int ch = 0; ch < numActive; ++ch) {
+      const Context context{
+          coefficients,
+          rateCoefficients,
+          1,
+          false,
+          envelopes.data() + ch,
+          state.adaaHistory.data() + ch * VT2WKernels::kAdaaHistorySize,
+          state.phaseHistory.data() + 2 * ch};
+      Sample *samples = channels[ch];
+
+      for (int sample = 0; sample < numSamples; ++sample) {
+        Sample wet = samples[sample];
+        Stages::processFrame(&wet, context);
+        samples[sample] = mixSample(ch, samples[sample], wet, mix);
+      }
+    }
+    return;
+  }
+
+  Sample *wet = state.referenceWet.data();
+
+  for (int sample = 0; sample < numSamples; ++sample) {
+    float currentDrive = smoothedDrive.getNextValue();
+    float currentMix = smoothedMix.getNextValue();
+
+    const auto coefficients = getModelCoefficients<Model>(currentDrive);
+    const Context context{coefficients,
+                          rateCoefficients,
+                          numActive,
+                          linked,
+                          envelopes.data(),
+                          state.adaaHistory.data(),
+                          state.phaseHistory.data()};
+
+    for (int ch = 0; ch < numActive; ++ch)
+      wet[ch] = channels[ch][sample];
+
+    Stages::processFrame(wet, context);
+
+    for (int ch = 0; ch < numActive; ++ch)
+      channels[ch][sample] =
+          mixSample(ch, channels[ch][sample], wet[ch], currentMix);
+  }
+}
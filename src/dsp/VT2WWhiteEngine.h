@@ -0,0 +1,377 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    DSP Engine (JUCE 非依存)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "VT2WAutomation.h"
+#include "VT2WCoefficients.h"
+#include "VT2WConstants.h"
+#include "VT2WKernels.h"
+#include "VT2WLinearSmoother.h"
+#include "VT2WModels.h"
+#include "VT2WOversampler.h"
+#include "VT2WSettings.h"
+
+#include <type_traits>
+#include <vector>
+
+//==============================================================================
+/**
+ * VT-2W White DSP エンジン
+ *
+ * VT2WWhiteProcessor の信号処理部分。JUCE に依存しないため、
+ * プラグインホスト無しでベンチマークやオフライン処理から再利用できる。
+ *
+ * float と double のバッファを直接処理できる。サンプル単位の処理と
+ * オーバーサンプラーはサンプル型のテンプレートで、process の引数の型で
+ * コンパイル時に経路が決まる (double はホストの 64bit ミックスのまま通す)。
+ *
+ * サンプル単位の処理はモデル (VT2WModels.h) のステージの並びを 1 本の
+ * ループに展開したもので、White と Black は同じループのインスタンス。
+ * モデルの切り替えはブロック単位で 1 回だけ分岐する。
+ */
+class VT2WWhiteEngine {
+public:
+  //==============================================================================
+  VT2WWhiteEngine();
+
+  /**
+   * 再生前の準備。チャンネル毎の状態と作業バッファ、オーバーサンプリング用の
+   * バッファ (最大 8x 分) もここで numChannels 分確保するので、以降の
+   * setOversampling や process は確保しない。
+   */
+  void prepare(double sampleRate, int maximumBlockSize, int numChannels = 2);
+  void reset();
+
+  /** Drive (0-10) と Mix (0-1) の目標値を設定する */
+  void setTargets(float drive, float mix);
+
+  /** スムージング中なら目標値まで飛ばす (途中から処理を始めるエンジン用) */
+  void skipSmoothing();
+
+  /**
+   * パラメータ一式を反映する (品質・オーバーサンプリング・ADAA・リンク・目標値)
+   * prepare の前に呼ぶと、スムージングは最初から目標値で始まる。
+   */
+  void applySettings(const VT2WSettings &settings);
+
+  /**
+   * ブロック処理 (in-place)
+   * チャンネル数は任意 (モノラル / ステレオ / 5.1 / 7.1.4 など)。prepare した
+   * 数を超えるチャンネルは処理せずそのまま通す。
+   */
+  void process(float *const *channels, int numChannels, int numSamples);
+
+  /**
+   * double のブロック処理 (in-place)
+   * オーバーサンプリングを含めて全段を double で処理する。SIMD カーネルは
+   * float 専用なので、品質設定に依らずリファレンス経路になる。
+   * エンベロープとパラメーターのスムージング (制御信号) は float と共有。
+   */
+  void process(double *const *channels, int numChannels, int numSamples);
+
+  /**
+   * 変化点付きのブロック処理 (in-place)
+   * events の位置でブロックを分けて通常の process で処理し、各位置で
+   * Drive / Mix の目標値を変える。ランプは変化点のサンプルから始まるので、
+   * 同じ変化点ならブロック長に依らず同じ出力になる (無音スリープの判定だけは
+   * ブロック単位)。
+   */
+  void process(float *const *channels, int numChannels, int numSamples,
+               const VT2WParameterEvents &events);
+  void process(double *const *channels, int numChannels, int numSamples,
+               const VT2WParameterEvents &events);
+
+  /** 変化点 1 つ分の目標値の更新 (範囲外の値は丸める) */
+  void applyEvent(const VT2WParameterEvent &event);
+
+  double getSampleRate() const { return currentSampleRate; }
+  int getNumChannels() const { return numChannels; }
+
+  /**
+   * トランジェント段のエンベロープ (直前に処理したブロックの最後の値)
+   * リンク時は共有の 1 本、それ以外は全チャンネルの最大。メーター用。
+   */
+  float getEnvelopeLevel() const;
+
+  /** 現在の Drive で Wet に掛かるメイクアップゲイン (Mix は含まない) */
+  float getMakeupGain() const;
+
+  /**
+   * キャラクター (White / Black)
+   * Black はステージの並びごと別の回路で、SIMD カーネルを持たないので
+   * 品質設定に依らずリファレンス経路で処理する。ADAA には対応しない
+   * (設定は保持するが、半サンプルの遅延も足さない)。
+   * 変更するとエンベロープなどの状態をリセットし、テール長が変わる。
+   */
+  void setModel(VT2WModel newModel);
+  VT2WModel getModel() const { return model; }
+
+  /**
+   * エンベロープのリンク
+   * 有効にすると全チャンネルの最大値で 1 本のエンベロープを追従し、
+   * トランジェント強調が全チャンネルで同じタイミングでかかる (定位が揺れない)。
+   */
+  void setEnvelopeLinked(bool shouldBeLinked);
+  bool isEnvelopeLinked() const { return envelopeLinked; }
+
+  /**
+   * オーバーサンプリング倍率 (log2 で 0-3 = 1x/2x/4x/8x) とフィルター方式
+   * サチュレーション〜トランジェント〜Dry/Wet ミックスまでを内部レートで
+   * 処理する (Dry もフィルターを通るので Wet と位相が揃う)。
+   * 変更するとフィルター状態をリセットし、レイテンシが変わる。
+   */
+  void setOversampling(int factorLog2, VT2WOversamplingFilter filter);
+  int getOversamplingFactorLog2() const {
+    return floatState.oversampler.getFactorLog2();
+  }
+  VT2WOversamplingFilter getOversamplingFilter() const {
+    return floatState.oversampler.getFilter();
+  }
+
+  /**
+   * ADAA (1 次の逆導関数アンチエイリアシング)
+   * サチュレーションと倍音を逆導関数の差分商に置き換え、折り返しを内部レートの
+   * まま抑える。出力は内部レートで半サンプル遅れ (Dry も揃えて遅らせる)、
+   * 1x / IIR ではその分もレイテンシに含めて整数サンプルに揃える。
+   * 線形部分は 2 点平均になるので、1x では fs/4 で -3dB の高域減衰がある。
+   */
+  void setAdaaEnabled(bool shouldBeEnabled);
+  bool isAdaaEnabled() const { return adaaEnabled; }
+
+  /**
+   * 無音スリープ (既定で有効)
+   * 入力が kSilenceThreshold 未満のまま出力のテール (getTailLengthSamples) を
+   * 過ぎ、エンベロープも閾値未満まで下がったら、Wet の状態をゼロに戻して
+   * Wet の処理を止め、Dry だけを (1 - Mix) 倍で通す (Mix 100% なら無音)。
+   * 閾値以上の入力が来たブロックからすぐに処理を再開する
+   * (状態はゼロなので、止めなかった場合との差は閾値未満)。
+   */
+  void setSleepEnabled(bool shouldBeEnabled);
+  bool isSleepEnabled() const { return sleepEnabled; }
+  bool isSleeping() const { return sleeping; }
+
+  /** オーバーサンプリングで増える遅延 (基本レートのサンプル数、整数) */
+  int getLatencySamples() const {
+    return floatState.oversampler.getLatencySamples();
+  }
+
+  /** 入力が無音になってから出力が消えるまでのサンプル数 */
+  int getTailLengthSamples() const {
+    return floatState.oversampler.getTailSamples() +
+           VT2WModels::getTailSamples(model, currentSampleRate);
+  }
+
+  /**
+   * 使用するカーネルを指定する (既定は CPU 機能から自動選択)
+   * Scalar は std::tanh を使うリファレンス経路 (決定的モードでは 1 レーンの
+   * 移植版カーネル)。非対応の ISA なら false。
+   */
+  bool setKernel(VT2WKernelIsa isa);
+  VT2WKernelIsa getKernel() const { return kernelIsa; }
+
+  /**
+   * 決定的モード (既定は無効)
+   * 同じ入力・設定・サンプルレートなら、カーネルの ISA・ブロック長・
+   * コンパイラや libm に依らず、出力がビット単位で同じになる。
+   *  - カーネルは積和を FMA にしない決定的テーブル
+   *    (VT2WKernels::getDeterministicOps。幅の広い ISA はそのまま使う)
+   *  - リファレンス経路・double・Black の超越関数は VT2WPortableMath
+   *  - ブロック単位で判定する無音スリープは止める
+   * 通常のモードとの差は SIMD の積和 1 回分の丸め程度。オーディオスレッド
+   * から切り替えてよい (確保しない)。
+   */
+  void setDeterministic(bool shouldBeDeterministic);
+  bool isDeterministic() const { return deterministic; }
+
+  /**
+   * サチュレーションの品質 (Eco / Standard / Reference)
+   * Reference、または SIMD カーネルが無い場合はリファレンス経路で処理する。
+   */
+  void setQuality(VT2WSaturationQuality newQuality) { quality = newQuality; }
+  VT2WSaturationQuality getQuality() const { return quality; }
+
+private:
+  //==============================================================================
+  // SIMD カーネル 1 回あたりの最大サンプル数 (作業バッファのサイズ)
+  static constexpr int kChunkSize = 256;
+
+  /**
+   * サンプル型ごとの状態 (float 経路と double 経路で別に持つ)
+   * 設定の変更は両方に入れておき、どちらを使うかは process の型で決まる。
+   */
+  template <typename Sample> struct PrecisionState {
+    VT2WOversamplerT<Sample> oversampler;
+
+    // ADAA の前サンプル状態 (チャンネル毎に kAdaaHistorySize 個)
+    std::vector<Sample> adaaHistory;
+    std::vector<Sample> dryHistory;
+
+    // Black の位相安定化オールパス (チャンネル毎に x[n-1], y[n-1])
+    std::vector<Sample> phaseHistory;
+
+    std::vector<Sample> referenceWet; // リファレンス経路の 1 サンプル分
+    std::vector<Sample *> subBlock;   // オーバーサンプリング時の分割用
+    std::vector<Sample *> eventSpan;  // 変化点で分けた区間用
+  };
+
+  template <typename Sample> PrecisionState<Sample> &getState() {
+    if constexpr (std::is_same_v<Sample, double>)
+      return doubleState;
+    else
+      return floatState;
+  }
+
+  /** 内部レート (基本レート x 倍率) に依存する係数とスムージングを更新 */
+  void updateInternalRate();
+
+  /** 無音スリープとオーバーサンプリングの分割 (process の本体) */
+  template <typename Sample>
+  void processBlock(Sample *const *channels, int numChannels, int numSamples);
+
+  /** 変化点で分けて processBlock に渡す */
+  template <typename Sample>
+  void processEvents(Sample *const *channels, int numChannels, int numSamples,
+                     const VT2WParameterEvents &events);
+
+  /**
+   * 内部レートでの処理 (オーバーサンプリング無しならホストのバッファ)
+   * float は SIMD カーネルかリファレンス、double は常にリファレンス
+   */
+  void processInternal(float *const *channels, int numChannels,
+                       int numSamples);
+  void processInternal(double *const *channels, int numChannels,
+                       int numSamples);
+
+  /**
+   * サンプル単位のリファレンス処理 (超越関数の実装を選ぶだけ)
+   * 通常は std::tanh など、決定的モードでは VT2WPortableMath を使う。
+   */
+  template <typename Sample>
+  void processReference(Sample *const *channels, int numChannels,
+                        int numSamples);
+
+  /** モデルと ADAA の組み合わせで展開済みのループを選ぶ */
+  template <typename Math, typename Sample>
+  void selectPipeline(Sample *const *channels, int numChannels,
+                      int numSamples);
+
+  /**
+   * Model のステージを 1 サンプルずつ全段通し、Dry とミックスする
+   * (パラメータが静止していてリンクも無ければチャンネル毎のループ)
+   */
+  template <typename Model, bool Adaa, typename Math, typename Sample>
+  void processPipeline(Sample *const *channels, int numChannels,
+                       int numSamples);
+
+  /** Model の係数 (スムージング中でなければキャッシュ) */
+  template <typename Model>
+  typename Model::Coefficients getModelCoefficients(float drive) const;
+
+  /** SIMD カーネルによるチャンク処理 */
+  void processChunk(float *const *channels, int numChannels, int offset,
+                    int numSamples);
+
+  /** ブロック全体が kSilenceThreshold 未満か */
+  template <typename Sample>
+  static bool isSilent(const Sample *const *channels, int numChannels,
+                       int numSamples);
+
+  /** 無音が続いていればスリープに入る (process の最後に呼ぶ) */
+  void updateSleep();
+
+  /**
+   * オーバーサンプリング中は内部レートに上げて process に渡し、基本レートに
+   * 戻す (prepare の最大ブロック長を超えるブロックは分割する)
+   */
+  template <typename Sample, typename Process>
+  void processOversampled(Sample *const *channels, int numChannels,
+                          int numSamples, Process &&process);
+
+  /** スリープ中の Dry だけの経路 ((1 - Mix) 倍、ADAA なら半サンプル遅延) */
+  template <typename Sample>
+  void processDry(Sample *const *channels, int numChannels, int numSamples);
+
+  /** kernelIsa と決定的モードからカーネルのテーブルを選ぶ */
+  void updateKernelOps();
+
+  /** 現在の Drive に対応する係数 (スムージング中でなければキャッシュ) */
+  VT2WDriveCoefficients getDriveCoefficients(float drive) const;
+
+  /** チャンネル数に依る状態と作業バッファを確保する */
+  void allocateChannels(int newNumChannels);
+
+  /** ADAA・Dry・位相オールパスの前サンプル状態を戻す */
+  void resetHistory();
+
+  /** Wet 側 (ADAA・位相オールパス) の前サンプル状態だけを戻す */
+  void resetWetHistory();
+
+  /** ADAA が有効で、モデルも対応しているか */
+  bool isAdaaActive() const {
+    return adaaEnabled && VT2WModels::supportsAdaa(model);
+  }
+
+  /** ADAA の半サンプル遅延をオーバーサンプラーに伝える */
+  void updateProcessingDelay();
+
+  /** ADAA の半サンプル遅延に Dry を揃える (前サンプルとの 2 点平均) */
+  static void averageDry(float *io, int numSamples, float &history);
+
+  /** エンベロープ追従 (3 チャンネル以上はチャンネルを SIMD のレーンにする) */
+  void followEnvelope(int numChannels, int numSamples);
+
+  float *getWetValues(int ch) { return wetValues.data() + ch * kChunkSize; }
+  float *getEnvelopeValues(int ch) {
+    return envelopeValues.data() + ch * kChunkSize;
+  }
+
+  //==============================================================================
+  double currentSampleRate = 44100.0;
+  double internalSampleRate = 44100.0;
+
+  const VT2WKernelOps *kernelOps = nullptr; // nullptr ならリファレンス経路
+  VT2WKernelIsa kernelIsa = VT2WKernelIsa::Scalar;
+  bool deterministic = false;
+  VT2WSaturationQuality quality = VT2WSaturationQuality::Standard;
+  VT2WModel model = VT2WModel::White;
+  bool adaaEnabled = false;
+  bool envelopeLinked = false;
+  int numChannels = 0;
+
+  // 係数キャッシュ
+  // rateCoefficients は prepare で、driveCoefficients は Drive の目標値が
+  // 変わった時に作り直す
+  VT2WRateCoefficients rateCoefficients;
+  VT2WDriveCoefficients driveCoefficients;
+  VT2WBlackCoefficients blackCoefficients;
+
+  // エンベロープフォロワー（トランジェント追従用）
+  // チャンネル毎の現在値を連続に並べる (SIMD カーネルがそのままレーンに読む)
+  // リンク時は先頭の 1 つだけを使う
+  std::vector<float> envelopes;
+
+  // 無音スリープ
+  bool sleepEnabled = true;
+  bool sleeping = false;
+  int silentSamples = 0; // 入力が無音になってからのサンプル数 (基本レート)
+
+  // スムージング
+  VT2WLinearSmoother smoothedDrive;
+  VT2WLinearSmoother smoothedMix;
+
+  // オーバーサンプラーと ADAA の状態 (サンプル型ごと)
+  PrecisionState<float> floatState;
+  PrecisionState<double> doubleState;
+
+  // 作業バッファ (チャンネル数に依るものは prepare で確保)
+  alignas(64) float driveValues[kChunkSize];
+  alignas(64) float mixValues[kChunkSize];
+  alignas(64) float adaaScratch[VT2WKernels::adaaScratchSize(kChunkSize)];
+  std::vector<float> wetValues;      // チャンネル x kChunkSize
+  std::vector<float> envelopeValues; // チャンネル x kChunkSize
+};
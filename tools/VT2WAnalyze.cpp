@@ -0,0 +1,1159 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Quality / Cost Analyzer
+
+    使い方:
+      EA_VT_2W_Analyze [--quick] [--rate <Hz>] [--drives <d,d,...>]
+                       [--mix <0-100>] [--model <モデル>] [--isa <名前>]
+                       [--seconds <秒>] [--csv <パス>] [--json <パス>]
+                       [--max-alias <dBc>] [--max-thd-error <dB>]
+                       [--max-imd-error <dB>] [--max-transient <dB>]
+
+    --rate          サンプルレート (既定 48000)
+    --drives        解析する Drive (既定 1,2.5,5,7.5,10、--quick は 2.5,10)
+    --mix           Mix (既定 100。Dry が混ざると歪みが薄まる)
+    --model         white / black / all (既定は all)
+    --isa           scalar / sse2 / avx2 / avx512 / neon / all
+                    (既定は自動選択のカーネルだけ。all は対応する全カーネル)
+    --seconds       負荷の計測 1 回で処理する長さ (既定 0.25、--quick は 0.1)
+    --csv / --json  結果を書き出すファイル (- で標準出力。表は出さない)
+    --max-*         品質の基準 (既定 -60dBc / 1dB / 1dB / -30dB)
+
+    品質と処理コストの組み合わせを全て並べ、用途毎に基準を満たす最も安い
+    設定を選べるようにする。構成はモデル x 品質 x カーネル x 倍率 x
+    フィルター x ADAA (Black は品質・ADAA を持たないので倍率とフィルター
+    だけ)。各構成を Drive 毎に解析し、次の値を出す:
+
+      thd        1kHz のサイン (-3dBFS) の倍音 (ナイキスト未満の整数倍) の
+                 基本波比
+      alias      5kHz のサイン (-1dBFS) の、ナイキストを超えた倍音が
+                 折り返したビンのエネルギーの基本波比。FFT のビンにちょうど
+                 乗る奇数ビンの周期信号なので、整数倍以外のビンは全て
+                 折り返しとみなせる
+      imd        SMPTE (60Hz + 7kHz、4:1、ピーク -1dBFS) の 7kHz の両側
+                 4 本ずつの側帯波の、7kHz に対する比
+      transient  ドラム風のバースト (減衰するサイン + クリック) の
+                 リファレンスとの差 (20kHz まで) のエネルギー比と最大値
+                 (dBFS)。レイテンシの端数は分数遅延で揃え、そのずれは
+                 CSV / JSON の transient_delay に出す。IIR の位相の
+                 ずれや ADAA の高域減衰もここに入る
+
+    リファレンスは、入力を周波数領域で 4 倍のレートに補間して同じモデルを
+    double・Reference 品質・8x FIR (直線位相) で処理し、元の帯域に
+    ブリックウォールで制限して戻したもの (内部 32 倍で、折り返しも
+    ハーフバンドの遷移帯も元の帯域に残らない。表の ideal の行)。
+    thd / imd の error はリファレンスとの差 (dB)。同じ処理を基本レートで
+    行ったものも double の行として載る。
+
+    ns/sample はステレオ 48kHz 相当 (--rate) / ブロック 256 / Drive 5 の
+    サンプルフレームあたりの処理時間 (このマシンでの実測、3 回の最良値)。
+    最後に、モデルと Drive 毎に全ての基準を満たす最も安い構成を出す。
+  ==============================================================================
+*/
+
+#include "dsp/VT2WKernels.h"
+#include "dsp/VT2WWhiteEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// measureCost の結果の書き出し先
+volatile double keptAlive = 0.0;
+
+//==============================================================================
+struct QualityBar {
+  double maxAliasDbc = -60.0;
+  double maxThdErrorDb = 1.0;
+  double maxImdErrorDb = 1.0;
+  double maxTransientDb = -30.0;
+};
+
+struct AnalyzerOptions {
+  bool quick = false;
+  double sampleRate = 48000.0;
+  std::vector<float> drives;
+  float mix = 100.0f;
+  bool white = true;
+  bool black = true;
+  bool allIsas = false;
+  bool forceIsa = false;
+  VT2WKernelIsa isa = VT2WKernelIsa::Scalar;
+  double seconds = 0.25;
+  std::string csvPath;
+  std::string jsonPath;
+  QualityBar bar;
+};
+
+/** 解析する処理の構成 (Drive と Mix は解析毎に入れる) */
+struct AnalyzerConfig {
+  VT2WSettings settings;
+  VT2WKernelIsa isa = VT2WKernelIsa::Scalar;
+  bool usesKernel = false;      // SIMD カーネルの経路か
+  bool doublePrecision = false; // process(double*) で処理する
+};
+
+constexpr int kBlockSize = 256;
+constexpr int kRepeats = 3;
+const double kTwoPi = 6.283185307179586;
+
+const VT2WKernelIsa kAllIsas[] = {VT2WKernelIsa::Scalar, VT2WKernelIsa::SSE2,
+                                  VT2WKernelIsa::AVX2, VT2WKernelIsa::AVX512,
+                                  VT2WKernelIsa::NEON};
+
+bool parseIsa(const std::string &name, VT2WKernelIsa &isa) {
+  const std::pair<const char *, VT2WKernelIsa> names[] = {
+      {"scalar", VT2WKernelIsa::Scalar}, {"sse2", VT2WKernelIsa::SSE2},
+      {"avx2", VT2WKernelIsa::AVX2},     {"avx512", VT2WKernelIsa::AVX512},
+      {"neon", VT2WKernelIsa::NEON}};
+
+  for (const auto &entry : names)
+    if (name == entry.first) {
+      isa = entry.second;
+      return true;
+    }
+
+  return false;
+}
+
+/** "1,2.5,10" を Drive の列にする (0-10 に丸める) */
+bool parseDrives(const std::string &list, std::vector<float> &drives) {
+  drives.clear();
+  const char *p = list.c_str();
+  while (*p != '\0') {
+    char *end = nullptr;
+    const double value = std::strtod(p, &end);
+    if (end == p)
+      return false;
+    drives.push_back(std::clamp((float)value, 0.0f, 10.0f));
+    p = *end == ',' ? end + 1 : end;
+  }
+  return !drives.empty();
+}
+
+AnalyzerOptions parseOptions(int argc, char **argv) {
+  AnalyzerOptions options;
+  bool drivesGiven = false;
+  bool secondsGiven = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--quick")
+      options.quick = true;
+    else if (arg == "--rate" && i + 1 < argc)
+      options.sampleRate = std::clamp(std::atof(argv[++i]), 22050.0, 192000.0);
+    else if (arg == "--drives" && i + 1 < argc &&
+             parseDrives(argv[i + 1], options.drives)) {
+      drivesGiven = true;
+      ++i;
+    } else if (arg == "--mix" && i + 1 < argc)
+      options.mix = std::clamp((float)std::atof(argv[++i]), 0.0f, 100.0f);
+    else if (arg == "--model" && i + 1 < argc) {
+      const std::string name = argv[++i];
+      if (name != "white" && name != "black" && name != "all") {
+        std::fprintf(stderr, "unknown model: %s\n", name.c_str());
+        std::exit(2);
+      }
+      options.white = name != "black";
+      options.black = name != "white";
+    } else if (arg == "--isa" && i + 1 < argc) {
+      const std::string name = argv[++i];
+      if (name == "all")
+        options.allIsas = true;
+      else if (parseIsa(name, options.isa))
+        options.forceIsa = true;
+      else {
+        std::fprintf(stderr, "unknown isa: %s\n", name.c_str());
+        std::exit(2);
+      }
+    } else if (arg == "--seconds" && i + 1 < argc) {
+      options.seconds = std::max(0.01, std::atof(argv[++i]));
+      secondsGiven = true;
+    } else if (arg == "--csv" && i + 1 < argc)
+      options.csvPath = argv[++i];
+    else if (arg == "--json" && i + 1 < argc)
+      options.jsonPath = argv[++i];
+    else if (arg == "--max-alias" && i + 1 < argc)
+      options.bar.maxAliasDbc = std::atof(argv[++i]);
+    else if (arg == "--max-thd-error" && i + 1 < argc)
+      options.bar.maxThdErrorDb = std::atof(argv[++i]);
+    else if (arg == "--max-imd-error" && i + 1 < argc)
+      options.bar.maxImdErrorDb = std::atof(argv[++i]);
+    else if (arg == "--max-transient" && i + 1 < argc)
+      options.bar.maxTransientDb = std::atof(argv[++i]);
+    else {
+      std::fprintf(
+          stderr,
+          "usage: %s [--quick] [--rate <Hz>] [--drives <d,d,...>] "
+          "[--mix <0-100>] [--model white|black|all] [--isa <name>|all] "
+          "[--seconds <seconds>] [--csv <path>] [--json <path>] "
+          "[--max-alias <dBc>] [--max-thd-error <dB>] "
+          "[--max-imd-error <dB>] [--max-transient <dB>]\n",
+          argv[0]);
+      std::exit(2);
+    }
+  }
+
+  if (options.forceIsa && !VT2WKernels::isSupported(options.isa)) {
+    std::fprintf(stderr, "kernel %s is not supported on this CPU\n",
+                 VT2WKernels::getName(options.isa));
+    std::exit(2);
+  }
+
+  if (!drivesGiven)
+    options.drives = options.quick ? std::vector<float>{2.5f, 10.0f}
+                                   : std::vector<float>{1.0f, 2.5f, 5.0f,
+                                                        7.5f, 10.0f};
+  if (options.quick && !secondsGiven)
+    options.seconds = 0.1;
+
+  return options;
+}
+
+//==============================================================================
+// 構成の列挙
+
+const char *getFilterName(VT2WOversamplingFilter filter) {
+  return filter == VT2WOversamplingFilter::LinearPhaseFIR ? "fir" : "iir";
+}
+
+const char *getModelName(VT2WModel model) {
+  return model == VT2WModel::White ? "white" : "black";
+}
+
+const char *getModelName(const AnalyzerConfig &config) {
+  return getModelName(config.settings.model);
+}
+
+const char *getQualityName(const AnalyzerConfig &config) {
+  switch (config.settings.quality) {
+  case VT2WSaturationQuality::Eco:
+    return "eco";
+  case VT2WSaturationQuality::Standard:
+    return "standard";
+  case VT2WSaturationQuality::Reference:
+    break;
+  }
+  return "reference";
+}
+
+/** 処理の経路 (カーネル名。Reference 品質・Black・double はリファレンス) */
+const char *getPathName(const AnalyzerConfig &config) {
+  if (config.doublePrecision)
+    return "double";
+  return config.usesKernel ? VT2WKernels::getName(config.isa) : "reference";
+}
+
+std::string getLabel(const AnalyzerConfig &config) {
+  std::string label = getModelName(config);
+  if (config.settings.model == VT2WModel::White)
+    label += std::string(" ") + getQualityName(config);
+  label += " " + std::to_string(1 << config.settings.oversamplingLog2) + "x";
+  if (config.settings.oversamplingLog2 > 0)
+    label += std::string(" ") +
+             getFilterName(config.settings.oversamplingFilter);
+  if (config.settings.adaa)
+    label += " adaa";
+  return label;
+}
+
+/** 比較の基準: double・Reference 品質・8x FIR */
+AnalyzerConfig makeReferenceConfig(VT2WModel model) {
+  AnalyzerConfig config;
+  config.settings.model = model;
+  config.settings.quality = VT2WSaturationQuality::Reference;
+  config.settings.oversamplingLog2 = 3;
+  config.settings.oversamplingFilter = VT2WOversamplingFilter::LinearPhaseFIR;
+  config.settings.adaa = false;
+  config.doublePrecision = true;
+  return config;
+}
+
+std::vector<AnalyzerConfig> makeConfigs(VT2WModel model,
+                                        const AnalyzerOptions &options) {
+  struct Oversampling {
+    int factorLog2;
+    VT2WOversamplingFilter filter;
+  };
+
+  const Oversampling oversamplings[] = {
+      {0, VT2WOversamplingFilter::PolyphaseIIR},
+      {1, VT2WOversamplingFilter::PolyphaseIIR},
+      {2, VT2WOversamplingFilter::PolyphaseIIR},
+      {3, VT2WOversamplingFilter::PolyphaseIIR},
+      {1, VT2WOversamplingFilter::LinearPhaseFIR},
+      {2, VT2WOversamplingFilter::LinearPhaseFIR},
+      {3, VT2WOversamplingFilter::LinearPhaseFIR}};
+
+  // SIMD カーネルの経路で比べるカーネル (Scalar はリファレンス経路なので除く)
+  std::vector<VT2WKernelIsa> isas;
+  if (options.allIsas) {
+    for (auto isa : kAllIsas)
+      if (isa != VT2WKernelIsa::Scalar && VT2WKernels::isSupported(isa))
+        isas.push_back(isa);
+  } else if (options.forceIsa) {
+    if (options.isa != VT2WKernelIsa::Scalar)
+      isas.push_back(options.isa);
+  } else if (const auto *best = VT2WKernels::getBestAvailable()) {
+    isas.push_back(best->isa);
+  }
+
+  std::vector<AnalyzerConfig> configs;
+  auto add = [&](VT2WSaturationQuality quality, VT2WKernelIsa isa,
+                 bool usesKernel) {
+    for (const auto &oversampling : oversamplings)
+      for (bool adaa : {false, true}) {
+        if (adaa && !VT2WModels::supportsAdaa(model))
+          continue;
+
+        AnalyzerConfig config;
+        config.settings.model = model;
+        config.settings.quality = quality;
+        config.settings.oversamplingLog2 = oversampling.factorLog2;
+        config.settings.oversamplingFilter = oversampling.filter;
+        config.settings.adaa = adaa;
+        config.isa = isa;
+        config.usesKernel = usesKernel;
+        configs.push_back(config);
+      }
+  };
+
+  // Black はカーネルを持たず、品質に依らずリファレンス経路
+  if (model == VT2WModel::White)
+    for (auto quality :
+         {VT2WSaturationQuality::Eco, VT2WSaturationQuality::Standard})
+      for (auto isa : isas)
+        add(quality, isa, true);
+  add(VT2WSaturationQuality::Reference, VT2WKernelIsa::Scalar, false);
+
+  configs.push_back(makeReferenceConfig(model));
+  return configs;
+}
+
+//==============================================================================
+// 処理
+
+/**
+ * モノラルの input を構成で処理し、レイテンシを除いて入力に揃えた出力を返す
+ * (末尾はレイテンシ分の無音を足して処理する)
+ */
+template <typename Sample>
+std::vector<double> render(const AnalyzerConfig &config, float drive,
+                           float mix, double sampleRate,
+                           const std::vector<double> &input) {
+  VT2WWhiteEngine engine;
+  if (config.usesKernel)
+    engine.setKernel(config.isa);
+  auto settings = config.settings;
+  settings.drive = drive;
+  settings.mix = mix;
+  engine.applySettings(settings); // prepare の前なのでランプ無しで始まる
+  engine.setSleepEnabled(false);
+  engine.prepare(sampleRate, kBlockSize, 1);
+
+  const int latency = engine.getLatencySamples();
+  std::vector<Sample> audio(input.size() + latency, Sample(0));
+  std::copy(input.begin(), input.end(), audio.begin());
+
+  const int numSamples = (int)audio.size();
+  for (int pos = 0; pos < numSamples; pos += kBlockSize) {
+    Sample *channel = audio.data() + pos;
+    engine.process(&channel, 1, std::min(kBlockSize, numSamples - pos));
+  }
+
+  return std::vector<double>(audio.begin() + latency, audio.end());
+}
+
+std::vector<double> render(const AnalyzerConfig &config, float drive,
+                           float mix, double sampleRate,
+                           const std::vector<double> &input) {
+  if (config.doublePrecision)
+    return render<double>(config, drive, mix, sampleRate, input);
+  return render<float>(config, drive, mix, sampleRate, input);
+}
+
+/** 負荷: ステレオ / ブロック 256 / Drive 5 の ns/sample (最良値) */
+template <typename Sample>
+double measureCost(const AnalyzerConfig &config,
+                   const AnalyzerOptions &options) {
+  const int numSamples =
+      std::max(kBlockSize, int(options.sampleRate * options.seconds));
+
+  // ベンチマークと同じ 100Hz + 3kHz + 薄いノイズ
+  std::vector<std::vector<Sample>> source(2, std::vector<Sample>(numSamples));
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<double> noise(-0.05, 0.05);
+  for (int ch = 0; ch < 2; ++ch)
+    for (int i = 0; i < numSamples; ++i) {
+      const double t = i / options.sampleRate;
+      source[ch][i] = Sample(0.5 * std::sin(kTwoPi * 100.0 * t + ch) +
+                             0.2 * std::sin(kTwoPi * 3000.0 * t) + noise(rng));
+    }
+
+  double bestSeconds = 1.0e30;
+  double sink = 0.0;
+
+  for (int repeat = 0; repeat < kRepeats; ++repeat) {
+    auto work = source;
+
+    VT2WWhiteEngine engine;
+    if (config.usesKernel)
+      engine.setKernel(config.isa);
+    auto settings = config.settings;
+    settings.drive = 5.0f;
+    settings.mix = options.mix;
+    engine.applySettings(settings);
+    engine.prepare(options.sampleRate, kBlockSize, 2);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int pos = 0; pos < numSamples; pos += kBlockSize) {
+      Sample *channels[] = {work[0].data() + pos, work[1].data() + pos};
+      engine.process(channels, 2, std::min(kBlockSize, numSamples - pos));
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    bestSeconds = std::min(
+        bestSeconds, std::chrono::duration<double>(end - start).count());
+    sink += double(work[0][numSamples - 1]);
+  }
+
+  keptAlive = sink; // 最適化で処理が消えないようにする
+
+  return bestSeconds * 1.0e9 / numSamples;
+}
+
+double measureCost(const AnalyzerConfig &config,
+                   const AnalyzerOptions &options) {
+  if (config.doublePrecision)
+    return measureCost<double>(config, options);
+  return measureCost<float>(config, options);
+}
+
+//==============================================================================
+// 解析
+
+/** 2 のべき乗長の in-place FFT (基数 2、計測用なので素朴な実装) */
+void fft(std::vector<double> &re, std::vector<double> &im) {
+  const size_t n = re.size();
+
+  for (size_t i = 1, j = 0; i < n; ++i) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      std::swap(re[i], re[j]);
+      std::swap(im[i], im[j]);
+    }
+  }
+
+  for (size_t length = 2; length <= n; length <<= 1) {
+    const double angle = -kTwoPi / double(length);
+    for (size_t i = 0; i < n; i += length)
+      for (size_t k = 0; k < length / 2; ++k) {
+        const double wr = std::cos(angle * double(k));
+        const double wi = std::sin(angle * double(k));
+        const size_t a = i + k, b = a + length / 2;
+        const double tr = re[b] * wr - im[b] * wi;
+        const double ti = re[b] * wi + im[b] * wr;
+        re[b] = re[a] - tr;
+        im[b] = im[a] - ti;
+        re[a] += tr;
+        im[a] += ti;
+      }
+  }
+}
+
+double toDb(double powerRatio) {
+  return 10.0 * std::log10(std::max(powerRatio, 1.0e-30));
+}
+
+/**
+ * 周期信号の解析
+ * 周期 (FFT 長) はサンプルレートに比例させ、エンベロープとフィルターが
+ * 定常になるよう kSettlePeriods 周期処理した後の 1 周期を解析する。
+ * 周期信号なので窓は要らない。最後の 1 周期はリニアフェーズ FIR の
+ * 先読みの分で、解析しない。
+ */
+class PeriodicAnalysis {
+public:
+  static constexpr int kSettlePeriods = 2;
+
+  explicit PeriodicAnalysis(double rate) : sampleRate(rate) {
+    while (fftSize < 16384.0 * rate / 48000.0)
+      fftSize *= 2;
+  }
+
+  int getFftSize() const { return fftSize; }
+
+  /** frequency に最も近い奇数ビン (倍音の折り返しが倍音と重ならない) */
+  int getBin(double frequency) const {
+    return (int)std::lround(frequency * fftSize / sampleRate) | 1;
+  }
+
+  /** 周期 fftSize の信号を kSettlePeriods + 2 周期分作る */
+  template <typename Generator>
+  std::vector<double> makeSignal(Generator &&generator) const {
+    std::vector<double> signal((size_t)fftSize * (kSettlePeriods + 2));
+    for (size_t i = 0; i < signal.size(); ++i)
+      signal[i] = generator(kTwoPi * double(i % fftSize) / fftSize);
+    return signal;
+  }
+
+  /** 出力の解析区間のパワースペクトル (ビン 0 .. fftSize / 2) */
+  std::vector<double> getPowerSpectrum(const std::vector<double> &y) const {
+    const auto begin = y.begin() + (size_t)fftSize * kSettlePeriods;
+    std::vector<double> re(begin, begin + fftSize);
+    std::vector<double> im(fftSize, 0.0);
+    fft(re, im);
+
+    std::vector<double> power(fftSize / 2 + 1);
+    for (size_t k = 0; k < power.size(); ++k)
+      power[k] = re[k] * re[k] + im[k] * im[k];
+    return power;
+  }
+
+private:
+  int fftSize = 1024;
+  double sampleRate = 48000.0;
+};
+
+/** 倍音 (ナイキスト未満の整数倍、基本波を除く) の基本波比 */
+double measureThd(const std::vector<double> &power, int bin) {
+  double harmonics = 0.0;
+  for (size_t k = 2 * (size_t)bin; k < power.size(); k += bin)
+    harmonics += power[k];
+  return toDb(harmonics / power[bin]);
+}
+
+/** 整数倍以外のビン (ナイキストを超えた倍音の折り返し) の基本波比 */
+double measureAliasing(const std::vector<double> &power, int bin) {
+  double aliases = 0.0;
+  for (size_t k = 1; k < power.size(); ++k)
+    if (k % bin != 0)
+      aliases += power[k];
+  return toDb(aliases / power[bin]);
+}
+
+/** high の両側 4 本ずつの側帯波 (high ± n low) の high に対する比 */
+double measureImd(const std::vector<double> &power, int low, int high) {
+  double sidebands = 0.0;
+  for (int n = 1; n <= 4; ++n) {
+    sidebands += power[high + n * low];
+    if (high - n * low > 0)
+      sidebands += power[high - n * low];
+  }
+  return toDb(sidebands / power[high]);
+}
+
+/**
+ * 長さ n (2 のべき乗) の信号を周波数領域で長さ m (2 のべき乗) に変える
+ * (m / n 倍のレート)。両方のナイキスト未満のビンだけを残すので、理想的な
+ * (ブリックウォールの) 補間・帯域制限になる。逆 FFT は共役で FFT を使う。
+ */
+std::vector<double> changeRate(const std::vector<double> &x, size_t m) {
+  const size_t n = x.size();
+  std::vector<double> re(x), im(n, 0.0);
+  fft(re, im);
+
+  std::vector<double> outRe(m, 0.0), outIm(m, 0.0);
+  outRe[0] = re[0];
+  for (size_t k = 1; k < std::min(n, m) / 2; ++k) {
+    outRe[k] = re[k];
+    outIm[k] = -im[k];
+    outRe[m - k] = re[n - k];
+    outIm[m - k] = -im[n - k];
+  }
+
+  // 振幅はレートを変えても同じ (m / n 倍して逆 FFT の 1 / m)
+  fft(outRe, outIm);
+  for (auto &y : outRe)
+    y /= double(n);
+  return outRe;
+}
+
+size_t getPowerOfTwoAtLeast(size_t length) {
+  size_t n = 1;
+  while (n < length)
+    n *= 2;
+  return n;
+}
+
+/**
+ * ドラム風のバースト (0.25 秒毎、強さを変える)
+ * 前後に無音を置き、リファレンスの周波数領域の補間が端で回り込まないように
+ * する。
+ */
+std::vector<double> makeTransientSignal(double sampleRate) {
+  const int period = int(0.25 * sampleRate);
+  const int lead = int(0.05 * sampleRate);
+  const double levels[] = {1.0, 0.3, 0.7, 0.5};
+  std::vector<double> signal(size_t(lead + 4 * period + 0.1 * sampleRate),
+                             0.0);
+
+  std::mt19937 rng(4321);
+  std::uniform_real_distribution<double> noise(-1.0, 1.0);
+
+  for (int burst = 0; burst < 4; ++burst)
+    for (int i = 0; i < period; ++i) {
+      const double t = i / sampleRate;
+      // 140Hz から 50Hz へ下がる減衰サイン + 2ms で消えるクリック
+      const double frequency = 50.0 + 90.0 * std::exp(-t / 0.03);
+      const double body = std::sin(kTwoPi * frequency * t) *
+                          std::exp(-t / 0.08);
+      const double click = noise(rng) * std::exp(-t / 0.002);
+      signal[(size_t)(lead + burst * period + i)] =
+          levels[burst] * (0.8 * body + 0.2 * click);
+    }
+
+  return signal;
+}
+
+//==============================================================================
+/**
+ * トランジェントの比較
+ * レイテンシは整数サンプルなので、IIR の群遅延や ADAA の半サンプルの
+ * 端数がそのまま差に出てしまう。リファレンスを分数遅延 (±kMaxDelay
+ * サンプル) でずらし、差が最小になる位置で比べる (ずれ自体は別に出す)。
+ * ずらすのは周波数領域で e^{-jωd} を掛けて行い、差のエネルギーは
+ * パーセバルの等式で周波数領域のまま求める。
+ * 比べるのは可聴帯域 (20kHz、0.45 fs まで) だけ。その上はハーフバンド
+ * フィルターの遷移帯で、倍率やフィルターの違いがそのまま出てしまう。
+ */
+class TransientComparison {
+public:
+  static constexpr double kMaxDelay = 2.0;
+
+  TransientComparison(const std::vector<double> &reference, double sampleRate)
+      : length(reference.size()),
+        fftSize(getPowerOfTwoAtLeast(2 * reference.size())) {
+    transform(reference, referenceRe, referenceIm);
+    const double cutoff = std::min(20000.0, 0.45 * sampleRate);
+    numBins = size_t(cutoff / sampleRate * double(fftSize)) + 1;
+
+    referenceEnergy =
+        getEnergy(referenceRe, referenceIm, nullptr, nullptr, 0.0);
+  }
+
+  struct Result {
+    double errorDb; // 差のエネルギー / リファレンスのエネルギー
+    double peakDb;  // 差の最大値 (dBFS)
+    double delay;   // リファレンスに対する遅れ (サンプル)
+  };
+
+  Result compare(const std::vector<double> &y) const {
+    std::vector<double> re, im;
+    transform(y, re, im);
+
+    // 1/8 サンプル毎に探し、最小の周りを 1/256 サンプル毎に詰める
+    double bestDelay = 0.0;
+    double bestError = getEnergy(re, im, &referenceRe, &referenceIm, 0.0);
+    auto search = [&](double from, double to, double step) {
+      for (double delay = from; delay <= to + 0.5 * step; delay += step) {
+        const double error =
+            getEnergy(re, im, &referenceRe, &referenceIm, delay);
+        if (error < bestError) {
+          bestError = error;
+          bestDelay = delay;
+        }
+      }
+    };
+    search(-kMaxDelay, kMaxDelay, 1.0 / 8.0);
+    search(bestDelay - 1.0 / 8.0, bestDelay + 1.0 / 8.0, 1.0 / 256.0);
+
+    // 最大値は可聴帯域の差を時間領域に戻して求める
+    double peak = 0.0;
+    for (double error : getErrorSignal(re, im, bestDelay))
+      peak = std::max(peak, std::abs(error));
+
+    Result result;
+    result.errorDb = toDb(bestError / std::max(referenceEnergy, 1.0e-30));
+    result.peakDb = toDb(peak * peak);
+    result.delay = bestDelay;
+    return result;
+  }
+
+private:
+  void transform(const std::vector<double> &x, std::vector<double> &re,
+                 std::vector<double> &im) const {
+    re.assign(fftSize, 0.0);
+    im.assign(fftSize, 0.0);
+    std::copy(x.begin(), x.begin() + std::min(length, x.size()), re.begin());
+    fft(re, im);
+  }
+
+  /**
+   * 可聴帯域のビンの (re, im) - (subRe, subIm) e^{-jωd} のエネルギー
+   * (sub が nullptr ならそのまま)。実信号なので正の周波数だけを 2 倍して
+   * 足す。e^{-jωd} はビン毎に回転を掛けて進める。
+   */
+  double getEnergy(const std::vector<double> &re, const std::vector<double> &im,
+                   const std::vector<double> *subRe,
+                   const std::vector<double> *subIm, double delay) const {
+    const double angle = -kTwoPi * delay / double(fftSize);
+    const double stepRe = std::cos(angle), stepIm = std::sin(angle);
+    double rotationRe = 1.0, rotationIm = 0.0;
+    double energy = 0.0;
+
+    for (size_t k = 0; k < numBins; ++k) {
+      double dr = re[k], di = im[k];
+      if (subRe) {
+        dr -= (*subRe)[k] * rotationRe - (*subIm)[k] * rotationIm;
+        di -= (*subRe)[k] * rotationIm + (*subIm)[k] * rotationRe;
+      }
+      energy += (k == 0 ? 1.0 : 2.0) * (dr * dr + di * di);
+
+      const double nextRe = rotationRe * stepRe - rotationIm * stepIm;
+      rotationIm = rotationRe * stepIm + rotationIm * stepRe;
+      rotationRe = nextRe;
+    }
+
+    return energy / double(fftSize);
+  }
+
+  /** 可聴帯域の差の時間信号 (逆 FFT は共役で FFT を使う) */
+  std::vector<double> getErrorSignal(const std::vector<double> &re,
+                                     const std::vector<double> &im,
+                                     double delay) const {
+    std::vector<double> errorRe(fftSize, 0.0), errorIm(fftSize, 0.0);
+    for (size_t k = 0; k < numBins; ++k) {
+      const double angle = -kTwoPi * delay * double(k) / double(fftSize);
+      const double c = std::cos(angle), s = std::sin(angle);
+      const double dr = re[k] - (referenceRe[k] * c - referenceIm[k] * s);
+      const double di = im[k] - (referenceRe[k] * s + referenceIm[k] * c);
+      errorRe[k] = dr;
+      errorIm[k] = -di;
+      if (k > 0) {
+        errorRe[fftSize - k] = dr;
+        errorIm[fftSize - k] = di;
+      }
+    }
+
+    fft(errorRe, errorIm);
+    errorRe.resize(length);
+    for (auto &x : errorRe)
+      x /= double(fftSize);
+    return errorRe;
+  }
+
+  size_t length = 0;
+  size_t fftSize = 0;
+  size_t numBins = 0;
+  std::vector<double> referenceRe, referenceIm;
+  double referenceEnergy = 0.0;
+};
+
+struct ReferenceMetrics {
+  double thdDb = 0.0;
+  double aliasDbc = 0.0; // リファレンス自体の折り返し (確認用)
+  double imdDb = 0.0;
+  std::unique_ptr<TransientComparison> transient;
+};
+
+/** リファレンス自体の値 (表と JSON で確認用に出す) */
+struct ReferenceRow {
+  VT2WModel model = VT2WModel::White;
+  float drive = 0.0f;
+  double thdDb = 0.0;
+  double aliasDbc = 0.0;
+  double imdDb = 0.0;
+};
+
+struct AnalysisRow {
+  const AnalyzerConfig *config = nullptr;
+  float drive = 0.0f;
+  int latency = 0;
+  double nsPerSample = 0.0;
+  double thdDb = 0.0;
+  double thdErrorDb = 0.0;
+  double aliasDbc = 0.0;
+  double imdDb = 0.0;
+  double imdErrorDb = 0.0;
+  double transientDb = 0.0;     // 差のエネルギー / リファレンスのエネルギー
+  double transientPeakDb = 0.0; // 差の最大値 (dBFS)
+  double transientDelay = 0.0;  // リファレンスに対する端数の遅れ (サンプル)
+  bool meetsBar = false;
+};
+
+class Analyzer {
+public:
+  /** リファレンスを処理するレート (基本レートの倍数) */
+  static constexpr int kReferenceRateFactor = 4;
+
+  explicit Analyzer(const AnalyzerOptions &analyzerOptions)
+      : options(analyzerOptions), periodic(analyzerOptions.sampleRate) {
+    thdBin = periodic.getBin(1000.0);
+    aliasBin = periodic.getBin(5000.0);
+    imdLow = periodic.getBin(60.0);
+    imdHigh = periodic.getBin(7000.0);
+    if (imdHigh % imdLow == 0) // 側帯波が低域の倍音と重ならないように
+      imdHigh += 2;
+
+    const double thdLevel = std::pow(10.0, -3.0 / 20.0);
+    const double fullLevel = std::pow(10.0, -1.0 / 20.0);
+    const double thd = double(thdBin), alias = double(aliasBin);
+    const double low = double(imdLow), high = double(imdHigh);
+
+    thdSignal = periodic.makeSignal(
+        [&](double phase) { return thdLevel * std::sin(thd * phase); });
+    aliasSignal = periodic.makeSignal(
+        [&](double phase) { return fullLevel * std::sin(alias * phase); });
+    imdSignal = periodic.makeSignal([&](double phase) {
+      return fullLevel * (0.8 * std::sin(low * phase) +
+                          0.2 * std::sin(high * phase));
+    });
+    transientSignal = makeTransientSignal(options.sampleRate);
+  }
+
+  double getBinFrequency(int bin) const {
+    return bin * options.sampleRate / periodic.getFftSize();
+  }
+  int getThdBin() const { return thdBin; }
+  int getAliasBin() const { return aliasBin; }
+  int getImdLowBin() const { return imdLow; }
+  int getImdHighBin() const { return imdHigh; }
+
+  ReferenceMetrics analyzeReference(VT2WModel model, float drive) const {
+    ReferenceMetrics reference;
+    reference.thdDb = measureThd(
+        periodic.getPowerSpectrum(renderIdeal(model, drive, thdSignal)),
+        thdBin);
+    reference.aliasDbc = measureAliasing(
+        periodic.getPowerSpectrum(renderIdeal(model, drive, aliasSignal)),
+        aliasBin);
+    reference.imdDb = measureImd(
+        periodic.getPowerSpectrum(renderIdeal(model, drive, imdSignal)),
+        imdLow, imdHigh);
+    reference.transient = std::make_unique<TransientComparison>(
+        renderIdeal(model, drive, transientSignal), options.sampleRate);
+    return reference;
+  }
+
+  AnalysisRow analyze(const AnalyzerConfig &config, float drive,
+                      const ReferenceMetrics &reference) const {
+    AnalysisRow row;
+    row.config = &config;
+    row.drive = drive;
+
+    const auto thd = renderAtBaseRate(config, drive, thdSignal);
+    row.thdDb = measureThd(periodic.getPowerSpectrum(thd), thdBin);
+    row.thdErrorDb = row.thdDb - reference.thdDb;
+
+    const auto alias = renderAtBaseRate(config, drive, aliasSignal);
+    row.aliasDbc = measureAliasing(periodic.getPowerSpectrum(alias), aliasBin);
+
+    const auto imd = renderAtBaseRate(config, drive, imdSignal);
+    row.imdDb = measureImd(periodic.getPowerSpectrum(imd), imdLow, imdHigh);
+    row.imdErrorDb = row.imdDb - reference.imdDb;
+
+    const auto transient = reference.transient->compare(
+        renderAtBaseRate(config, drive, transientSignal));
+    row.transientDb = transient.errorDb;
+    row.transientPeakDb = transient.peakDb;
+    row.transientDelay = transient.delay;
+
+    const auto &bar = options.bar;
+    row.meetsBar = row.aliasDbc <= bar.maxAliasDbc &&
+                   std::abs(row.thdErrorDb) <= bar.maxThdErrorDb &&
+                   std::abs(row.imdErrorDb) <= bar.maxImdErrorDb &&
+                   row.transientDb <= bar.maxTransientDb;
+    return row;
+  }
+
+private:
+  std::vector<double> renderAtBaseRate(const AnalyzerConfig &config,
+                                       float drive,
+                                       const std::vector<double> &input) const {
+    return render(config, drive, options.mix, options.sampleRate, input);
+  }
+
+  /**
+   * リファレンス: 入力を周波数領域で kReferenceRateFactor 倍のレートに
+   * 補間し、double・Reference 品質・8x FIR で処理して、元の帯域に
+   * ブリックウォールで制限して戻す。内部レートは 32 倍になり、
+   * 元の帯域に折り返す倍音もハーフバンドの遷移帯も残らない。
+   */
+  std::vector<double> renderIdeal(VT2WModel model, float drive,
+                                  const std::vector<double> &input) const {
+    const size_t n = getPowerOfTwoAtLeast(input.size());
+    std::vector<double> padded(input);
+    padded.resize(n, 0.0);
+
+    const auto output =
+        render(makeReferenceConfig(model), drive, options.mix,
+               options.sampleRate * kReferenceRateFactor,
+               changeRate(padded, n * kReferenceRateFactor));
+
+    auto result = changeRate(output, n);
+    result.resize(input.size());
+    return result;
+  }
+
+  const AnalyzerOptions &options;
+  PeriodicAnalysis periodic;
+  int thdBin = 0, aliasBin = 0, imdLow = 0, imdHigh = 0;
+  std::vector<double> thdSignal, aliasSignal, imdSignal, transientSignal;
+};
+
+//==============================================================================
+// 出力
+
+void printHeader() {
+  std::printf("%-26s %-9s %5s %7s %9s %8s %7s %8s %7s %8s %8s %4s\n",
+              "config", "path", "drive", "latency", "ns/sample", "thd dB",
+              "err dB", "alias", "imd dB", "err dB", "trans dB", "bar");
+}
+
+void printReference(const ReferenceRow &reference) {
+  const std::string label =
+      std::string(getModelName(reference.model)) + " (reference)";
+  std::printf("%-26s %-9s %5.1f %7s %9s %8.1f %7s %8.1f %7.1f %8s %8s %4s\n",
+              label.c_str(), "ideal", reference.drive, "-", "-",
+              reference.thdDb, "-", reference.aliasDbc, reference.imdDb, "-",
+              "-", "-");
+}
+
+void printRow(const AnalysisRow &row) {
+  std::printf("%-26s %-9s %5.1f %7d %9.2f %8.1f %7.2f %8.1f %7.1f %8.2f "
+              "%8.1f %4s\n",
+              getLabel(*row.config).c_str(), getPathName(*row.config),
+              row.drive, row.latency, row.nsPerSample, row.thdDb,
+              row.thdErrorDb, row.aliasDbc, row.imdDb, row.imdErrorDb,
+              row.transientDb, row.meetsBar ? "ok" : "-");
+  std::fflush(stdout);
+}
+
+/** "-" なら標準出力。閉じるのは呼び出し側 (closeOutput) */
+FILE *openOutput(const std::string &path) {
+  return path == "-" ? stdout : std::fopen(path.c_str(), "w");
+}
+
+void closeOutput(FILE *file) {
+  if (file != stdout)
+    std::fclose(file);
+}
+
+void writeCsv(FILE *file, const std::vector<AnalysisRow> &rows) {
+  std::fprintf(file, "model,quality,path,oversampling,filter,adaa,drive,"
+                     "latency,ns_per_sample,thd_db,thd_error_db,alias_dbc,"
+                     "imd_db,imd_error_db,transient_error_db,"
+                     "transient_peak_dbfs,transient_delay,meets_bar\n");
+
+  for (const auto &row : rows) {
+    const auto &settings = row.config->settings;
+    std::fprintf(file,
+                 "%s,%s,%s,%d,%s,%d,%.2f,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,"
+                 "%.3f,%.3f,%.4f,%d\n",
+                 getModelName(*row.config), getQualityName(*row.config),
+                 getPathName(*row.config), 1 << settings.oversamplingLog2,
+                 getFilterName(settings.oversamplingFilter), settings.adaa,
+                 row.drive, row.latency, row.nsPerSample, row.thdDb,
+                 row.thdErrorDb, row.aliasDbc, row.imdDb, row.imdErrorDb,
+                 row.transientDb, row.transientPeakDb, row.transientDelay,
+                 row.meetsBar);
+  }
+}
+
+void writeJson(FILE *file, const std::vector<AnalysisRow> &rows,
+               const std::vector<ReferenceRow> &references,
+               const AnalyzerOptions &options, const Analyzer &analyzer) {
+  const auto &bar = options.bar;
+  std::fprintf(file, "{\n");
+  std::fprintf(file, "  \"sample_rate\": %.0f,\n", options.sampleRate);
+  std::fprintf(file, "  \"mix\": %.1f,\n", options.mix);
+  std::fprintf(file,
+               "  \"signals\": {\"thd_hz\": %.2f, \"alias_hz\": %.2f, "
+               "\"imd_low_hz\": %.2f, \"imd_high_hz\": %.2f},\n",
+               analyzer.getBinFrequency(analyzer.getThdBin()),
+               analyzer.getBinFrequency(analyzer.getAliasBin()),
+               analyzer.getBinFrequency(analyzer.getImdLowBin()),
+               analyzer.getBinFrequency(analyzer.getImdHighBin()));
+  std::fprintf(file,
+               "  \"reference\": {\"precision\": \"double\", "
+               "\"quality\": \"reference\", \"oversampling\": 8, "
+               "\"filter\": \"fir\", \"rate_factor\": %d},\n",
+               Analyzer::kReferenceRateFactor);
+  std::fprintf(file, "  \"reference_metrics\": [\n");
+  for (size_t i = 0; i < references.size(); ++i) {
+    const auto &reference = references[i];
+    std::fprintf(file,
+                 "    {\"model\": \"%s\", \"drive\": %.2f, "
+                 "\"thd_db\": %.3f, \"alias_dbc\": %.3f, "
+                 "\"imd_db\": %.3f}%s\n",
+                 getModelName(reference.model),
+                 reference.drive, reference.thdDb, reference.aliasDbc,
+                 reference.imdDb, i + 1 < references.size() ? "," : "");
+  }
+  std::fprintf(file, "  ],\n");
+  std::fprintf(file,
+               "  \"quality_bar\": {\"max_alias_dbc\": %.2f, "
+               "\"max_thd_error_db\": %.2f, \"max_imd_error_db\": %.2f, "
+               "\"max_transient_db\": %.2f},\n",
+               bar.maxAliasDbc, bar.maxThdErrorDb, bar.maxImdErrorDb,
+               bar.maxTransientDb);
+  std::fprintf(file, "  \"results\": [\n");
+
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const auto &row = rows[i];
+    const auto &settings = row.config->settings;
+    std::fprintf(
+        file,
+        "    {\"model\": \"%s\", \"quality\": \"%s\", \"path\": \"%s\", "
+        "\"oversampling\": %d, \"filter\": \"%s\", \"adaa\": %s, "
+        "\"drive\": %.2f, \"latency\": %d, \"ns_per_sample\": %.3f, "
+        "\"thd_db\": %.3f, \"thd_error_db\": %.3f, \"alias_dbc\": %.3f, "
+        "\"imd_db\": %.3f, \"imd_error_db\": %.3f, "
+        "\"transient_error_db\": %.3f, \"transient_peak_dbfs\": %.3f, "
+        "\"transient_delay\": %.4f, \"meets_bar\": %s}%s\n",
+        getModelName(*row.config), getQualityName(*row.config),
+        getPathName(*row.config), 1 << settings.oversamplingLog2,
+        getFilterName(settings.oversamplingFilter),
+        settings.adaa ? "true" : "false", row.drive, row.latency,
+        row.nsPerSample, row.thdDb, row.thdErrorDb, row.aliasDbc, row.imdDb,
+        row.imdErrorDb, row.transientDb, row.transientPeakDb,
+        row.transientDelay, row.meetsBar ? "true" : "false",
+        i + 1 < rows.size() ? "," : "");
+  }
+
+  std::fprintf(file, "  ]\n}\n");
+}
+
+/** モデルと Drive 毎に、基準を満たす最も安い構成 */
+void printCheapest(const std::vector<AnalysisRow> &rows,
+                   const AnalyzerOptions &options) {
+  const auto &bar = options.bar;
+  std::printf("\ncheapest configuration within the bar (alias <= %.1f dBc, "
+              "|thd err| <= %.2f dB, |imd err| <= %.2f dB, "
+              "transient <= %.1f dB):\n",
+              bar.maxAliasDbc, bar.maxThdErrorDb, bar.maxImdErrorDb,
+              bar.maxTransientDb);
+  std::printf("%-6s %5s %-26s %-9s %9s %7s\n", "model", "drive", "config",
+              "path", "ns/sample", "latency");
+
+  for (auto model : {VT2WModel::White, VT2WModel::Black})
+    for (float drive : options.drives) {
+      const AnalysisRow *best = nullptr;
+      bool analyzed = false;
+      for (const auto &row : rows) {
+        if (row.config->settings.model != model || row.drive != drive)
+          continue;
+        analyzed = true;
+        if (row.meetsBar && (!best || row.nsPerSample < best->nsPerSample))
+          best = &row;
+      }
+
+      if (!analyzed)
+        continue;
+
+      const char *modelName = getModelName(model);
+      if (best)
+        std::printf("%-6s %5.1f %-26s %-9s %9.2f %7d\n", modelName, drive,
+                    getLabel(*best->config).c_str(),
+                    getPathName(*best->config), best->nsPerSample,
+                    best->latency);
+      else
+        std::printf("%-6s %5.1f (none)\n", modelName, drive);
+    }
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char **argv) {
+  const auto options = parseOptions(argc, argv);
+  const Analyzer analyzer(options);
+
+  // 表は CSV / JSON を標準出力に書く時は出さない
+  const bool table = options.csvPath != "-" && options.jsonPath != "-";
+
+  if (table) {
+    std::printf("%.0f Hz, mix %.0f%%, thd %.0f Hz, alias %.0f Hz, "
+                "imd %.1f + %.0f Hz, reference: double reference 8x fir at "
+                "%dx rate\n",
+                options.sampleRate, options.mix,
+                analyzer.getBinFrequency(analyzer.getThdBin()),
+                analyzer.getBinFrequency(analyzer.getAliasBin()),
+                analyzer.getBinFrequency(analyzer.getImdLowBin()),
+                analyzer.getBinFrequency(analyzer.getImdHighBin()),
+                Analyzer::kReferenceRateFactor);
+    printHeader();
+  }
+
+  std::vector<VT2WModel> models;
+  if (options.white)
+    models.push_back(VT2WModel::White);
+  if (options.black)
+    models.push_back(VT2WModel::Black);
+
+  // rows は configs の要素を指すので、全モデル分を先に作っておく
+  std::vector<std::vector<AnalyzerConfig>> configs;
+  for (auto model : models)
+    configs.push_back(makeConfigs(model, options));
+
+  std::vector<AnalysisRow> rows;
+  std::vector<ReferenceRow> references;
+  for (size_t m = 0; m < models.size(); ++m) {
+    std::vector<double> costs;
+    std::vector<int> latencies;
+    for (const auto &config : configs[m]) {
+      costs.push_back(measureCost(config, options));
+
+      VT2WWhiteEngine engine;
+      engine.applySettings(config.settings);
+      engine.prepare(options.sampleRate, kBlockSize, 1);
+      latencies.push_back(engine.getLatencySamples());
+    }
+
+    for (float drive : options.drives) {
+      const auto reference = analyzer.analyzeReference(models[m], drive);
+      references.push_back({models[m], drive, reference.thdDb,
+                            reference.aliasDbc, reference.imdDb});
+      if (table)
+        printReference(references.back());
+
+      for (size_t c = 0; c < configs[m].size(); ++c) {
+        auto row = analyzer.analyze(configs[m][c], drive, reference);
+        row.nsPerSample = costs[c];
+        row.latency = latencies[c];
+        if (table)
+          printRow(row);
+        rows.push_back(row);
+      }
+    }
+  }
+
+  if (table)
+    printCheapest(rows, options);
+
+  if (!options.csvPath.empty()) {
+    FILE *file = openOutput(options.csvPath);
+    if (!file) {
+      std::fprintf(stderr, "cannot write %s\n", options.csvPath.c_str());
+      return 1;
+    }
+    writeCsv(file, rows);
+    closeOutput(file);
+  }
+
+  if (!options.jsonPath.empty()) {
+    FILE *file = openOutput(options.jsonPath);
+    if (!file) {
+      std::fprintf(stderr, "cannot write %s\n", options.jsonPath.c_str());
+      return 1;
+    }
+    writeJson(file, rows, references, options, analyzer);
+    closeOutput(file);
+  }
+
+  return 0;
+}
@@ -0,0 +1,1077 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    DSP Microbenchmark
+
+    使い方:
+      EA_VT_2W_Bench [--quick] [--csv] [--seconds <秒>] [--isa <名前>]
+                     [--quality <品質>] [--oversampling <倍率>]
+                     [--os-filter <方式>] [--adaa] [--deterministic]
+      EA_VT_2W_Bench --verify
+      EA_VT_2W_Bench --aliasing [--quick]
+      EA_VT_2W_Bench --multichannel [--quick] [--isa ...] [--oversampling ...]
+      EA_VT_2W_Bench --segments [--quick] [--oversampling ...] [--adaa]
+      EA_VT_2W_Bench --silence [--quick] [--oversampling ...] [--os-filter ...]
+      EA_VT_2W_Bench --precision [--quick] [--os-filter ...] [--adaa]
+      EA_VT_2W_Bench --models [--quick]
+      EA_VT_2W_Bench --state [--quick]
+      EA_VT_2W_Bench --regress <dir> [--update] [--tolerance <誤差>]
+                     [--max-regression <%>] [--golden-only | --perf-only]
+                     [--quick]
+                     [--isa ...]
+
+    --isa           scalar / sse2 / avx2 / avx512 / neon (既定は自動選択)
+    --quality       eco / standard / reference (既定は standard)
+    --oversampling  1 / 2 / 4 / 8 (既定は 1)
+    --os-filter     iir / fir (既定は iir)
+    --adaa          サチュレーション・倍音段を ADAA (1 次) で処理する
+    --deterministic 決定的モード (FMA を使わないカーネル・libm を使わない
+                    リファレンス経路) で測る
+    --verify        tanh 近似の最大誤差・単調性、対応している全カーネルの
+                    出力とスカラー経路の比較、オーバーサンプリングの
+                    レイテンシ・エイリアス除去・ブロック分割の不変性、
+                    ADAA のスカラー経路との誤差とレイテンシ、区間並列
+                    レンダーと逐次処理の誤差、ブロック計測の統計、
+                    自動品質の切り替え (往復しないこと・クリック・遅延)、
+                    メーターの値と FIFO、無音スリープとテール長、
+                    float と double の経路の一致、White / Black の
+                    パイプラインと手書きのループの一致、状態のバイナリ形式
+                    (往復・破損の検出・新しい版の読み込み)、プリセットの
+                    トリプルバッファと呼び出し・モーフィングのクリック、
+                    サンプル単位のオートメーションがブロック長 32 / 512 /
+                    4096 で同じ出力になること、決定的モードの出力のハッシュが
+                    全カーネル・ブロック長で一致することを確認する
+    --aliasing      1x / ADAA / オーバーサンプリング各方式の負荷と
+                    折り返し量 (dBc) を並べて比較する
+    --multichannel  5.1 / 7.1.4 / 9.1.6 を 1 インスタンスで処理した場合と
+                    ステレオインスタンスを並べた場合の負荷を比較する
+    --segments      長い 1 本の音声を区間並列でレンダーした場合と
+                    1 スレッドで逐次処理した場合の時間と誤差を比較する
+    --silence       大半のトラックが無音の 200 トラックのセッションを
+                    無音スリープ有り・無しで処理し、負荷を比較する
+    --precision     float (SIMD / リファレンス) と double の経路の負荷を
+                    倍率ごとに比較する
+    --models        White / Black のステージのパイプラインと、同じ処理を
+                    手で 1 本のループに書いた場合の負荷を比較する
+    --state         1000 インスタンスのセッションの状態の保存と、
+                    開き直し (値が変わる場合・変わらない場合) の時間を測る
+                    (EA_VT_2W_Bench_Plugin は VT2WWhiteProcessor の
+                    get / setStateInformation をバイナリ形式と XML 形式で
+                    比べる表も出す)
+    --regress       サイン・スイープ・インパルス・ノイズ・無音からの
+                    ステップを Drive / Mix / サンプルレート / モデルの
+                    組み合わせでプラグインと同じ経路 (決定的モード) で
+                    処理し、<dir> のゴールデンと比較する (誤差は
+                    <dir>/golden.txt のケース毎の値以内、--tolerance で
+                    上書き。ブロック長を変えても同じゴールデンと一致する
+                    こと)。続けてカーネルの負荷を <dir>/performance.txt と
+                    比べ、--max-regression % (既定 10) を超えて遅くなって
+                    いれば失敗する (--golden-only で省く。--perf-only なら
+                    負荷だけを比べる)。
+                    --update で現在のビルドの出力と負荷を <dir> に保存する
+                    (--tolerance を golden.txt に書く。既定 1e-6)。
+                    リポジトリの tools/regress にゴールデンを置いてある
+
+    ns/sample はサンプルフレーム (全チャンネル分) あたりの処理時間。
+    インスタンス単位のコストをそのまま比較できるよう、チャンネル数で割らない。
+
+    VT2W_BENCH_PROCESSOR を定義してビルドすると (EA_VT_2W_Bench_Plugin)
+    --regress は実際の VT2WWhiteProcessor の processBlock を通す。定義しない
+    場合 (EA_VT_2W_Bench) はプロセッサーと同じ手順をエンジンで再現する。
+  ==============================================================================
+*/
+
+#if VT2W_BENCH_PROCESSOR
+#include "PluginProcessor.h"
+#include "VT2WParameters.h"
+#endif
+
+#include "VT2WBenchFixture.h"
+
+#include "dsp/VT2WAdaptiveEngine.h"
+#include "dsp/VT2WPresetBank.h"
+#include "dsp/VT2WStateFormat.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+using namespace VT2WBench;
+
+namespace {
+
+bool parseIsa(const std::string &name, VT2WKernelIsa &isa) {
+  const std::pair<const char *, VT2WKernelIsa> names[] = {
+      {"scalar", VT2WKernelIsa::Scalar}, {"sse2", VT2WKernelIsa::SSE2},
+      {"avx2", VT2WKernelIsa::AVX2},     {"avx512", VT2WKernelIsa::AVX512},
+      {"neon", VT2WKernelIsa::NEON}};
+
+  for (const auto &entry : names)
+    if (name == entry.first) {
+      isa = entry.second;
+      return true;
+    }
+
+  return false;
+}
+
+bool parseQuality(const std::string &name, VT2WSaturationQuality &quality) {
+  const std::pair<const char *, VT2WSaturationQuality> names[] = {
+      {"eco", VT2WSaturationQuality::Eco},
+      {"standard", VT2WSaturationQuality::Standard},
+      {"reference", VT2WSaturationQuality::Reference}};
+
+  for (const auto &entry : names)
+    if (name == entry.first) {
+      quality = entry.second;
+      return true;
+    }
+
+  return false;
+}
+
+bool parseOversampling(const std::string &name, int &factorLog2) {
+  const std::pair<const char *, int> names[] = {
+      {"1", 0}, {"2", 1}, {"4", 2}, {"8", 3}};
+
+  for (const auto &entry : names)
+    if (name == entry.first) {
+      factorLog2 = entry.second;
+      return true;
+    }
+
+  return false;
+}
+
+bool parseOversamplingFilter(const std::string &name,
+                             VT2WOversamplingFilter &filter) {
+  const std::pair<const char *, VT2WOversamplingFilter> names[] = {
+      {"iir", VT2WOversamplingFilter::PolyphaseIIR},
+      {"fir", VT2WOversamplingFilter::LinearPhaseFIR}};
+
+  for (const auto &entry : names)
+    if (name == entry.first) {
+      filter = entry.second;
+      return true;
+    }
+
+  return false;
+}
+
+BenchOptions parseOptions(int argc, char **argv) {
+  BenchOptions options;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--quick")
+      options.quick = true;
+    else if (arg == "--csv")
+      options.csv = true;
+    else if (arg == "--verify")
+      options.verify = true;
+    else if (arg == "--aliasing")
+      options.aliasing = true;
+    else if (arg == "--multichannel")
+      options.multichannel = true;
+    else if (arg == "--segments")
+      options.segments = true;
+    else if (arg == "--silence")
+      options.silence = true;
+    else if (arg == "--precision")
+      options.precision = true;
+    else if (arg == "--models")
+      options.models = true;
+    else if (arg == "--state")
+      options.state = true;
+    else if (arg == "--regress" && i + 1 < argc)
+      options.regressDirectory = argv[++i];
+    else if (arg == "--update")
+      options.update = true;
+    else if (arg == "--golden-only")
+      options.goldenOnly = true;
+    else if (arg == "--perf-only")
+      options.perfOnly = true;
+    else if (arg == "--tolerance" && i + 1 < argc)
+      options.tolerance = std::max(0.0f, (float)std::atof(argv[++i]));
+    else if (arg == "--max-regression" && i + 1 < argc)
+      options.maxRegressionPercent = std::max(0.0, std::atof(argv[++i]));
+    else if (arg == "--adaa")
+      options.adaa = true;
+    else if (arg == "--deterministic")
+      options.deterministic = true;
+    else if (arg == "--seconds" && i + 1 < argc)
+      options.seconds = std::max(0.01, std::atof(argv[++i]));
+    else if (arg == "--isa" && i + 1 < argc &&
+             parseIsa(argv[i + 1], options.isa)) {
+      options.forceIsa = true;
+      ++i;
+    } else if (arg == "--quality" && i + 1 < argc &&
+               parseQuality(argv[i + 1], options.quality)) {
+      ++i;
+    } else if (arg == "--oversampling" && i + 1 < argc &&
+               parseOversampling(argv[i + 1], options.oversamplingLog2)) {
+      ++i;
+    } else if (arg == "--os-filter" && i + 1 < argc &&
+               parseOversamplingFilter(argv[i + 1],
+                                       options.oversamplingFilter)) {
+      ++i;
+    } else {
+      std::fprintf(stderr,
+                   "usage: %s [--quick] [--csv] [--seconds <seconds>] "
+                   "[--isa scalar|sse2|avx2|avx512|neon] "
+                   "[--quality eco|standard|reference] "
+                   "[--oversampling 1|2|4|8] [--os-filter iir|fir] "
+                   "[--adaa] [--deterministic] [--verify] [--aliasing] "
+                   "[--multichannel] "
+                   "[--segments] [--silence] [--precision] [--models] "
+                   "[--state] "
+                   "[--regress <dir> [--update] [--tolerance <abs>] "
+                   "[--max-regression <percent>] "
+                   "[--golden-only|--perf-only]]\n",
+                   argv[0]);
+      std::exit(1);
+    }
+  }
+
+  if (options.forceIsa && !VT2WKernels::isSupported(options.isa)) {
+    std::fprintf(stderr, "%s is not supported on this CPU\n",
+                 VT2WKernels::getName(options.isa));
+    std::exit(1);
+  }
+
+  if (options.goldenOnly && options.perfOnly) {
+    std::fprintf(stderr, "--golden-only and --perf-only are exclusive\n");
+    std::exit(1);
+  }
+
+  if (options.quick)
+    options.seconds = std::min(options.seconds, 0.25);
+
+  return options;
+}
+
+//==============================================================================
+// 検証 (VT2WVerifyKernels.cpp / VT2WVerifyEngine.cpp)
+int runVerify() {
+  const double sampleRate = 48000.0;
+  bool passed = verifyKernels(sampleRate, 48000);
+  passed &= verifyEngine(sampleRate);
+  return passed ? 0 : 1;
+}
+
+//==============================================================================
+// 折り返し比較: ADAA とオーバーサンプリングの負荷・エイリアス量
+
+/** 2 のべき乗長の in-place FFT (基数 2、計測用なので素朴な実装) */
+void fft(std::vector<double> &re, std::vector<double> &im) {
+  const size_t n = re.size();
+
+  for (size_t i = 1, j = 0; i < n; ++i) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      std::swap(re[i], re[j]);
+      std::swap(im[i], im[j]);
+    }
+  }
+
+  for (size_t length = 2; length <= n; length <<= 1) {
+    const double angle = -6.283185307179586 / double(length);
+    for (size_t i = 0; i < n; i += length)
+      for (size_t k = 0; k < length / 2; ++k) {
+        const double wr = std::cos(angle * double(k));
+        const double wi = std::sin(angle * double(k));
+        const size_t a = i + k, b = a + length / 2;
+        const double tr = re[b] * wr - im[b] * wi;
+        const double ti = re[b] * wi + im[b] * wr;
+        re[b] = re[a] - tr;
+        im[b] = im[a] - ti;
+        re[a] += tr;
+        im[a] += ti;
+      }
+  }
+}
+
+struct AliasingResult {
+  double aliasDbc;      // 真の倍音以外の成分 (基本波比)
+  double fundamental;   // 基本波の振幅
+};
+
+/**
+ * FFT のビンにちょうど乗るサイン (bin 番目) を強くドライブし、定常に
+ * なった後の 1 周期 (kFftSize) を解析する。入力が周期的なので窓は不要で、
+ * 基本波の整数倍 (ナイキスト未満) 以外のビンは全て折り返しとみなせる。
+ */
+AliasingResult measureAliasing(int bin, int factorLog2,
+                               VT2WOversamplingFilter filter, bool adaa) {
+  constexpr int kFftSize = 16384;
+  constexpr int kSettlePeriods = 2;
+  const double twoPi = 6.283185307179586;
+
+  VT2WWhiteEngine engine;
+  engine.setOversampling(factorLog2, filter);
+  engine.setAdaaEnabled(adaa);
+  engine.prepare(48000.0, 256);
+  engine.setTargets(10.0f, 1.0f);
+
+  const int numSamples = kFftSize * (kSettlePeriods + 1);
+  std::vector<float> audio(numSamples);
+  for (int i = 0; i < numSamples; ++i)
+    audio[i] = float(0.9 * std::sin(twoPi * double(bin) * double(i % kFftSize) /
+                                    kFftSize));
+
+  for (int pos = 0; pos < numSamples; pos += 256) {
+    float *channel = audio.data() + pos;
+    engine.process(&channel, 1, std::min(256, numSamples - pos));
+  }
+
+  std::vector<double> re(audio.end() - kFftSize, audio.end());
+  std::vector<double> im(kFftSize, 0.0);
+  fft(re, im);
+
+  std::vector<bool> harmonic(kFftSize / 2 + 1, false);
+  harmonic[0] = true;
+  for (int k = bin; k <= kFftSize / 2; k += bin)
+    harmonic[k] = true;
+
+  double aliasPower = 0.0;
+  for (int k = 1; k <= kFftSize / 2; ++k)
+    if (!harmonic[k])
+      aliasPower += re[k] * re[k] + im[k] * im[k];
+
+  const double fundamentalPower = re[bin] * re[bin] + im[bin] * im[bin];
+
+  AliasingResult result;
+  result.aliasDbc =
+      10.0 * std::log10(std::max(aliasPower, 1.0e-30) / fundamentalPower);
+  result.fundamental = 2.0 * std::sqrt(fundamentalPower) / kFftSize;
+  return result;
+}
+
+int runAliasing(const BenchOptions &baseOptions) {
+  struct Mode {
+    const char *name;
+    int factorLog2;
+    VT2WOversamplingFilter filter;
+    bool adaa;
+  };
+
+  const Mode modes[] = {
+      {"1x", 0, VT2WOversamplingFilter::PolyphaseIIR, false},
+      {"1x ADAA", 0, VT2WOversamplingFilter::PolyphaseIIR, true},
+      {"2x iir", 1, VT2WOversamplingFilter::PolyphaseIIR, false},
+      {"2x iir ADAA", 1, VT2WOversamplingFilter::PolyphaseIIR, true},
+      {"4x iir", 2, VT2WOversamplingFilter::PolyphaseIIR, false},
+      {"8x iir", 3, VT2WOversamplingFilter::PolyphaseIIR, false},
+      {"2x fir", 1, VT2WOversamplingFilter::LinearPhaseFIR, false}};
+
+  // 48kHz で 約 5kHz / 約 11kHz (奇数ビンなので折り返しが倍音と重ならない)
+  const int bins[] = {1707, 3755};
+  const BenchConfig config{2, 48000.0, 256, false};
+
+  std::printf("stereo 48kHz block 256, drive 10, mix 100%%, sine 0.9\n");
+  std::printf("%-12s %10s %9s %12s %9s %12s %9s\n", "mode", "ns/sample",
+              "latency", "alias@5k", "level@5k", "alias@11k", "level@11k");
+
+  AliasingResult baseline[2] = {};
+
+  for (const auto &mode : modes) {
+    auto options = baseOptions;
+    options.oversamplingLog2 = mode.factorLog2;
+    options.oversamplingFilter = mode.filter;
+    options.adaa = mode.adaa;
+    const auto cost = runConfig(config, options);
+
+    VT2WWhiteEngine engine;
+    engine.setOversampling(mode.factorLog2, mode.filter);
+    engine.setAdaaEnabled(mode.adaa);
+    engine.prepare(48000.0, 256);
+
+    std::printf("%-12s %10.2f %9d", mode.name, cost.nsPerSample,
+                engine.getLatencySamples());
+
+    for (int t = 0; t < 2; ++t) {
+      const auto result =
+          measureAliasing(bins[t], mode.factorLog2, mode.filter, mode.adaa);
+      if (&mode == &modes[0])
+        baseline[t] = result;
+
+      // level は 1x との基本波の差 (ADAA の高域減衰とフィルターの影響)
+      std::printf(" %8.1f dBc %6.2f dB", result.aliasDbc,
+                  20.0 * std::log10(result.fundamental /
+                                    baseline[t].fundamental));
+    }
+
+    std::printf("\n");
+    std::fflush(stdout);
+  }
+
+  return 0;
+}
+
+//==============================================================================
+// 多チャンネル: 1 インスタンスとステレオインスタンスの並列の比較
+
+int runMultichannel(const BenchOptions &options) {
+  struct Layout {
+    const char *name;
+    int numChannels;
+  };
+
+  const Layout layouts[] = {{"5.1", 6}, {"7.1.4", 12}, {"9.1.6", 16}};
+
+  std::printf("48kHz block 256, static, oversampling %dx %s%s\n",
+              1 << options.oversamplingLog2,
+              getFilterName(options.oversamplingFilter),
+              options.adaa ? " + ADAA" : "");
+  std::printf("%-8s %-22s %12s %12s\n", "layout", "configuration",
+              "ns/frame", "vs stereo");
+
+  for (const auto &layout : layouts) {
+    const int numPairs = layout.numChannels / 2;
+    const BenchConfig stereo{2, 48000.0, 256, false, numPairs, false};
+    const BenchConfig single{layout.numChannels, 48000.0, 256, false, 1,
+                             false};
+    const BenchConfig linked{layout.numChannels, 48000.0, 256, false, 1, true};
+
+    const double stereoNs = runConfig(stereo, options).nsPerSample;
+    const double singleNs = runConfig(single, options).nsPerSample;
+    const double linkedNs = runConfig(linked, options).nsPerSample;
+
+    char label[32];
+    std::snprintf(label, sizeof(label), "%d x stereo", numPairs);
+    std::printf("%-8s %-22s %12.2f %11.2fx\n", layout.name, label, stereoNs,
+                1.0);
+    std::snprintf(label, sizeof(label), "1 x %dch", layout.numChannels);
+    std::printf("%-8s %-22s %12.2f %11.2fx\n", layout.name, label, singleNs,
+                singleNs / stereoNs);
+    std::snprintf(label, sizeof(label), "1 x %dch linked", layout.numChannels);
+    std::printf("%-8s %-22s %12.2f %11.2fx\n", layout.name, label, linkedNs,
+                linkedNs / stereoNs);
+    std::fflush(stdout);
+  }
+
+  return 0;
+}
+
+//==============================================================================
+// 区間並列: 長い 1 本の音声を逐次処理した場合と区間に分けた場合の比較
+
+int runSegments(const BenchOptions &options) {
+  const double sampleRate = 48000.0;
+  const double seconds = options.quick ? 60.0 : 180.0;
+  const int numSamples = int(sampleRate * seconds);
+  const int numThreads =
+      std::max(1, int(std::thread::hardware_concurrency()));
+
+  VT2WSettings settings;
+  settings.drive = 5.0f;
+  settings.quality = options.quality;
+  settings.oversamplingLog2 = options.oversamplingLog2;
+  settings.oversamplingFilter = options.oversamplingFilter;
+  settings.adaa = options.adaa;
+
+  const auto input = makeBurstInput(2, sampleRate, numSamples);
+  const VT2WSegmentRenderer renderer(settings, sampleRate, 2);
+
+  std::printf("%.0f s stereo 48kHz, oversampling %dx %s%s, warm-up %lld "
+              "samples\n",
+              seconds, 1 << options.oversamplingLog2,
+              getFilterName(options.oversamplingFilter),
+              options.adaa ? " + ADAA" : "",
+              (long long)renderer.getWarmUpSamples());
+  std::printf("%-24s %10s %12s %9s\n", "configuration", "seconds",
+              "realtime x", "speedup");
+
+  auto time = [&](int threads, int64_t segmentLength,
+                  std::vector<std::vector<float>> &output) {
+    const auto start = std::chrono::steady_clock::now();
+    output = renderSegmented(renderer, input, threads, segmentLength);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  };
+
+  std::vector<std::vector<float>> sequential, parallel;
+  const double sequentialSeconds = time(1, numSamples, sequential);
+  const double parallelSeconds = time(numThreads, 0, parallel);
+
+  std::printf("%-24s %10.2f %12.1f %8.2fx\n", "sequential (1 thread)",
+              sequentialSeconds, seconds / sequentialSeconds, 1.0);
+
+  char label[32];
+  std::snprintf(label, sizeof(label), "segments (%d threads)", numThreads);
+  std::printf("%-24s %10.2f %12.1f %8.2fx\n", label, parallelSeconds,
+              seconds / parallelSeconds, sequentialSeconds / parallelSeconds);
+  std::printf("max abs error vs sequential %.3g (tolerance %.1g)\n",
+              maxAbsError(parallel, sequential),
+              VT2WSegmentRenderer::kSegmentTolerance);
+
+  return 0;
+}
+
+//==============================================================================
+// 無音スリープ: 大半のトラックが無音のセッション
+
+/**
+ * 200 トラック (ステレオ、48kHz / 256 サンプル) のうち 20 トラックだけが
+ * 鳴り続け、20 トラックは時々鳴り (1 秒鳴って 9 秒無音)、残りの 160 トラックは
+ * ずっと無音 (デジタルゼロ) のセッションを、スリープ有り・無しで処理する。
+ */
+int runSilence(const BenchOptions &options) {
+  // ホストと同じく非正規化数をゼロに丸める (juce::ScopedNoDenormals 相当)。
+  // 丸めないと無音のトラックで IIR の状態が非正規化数になり、不当に重くなる
+#if defined(__SSE2__) || defined(_M_X64)
+  const unsigned int previousCsr = _mm_getcsr();
+  _mm_setcsr(previousCsr | 0x8040); // FTZ | DAZ
+#endif
+
+  const double sampleRate = 48000.0;
+  const int blockSize = 256;
+  const int numTracks = 200;
+  const int numPlaying = 20;
+  const int numSparse = 20;
+  const double seconds = options.quick ? 10.0 : 30.0;
+  const int numSamples = int(sampleRate * seconds);
+
+  const auto playing = makeInput(2, sampleRate, numSamples);
+  const auto sparse = makeGappedInput(2, sampleRate, numSamples, 1.0, 9.0);
+  const std::vector<std::vector<float>> silent(
+      2, std::vector<float>(size_t(numSamples), 0.0f));
+
+  std::printf("%d tracks (%d playing, %d sparse, %d silent), %.0f s stereo "
+              "48kHz, block %d, oversampling %dx %s%s\n",
+              numTracks, numPlaying, numSparse,
+              numTracks - numPlaying - numSparse, seconds, blockSize,
+              1 << options.oversamplingLog2,
+              getFilterName(options.oversamplingFilter),
+              options.adaa ? " + ADAA" : "");
+  std::printf("%-12s %10s %14s %12s\n", "sleep", "seconds", "session load",
+              "asleep");
+
+  double secondsWithout = 0.0;
+
+  for (bool sleep : {false, true}) {
+    std::vector<std::unique_ptr<VT2WWhiteEngine>> engines;
+    for (int track = 0; track < numTracks; ++track) {
+      auto engine = std::make_unique<VT2WWhiteEngine>();
+      engine->setQuality(options.quality);
+      engine->setOversampling(options.oversamplingLog2,
+                              options.oversamplingFilter);
+      engine->setAdaaEnabled(options.adaa);
+      engine->setSleepEnabled(sleep);
+      engine->setTargets(5.0f, 1.0f);
+      engine->prepare(sampleRate, blockSize, 2);
+      engines.push_back(std::move(engine));
+    }
+
+    std::vector<float> buffer(size_t(2 * blockSize));
+    float *channels[] = {buffer.data(), buffer.data() + blockSize};
+    double processSeconds = 0.0;
+    long long asleepBlocks = 0, totalBlocks = 0;
+
+    for (int pos = 0; pos < numSamples; pos += blockSize) {
+      const int length = std::min(blockSize, numSamples - pos);
+
+      for (int track = 0; track < numTracks; ++track) {
+        const auto &source = track < numPlaying                ? playing
+                             : track < numPlaying + numSparse ? sparse
+                                                               : silent;
+        for (int ch = 0; ch < 2; ++ch)
+          std::copy(source[ch].begin() + pos,
+                    source[ch].begin() + pos + length, channels[ch]);
+
+        // ホストがバッファを用意する分は含めず、process だけを計る
+        const auto start = std::chrono::steady_clock::now();
+        engines[track]->process(channels, 2, length);
+        processSeconds += std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+
+        asleepBlocks += engines[track]->isSleeping() ? 1 : 0;
+        ++totalBlocks;
+      }
+    }
+
+    if (!sleep)
+      secondsWithout = processSeconds;
+
+    std::printf("%-12s %10.3f %13.1f%% %11.1f%%\n", sleep ? "on" : "off",
+                processSeconds, 100.0 * processSeconds / seconds,
+                100.0 * asleepBlocks / totalBlocks);
+    if (sleep)
+      std::printf("speedup %.2fx\n", secondsWithout / processSeconds);
+  }
+
+#if defined(__SSE2__) || defined(_M_X64)
+  _mm_setcsr(previousCsr);
+#endif
+  return 0;
+}
+
+//==============================================================================
+/**
+ * float と double の経路の負荷 (ステレオ、48kHz / 256 サンプル、Drive 5)
+ * float は SIMD カーネル (Standard) とリファレンス、double はリファレンスのみ。
+ * ホストが 64bit のミックスエンジンの場合、float 版はこれに加えて
+ * ブロック毎に double -> float -> double の変換が掛かる。
+ */
+template <typename Sample>
+double timePrecision(const std::vector<std::vector<float>> &source,
+                     VT2WSaturationQuality quality, int factorLog2,
+                     const BenchOptions &options) {
+  const double sampleRate = 48000.0;
+  const int blockSize = 256;
+  const int numSamples = int(source[0].size());
+  double bestSeconds = 1.0e30;
+  Sample sink = 0;
+
+  for (int repeat = 0; repeat < kRepeats; ++repeat) {
+    std::vector<std::vector<Sample>> work;
+    for (const auto &channel : source)
+      work.emplace_back(channel.begin(), channel.end());
+
+    VT2WWhiteEngine engine;
+    engine.setQuality(quality);
+    engine.setOversampling(factorLog2, options.oversamplingFilter);
+    engine.setAdaaEnabled(options.adaa);
+    engine.setTargets(5.0f, 1.0f);
+    engine.prepare(sampleRate, blockSize, 2);
+
+    const auto start = std::chrono::steady_clock::now();
+    renderBlocks(engine, work, blockSize);
+    bestSeconds = std::min(bestSeconds,
+                           std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
+
+    sink += work[0][size_t(numSamples - 1)];
+  }
+
+  keepAlive(sink);
+
+  return bestSeconds * 1.0e9 / numSamples;
+}
+
+int runPrecision(const BenchOptions &options) {
+  const double sampleRate = 48000.0;
+  const auto source =
+      makeInput(2, sampleRate, int(sampleRate * options.seconds));
+
+  std::printf("stereo 48kHz, block 256, %s%s, kernel %s\n",
+              getFilterName(options.oversamplingFilter),
+              options.adaa ? " + ADAA" : "",
+              VT2WKernels::getName(VT2WWhiteEngine().getKernel()));
+  std::printf("%-6s %16s %18s %14s %14s\n", "factor", "float ns/sample",
+              "float ref ns/smp", "double ns/smp", "double / float");
+
+  for (int factorLog2 = 0; factorLog2 <= VT2WOversampler::kMaxFactorLog2;
+       ++factorLog2) {
+    const double simd = timePrecision<float>(
+        source, VT2WSaturationQuality::Standard, factorLog2, options);
+    const double reference = timePrecision<float>(
+        source, VT2WSaturationQuality::Reference, factorLog2, options);
+    const double precise = timePrecision<double>(
+        source, VT2WSaturationQuality::Reference, factorLog2, options);
+
+    std::printf("%-6d %16.3f %18.3f %14.3f %13.2fx\n", 1 << factorLog2, simd,
+                reference, precise, precise / simd);
+    std::fflush(stdout);
+  }
+
+  return 0;
+}
+
+//==============================================================================
+// モデル: パイプラインと手書きのループの負荷
+//==============================================================================
+/**
+ * ステレオ 48kHz / 256 サンプル、1x、Drive 5・Mix 100% 一定で、
+ * エンジン (リファレンス経路 = ステージのパイプライン) と手書きのループの
+ * ns/sample を比べる。エンジン側はスムージングとスリープ判定の分も含む。
+ */
+int runModels(const BenchOptions &options) {
+  const double sampleRate = 48000.0;
+  const int blockSize = 256;
+  const auto source =
+      makeInput(2, sampleRate, int(sampleRate * options.seconds));
+  const int numSamples = int(source[0].size());
+
+  std::printf("stereo 48kHz, block %d, 1x, drive 5, mix 100%%\n", blockSize);
+  std::printf("%-6s %16s %20s %8s\n", "model", "pipeline ns/smp",
+              "hand-written ns/smp", "ratio");
+
+  for (auto model : {VT2WModel::White, VT2WModel::Black}) {
+    double pipelineSeconds = 1.0e30, handSeconds = 1.0e30;
+    float sink = 0.0f;
+
+    for (int repeat = 0; repeat < kRepeats; ++repeat) {
+      auto work = source;
+      auto engine = makeModelEngine(model, 5.0f, 1.0f, sampleRate, blockSize);
+      auto start = std::chrono::steady_clock::now();
+      renderBlocks(*engine, work, blockSize);
+      pipelineSeconds = std::min(
+          pipelineSeconds, std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
+      sink += work[0][size_t(numSamples - 1)];
+
+      work = source;
+      start = std::chrono::steady_clock::now();
+      renderHandWritten(model, work, 5.0f, 1.0f, sampleRate);
+      handSeconds = std::min(handSeconds,
+                             std::chrono::duration<double>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count());
+      sink += work[0][size_t(numSamples - 1)];
+    }
+
+    keepAlive(sink);
+
+    const double pipeline = pipelineSeconds * 1.0e9 / numSamples;
+    const double hand = handSeconds * 1.0e9 / numSamples;
+    std::printf("%-6s %16.3f %20.3f %7.2fx\n", VT2WModels::getName(model),
+                pipeline, hand, pipeline / hand);
+    std::fflush(stdout);
+  }
+
+  return 0;
+}
+
+
+//==============================================================================
+// 状態の保存・復元: 1000 インスタンスのセッション
+//==============================================================================
+#if VT2W_BENCH_PROCESSOR
+/** ホストのラッパーの代わりにパラメータの変更の通知を数える */
+class CountingListener : public juce::AudioProcessorListener {
+public:
+  int notifications = 0;
+
+  void audioProcessorParameterChanged(juce::AudioProcessor *, int,
+                                      float) override {
+    ++notifications;
+  }
+  void audioProcessorChanged(juce::AudioProcessor *,
+                             const ChangeDetails &) override {}
+};
+
+/**
+ * 実際の VT2WWhiteProcessor で、セッションの保存 (getStateInformation) と
+ * 開き直し (setStateInformation: 状態の解析、setParameterValues による
+ * 値が変わるパラメータの書き換えとホストへの通知) を、バイナリ形式と
+ * 以前の版の XML 形式 (ValueTree を XML にして copyXmlToBinary で書く)
+ * で比べる。オーディオスレッドでのエンジンへの反映は runState の表で測る。
+ */
+int runProcessorState(const std::vector<VT2WSettings> &session,
+                      int numRounds) {
+  const int numInstances = int(session.size());
+
+  // リスナーはプロセッサーより後に破棄する
+  std::vector<CountingListener> listeners(session.size());
+  std::vector<std::unique_ptr<VT2WWhiteProcessor>> processors;
+  for (auto &listener : listeners) {
+    processors.push_back(std::make_unique<VT2WWhiteProcessor>());
+    processors.back()->addListener(&listener);
+  }
+
+  // 既定値の状態 (値が全て変わる開き直しの前に戻す)
+  juce::MemoryBlock defaults;
+  processors[0]->getStateInformation(defaults);
+
+  for (size_t i = 0; i < session.size(); ++i) {
+    auto &parameters = processors[i]->getParameters();
+    for (const auto &value : VT2WParameters::getParameterValues(session[i]))
+      if (auto *parameter = parameters.getParameter(value.id))
+        parameter->setValueNotifyingHost(
+            parameter->convertTo0to1(value.value));
+  }
+
+  // 開き直した後のパラメータがセッションの値と一致するか
+  auto matches = [&](size_t i) {
+    auto &parameters = processors[i]->getParameters();
+    for (const auto &value : VT2WParameters::getParameterValues(session[i])) {
+      auto *parameter = parameters.getParameter(value.id);
+      if (parameter == nullptr ||
+          parameter->getValue() != parameter->convertTo0to1(value.value))
+        return false;
+    }
+    return true;
+  };
+
+  auto seconds = [](auto start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  };
+
+  std::vector<juce::MemoryBlock> binaryBlobs(session.size());
+  std::vector<juce::MemoryBlock> xmlBlobs(session.size());
+
+  // [形式][値が変わるか]
+  double saveSeconds[2] = {1.0e30, 1.0e30};
+  double recallSeconds[2][2] = {{1.0e30, 1.0e30}, {1.0e30, 1.0e30}};
+  int notifications[2][2] = {};
+  int failures = 0;
+
+  for (int round = 0; round < numRounds; ++round) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < session.size(); ++i)
+      processors[i]->getStateInformation(binaryBlobs[i]);
+    saveSeconds[0] = std::min(saveSeconds[0], seconds(start));
+
+    // 以前の版の getStateInformation と同じ手順
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < session.size(); ++i) {
+      auto xml = processors[i]->getParameters().copyState().createXml();
+      juce::AudioProcessor::copyXmlToBinary(*xml, xmlBlobs[i]);
+    }
+    saveSeconds[1] = std::min(saveSeconds[1], seconds(start));
+
+    for (int format = 0; format < 2; ++format)
+      for (int changed = 0; changed < 2; ++changed) {
+        const auto &blobs = format == 0 ? binaryBlobs : xmlBlobs;
+        for (size_t i = 0; i < session.size(); ++i) {
+          const auto &before = changed ? defaults : blobs[i];
+          processors[i]->setStateInformation(before.getData(),
+                                             int(before.getSize()));
+          listeners[i].notifications = 0;
+        }
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < session.size(); ++i)
+          processors[i]->setStateInformation(blobs[i].getData(),
+                                             int(blobs[i].getSize()));
+        auto &best = recallSeconds[format][changed];
+        best = std::min(best, seconds(start));
+
+        notifications[format][changed] = 0;
+        for (size_t i = 0; i < session.size(); ++i) {
+          notifications[format][changed] += listeners[i].notifications;
+          if (!matches(i))
+            ++failures;
+        }
+      }
+  }
+
+  for (size_t i = 0; i < session.size(); ++i)
+    processors[i]->removeListener(&listeners[i]);
+
+  size_t binaryBytes = 0, xmlBytes = 0;
+  for (size_t i = 0; i < session.size(); ++i) {
+    binaryBytes += binaryBlobs[i].getSize();
+    xmlBytes += xmlBlobs[i].getSize();
+  }
+
+  std::printf("\nVT2WWhiteProcessor: %d instances, binary %zu bytes / "
+              "XML %zu bytes (mean), best of %d rounds\n",
+              numInstances, binaryBytes / session.size(),
+              xmlBytes / session.size(), numRounds);
+  std::printf("%-34s %10s %14s %14s\n", "", "total ms", "us / instance",
+              "notifications");
+  auto print = [&](const char *name, double total, int count) {
+    std::printf("%-34s %10.3f %14.3f %14d\n", name, total * 1.0e3,
+                total * 1.0e6 / numInstances, count);
+  };
+  print("save (binary)", saveSeconds[0], 0);
+  print("save (XML)", saveSeconds[1], 0);
+  print("recall binary (all values changed)", recallSeconds[0][1],
+        notifications[0][1]);
+  print("recall XML (all values changed)", recallSeconds[1][1],
+        notifications[1][1]);
+  print("recall binary (values unchanged)", recallSeconds[0][0],
+        notifications[0][0]);
+  print("recall XML (values unchanged)", recallSeconds[1][0],
+        notifications[1][0]);
+
+  if (failures != 0)
+    std::printf("FAIL: %d recalls did not restore the parameters\n",
+                failures);
+  return failures == 0 ? 0 : 1;
+}
+#endif
+
+/**
+ * セッションの保存 (全インスタンスの getStateInformation) と、開き直し
+ * (setStateInformation と、エンジンへの設定の反映) の時間。
+ * 値が変わらないインスタンスは設定の比較だけで済む (プロセッサーと同じく
+ * 変わった項目だけを反映する) ので、全て変わる場合と変わらない場合を測る。
+ * XML 形式との比較は JUCE が要るので、EA_VT_2W_Bench では新しい形式だけを
+ * 測る。EA_VT_2W_Bench_Plugin は続けて runProcessorState も測る。
+ */
+int runState(const BenchOptions &options) {
+  namespace State = VT2WStateFormat;
+  const int numInstances = 1000;
+  const int numRounds = options.quick ? 5 : 50;
+
+  std::mt19937 rng(7);
+  std::vector<VT2WSettings> session;
+  for (int i = 0; i < numInstances; ++i)
+    session.push_back(makeRandomSettings(rng));
+
+  std::vector<std::unique_ptr<VT2WAdaptiveEngine>> engines;
+  for (int i = 0; i < numInstances; ++i)
+    engines.push_back(std::make_unique<VT2WAdaptiveEngine>());
+
+  std::vector<State::Data> blobs(session.size());
+  std::vector<VT2WSettings> current(session.size());
+
+  auto seconds = [](auto start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  };
+
+  double saveSeconds = 1.0e30, changedSeconds = 1.0e30,
+         unchangedSeconds = 1.0e30;
+  int failures = 0;
+
+  for (int round = 0; round < numRounds; ++round) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < session.size(); ++i)
+      blobs[i] = State::write(session[i]);
+    saveSeconds = std::min(saveSeconds, seconds(start));
+
+    // 開き直し: 全インスタンスが既定値から変わる / 同じ値のまま
+    for (bool changed : {true, false}) {
+      for (size_t i = 0; i < session.size(); ++i) {
+        current[i] = changed ? VT2WSettings() : session[i];
+        engines[i]->applySettings(current[i]);
+      }
+
+      start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < session.size(); ++i) {
+        VT2WSettings restored;
+        if (State::read(blobs[i].data(), State::kSize, restored) !=
+            State::Status::Ok) {
+          ++failures;
+          continue;
+        }
+
+        if (restored != current[i]) {
+          current[i] = restored;
+          engines[i]->applySettings(restored);
+        }
+      }
+
+      auto &best = changed ? changedSeconds : unchangedSeconds;
+      best = std::min(best, seconds(start));
+    }
+  }
+
+  std::printf("%d instances, %d-byte state, best of %d rounds\n",
+              numInstances, State::kSize, numRounds);
+  std::printf("%-30s %10s %14s\n", "", "total ms", "us / instance");
+  auto print = [&](const char *name, double total) {
+    std::printf("%-30s %10.3f %14.3f\n", name, total * 1.0e3,
+                total * 1.0e6 / numInstances);
+  };
+  print("save", saveSeconds);
+  print("recall (all values changed)", changedSeconds);
+  print("recall (values unchanged)", unchangedSeconds);
+
+#if VT2W_BENCH_PROCESSOR
+  if (runProcessorState(session, options.quick ? 2 : 10) != 0)
+    ++failures;
+#endif
+
+  return failures == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+#if VT2W_BENCH_PROCESSOR
+  const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+#endif
+
+  const auto options = parseOptions(argc, argv);
+
+  if (options.verify)
+    return runVerify();
+
+  if (options.aliasing)
+    return runAliasing(options);
+
+  if (options.multichannel)
+    return runMultichannel(options);
+
+  if (options.segments)
+    return runSegments(options);
+
+  if (options.silence)
+    return runSilence(options);
+
+  if (options.precision)
+    return runPrecision(options);
+
+  if (options.models)
+    return runModels(options);
+
+  if (options.state)
+    return runState(options);
+
+  if (!options.regressDirectory.empty())
+    return runRegress(options);
+
+  if (!options.csv) {
+    VT2WWhiteEngine engine;
+    if (options.forceIsa)
+      engine.setKernel(options.isa);
+    engine.setOversampling(options.oversamplingLog2,
+                           options.oversamplingFilter);
+    engine.setAdaaEnabled(options.adaa);
+    engine.prepare(48000.0, 512);
+    std::printf("kernel: %s%s, quality: %s, oversampling: %dx %s%s "
+                "(latency %d samples)\n",
+                VT2WKernels::getName(engine.getKernel()),
+                options.deterministic ? " (deterministic)" : "",
+                VT2WKernels::getName(options.quality),
+                1 << options.oversamplingLog2,
+                getFilterName(options.oversamplingFilter),
+                options.adaa ? " + ADAA" : "", engine.getLatencySamples());
+  }
+
+  const int channelCounts[] = {1, 2};
+  const double sampleRates[] = {44100.0, 48000.0, 96000.0, 192000.0};
+  const int blockSizes[] = {16, 64, 256, 1024, 8192};
+
+  if (options.csv)
+    std::printf("channels,sample_rate,block_size,parameters,ns_per_sample,"
+                "samples_per_sec,realtime_x\n");
+  else
+    std::printf("%-8s %-8s %-6s %-8s %12s %16s %12s\n", "channels", "rate",
+                "block", "params", "ns/sample", "samples/sec", "realtime x");
+
+  for (int numChannels : channelCounts)
+    for (double sampleRate : sampleRates)
+      for (int blockSize : blockSizes)
+        for (bool moving : {false, true}) {
+          BenchConfig config{numChannels, sampleRate, blockSize, moving};
+          auto result = runConfig(config, options);
+
+          const char *params = moving ? "moving" : "static";
+          if (options.csv)
+            std::printf("%d,%.0f,%d,%s,%.3f,%.0f,%.1f\n", numChannels,
+                        sampleRate, blockSize, params, result.nsPerSample,
+                        result.samplesPerSecond, result.realtimeMultiple);
+          else
+            std::printf("%-8d %-8.0f %-6d %-8s %12.3f %16.0f %12.1f\n",
+                        numChannels, sampleRate, blockSize, params,
+                        result.nsPerSample, result.samplesPerSecond,
+                        result.realtimeMultiple);
+          std::fflush(stdout);
+        }
+
+  return 0;
+}
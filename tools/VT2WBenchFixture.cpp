@@ -0,0 +1,304 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Bench Fixture Implementation
+  ==============================================================================
+*/
+
+#include "VT2WBenchFixture.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace VT2WBench {
+
+namespace {
+
+// keepAlive の書き出し先
+volatile double keptAlive = 0.0;
+
+/** 1x の VT2WRateCoefficients (VT2WWhiteEngine::updateInternalRate と同じ) */
+VT2WRateCoefficients makeRateCoefficients(double sampleRate) {
+  VT2WRateCoefficients rate;
+  rate.attack = 1.0f - std::exp(-1.0f / (float(sampleRate) *
+                                         VT2WConstants::kEnvelopeAttack));
+  rate.release = 1.0f - std::exp(-1.0f / (float(sampleRate) *
+                                          VT2WConstants::kEnvelopeRelease));
+  rate.peakRelease = std::exp(
+      -1.0f / (float(sampleRate) * VT2WConstants::kEnvelopeRelease));
+  rate.phaseAllpass = (float)VT2WModels::getAllpassCoefficient(
+      VT2WConstants::kBlackPhaseFrequency, sampleRate);
+  return rate;
+}
+
+/**
+ * White を 1 本のループに手で書き下したもの (パイプライン化する前の
+ * 4 つの関数を順に呼ぶ形と同じ式)。係数は一定、エンベロープはチャンネル毎。
+ */
+void handWrittenWhite(float *samples, int numSamples,
+                      const VT2WDriveCoefficients &c,
+                      const VT2WRateCoefficients &rate, float mix,
+                      float &envelope) {
+  for (int i = 0; i < numSamples; ++i) {
+    const float dry = samples[i];
+    const float x = dry * c.preGain;
+
+    float saturated = x;
+    if (std::abs(x) >= 0.0001f)
+      saturated = std::tanh((x - c.cubic * (x * x * x)) * c.limit) *
+                  c.inverseLimit;
+    float wet = saturated + ((x * std::abs(x)) * c.harmonic2 -
+                             (x * x * x) * c.harmonic3);
+
+    const float level = std::abs(wet);
+    envelope += (level > envelope ? rate.attack : rate.release) *
+                (level - envelope);
+    const float transient = level - envelope;
+    if (transient > 0)
+      wet += wet * (transient * c.transientGain);
+
+    wet *= c.makeupGain;
+    samples[i] = dry * (1.0f - mix) + wet * mix;
+  }
+}
+
+/** Black を 1 本のループに手で書き下したもの (history は x[n-1], y[n-1]) */
+void handWrittenBlack(float *samples, int numSamples,
+                      const VT2WBlackCoefficients &c,
+                      const VT2WRateCoefficients &rate, float mix,
+                      float &envelope, float *history) {
+  for (int i = 0; i < numSamples; ++i) {
+    const float dry = samples[i];
+    float x = dry / (1.0f + c.density * std::pow(std::abs(dry), c.shape));
+    x = x + (x * std::abs(x)) * c.harmonic2 + (x * x * x) * c.harmonic3;
+
+    envelope = std::max(envelope * rate.peakRelease, std::abs(x));
+    const float t =
+        std::clamp((envelope - VT2WConstants::kBlackTransientThreshold) /
+                       VT2WConstants::kBlackTransientKnee,
+                   0.0f, 1.0f);
+    x *= 1.0f - t * t * (3.0f - 2.0f * t) * c.transientAmount;
+
+    const float y = rate.phaseAllpass * (x - history[1]) + history[0];
+    history[0] = x;
+    history[1] = y;
+
+    samples[i] = dry * (1.0f - mix) + y * c.makeupGain * mix;
+  }
+}
+
+} // namespace
+
+const char *getFilterName(VT2WOversamplingFilter filter) {
+  return filter == VT2WOversamplingFilter::LinearPhaseFIR ? "fir" : "iir";
+}
+
+std::vector<std::vector<float>> makeInput(int numChannels, double sampleRate,
+                                          int numSamples) {
+  std::vector<std::vector<float>> input(numChannels,
+                                        std::vector<float>(numSamples));
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+  const double twoPi = 6.283185307179586;
+
+  for (int ch = 0; ch < numChannels; ++ch)
+    for (int i = 0; i < numSamples; ++i) {
+      double t = i / sampleRate;
+      input[ch][i] = float(0.5 * std::sin(twoPi * 100.0 * t + ch) +
+                           0.2 * std::sin(twoPi * 3000.0 * t)) +
+                     noise(rng);
+    }
+
+  return input;
+}
+
+std::vector<std::vector<float>> makeBurstInput(int numChannels,
+                                               double sampleRate,
+                                               int numSamples) {
+  auto input = makeInput(numChannels, sampleRate, numSamples);
+  const int burstLength = int(sampleRate * 0.37);
+
+  for (auto &channel : input)
+    for (int i = 0; i < numSamples; ++i)
+      channel[i] *= (i / burstLength) % 3 == 0 ? 3.0f : 0.25f;
+
+  return input;
+}
+
+
+std::vector<std::vector<float>> makeGappedInput(int numChannels,
+                                                double sampleRate,
+                                                int numSamples,
+                                                double soundSeconds,
+                                                double silenceSeconds) {
+  auto input = makeInput(numChannels, sampleRate, numSamples);
+  const int period = int(sampleRate * (soundSeconds + silenceSeconds));
+  const int sound = int(sampleRate * soundSeconds);
+
+  for (auto &channel : input)
+    for (int i = 0; i < numSamples; ++i)
+      if (i % period >= sound)
+        channel[i] = 0.0f;
+
+  return input;
+}
+
+std::vector<std::vector<double>>
+toDouble(const std::vector<std::vector<float>> &input) {
+  std::vector<std::vector<double>> output;
+  for (const auto &channel : input)
+    output.emplace_back(channel.begin(), channel.end());
+  return output;
+}
+
+VT2WSettings makeRandomSettings(std::mt19937 &rng) {
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  std::uniform_int_distribution<int> choice(0, 7);
+
+  VT2WSettings settings;
+  settings.drive = VT2WConstants::kDriveMax * unit(rng);
+  settings.mix = VT2WConstants::kMixMax * unit(rng);
+  settings.quality = static_cast<VT2WSaturationQuality>(choice(rng) % 3);
+  settings.oversamplingLog2 = choice(rng) % 4;
+  settings.oversamplingFilter =
+      static_cast<VT2WOversamplingFilter>(choice(rng) % 2);
+  settings.adaa = (choice(rng) & 1) != 0;
+  settings.link = (choice(rng) & 1) != 0;
+  settings.adaptive = (choice(rng) & 1) != 0;
+  settings.model = static_cast<VT2WModel>(choice(rng) % 2);
+  return settings;
+}
+
+std::vector<std::vector<float>>
+renderSegmented(const VT2WSegmentRenderer &renderer,
+                const std::vector<std::vector<float>> &input, int numThreads,
+                int64_t segmentLength) {
+  auto output = input;
+  std::vector<const float *> in;
+  std::vector<float *> out;
+  for (size_t ch = 0; ch < input.size(); ++ch) {
+    in.push_back(input[ch].data());
+    out.push_back(output[ch].data());
+  }
+
+  renderer.render(in.data(), out.data(), int64_t(input[0].size()), numThreads,
+                  segmentLength);
+  return output;
+}
+
+void renderHandWritten(VT2WModel model, std::vector<std::vector<float>> &audio,
+                       float drive, float mix, double sampleRate) {
+  const auto rate = makeRateCoefficients(sampleRate);
+  const auto white = VT2WDriveCoefficients::fromDrive(drive);
+  const auto black = VT2WBlackCoefficients::fromDrive(drive);
+
+  for (auto &channel : audio) {
+    float envelope = 0.0f;
+    float history[2] = {};
+    if (model == VT2WModel::Black)
+      handWrittenBlack(channel.data(), int(channel.size()), black, rate, mix,
+                       envelope, history);
+    else
+      handWrittenWhite(channel.data(), int(channel.size()), white, rate, mix,
+                       envelope);
+  }
+}
+
+std::unique_ptr<VT2WWhiteEngine> makeModelEngine(VT2WModel model, float drive,
+                                                 float mix, double sampleRate,
+                                                 int blockSize) {
+  auto engine = std::make_unique<VT2WWhiteEngine>();
+  engine->setModel(model);
+  engine->setQuality(VT2WSaturationQuality::Reference);
+  engine->setOversampling(0, VT2WOversamplingFilter::PolyphaseIIR);
+  engine->setSleepEnabled(false);
+  engine->setTargets(drive, mix);
+  engine->prepare(sampleRate, blockSize, 2);
+  return engine;
+}
+
+float maxAbsError(const std::vector<std::vector<float>> &a,
+                  const std::vector<std::vector<float>> &b) {
+  float maxError = 0.0f;
+  for (size_t ch = 0; ch < a.size(); ++ch)
+    for (size_t i = 0; i < a[ch].size(); ++i)
+      maxError = std::max(maxError, std::abs(a[ch][i] - b[ch][i]));
+  return maxError;
+}
+
+BenchResult runConfig(const BenchConfig &config, const BenchOptions &options) {
+  const int totalSamples =
+      std::max(config.blockSize, int(config.sampleRate * options.seconds));
+  const int totalChannels = config.numChannels * config.numInstances;
+  const auto source =
+      makeInput(totalChannels, config.sampleRate, totalSamples);
+
+  auto work = source;
+  std::vector<float *> channels(totalChannels);
+
+  double bestSeconds = 1.0e30;
+  float sink = 0.0f;
+
+  for (int repeat = 0; repeat < kRepeats; ++repeat) {
+    work = source;
+
+    // 複数インスタンスはホストと同じく、ブロック毎に順番に処理する
+    std::vector<VT2WWhiteEngine> engines(config.numInstances);
+    for (auto &engine : engines) {
+      if (options.forceIsa)
+        engine.setKernel(options.isa);
+      engine.setDeterministic(options.deterministic);
+      engine.setQuality(options.quality);
+      engine.setOversampling(options.oversamplingLog2,
+                             options.oversamplingFilter);
+      engine.setAdaaEnabled(options.adaa);
+      engine.setEnvelopeLinked(config.linked);
+      engine.prepare(config.sampleRate, config.blockSize, config.numChannels);
+      engine.setTargets(5.0f, 1.0f);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    int blockIndex = 0;
+    for (int pos = 0; pos < totalSamples; pos += config.blockSize) {
+      int numSamples = std::min(config.blockSize, totalSamples - pos);
+
+      for (int ch = 0; ch < totalChannels; ++ch)
+        channels[ch] = work[ch].data() + pos;
+
+      for (int instance = 0; instance < config.numInstances; ++instance) {
+        auto &engine = engines[instance];
+
+        if (config.movingParameters) {
+          // ブロック毎に目標値を動かし、スムージングを常に走らせる
+          float phase = 0.05f * float(blockIndex);
+          engine.setTargets(5.0f + 5.0f * std::sin(phase),
+                            0.5f + 0.5f * std::cos(phase));
+        }
+
+        engine.process(channels.data() + instance * config.numChannels,
+                       config.numChannels, numSamples);
+      }
+      ++blockIndex;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    bestSeconds = std::min(
+        bestSeconds, std::chrono::duration<double>(end - start).count());
+
+    for (int ch = 0; ch < totalChannels; ++ch)
+      sink += work[ch][totalSamples - 1];
+  }
+
+  keepAlive(sink);
+
+  BenchResult result;
+  result.nsPerSample = bestSeconds * 1.0e9 / totalSamples;
+  result.samplesPerSecond = totalSamples / bestSeconds;
+  result.realtimeMultiple = result.samplesPerSecond / config.sampleRate;
+  return result;
+}
+
+void keepAlive(double value) { keptAlive = value; }
+
+} // namespace VT2WBench
@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Bench Fixture
+
+    EA_VT_2W_Bench の各モードが共有するもの: コマンドラインの設定、
+    テスト信号、ブロック毎のレンダー、結果の比較、負荷の計測。
+      VT2WBench.cpp         負荷計測のモードと main
+      VT2WVerifyKernels.cpp --verify (カーネル・オーバーサンプリング・
+                            精度・モデル)
+      VT2WVerifyEngine.cpp  --verify (区間並列・自動品質・メーター・
+                            スリープ・状態・プリセット・オートメーション・
+                            決定的モード)
+      VT2WRegress.cpp       --regress
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "dsp/VT2WSegmentRenderer.h"
+#include "dsp/VT2WWhiteEngine.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace VT2WBench {
+
+//==============================================================================
+struct BenchConfig {
+  int numChannels; // 1 インスタンスあたり
+  double sampleRate;
+  int blockSize;
+  bool movingParameters;
+  int numInstances = 1;
+  bool linked = false;
+};
+
+struct BenchResult {
+  double nsPerSample;
+  double samplesPerSecond;
+  double realtimeMultiple;
+};
+
+struct BenchOptions {
+  bool quick = false;
+  bool csv = false;
+  bool verify = false;
+  bool aliasing = false;
+  bool multichannel = false;
+  bool segments = false;
+  bool silence = false;
+  bool precision = false;
+  bool models = false;
+  bool state = false;
+  bool update = false;     // --regress: 比較せずに保存する
+  bool goldenOnly = false; // --regress: 負荷のベースラインと比べない
+  bool perfOnly = false;   // --regress: ゴールデンと比べない
+  bool adaa = false;
+  bool deterministic = false;
+  bool forceIsa = false;
+  VT2WKernelIsa isa = VT2WKernelIsa::Scalar;
+  VT2WSaturationQuality quality = VT2WSaturationQuality::Standard;
+  int oversamplingLog2 = 0;
+  VT2WOversamplingFilter oversamplingFilter =
+      VT2WOversamplingFilter::PolyphaseIIR;
+  double seconds = 1.0;
+  std::string regressDirectory;       // --regress
+  float tolerance = -1.0f;            // 負ならゴールデンの一覧の値
+  double maxRegressionPercent = 10.0; // ns/sample の許容増加率
+};
+
+inline const VT2WSaturationQuality kAllQualities[] = {
+    VT2WSaturationQuality::Eco, VT2WSaturationQuality::Standard,
+    VT2WSaturationQuality::Reference};
+
+inline const VT2WKernelIsa kAllIsas[] = {
+    VT2WKernelIsa::Scalar, VT2WKernelIsa::SSE2, VT2WKernelIsa::AVX2,
+    VT2WKernelIsa::AVX512, VT2WKernelIsa::NEON};
+
+constexpr int kRepeats = 3;
+
+const char *getFilterName(VT2WOversamplingFilter filter);
+
+//==============================================================================
+// テスト信号
+
+/** 100Hz サイン + 3kHz サイン + 薄いノイズ */
+std::vector<std::vector<float>> makeInput(int numChannels, double sampleRate,
+                                          int numSamples);
+
+/** 区間並列レンダーの検証用: 音量が大きく変わる (エンベロープが効く) 信号 */
+std::vector<std::vector<float>> makeBurstInput(int numChannels,
+                                               double sampleRate,
+                                               int numSamples);
+
+/** 音の区間と無音 (デジタルゼロ) の区間が交互に来る信号 */
+std::vector<std::vector<float>> makeGappedInput(int numChannels,
+                                                double sampleRate,
+                                                int numSamples,
+                                                double soundSeconds,
+                                                double silenceSeconds);
+
+/** float の信号を double に */
+std::vector<std::vector<double>>
+toDouble(const std::vector<std::vector<float>> &input);
+
+/** 全項目をばらけさせた設定 (rng の系列で決まる) */
+VT2WSettings makeRandomSettings(std::mt19937 &rng);
+
+//==============================================================================
+// レンダーと比較
+
+/** engine でブロック毎に処理する (Sample は float か double) */
+template <typename Engine, typename Sample>
+void renderBlocks(Engine &engine, std::vector<std::vector<Sample>> &audio,
+                  int blockSize) {
+  std::vector<Sample *> channels(audio.size());
+  const int numSamples = int(audio[0].size());
+
+  for (int pos = 0; pos < numSamples; pos += blockSize) {
+    for (size_t ch = 0; ch < audio.size(); ++ch)
+      channels[ch] = audio[ch].data() + pos;
+    engine.process(channels.data(), int(audio.size()),
+                   std::min(blockSize, numSamples - pos));
+  }
+}
+
+/** 区間並列レンダー (出力はレイテンシ補正済みで入力と同じ長さ) */
+std::vector<std::vector<float>>
+renderSegmented(const VT2WSegmentRenderer &renderer,
+                const std::vector<std::vector<float>> &input, int numThreads,
+                int64_t segmentLength);
+
+/** model のステージを 1 本のループに手で書き下したもので処理する */
+void renderHandWritten(VT2WModel model, std::vector<std::vector<float>> &audio,
+                       float drive, float mix, double sampleRate);
+
+/** 1x・リファレンス経路 (パイプライン) のエンジン */
+std::unique_ptr<VT2WWhiteEngine> makeModelEngine(VT2WModel model, float drive,
+                                                 float mix, double sampleRate,
+                                                 int blockSize);
+
+/** 2 つのレンダリング結果の最大絶対誤差 */
+float maxAbsError(const std::vector<std::vector<float>> &a,
+                  const std::vector<std::vector<float>> &b);
+
+//==============================================================================
+// 負荷の計測
+
+/** config の条件で VT2WWhiteEngine を回し、kRepeats 回の最良を返す */
+BenchResult runConfig(const BenchConfig &config, const BenchOptions &options);
+
+/** 計測した処理が最適化で消えないよう、結果を関数の外へ書き出す */
+void keepAlive(double value);
+
+//==============================================================================
+// モード (run* の戻り値はプロセスの終了コード)
+
+/** tanh 近似・全カーネル・オーバーサンプリング・精度・モデルの検証 */
+bool verifyKernels(double sampleRate, int numSamples);
+
+/** 区間並列からオートメーション・決定的モードまでの検証 */
+bool verifyEngine(double sampleRate);
+
+int runRegress(const BenchOptions &options);
+
+} // namespace VT2WBench
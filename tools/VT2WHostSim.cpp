@@ -0,0 +1,706 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Many-Instance Host Simulator
+
+    使い方:
+      EA_VT_2W_HostSim [--instances <数>] [--threads <数>] [--block <長さ>]
+                       [--rate <Hz>] [--seconds <秒>] [--realtime] [--ui]
+                       [--schedule <方式>] [--no-contention] [--csv]
+                       [--model <モデル>] [--quality <品質>]
+                       [--oversampling <倍率>] [--drive <0-10>]
+                       [--mix <0-100>] [--quick]
+
+    --instances     インスタンス数 (既定 300、--quick は 40)
+    --threads       ワーカースレッドの最大数 (既定はハードウェアのスレッド数)
+                    1, 2, 4, ... と倍にしながらこの数まで測る
+    --block         ホストのブロック長 (既定 128)
+    --rate          サンプルレート (既定 48000)
+    --seconds       1 回の計測で処理する音声の長さ (既定 5、--quick は 1)
+    --realtime      サイクルをブロックの周期に合わせて待つ (既定は間を空けずに
+                    次のサイクルを始め、スループットを測る)
+    --ui            UI の代わりに 30Hz でメーターと処理時間を読むスレッドを
+                    走らせる
+    --schedule      dynamic / interleaved / chunked (既定は dynamic)
+                    dynamic は空いたスレッドが次のインスタンスを取る (多くの
+                    DAW と同じ)。interleaved はインスタンス i をスレッド
+                    i % T、chunked は連続した範囲を 1 スレッドに割り当てる
+    --no-contention 隣り合うインスタンス間の競合の検出を省く
+    --model         white / black (既定は white)
+    --quality       eco / standard / reference (既定は standard)
+    --oversampling  1 / 2 / 4 / 8 (既定は 2)
+
+    1 サイクル = 全インスタンスの processBlock 1 回。サイクルの時間が
+    ブロックの周期 (block / rate) を超えたものをデッドライン超過に数える。
+    効率はスレッド数 T のスループットを T x (1 スレッドのスループット) で
+    割ったもの。
+
+    競合の検出は、インスタンスを続けて確保した配置 (packed) と、間に 4KB の
+    詰め物を挟んだ配置 (padded) を、隣同士を別のスレッドに置く割り当て
+    (interleaved) と同じスレッドに置く割り当て (chunked) で比べる。隣の
+    インスタンスの小さなヒープ領域 (エンベロープ・スムージングの状態など)
+    が同じキャッシュラインに乗っていると、packed の時だけ interleaved が
+    遅くなる。
+
+    VT2W_HOST_SIM_PROCESSOR を定義してビルドすると (EA_VT_2W_HostSim_Plugin)
+    実際の VT2WWhiteProcessor を使う。定義しない場合 (EA_VT_2W_HostSim、
+    JUCE 無しでビルドできる) は、プロセッサーの processBlock と同じ手順
+    (処理時間の計測・設定の反映・自動品質・メーター・FIFO) をエンジンで
+    再現する。
+  ==============================================================================
+*/
+
+#if VT2W_HOST_SIM_PROCESSOR
+#include "PluginProcessor.h"
+#endif
+
+#include "dsp/VT2WAdaptiveEngine.h"
+#include "dsp/VT2WBlockTimer.h"
+#include "dsp/VT2WKernels.h"
+#include "dsp/VT2WMetering.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+//==============================================================================
+enum class Schedule { Dynamic, Interleaved, Chunked };
+
+const char *getScheduleName(Schedule schedule) {
+  switch (schedule) {
+  case Schedule::Interleaved:
+    return "interleaved";
+  case Schedule::Chunked:
+    return "chunked";
+  case Schedule::Dynamic:
+    break;
+  }
+  return "dynamic";
+}
+
+struct HostSimOptions {
+  int numInstances = 300;
+  int maxThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+  int blockSize = 128;
+  double sampleRate = 48000.0;
+  double seconds = 5.0;
+  bool realtime = false;
+  bool ui = false;
+  bool contention = true;
+  bool csv = false;
+  bool quick = false;
+  Schedule schedule = Schedule::Dynamic;
+  VT2WSettings settings = [] {
+    VT2WSettings initial;
+    initial.drive = 5.0f;
+    initial.mix = 100.0f;
+    return initial;
+  }();
+};
+
+bool parseSchedule(const std::string &name, Schedule &schedule) {
+  if (name == "dynamic")
+    schedule = Schedule::Dynamic;
+  else if (name == "interleaved")
+    schedule = Schedule::Interleaved;
+  else if (name == "chunked")
+    schedule = Schedule::Chunked;
+  else
+    return false;
+  return true;
+}
+
+bool parseModel(const std::string &name, VT2WModel &model) {
+  if (name == "white")
+    model = VT2WModel::White;
+  else if (name == "black")
+    model = VT2WModel::Black;
+  else
+    return false;
+  return true;
+}
+
+bool parseQuality(const std::string &name, VT2WSaturationQuality &quality) {
+  if (name == "eco")
+    quality = VT2WSaturationQuality::Eco;
+  else if (name == "standard")
+    quality = VT2WSaturationQuality::Standard;
+  else if (name == "reference")
+    quality = VT2WSaturationQuality::Reference;
+  else
+    return false;
+  return true;
+}
+
+bool parseOversampling(const std::string &name, int &oversamplingLog2) {
+  const int factors[] = {1, 2, 4, 8};
+  for (int i = 0; i < 4; ++i)
+    if (std::atoi(name.c_str()) == factors[i]) {
+      oversamplingLog2 = i;
+      return true;
+    }
+  return false;
+}
+
+HostSimOptions parseOptions(int argc, char **argv) {
+  HostSimOptions options;
+  bool instancesGiven = false;
+  bool secondsGiven = false;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--quick")
+      options.quick = true;
+    else if (arg == "--csv")
+      options.csv = true;
+    else if (arg == "--realtime")
+      options.realtime = true;
+    else if (arg == "--ui")
+      options.ui = true;
+    else if (arg == "--no-contention")
+      options.contention = false;
+    else if (arg == "--instances" && i + 1 < argc) {
+      options.numInstances = std::max(1, std::atoi(argv[++i]));
+      instancesGiven = true;
+    } else if (arg == "--threads" && i + 1 < argc)
+      options.maxThreads = std::clamp(std::atoi(argv[++i]), 1, 256);
+    else if (arg == "--block" && i + 1 < argc)
+      options.blockSize = std::clamp(std::atoi(argv[++i]), 1, 8192);
+    else if (arg == "--rate" && i + 1 < argc)
+      options.sampleRate = std::clamp(std::atof(argv[++i]), 8000.0, 768000.0);
+    else if (arg == "--seconds" && i + 1 < argc) {
+      options.seconds = std::max(0.01, std::atof(argv[++i]));
+      secondsGiven = true;
+    } else if (arg == "--drive" && i + 1 < argc)
+      options.settings.drive =
+          std::clamp((float)std::atof(argv[++i]), 0.0f, 10.0f);
+    else if (arg == "--mix" && i + 1 < argc)
+      options.settings.mix =
+          std::clamp((float)std::atof(argv[++i]), 0.0f, 100.0f);
+    else if (arg == "--schedule" && i + 1 < argc &&
+             parseSchedule(argv[i + 1], options.schedule))
+      ++i;
+    else if (arg == "--model" && i + 1 < argc &&
+             parseModel(argv[i + 1], options.settings.model))
+      ++i;
+    else if (arg == "--quality" && i + 1 < argc &&
+             parseQuality(argv[i + 1], options.settings.quality))
+      ++i;
+    else if (arg == "--oversampling" && i + 1 < argc &&
+             parseOversampling(argv[i + 1], options.settings.oversamplingLog2))
+      ++i;
+    else {
+      std::fprintf(stderr, "unknown or incomplete option: %s\n", arg.c_str());
+      std::exit(2);
+    }
+  }
+
+  if (options.quick) {
+    if (!instancesGiven)
+      options.numInstances = 40;
+    if (!secondsGiven)
+      options.seconds = 1.0;
+  }
+
+  return options;
+}
+
+//==============================================================================
+/** 全インスタンスで共有する入力 (読むだけなので競合しない) */
+class InputSignal {
+public:
+  static constexpr int kLength = 1 << 16;
+
+  InputSignal() {
+    uint32_t seed = 0x2545f491u;
+    for (auto &channel : channels) {
+      channel.resize(kLength);
+      for (auto &sample : channel) {
+        seed = seed * 1664525u + 1013904223u;
+        sample = 0.25f * ((float)(seed >> 8) / (float)(1u << 24) - 0.5f);
+      }
+    }
+  }
+
+  /** インスタンス毎にずらした位置からブロック 1 つ分を写す */
+  void copy(float *const *destination, int numSamples, int instance,
+            int64_t cycle) const {
+    const int64_t span = std::max(kLength - numSamples, 1);
+    const int offset = (int)((instance * 7919 + cycle * numSamples) % span);
+    for (int channel = 0; channel < 2; ++channel)
+      std::memcpy(destination[channel], channels[channel].data() + offset,
+                  sizeof(float) * (size_t)numSamples);
+  }
+
+private:
+  std::vector<float> channels[2];
+};
+
+//==============================================================================
+#if VT2W_HOST_SIM_PROCESSOR
+/** 実際のプラグイン (ホストと同じく prepareToPlay / processBlock を呼ぶ) */
+class HostSimInstance {
+public:
+  void prepare(const HostSimOptions &options) {
+    processor = std::make_unique<VT2WWhiteProcessor>();
+    auto &parameters = processor->getParameters();
+    for (const auto &value :
+         VT2WParameters::getParameterValues(options.settings))
+      if (auto *parameter = parameters.getParameter(value.id))
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value.value));
+
+    processor->setRateAndBufferSizeDetails(options.sampleRate,
+                                           options.blockSize);
+    processor->prepareToPlay(options.sampleRate, options.blockSize);
+    buffer.setSize(2, options.blockSize);
+  }
+
+  void process(const InputSignal &input, int index, int64_t cycle) {
+    input.copy(buffer.getArrayOfWritePointers(), buffer.getNumSamples(), index,
+               cycle);
+    processor->processBlock(buffer, midi);
+  }
+
+  /** UI スレッド (エディターのタイマーと同じものを読む) */
+  void poll() {
+    VT2WMeterFrame frame;
+    while (processor->popMeterFrame(frame)) {
+    }
+    lastSnapshot = processor->getBlockTimer().getSnapshot();
+  }
+
+private:
+  std::unique_ptr<VT2WWhiteProcessor> processor;
+  juce::AudioBuffer<float> buffer;
+  juce::MidiBuffer midi;
+  VT2WBlockTimer::Snapshot lastSnapshot;
+};
+#else
+/**
+ * VT2WWhiteProcessor::processSamples と同じ手順をエンジンで再現する
+ * (パラメータは atomic から読み、処理時間の計測・自動品質・メーター・
+ * FIFO も含める)。メンバーの並びもプロセッサーに合わせている。
+ */
+class HostSimInstance {
+public:
+  void prepare(const HostSimOptions &options) {
+    sampleRate = options.sampleRate;
+    settings = options.settings;
+    driveParameter.store(settings.drive);
+    mixParameter.store(settings.mix);
+
+    engine.applySettings(getSettings());
+    engine.prepare(sampleRate, options.blockSize, 2);
+
+    for (auto &channel : channels)
+      channel.assign((size_t)options.blockSize, 0.0f);
+    pointers[0] = channels[0].data();
+    pointers[1] = channels[1].data();
+    blockSize = options.blockSize;
+  }
+
+  void process(const InputSignal &input, int index, int64_t cycle) {
+    input.copy(pointers, blockSize, index, cycle);
+
+    const VT2WBlockTimer::Scope timing(blockTimer, blockSize, sampleRate);
+    engine.applySettings(getSettings());
+    engine.setRealtime(true);
+    engine.reportLoad(blockTimer.getLastLoad(), blockSize);
+
+    VT2WMeterFrame meter;
+    meter.numSamples = blockSize;
+    VT2WMetering::measure(pointers, 2, blockSize, meter.inputPeak,
+                          meter.inputRms);
+
+    engine.process(pointers, 2, blockSize);
+
+    VT2WMetering::measure(pointers, 2, blockSize, meter.outputPeak,
+                          meter.outputRms);
+    meter.envelope = engine.getEnvelopeLevel();
+    meter.makeupGain = engine.getMakeupGain();
+    meterFifo.push(meter);
+  }
+
+  /** UI スレッド (エディターのタイマーと同じものを読む) */
+  void poll() {
+    VT2WMeterFrame frame;
+    while (meterFifo.pop(frame)) {
+    }
+    lastSnapshot = blockTimer.getSnapshot();
+  }
+
+private:
+  VT2WSettings getSettings() const {
+    auto current = settings;
+    current.drive = driveParameter.load();
+    current.mix = mixParameter.load();
+    return current;
+  }
+
+  std::atomic<float> driveParameter{0.0f};
+  std::atomic<float> mixParameter{0.0f};
+  VT2WSettings settings;
+
+  VT2WAdaptiveEngine engine;
+  VT2WBlockTimer blockTimer;
+  VT2WMeterFifo meterFifo;
+
+  std::vector<float> channels[2];
+  float *pointers[2] = {};
+  int blockSize = 0;
+  double sampleRate = 0.0;
+  VT2WBlockTimer::Snapshot lastSnapshot;
+};
+#endif
+
+//==============================================================================
+/**
+ * N 個のインスタンス
+ * padded の時はインスタンスの間に 4KB の詰め物を確保したまま残し、
+ * 隣のインスタンスの小さな確保が同じキャッシュラインに乗らないようにする。
+ */
+class Session {
+public:
+  static constexpr size_t kSpacerBytes = 4096;
+
+  Session(const HostSimOptions &options, bool padded) {
+    instances.reserve((size_t)options.numInstances);
+    for (int i = 0; i < options.numInstances; ++i) {
+      if (padded)
+        spacers.push_back(std::make_unique<char[]>(kSpacerBytes));
+      instances.push_back(std::make_unique<HostSimInstance>());
+      instances.back()->prepare(options);
+    }
+  }
+
+  int size() const { return (int)instances.size(); }
+  HostSimInstance &operator[](int index) { return *instances[(size_t)index]; }
+
+private:
+  std::vector<std::unique_ptr<char[]>> spacers;
+  std::vector<std::unique_ptr<HostSimInstance>> instances;
+};
+
+struct RunResult {
+  int numThreads = 0;
+  Schedule schedule = Schedule::Dynamic;
+  int cycles = 0;
+  double meanMs = 0.0;
+  double p99Ms = 0.0;
+  double maxMs = 0.0;
+  int misses = 0;
+  double instanceBlocksPerSecond = 0.0;
+  double realtimeMultiple = 0.0;
+  double busyPercent = 0.0; // スレッドが処理していた時間の割合 (平均)
+};
+
+// スレッド毎の集計 (計測そのものが偽共有しないように 1 ラインずつ)
+struct alignas(64) ThreadStats {
+  double busySeconds = 0.0;
+};
+
+//==============================================================================
+/**
+ * ホストのワーカープール
+ * 呼び出し元のスレッドもオーディオスレッドとして加わり、残りの
+ * numThreads - 1 本がサイクル毎に起こされる。サイクルの終わりは全員の
+ * 完了を待つ (DAW がグラフの最後で待つのと同じ)。
+ */
+RunResult runSession(Session &session, const InputSignal &input,
+                     const HostSimOptions &options, int numThreads,
+                     Schedule schedule) {
+  const int numInstances = session.size();
+  const double period = options.blockSize / options.sampleRate;
+  const int warmupCycles = 16;
+  const int cycles = std::max(
+      1, (int)(options.seconds * options.sampleRate / options.blockSize));
+
+  std::atomic<int64_t> generation{0};
+  std::atomic<int> nextInstance{0};
+  std::atomic<int> pending{0};
+  std::atomic<bool> stop{false};
+  std::vector<ThreadStats> stats((size_t)numThreads);
+  int64_t cycle = 0;
+
+  auto work = [&](int thread) {
+    const auto start = Clock::now();
+    switch (schedule) {
+    case Schedule::Dynamic:
+      for (int i; (i = nextInstance.fetch_add(1)) < numInstances;)
+        session[i].process(input, i, cycle);
+      break;
+    case Schedule::Interleaved:
+      for (int i = thread; i < numInstances; i += numThreads)
+        session[i].process(input, i, cycle);
+      break;
+    case Schedule::Chunked:
+      for (int i = numInstances * thread / numThreads,
+               end = numInstances * (thread + 1) / numThreads;
+           i < end; ++i)
+        session[i].process(input, i, cycle);
+      break;
+    }
+    stats[(size_t)thread].busySeconds +=
+        std::chrono::duration<double>(Clock::now() - start).count();
+  };
+
+  std::vector<std::thread> workers;
+  for (int thread = 1; thread < numThreads; ++thread)
+    workers.emplace_back([&, thread] {
+      int64_t seen = 0;
+      for (;;) {
+        while (generation.load(std::memory_order_acquire) == seen)
+          std::this_thread::yield();
+        ++seen;
+        if (stop.load(std::memory_order_acquire))
+          return;
+        work(thread);
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+      }
+    });
+
+  std::thread uiThread;
+  if (options.ui)
+    uiThread = std::thread([&] {
+      while (!stop.load(std::memory_order_acquire)) {
+        for (int i = 0; i < numInstances; ++i)
+          session[i].poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(33));
+      }
+    });
+
+  auto runCycle = [&] {
+    nextInstance.store(0, std::memory_order_relaxed);
+    pending.store(numThreads - 1, std::memory_order_relaxed);
+    generation.fetch_add(1, std::memory_order_acq_rel);
+    work(0);
+    while (pending.load(std::memory_order_acquire) != 0)
+      std::this_thread::yield();
+    ++cycle;
+  };
+
+  for (int i = 0; i < warmupCycles; ++i)
+    runCycle();
+  for (auto &threadStats : stats)
+    threadStats.busySeconds = 0.0;
+
+  std::vector<double> cycleSeconds;
+  cycleSeconds.reserve((size_t)cycles);
+  auto deadline = Clock::now();
+  const auto totalStart = Clock::now();
+
+  for (int i = 0; i < cycles; ++i) {
+    if (options.realtime)
+      std::this_thread::sleep_until(deadline);
+
+    const auto start = Clock::now();
+    runCycle();
+    const auto end = Clock::now();
+    cycleSeconds.push_back(std::chrono::duration<double>(end - start).count());
+
+    // 間に合わなかったサイクルの後は、遅れを取り戻さずにすぐ次を始める
+    deadline = std::max(deadline + std::chrono::duration_cast<Clock::duration>(
+                                       std::chrono::duration<double>(period)),
+                        end);
+  }
+
+  const double totalSeconds =
+      std::chrono::duration<double>(Clock::now() - totalStart).count();
+
+  stop.store(true, std::memory_order_release);
+  generation.fetch_add(1, std::memory_order_acq_rel);
+  for (auto &worker : workers)
+    worker.join();
+  if (uiThread.joinable())
+    uiThread.join();
+
+  RunResult result;
+  result.numThreads = numThreads;
+  result.schedule = schedule;
+  result.cycles = cycles;
+
+  double sum = 0.0;
+  for (double seconds : cycleSeconds) {
+    sum += seconds;
+    result.misses += seconds > period ? 1 : 0;
+  }
+
+  auto sorted = cycleSeconds;
+  std::sort(sorted.begin(), sorted.end());
+  result.meanMs = 1000.0 * sum / cycles;
+  result.p99Ms = 1000.0 * sorted[(size_t)((cycles - 1) * 0.99)];
+  result.maxMs = 1000.0 * sorted.back();
+  result.instanceBlocksPerSecond = (double)numInstances * cycles / sum;
+  result.realtimeMultiple = period * cycles / sum;
+
+  double busy = 0.0;
+  for (const auto &threadStats : stats)
+    busy += threadStats.busySeconds;
+  result.busyPercent = 100.0 * busy / (numThreads * totalSeconds);
+
+  return result;
+}
+
+/** 同じ条件を数回測り、平均のサイクル時間が最も短いものを返す (雑音対策) */
+RunResult runBest(Session &session, const InputSignal &input,
+                  const HostSimOptions &options, int numThreads,
+                  Schedule schedule, int repeats) {
+  RunResult best;
+  for (int i = 0; i < repeats; ++i) {
+    const auto result =
+        runSession(session, input, options, numThreads, schedule);
+    if (i == 0 || result.meanMs < best.meanMs)
+      best = result;
+  }
+  return best;
+}
+
+//==============================================================================
+void printHeader(const HostSimOptions &options) {
+  if (options.csv) {
+    std::printf("threads,schedule,cycles,mean_ms,p99_ms,max_ms,misses,"
+                "instance_blocks_per_sec,realtime_x,busy_percent,"
+                "efficiency\n");
+    return;
+  }
+
+  std::printf("%-8s %-12s %7s %9s %9s %9s %7s %14s %10s %7s %10s\n",
+              "threads", "schedule", "cycles", "mean ms", "p99 ms", "max ms",
+              "misses", "inst-blocks/s", "realtime x", "busy %", "efficiency");
+}
+
+void printResult(const HostSimOptions &options, const RunResult &result,
+                 double efficiency) {
+  const char *format =
+      options.csv
+          ? "%d,%s,%d,%.4f,%.4f,%.4f,%d,%.0f,%.2f,%.1f,%.3f\n"
+          : "%-8d %-12s %7d %9.4f %9.4f %9.4f %7d %14.0f %10.2f %7.1f %10.3f\n";
+  std::printf(format, result.numThreads, getScheduleName(result.schedule),
+              result.cycles, result.meanMs, result.p99Ms, result.maxMs,
+              result.misses, result.instanceBlocksPerSecond,
+              result.realtimeMultiple, result.busyPercent, efficiency);
+  std::fflush(stdout);
+}
+
+int runScaling(const HostSimOptions &options, const InputSignal &input) {
+  Session session(options, false);
+
+  std::vector<int> threadCounts;
+  for (int threads = 1; threads < options.maxThreads; threads *= 2)
+    threadCounts.push_back(threads);
+  threadCounts.push_back(options.maxThreads);
+
+  printHeader(options);
+
+  double singleThroughput = 0.0;
+  for (int threads : threadCounts) {
+    const auto result =
+        runSession(session, input, options, threads, options.schedule);
+    if (threads == 1)
+      singleThroughput = result.instanceBlocksPerSecond;
+
+    printResult(options, result,
+                result.instanceBlocksPerSecond / (threads * singleThroughput));
+  }
+
+  return 0;
+}
+
+/**
+ * 隣り合うインスタンスの間の競合
+ * interleaved / chunked の比 (隣を別スレッドに置いた時の遅さ) を packed と
+ * padded で比べ、packed の方だけが大きければ偽共有を疑う。
+ */
+int runContention(const HostSimOptions &options, const InputSignal &input) {
+  const int threads = options.maxThreads;
+  if (threads < 2) {
+    std::printf("\ncontention: skipped (needs --threads 2 or more)\n");
+    return 0;
+  }
+
+  const int repeats = options.quick ? 2 : 3;
+  const double threshold = 0.05;
+
+  std::printf("\ncontention between adjacent instances (%d threads, best of "
+              "%d):\n",
+              threads, repeats);
+  std::printf("%-8s %16s %16s %10s\n", "layout", "interleaved ms",
+              "chunked ms", "ratio");
+
+  double ratios[2] = {};
+  for (bool padded : {false, true}) {
+    Session session(options, padded);
+    const auto interleaved = runBest(session, input, options, threads,
+                                     Schedule::Interleaved, repeats);
+    const auto chunked =
+        runBest(session, input, options, threads, Schedule::Chunked, repeats);
+
+    ratios[padded] = interleaved.meanMs / chunked.meanMs;
+    std::printf("%-8s %16.4f %16.4f %10.3f\n", padded ? "padded" : "packed",
+                interleaved.meanMs, chunked.meanMs, ratios[padded]);
+  }
+
+  const double excess = ratios[0] / ratios[1] - 1.0;
+  std::printf("packed / padded excess: %+.1f%%", 100.0 * excess);
+
+  // スレッドが時分割で動いている間は同時にラインを取り合わないので判定しない
+  const int hardwareThreads = (int)std::thread::hardware_concurrency();
+  if (threads > hardwareThreads)
+    std::printf(" (not judged: %d threads on %d hardware threads)\n", threads,
+                hardwareThreads);
+  else
+    std::printf(" (%s)\n",
+                excess > threshold
+                    ? "possible false sharing between adjacent instances"
+                    : "no contention above the noise threshold of 5%");
+
+  return 0;
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char **argv) {
+#if VT2W_HOST_SIM_PROCESSOR
+  const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+#endif
+
+  const auto options = parseOptions(argc, argv);
+  const InputSignal input;
+
+  const double period = 1000.0 * options.blockSize / options.sampleRate;
+  if (!options.csv)
+    std::printf("%s: %d instances, block %d @ %.0f Hz (deadline %.3f ms), "
+                "%s, %s, %dx, drive %.1f, mix %.0f%%, hardware threads %u%s\n",
+#if VT2W_HOST_SIM_PROCESSOR
+                "VT2WWhiteProcessor",
+#else
+                "engine (processor mirror)",
+#endif
+                options.numInstances, options.blockSize, options.sampleRate,
+                period,
+                options.settings.model == VT2WModel::Black ? "black" : "white",
+                VT2WKernels::getName(options.settings.quality),
+                1 << options.settings.oversamplingLog2, options.settings.drive,
+                options.settings.mix, std::thread::hardware_concurrency(),
+                options.realtime ? ", paced" : "");
+
+  runScaling(options, input);
+
+  if (options.contention)
+    runContention(options, input);
+
+  return 0;
+}
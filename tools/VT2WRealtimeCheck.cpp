@@ -0,0 +1,804 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Realtime Safety Check (Linux)
+
+    使い方:
+      EA_VT_2W_RealtimeCheck [--quick] [--max-traces <数>]
+
+    malloc / free (new / delete を含む)、mutex・条件変数・セマフォ、
+    止まりうるシステムコール (read / write / open / close / sleep /
+    sched_yield / poll など) を横取りし、オーディオスレッドの区間
+    (VT2WRealtimeGuard::Scope) の中で呼ばれたら違反として数え、
+    スタックトレースを標準エラーに出す。違反が 1 つでもあれば終了コード 1。
+
+    準備 (prepare / prepareToPlay) とメッセージスレッド側の操作は区間の
+    外で行い、準備が終わった後のブロック処理だけを区間に入れる:
+      - 全モデル・品質・倍率・フィルター・ADAA・リンクの組み合わせの
+        float / double 処理 (ブロック長は 1 から最大まで不揃い)
+      - Drive / Mix の変化と、構造が変わる設定の切り替え (クロスフェード)
+      - サンプル単位のオートメーション (VT2WParameterEvents)
+      - Auto Quality の段の上げ下げ
+      - 無音スリープへの出入り、メーター・処理時間の計測と FIFO
+      - プリセットの呼び出し・モーフィング (VT2WTripleBuffer)
+      - 5.1 / 7.1.4 のチャンネル数
+
+    VT2W_REALTIME_CHECK_PROCESSOR を定義してビルドすると
+    (EA_VT_2W_RealtimeCheck_Plugin)、同じ確認を実際の VT2WWhiteProcessor の
+    prepareToPlay / processBlock とパラメータ・プログラム・A/B の変更で行う。
+    プロセッサーにはホストのラッパーの代わりに AudioProcessorListener を
+    登録し、ホストへの通知 (setLatencySamples などの updateHostDisplay) が
+    区間の中で来たら違反にする。JUCE の CriticalSection と、メッセージ
+    スレッドへの送信 (AsyncUpdater::triggerAsyncUpdate、Timer の開始など)
+    は Linux では pthread_mutex_lock とパイプへの write になるので、
+    下の横取りで捕まる (自己テストで確かめる)。
+
+    横取りは glibc の実装に依るので Linux 専用。シンボル名の出たトレースに
+    するため、実行ファイルはシンボルを公開してリンクする (ENABLE_EXPORTS)。
+  ==============================================================================
+*/
+
+// 標準ヘッダーが read / open などを inline の検査付き関数に置き換えると
+// 横取りの定義と衝突するので、ここでは使わない
+#undef _FORTIFY_SOURCE
+
+#if VT2W_REALTIME_CHECK_PROCESSOR
+#include "PluginProcessor.h"
+#endif
+
+#include "dsp/VT2WAdaptiveEngine.h"
+#include "dsp/VT2WAutomation.h"
+#include "dsp/VT2WBlockTimer.h"
+#include "dsp/VT2WMetering.h"
+#include "dsp/VT2WPresetBank.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/select.h>
+#include <sys/types.h>
+#include <time.h>
+
+//==============================================================================
+namespace VT2WRealtimeGuard {
+
+// 区間の入れ子の深さ (0 なら検査しない)。初期化子が定数なので、
+// malloc から最初に触られても動的な初期化は走らない
+thread_local int depth = 0;
+thread_local bool reporting = false;
+thread_local const char *stage = "";
+
+std::atomic<int> numViolations{0};
+std::atomic<int> maxTraces{8};
+
+/** オーディオスレッドの区間 (入れ子にできる) */
+class Scope {
+public:
+  explicit Scope(const char *name) : previousStage(stage) {
+    stage = name;
+    ++depth;
+  }
+
+  ~Scope() {
+    --depth;
+    stage = previousStage;
+  }
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+private:
+  const char *previousStage;
+};
+
+/** 横取りした関数の先頭で呼ぶ。区間の中なら違反として記録する */
+void check(const char *function) {
+  if (depth == 0 || reporting)
+    return;
+
+  // 報告の途中の確保・書き込みは数えない
+  reporting = true;
+  const int count = ++numViolations;
+  if (count <= maxTraces.load()) {
+    std::fprintf(stderr, "\nrealtime violation: %s during \"%s\"\n", function,
+                 stage);
+    void *frames[64];
+    const int numFrames = backtrace(frames, 64);
+    backtrace_symbols_fd(frames + 1, numFrames - 1, 2);
+  } else if (count == maxTraces.load() + 1 && count > 1) {
+    std::fprintf(stderr, "\n(further stack traces suppressed)\n");
+  }
+  reporting = false;
+}
+
+/** 次の (本来の) 定義を引く。横取りの中で確保しないよう結果を保持する */
+template <typename Function>
+Function next(std::atomic<void *> &cache, const char *name) {
+  void *function = cache.load(std::memory_order_relaxed);
+  if (function == nullptr) {
+    function = dlsym(RTLD_NEXT, name);
+    cache.store(function, std::memory_order_relaxed);
+  }
+  return reinterpret_cast<Function>(function);
+}
+
+} // namespace VT2WRealtimeGuard
+
+//==============================================================================
+// 確保 (glibc の本体を直接呼ぶので dlsym を通らない)
+extern "C" {
+void *__libc_malloc(size_t size);
+void __libc_free(void *pointer);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+
+void *malloc(size_t size) {
+  VT2WRealtimeGuard::check("malloc");
+  return __libc_malloc(size);
+}
+
+void free(void *pointer) {
+  if (pointer != nullptr)
+    VT2WRealtimeGuard::check("free");
+  __libc_free(pointer);
+}
+
+void *calloc(size_t count, size_t size) {
+  VT2WRealtimeGuard::check("calloc");
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size) {
+  VT2WRealtimeGuard::check("realloc");
+  return __libc_realloc(pointer, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+  VT2WRealtimeGuard::check("memalign");
+  return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+  VT2WRealtimeGuard::check("aligned_alloc");
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **result, size_t alignment, size_t size) {
+  VT2WRealtimeGuard::check("posix_memalign");
+  if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0)
+    return EINVAL;
+
+  *result = __libc_memalign(alignment, size);
+  return *result != nullptr ? 0 : ENOMEM;
+}
+} // extern "C"
+
+//==============================================================================
+// ロックと待機、止まりうるシステムコール (本来の定義へ転送する)
+#define VT2W_INTERPOSE(result, name, parameters, arguments)                    \
+  extern "C" result name parameters {                                          \
+    static std::atomic<void *> cache{nullptr};                                 \
+    VT2WRealtimeGuard::check(#name);                                           \
+    return VT2WRealtimeGuard::next<result(*) parameters>(cache, #name)         \
+        arguments;                                                             \
+  }
+
+VT2W_INTERPOSE(int, pthread_mutex_lock, (pthread_mutex_t * mutex), (mutex))
+VT2W_INTERPOSE(int, pthread_mutex_timedlock,
+               (pthread_mutex_t * mutex, const struct timespec *time),
+               (mutex, time))
+VT2W_INTERPOSE(int, pthread_rwlock_rdlock, (pthread_rwlock_t * lock), (lock))
+VT2W_INTERPOSE(int, pthread_rwlock_wrlock, (pthread_rwlock_t * lock), (lock))
+VT2W_INTERPOSE(int, pthread_cond_wait,
+               (pthread_cond_t * condition, pthread_mutex_t *mutex),
+               (condition, mutex))
+VT2W_INTERPOSE(int, pthread_cond_timedwait,
+               (pthread_cond_t * condition, pthread_mutex_t *mutex,
+                const struct timespec *time),
+               (condition, mutex, time))
+VT2W_INTERPOSE(int, pthread_cond_signal, (pthread_cond_t * condition),
+               (condition))
+VT2W_INTERPOSE(int, pthread_cond_broadcast, (pthread_cond_t * condition),
+               (condition))
+VT2W_INTERPOSE(int, pthread_join, (pthread_t thread, void **result),
+               (thread, result))
+VT2W_INTERPOSE(int, sem_wait, (sem_t * semaphore), (semaphore))
+VT2W_INTERPOSE(int, sem_timedwait,
+               (sem_t * semaphore, const struct timespec *time),
+               (semaphore, time))
+VT2W_INTERPOSE(int, sem_post, (sem_t * semaphore), (semaphore))
+
+VT2W_INTERPOSE(ssize_t, read, (int file, void *data, size_t size),
+               (file, data, size))
+VT2W_INTERPOSE(ssize_t, write, (int file, const void *data, size_t size),
+               (file, data, size))
+VT2W_INTERPOSE(int, close, (int file), (file))
+VT2W_INTERPOSE(int, fsync, (int file), (file))
+VT2W_INTERPOSE(int, nanosleep,
+               (const struct timespec *time, struct timespec *remaining),
+               (time, remaining))
+VT2W_INTERPOSE(int, clock_nanosleep,
+               (clockid_t clock, int flags, const struct timespec *time,
+                struct timespec *remaining),
+               (clock, flags, time, remaining))
+VT2W_INTERPOSE(int, usleep, (useconds_t microseconds), (microseconds))
+VT2W_INTERPOSE(int, sched_yield, (), ())
+VT2W_INTERPOSE(int, poll, (struct pollfd * files, nfds_t count, int timeout),
+               (files, count, timeout))
+VT2W_INTERPOSE(int, select,
+               (int count, fd_set *readable, fd_set *writable,
+                fd_set *exceptional, struct timeval *timeout),
+               (count, readable, writable, exceptional, timeout))
+VT2W_INTERPOSE(FILE *, fopen, (const char *path, const char *mode),
+               (path, mode))
+VT2W_INTERPOSE(size_t, fwrite,
+               (const void *data, size_t size, size_t count, FILE *file),
+               (data, size, count, file))
+VT2W_INTERPOSE(int, fflush, (FILE * file), (file))
+
+#undef VT2W_INTERPOSE
+
+// open / openat は可変長引数 (mode は O_CREAT の時だけ)
+extern "C" int open(const char *path, int flags, ...) {
+  static std::atomic<void *> cache{nullptr};
+  VT2WRealtimeGuard::check("open");
+  va_list arguments;
+  va_start(arguments, flags);
+  const int mode = va_arg(arguments, int);
+  va_end(arguments);
+  return VT2WRealtimeGuard::next<int (*)(const char *, int, ...)>(
+      cache, "open")(path, flags, mode);
+}
+
+extern "C" int openat(int directory, const char *path, int flags, ...) {
+  static std::atomic<void *> cache{nullptr};
+  VT2WRealtimeGuard::check("openat");
+  va_list arguments;
+  va_start(arguments, flags);
+  const int mode = va_arg(arguments, int);
+  va_end(arguments);
+  return VT2WRealtimeGuard::next<int (*)(int, const char *, int, ...)>(
+      cache, "openat")(directory, path, flags, mode);
+}
+
+namespace {
+
+//==============================================================================
+struct CheckOptions {
+  bool quick = false;
+};
+
+constexpr double kSampleRate = 48000.0;
+constexpr int kMaxBlockSize = 512;
+
+// 不揃いなブロック長 (1 サンプルや最大長、端数も通す)
+constexpr int kBlockSizes[] = {512, 64, 1, 333, 128, 7, 256, 511, 32};
+
+/** 準備済みの入出力バッファ (区間の外で確保する) */
+template <typename Sample> class Buffers {
+public:
+  Buffers(int numChannels, int numSamples)
+      : data((size_t)(numChannels * numSamples)),
+        pointers((size_t)numChannels) {
+    for (int channel = 0; channel < numChannels; ++channel)
+      pointers[(size_t)channel] = data.data() + channel * numSamples;
+  }
+
+  /** サイン波 (silent なら無音) を書く。確保しない */
+  void fill(int numSamples, int64_t position, float amplitude) {
+    for (size_t channel = 0; channel < pointers.size(); ++channel)
+      for (int i = 0; i < numSamples; ++i)
+        pointers[channel][i] = Sample(
+            amplitude *
+            std::sin(0.0575 * double(position + i) + 0.3 * double(channel)));
+  }
+
+  Sample *const *get() { return pointers.data(); }
+  int getNumChannels() const { return (int)pointers.size(); }
+
+private:
+  std::vector<Sample> data;
+  std::vector<Sample *> pointers;
+};
+
+//==============================================================================
+#if VT2W_REALTIME_CHECK_PROCESSOR
+/**
+ * ホストのラッパーの代わり (JUCE の VST3 / AU ラッパーと同じく
+ * プロセッサーのリスナーになる)。通知はラッパーからホストへの呼び出しに
+ * なるので、オーディオスレッドの区間で来たら違反にする
+ */
+class HostListener : public juce::AudioProcessorListener {
+public:
+  void audioProcessorParameterChanged(juce::AudioProcessor *, int,
+                                      float) override {
+    VT2WRealtimeGuard::check("audioProcessorParameterChanged");
+  }
+
+  void audioProcessorChanged(juce::AudioProcessor *,
+                             const ChangeDetails &) override {
+    VT2WRealtimeGuard::check("audioProcessorChanged");
+  }
+};
+
+/** 実際のプラグイン。パラメータ・プログラム・A/B はメッセージスレッド側 */
+class CheckTarget {
+public:
+  ~CheckTarget() {
+    if (processor != nullptr)
+      processor->removeListener(&host);
+  }
+
+  void prepare(const VT2WSettings &settings, int numChannels) {
+    juce::ignoreUnused(numChannels);
+    if (processor == nullptr) {
+      processor = std::make_unique<VT2WWhiteProcessor>();
+      processor->addListener(&host);
+    }
+
+    setSettings(settings);
+    processor->setRateAndBufferSizeDetails(kSampleRate, kMaxBlockSize);
+    processor->prepareToPlay(kSampleRate, kMaxBlockSize);
+    floatBuffer.setSize(2, kMaxBlockSize);
+    doubleBuffer.setSize(2, kMaxBlockSize);
+  }
+
+  /** パラメータの変更 (区間の外、ホストのメッセージスレッドの代わり) */
+  void setSettings(const VT2WSettings &settings) {
+    auto &parameters = processor->getParameters();
+    for (const auto &value : VT2WParameters::getParameterValues(settings))
+      if (auto *parameter = parameters.getParameter(value.id))
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value.value));
+  }
+
+  /** プログラム・A/B・モーフ (区間の外) */
+  void recall(int step) {
+    processor->setCurrentProgram(step % processor->getNumPrograms());
+    processor->selectSlot(step & 1);
+    processor->copyToOtherSlot();
+    if (auto *morph =
+            processor->getParameters().getParameter(VT2WParameters::kMorph))
+      morph->setValueNotifyingHost(float(step % 5) / 4.0f);
+  }
+
+  template <typename Sample>
+  void process(Buffers<Sample> &buffers, int numSamples,
+               const VT2WParameterEvents &events) {
+    juce::ignoreUnused(events);
+    auto &buffer = getBuffer<Sample>();
+    buffer.setDataToReferTo(buffers.get(), 2, numSamples);
+    processor->processBlock(buffer, midi);
+  }
+
+  /** エディターのタイマーが読むもの */
+  void poll() {
+    VT2WMeterFrame frame;
+    while (processor->popMeterFrame(frame)) {
+    }
+    juce::ignoreUnused(processor->getBlockTimer().getSnapshot(),
+                       processor->getQualityLevel());
+  }
+
+private:
+  template <typename Sample> juce::AudioBuffer<Sample> &getBuffer() {
+    if constexpr (std::is_same_v<Sample, double>)
+      return doubleBuffer;
+    else
+      return floatBuffer;
+  }
+
+  HostListener host;
+  std::unique_ptr<VT2WWhiteProcessor> processor;
+  juce::AudioBuffer<float> floatBuffer;
+  juce::AudioBuffer<double> doubleBuffer;
+  juce::MidiBuffer midi;
+};
+#else
+/**
+ * VT2WWhiteProcessor::processSamples と同じ手順 (処理時間の計測・バンクの
+ * 読み出し・モーフ・自動品質・メーター・FIFO) をエンジンで再現する
+ */
+class CheckTarget {
+public:
+  void prepare(const VT2WSettings &settings, int numChannels) {
+    current = settings;
+    publish();
+    engine.applySettings(settings);
+    engine.prepare(kSampleRate, kMaxBlockSize, numChannels);
+  }
+
+  void setSettings(const VT2WSettings &settings) {
+    current = settings;
+    publish();
+  }
+
+  void recall(int step) {
+    const auto &preset = VT2WPresets::getFactoryPreset(step);
+    bank.selectSlot(step & 1, current);
+    bank.copyToOther(current);
+    current = bank.selectProgram(step);
+    current.oversamplingLog2 = preset.settings.oversamplingLog2;
+    morph = float(step % 5) / 4.0f;
+    publish();
+  }
+
+  template <typename Sample>
+  void process(Buffers<Sample> &buffers, int numSamples,
+               const VT2WParameterEvents &events) {
+    const VT2WBlockTimer::Scope timing(blockTimer, numSamples, kSampleRate);
+    const int numChannels = buffers.getNumChannels();
+
+    const auto &snapshot = bankSnapshot.read();
+    const auto settings = snapshot.recalling ? snapshot.target : current;
+    engine.applySettings(
+        VT2WPresets::interpolate(settings, snapshot.other, morph));
+
+    engine.setRealtime(true);
+    engine.reportLoad(load >= 0.0f ? load : blockTimer.getLastLoad(),
+                      numSamples);
+
+    VT2WMeterFrame meter;
+    meter.numSamples = numSamples;
+    VT2WMetering::measure(buffers.get(), numChannels, numSamples,
+                          meter.inputPeak, meter.inputRms);
+
+    if (events.empty())
+      engine.process(buffers.get(), numChannels, numSamples);
+    else
+      engine.process(buffers.get(), numChannels, numSamples, events);
+
+    VT2WMetering::measure(buffers.get(), numChannels, numSamples,
+                          meter.outputPeak, meter.outputRms);
+    meter.envelope = engine.getEnvelopeLevel();
+    meter.makeupGain = engine.getMakeupGain();
+    meterFifo.push(meter);
+  }
+
+  void poll() {
+    VT2WMeterFrame frame;
+    while (meterFifo.pop(frame)) {
+    }
+    (void)blockTimer.getSnapshot();
+    maxLevel = std::max(maxLevel, engine.getLevel());
+  }
+
+  /** poll で見た最も低い品質の段 (Auto Quality が動いたことの確認用) */
+  int getMaxLevel() const { return maxLevel; }
+
+  /** 負荷率を差し替える (負なら実測)。Auto Quality の段を動かす用 */
+  void overrideLoad(float newLoad) { load = newLoad; }
+
+private:
+  void publish() {
+    VT2WBankSnapshot snapshot;
+    snapshot.target = current;
+    snapshot.other = bank.getOther();
+    bankSnapshot.write(snapshot);
+  }
+
+  VT2WSettings current;
+  VT2WPresetBank bank;
+  VT2WTripleBuffer<VT2WBankSnapshot> bankSnapshot;
+  float morph = 0.0f;
+  float load = -1.0f;
+  int maxLevel = 0;
+
+  VT2WAdaptiveEngine engine;
+  VT2WBlockTimer blockTimer;
+  VT2WMeterFifo meterFifo;
+};
+#endif
+
+//==============================================================================
+/** 全ての構造の組み合わせ (切り替えの順番もこの並び) */
+std::vector<VT2WSettings> makeConfigurations() {
+  std::vector<VT2WSettings> configurations;
+  for (auto model : {VT2WModel::White, VT2WModel::Black})
+    for (auto quality :
+         {VT2WSaturationQuality::Eco, VT2WSaturationQuality::Standard,
+          VT2WSaturationQuality::Reference})
+      for (int oversamplingLog2 = 0; oversamplingLog2 <= 3;
+           ++oversamplingLog2)
+        for (auto filter : {VT2WOversamplingFilter::PolyphaseIIR,
+                            VT2WOversamplingFilter::LinearPhaseFIR})
+          for (bool adaa : {false, true}) {
+            if (oversamplingLog2 == 0 &&
+                filter == VT2WOversamplingFilter::LinearPhaseFIR)
+              continue;
+
+            VT2WSettings settings;
+            settings.model = model;
+            settings.quality = quality;
+            settings.oversamplingLog2 = oversamplingLog2;
+            settings.oversamplingFilter = filter;
+            settings.adaa = adaa;
+            settings.link = adaa; // 組み合わせを増やさずにリンクも通す
+            settings.drive = 4.0f;
+            settings.mix = 80.0f;
+            configurations.push_back(settings);
+          }
+  return configurations;
+}
+
+/** numBlocks ブロックを処理する (区間の中で呼ぶ) */
+template <typename Sample>
+void runBlocks(CheckTarget &target, Buffers<Sample> &buffers,
+               VT2WParameterEvents &events, int numBlocks, float amplitude,
+               bool automate, int64_t &position) {
+  for (int block = 0; block < numBlocks; ++block) {
+    const int numSamples =
+        kBlockSizes[(size_t)block % std::size(kBlockSizes)];
+    buffers.fill(numSamples, position, amplitude);
+
+    events.clear();
+    if (automate)
+      for (int i = 0; i < numSamples; i += 37) {
+        const float phase = float(position + i) * 1.0e-3f;
+        events.add(i, VT2WAutomatedParameter::Drive,
+                   5.0f + 5.0f * std::sin(phase));
+        events.add(i + 11, VT2WAutomatedParameter::Mix,
+                   50.0f + 50.0f * std::cos(phase));
+      }
+
+    target.process(buffers, numSamples, events);
+    target.poll();
+    position += numSamples;
+  }
+}
+
+/** 1 つの確認の結果を表示する */
+bool report(const char *name, int violationsBefore) {
+  const int violations = VT2WRealtimeGuard::numViolations - violationsBefore;
+  std::printf("%-44s %6d violations %s\n", name, violations,
+              violations == 0 ? "OK" : "FAIL");
+  std::fflush(stdout);
+  return violations == 0;
+}
+
+template <typename Sample>
+bool checkPrecision(const CheckOptions &options, const char *name) {
+  using Guard = VT2WRealtimeGuard::Scope;
+  const auto configurations = makeConfigurations();
+  const int blocksPerStep = options.quick ? 6 : 24;
+  bool passed = true;
+
+  CheckTarget target;
+  Buffers<Sample> buffers(2, kMaxBlockSize);
+  VT2WParameterEvents events;
+  int64_t position = 0;
+
+  // 構造毎に準備し直し、準備の後のブロック処理を確認する
+  std::string label;
+  int before = VT2WRealtimeGuard::numViolations;
+  for (const auto &settings : configurations) {
+    target.prepare(settings, 2);
+    const Guard guard("process");
+    runBlocks(target, buffers, events, blocksPerStep, 0.5f, false, position);
+  }
+  label = std::string(name) + " process, all configurations";
+  passed &= report(label.c_str(), before);
+
+  // 1 度だけ準備し、メッセージスレッド側で設定を変えながら処理する
+  // (Drive / Mix の変化と構造の切り替えのクロスフェード)
+  before = VT2WRealtimeGuard::numViolations;
+  target.prepare(configurations.front(), 2);
+  for (size_t i = 0; i < configurations.size(); ++i) {
+    auto settings = configurations[i];
+    settings.drive = float(i % 11);
+    settings.mix = float((i * 37) % 101);
+    target.setSettings(settings);
+
+    const Guard guard("parameter changes");
+    runBlocks(target, buffers, events, blocksPerStep / 2, 0.5f, false,
+              position);
+  }
+  label = std::string(name) + " parameter and structure changes";
+  passed &= report(label.c_str(), before);
+
+  before = VT2WRealtimeGuard::numViolations;
+  for (int step = 0; step < 2 * VT2WPresets::getNumFactoryPresets(); ++step) {
+    target.recall(step);
+    const Guard guard("presets");
+    runBlocks(target, buffers, events, blocksPerStep / 2, 0.5f, false,
+              position);
+  }
+  label = std::string(name) + " presets, A/B and morph";
+  passed &= report(label.c_str(), before);
+
+#if !VT2W_REALTIME_CHECK_PROCESSOR
+  before = VT2WRealtimeGuard::numViolations;
+  {
+    const Guard guard("automation");
+    runBlocks(target, buffers, events, 4 * blocksPerStep, 0.5f, true,
+              position);
+  }
+  label = std::string(name) + " sample-accurate automation";
+  passed &= report(label.c_str(), before);
+
+  // 重い負荷を報告して段を下げ、軽い負荷で戻す (モーフの残っていない
+  // 新しいインスタンスで)
+  before = VT2WRealtimeGuard::numViolations;
+  CheckTarget adaptiveTarget;
+  auto adaptive = configurations.back();
+  adaptive.adaptive = true;
+  adaptiveTarget.prepare(adaptive, 2);
+
+  int totalSamples = 0;
+  for (int numSamples : kBlockSizes)
+    totalSamples += numSamples;
+  const int blocksPerSecond =
+      (int)(kSampleRate * std::size(kBlockSizes) / totalSamples);
+  const int seconds = options.quick ? 6 : 12;
+  for (float load : {3.0f, 0.05f}) {
+    adaptiveTarget.overrideLoad(load);
+    const Guard guard("auto quality");
+    runBlocks(adaptiveTarget, buffers, events, seconds * blocksPerSecond, 0.5f,
+              false, position);
+  }
+  label = std::string(name) + " auto quality steps";
+  passed &= report(label.c_str(), before);
+
+  // 段が動いていなければ確認したことにならない
+  if (adaptiveTarget.getMaxLevel() == 0) {
+    std::printf("%-44s quality level never changed FAIL\n", label.c_str());
+    passed = false;
+  }
+#endif
+
+  // 無音スリープへ入って出る
+  before = VT2WRealtimeGuard::numViolations;
+  target.prepare(configurations[configurations.size() / 2], 2);
+  for (float amplitude : {0.0f, 0.5f, 0.0f, 0.5f}) {
+    const Guard guard("silence");
+    runBlocks(target, buffers, events, 4 * blocksPerStep, amplitude, false,
+              position);
+  }
+  label = std::string(name) + " silence sleep and wake";
+  passed &= report(label.c_str(), before);
+
+  return passed;
+}
+
+#if !VT2W_REALTIME_CHECK_PROCESSOR
+bool checkMultichannel(const CheckOptions &options) {
+  using Guard = VT2WRealtimeGuard::Scope;
+  const int before = VT2WRealtimeGuard::numViolations;
+  VT2WParameterEvents events;
+  int64_t position = 0;
+
+  for (int numChannels : {6, 12}) {
+    for (bool link : {false, true}) {
+      CheckTarget target;
+      Buffers<float> buffers(numChannels, kMaxBlockSize);
+      VT2WSettings settings;
+      settings.link = link;
+      settings.oversamplingLog2 = 2;
+      target.prepare(settings, numChannels);
+
+      const Guard guard("multichannel");
+      runBlocks(target, buffers, events, options.quick ? 12 : 48, 0.5f,
+                link, position);
+    }
+  }
+  return report("float 5.1 / 7.1.4, linked and unlinked", before);
+}
+#endif
+
+CheckOptions parseOptions(int argc, char **argv) {
+  CheckOptions options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--quick")
+      options.quick = true;
+    else if (arg == "--max-traces" && i + 1 < argc)
+      VT2WRealtimeGuard::maxTraces = std::max(0, std::atoi(argv[++i]));
+  }
+  return options;
+}
+
+bool checkGuard() {
+  // 横取りが効いていること (効いていなければ全部 OK になってしまう)
+  const int before = VT2WRealtimeGuard::numViolations;
+  const int traces = VT2WRealtimeGuard::maxTraces.exchange(0);
+  {
+    const VT2WRealtimeGuard::Scope guard("self test");
+    std::vector<float> allocation(16);
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_lock(&mutex);
+    pthread_mutex_unlock(&mutex);
+  }
+  VT2WRealtimeGuard::maxTraces = traces;
+
+  const int detected = VT2WRealtimeGuard::numViolations - before;
+  VT2WRealtimeGuard::numViolations = before;
+  std::printf("%-44s %6d violations %s\n",
+              "self test (allocation, free and lock expected)", detected,
+              detected == 3 ? "OK" : "FAIL");
+  return detected == 3;
+}
+
+#if VT2W_REALTIME_CHECK_PROCESSOR
+/** 区間の中で fn を呼び、違反の数を返す (トレースは出さない) */
+template <typename Function> int countViolations(Function &&fn) {
+  const int before = VT2WRealtimeGuard::numViolations;
+  const int traces = VT2WRealtimeGuard::maxTraces.exchange(0);
+  {
+    const VT2WRealtimeGuard::Scope guard("self test");
+    fn();
+  }
+  VT2WRealtimeGuard::maxTraces = traces;
+
+  const int detected = VT2WRealtimeGuard::numViolations - before;
+  VT2WRealtimeGuard::numViolations = before;
+  return detected;
+}
+
+bool checkHostNotifications() {
+  // processBlock から呼んではいけない JUCE の呼び出しが捕まること
+  // (ホストへの通知はリスナーとロック、メッセージの送信はロックと write)
+  HostListener host;
+  auto processor = std::make_unique<VT2WWhiteProcessor>();
+  processor->addListener(&host);
+  processor->prepareToPlay(kSampleRate, kMaxBlockSize);
+
+  struct Updater : public juce::AsyncUpdater {
+    void handleAsyncUpdate() override {}
+  } updater;
+
+  const int latency = countViolations([&] {
+    processor->setLatencySamples(processor->getLatencySamples() + 1);
+  });
+  const int update = countViolations([&] { updater.triggerAsyncUpdate(); });
+  updater.cancelPendingUpdate();
+  processor->removeListener(&host);
+
+  const bool ok = latency > 0 && update > 0;
+  std::printf("%-44s %6d violations %s\n",
+              "self test (setLatencySamples, async update)", latency + update,
+              ok ? "OK" : "FAIL");
+  return ok;
+}
+#endif
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char **argv) {
+#if VT2W_REALTIME_CHECK_PROCESSOR
+  const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+#endif
+
+  const auto options = parseOptions(argc, argv);
+
+  // backtrace は最初の呼び出しで libgcc を読み込む (確保する) ので先に済ませる
+  void *frame = nullptr;
+  backtrace(&frame, 1);
+
+  bool passed = checkGuard();
+#if VT2W_REALTIME_CHECK_PROCESSOR
+  passed &= checkHostNotifications();
+#endif
+  passed &= checkPrecision<float>(options, "float ");
+  passed &= checkPrecision<double>(options, "double");
+#if !VT2W_REALTIME_CHECK_PROCESSOR
+  passed &= checkMultichannel(options);
+#endif
+
+  std::printf("%s\n", passed ? "realtime safety: OK"
+                             : "realtime safety: FAIL (see stack traces)");
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,668 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Offline Batch Renderer
+
+    使い方:
+      EA_VT_2W_Render [オプション] <入力ファイル>...
+
+    --drive <0-10>          Drive (既定 0)
+    --mix <0-100>           Mix % (既定 100)
+    --model <モデル>        white / black (既定 white)
+    --quality <品質>        eco / standard / reference (既定 standard)
+    --oversampling <倍率>   1 / 2 / 4 / 8 (既定 2)
+    --os-filter <方式>      iir / fir (既定 iir)
+    --adaa / --link         ADAA / エンベロープのリンクを有効にする
+    --state <ファイル>      getStateInformation で保存した状態を読み込む
+                            (保存時の Morph の位置も反映する。
+                            後に書いたオプションの方が優先)
+    --output-dir <dir>      出力先 (既定は入力と同じディレクトリ)
+    --suffix <文字列>       出力ファイル名に付ける接尾辞 (既定 "_vt2w")
+    --format <形式>         wav / aiff / flac (既定は入力と同じ)
+    --bits <16|24|32>       出力のビット深度 (既定は入力と同じ)
+    --jobs <N>              並列に処理するファイル数 (既定は CPU 数)
+    --block <N>             1 回に読み込み・処理するサンプル数 (既定 4096)
+    --segments              1 ファイルを区間に分けて --jobs 個のスレッドで
+                            処理する (長い 1 本の録音向け、ファイルは順番に処理)
+    --segment-seconds <秒>  区間の長さ (既定 60、warm-up の 8 倍以上になる)
+                            --segments ではレイテンシは常に補正する
+    --automation <ファイル> Drive / Mix のオートメーション (1 行に
+                            "秒,drive|mix,値"、# 以降はコメント)。変化点の
+                            サンプルでブロックを分けるので、--block を変えても
+                            同じ出力になる (--segments とは併用できない)
+    --deterministic         決定的モード (VT2WWhiteEngine::setDeterministic)。
+                            CPU の命令セット・--block・ビルド環境に依らず
+                            ビット単位で同じ出力になる (--segments とは
+                            併用できない)
+    --no-latency-compensation
+                            プラグインのレイテンシ分のずれを補正しない
+    --overwrite             出力ファイルが既にあれば上書きする
+
+    WAV / AIFF / FLAC を対応ブロックずつ読みながら処理して書き出す
+    (ファイル全体をメモリに載せない)。処理はプラグインと同じエンジンと
+    パラメータ変換 (VT2WWhiteEngine::applySettings) を通るので、同じ設定なら
+    プラグインと同じ出力になる。出力はレイテンシを補正して入力と同じ長さ。
+    --segments の出力と逐次処理の差は
+    VT2WSegmentRenderer::kSegmentTolerance 以下。
+  ==============================================================================
+*/
+
+#include "VT2WParameters.h"
+#include "dsp/VT2WPresetBank.h"
+#include "dsp/VT2WSegmentRenderer.h"
+#include "dsp/VT2WWhiteEngine.h"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/** オートメーションの 1 点 (ファイル先頭からの秒) */
+struct AutomationPoint {
+  double seconds;
+  VT2WAutomatedParameter parameter;
+  float value;
+};
+
+struct RenderOptions {
+  VT2WSettings settings;
+  std::vector<AutomationPoint> automation; // 時刻順
+  juce::File outputDirectory;
+  juce::String suffix = "_vt2w";
+  juce::String format; // 空なら入力と同じ
+  int bitDepth = 0;    // 0 なら入力と同じ
+  int numJobs = 0;     // 0 なら CPU 数
+  int blockSize = 4096;
+  bool segmented = false;
+  double segmentSeconds = 60.0;
+  bool deterministic = false;
+  bool compensateLatency = true;
+  bool overwrite = false;
+  juce::Array<juce::File> inputs;
+};
+
+struct RenderResult {
+  bool ok = false;
+  juce::String message;
+  double audioSeconds = 0.0;
+  double processSeconds = 0.0;
+};
+
+//==============================================================================
+[[noreturn]] void usage(const char *program) {
+  std::fprintf(stderr,
+               "usage: %s [--drive 0-10] [--mix 0-100] [--model white|black] "
+               "[--quality eco|standard|reference] "
+               "[--oversampling 1|2|4|8] [--os-filter iir|fir] [--adaa] "
+               "[--link] [--state <file>] [--output-dir <dir>] "
+               "[--suffix <text>] [--format wav|aiff|flac] [--bits 16|24|32] "
+               "[--jobs <n>] [--block <n>] [--segments] "
+               "[--segment-seconds <s>] "
+               "[--automation <file>] [--deterministic] "
+               "[--no-latency-compensation] "
+               "[--overwrite] <input>...\n",
+               program);
+  std::exit(1);
+}
+
+bool parseChoice(const std::string &name,
+                 std::initializer_list<const char *> choices, int &index) {
+  int i = 0;
+  for (const char *choice : choices) {
+    if (name == choice) {
+      index = i;
+      return true;
+    }
+    ++i;
+  }
+
+  return false;
+}
+
+bool loadState(const juce::File &file, VT2WSettings &settings) {
+  juce::MemoryBlock data;
+  if (!file.loadFileAsData(data))
+    return false;
+
+  // プラグインと同じく、保存時の Morph の位置で他方のスロットへ寄せる
+  VT2WStateFormat::BankState bank;
+  if (!VT2WParameters::readStateBlob(data.getData(), (int)data.getSize(),
+                                     settings, &bank))
+    return false;
+
+  settings =
+      VT2WPresets::interpolate(settings, bank.other, bank.morph / 100.0f);
+  return true;
+}
+
+/** "秒,drive|mix,値" の行を読む (空行と # 以降は無視) */
+bool loadAutomation(const juce::File &file,
+                    std::vector<AutomationPoint> &points) {
+  if (!file.existsAsFile())
+    return false;
+
+  juce::StringArray lines;
+  file.readLines(lines);
+
+  for (auto line : lines) {
+    line = line.upToFirstOccurrenceOf("#", false, false).trim();
+    if (line.isEmpty())
+      continue;
+
+    const auto fields = juce::StringArray::fromTokens(line, ",", "");
+    if (fields.size() != 3)
+      return false;
+
+    const auto name = fields[1].trim().toLowerCase();
+    if (name != "drive" && name != "mix")
+      return false;
+
+    const bool drive = name == "drive";
+    const float value = fields[2].trim().getFloatValue();
+    points.push_back(
+        {std::max(0.0, fields[0].trim().getDoubleValue()),
+         drive ? VT2WAutomatedParameter::Drive : VT2WAutomatedParameter::Mix,
+         drive ? juce::jlimit(VT2WConstants::kDriveMin,
+                              VT2WConstants::kDriveMax, value)
+               : juce::jlimit(VT2WConstants::kMixMin, VT2WConstants::kMixMax,
+                              value)});
+  }
+
+  std::stable_sort(points.begin(), points.end(),
+                   [](const auto &a, const auto &b) {
+                     return a.seconds < b.seconds;
+                   });
+  return true;
+}
+
+RenderOptions parseOptions(int argc, char **argv) {
+  RenderOptions options;
+  auto &settings = options.settings;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    int index = 0;
+
+    if (arg == "--drive" && hasValue) {
+      settings.drive = juce::jlimit(VT2WConstants::kDriveMin,
+                                    VT2WConstants::kDriveMax,
+                                    (float)std::atof(argv[++i]));
+    } else if (arg == "--mix" && hasValue) {
+      settings.mix = juce::jlimit(VT2WConstants::kMixMin,
+                                  VT2WConstants::kMixMax,
+                                  (float)std::atof(argv[++i]));
+    } else if (arg == "--model" && hasValue &&
+               parseChoice(argv[i + 1], {"white", "black"}, index)) {
+      settings.model = static_cast<VT2WModel>(index);
+      ++i;
+    } else if (arg == "--quality" && hasValue &&
+               parseChoice(argv[i + 1], {"eco", "standard", "reference"},
+                           index)) {
+      settings.quality = static_cast<VT2WSaturationQuality>(index);
+      ++i;
+    } else if (arg == "--oversampling" && hasValue &&
+               parseChoice(argv[i + 1], {"1", "2", "4", "8"}, index)) {
+      settings.oversamplingLog2 = index;
+      ++i;
+    } else if (arg == "--os-filter" && hasValue &&
+               parseChoice(argv[i + 1], {"iir", "fir"}, index)) {
+      settings.oversamplingFilter = static_cast<VT2WOversamplingFilter>(index);
+      ++i;
+    } else if (arg == "--adaa") {
+      settings.adaa = true;
+    } else if (arg == "--link") {
+      settings.link = true;
+    } else if (arg == "--state" && hasValue) {
+      const juce::File file =
+          juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+      if (!loadState(file, settings)) {
+        std::fprintf(stderr, "%s is not a VT-2W White state\n", argv[i]);
+        std::exit(1);
+      }
+    } else if (arg == "--output-dir" && hasValue) {
+      options.outputDirectory =
+          juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+    } else if (arg == "--suffix" && hasValue) {
+      options.suffix = argv[++i];
+    } else if (arg == "--format" && hasValue &&
+               parseChoice(argv[i + 1], {"wav", "aiff", "flac"}, index)) {
+      options.format = juce::String(".") + argv[++i];
+    } else if (arg == "--bits" && hasValue &&
+               parseChoice(argv[i + 1], {"16", "24", "32"}, index)) {
+      options.bitDepth = 16 + 8 * index;
+      ++i;
+    } else if (arg == "--jobs" && hasValue) {
+      options.numJobs = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--block" && hasValue) {
+      options.blockSize = juce::jlimit(16, 1 << 20, std::atoi(argv[++i]));
+    } else if (arg == "--segments") {
+      options.segmented = true;
+    } else if (arg == "--segment-seconds" && hasValue) {
+      options.segmentSeconds = std::max(1.0, std::atof(argv[++i]));
+    } else if (arg == "--automation" && hasValue) {
+      const juce::File file =
+          juce::File::getCurrentWorkingDirectory().getChildFile(argv[++i]);
+      options.automation.clear();
+      if (!loadAutomation(file, options.automation)) {
+        std::fprintf(stderr, "%s is not a valid automation file\n", argv[i]);
+        std::exit(1);
+      }
+    } else if (arg == "--deterministic") {
+      options.deterministic = true;
+    } else if (arg == "--no-latency-compensation") {
+      options.compensateLatency = false;
+    } else if (arg == "--overwrite") {
+      options.overwrite = true;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      usage(argv[0]);
+    } else {
+      options.inputs.add(
+          juce::File::getCurrentWorkingDirectory().getChildFile(argv[i]));
+    }
+  }
+
+  if (options.inputs.isEmpty())
+    usage(argv[0]);
+
+  // 区間レンダーは各区間を設定の値から処理し直すので、時間で変わる値は扱えない
+  if (options.segmented && !options.automation.empty()) {
+    std::fprintf(stderr, "--automation cannot be combined with --segments\n");
+    std::exit(1);
+  }
+
+  // 区間の継ぎ目は warm-up で近づけるだけなので、ビット単位では一致しない
+  if (options.segmented && options.deterministic) {
+    std::fprintf(stderr,
+                 "--deterministic cannot be combined with --segments\n");
+    std::exit(1);
+  }
+
+  return options;
+}
+
+//==============================================================================
+/** 出力形式が対応しているビット深度から選ぶ (無ければ対応している最大) */
+int chooseBitDepth(juce::AudioFormat &format, int requested,
+                   const juce::AudioFormatReader &reader) {
+  const int readerDepth =
+      reader.usesFloatingPointData ? 32 : (int)reader.bitsPerSample;
+  const int preferred = requested > 0 ? requested : readerDepth;
+  const auto depths = format.getPossibleBitDepths();
+
+  if (depths.contains(preferred) || depths.isEmpty())
+    return preferred;
+
+  return depths.getLast();
+}
+
+juce::File getOutputFile(const juce::File &input,
+                         const RenderOptions &options) {
+  const auto directory = options.outputDirectory == juce::File()
+                             ? input.getParentDirectory()
+                             : options.outputDirectory;
+  const auto extension =
+      options.format.isEmpty() ? input.getFileExtension() : options.format;
+
+  return directory.getChildFile(input.getFileNameWithoutExtension() +
+                                options.suffix + extension);
+}
+
+/** 出力ファイルを作る (失敗したら result.message に理由を入れて null を返す) */
+std::unique_ptr<juce::AudioFormatWriter>
+createWriter(const juce::File &input, const RenderOptions &options,
+             juce::AudioFormatManager &formats,
+             const juce::AudioFormatReader &reader, RenderResult &result) {
+  const auto output = getOutputFile(input, options);
+  auto *format = formats.findFormatForFileExtension(output.getFileExtension());
+  if (format == nullptr) {
+    result.message = "unsupported output format " + output.getFileExtension();
+    return nullptr;
+  }
+
+  if (output == input || (output.exists() && !options.overwrite)) {
+    result.message = output.getFullPathName() + " already exists";
+    return nullptr;
+  }
+
+  output.deleteFile();
+  output.getParentDirectory().createDirectory();
+
+  std::unique_ptr<juce::OutputStream> stream(output.createOutputStream());
+  std::unique_ptr<juce::AudioFormatWriter> writer;
+  if (stream != nullptr)
+    writer.reset(format->createWriterFor(
+        stream.get(), reader.sampleRate, reader.numChannels,
+        chooseBitDepth(*format, options.bitDepth, reader),
+        reader.metadataValues, 0));
+
+  if (writer == nullptr) {
+    result.message = "cannot create " + output.getFullPathName();
+    return nullptr;
+  }
+
+  stream.release(); // writer が所有する
+  result.message = output.getFullPathName();
+  return writer;
+}
+
+/**
+ * 1 ファイルを処理する (ワーカースレッドから呼ぶ)
+ * 読み込み -> エンジン -> 書き出しを blockSize ずつ繰り返す。レイテンシ分は
+ * 先頭を捨て、末尾は無音を流して押し出すので、出力は入力と同じ長さになる。
+ */
+RenderResult renderFile(const juce::File &input, const RenderOptions &options,
+                        juce::AudioFormatManager &formats) {
+  // プラグインの processBlock と同じ浮動小数点環境にする
+  juce::ScopedNoDenormals noDenormals;
+
+  RenderResult result;
+  const auto start = std::chrono::steady_clock::now();
+
+  std::unique_ptr<juce::AudioFormatReader> reader(
+      formats.createReaderFor(input));
+  if (reader == nullptr) {
+    result.message = "unsupported or unreadable file";
+    return result;
+  }
+
+  auto writer = createWriter(input, options, formats, *reader, result);
+  if (writer == nullptr)
+    return result;
+
+  const int numChannels = (int)reader->numChannels;
+  const juce::int64 length = reader->lengthInSamples;
+  const int blockSize = options.blockSize;
+
+  // プラグインと同じ順番: 設定 -> prepare -> ブロック毎に設定 + process
+  VT2WWhiteEngine engine;
+  engine.setDeterministic(options.deterministic);
+  engine.applySettings(options.settings);
+  engine.prepare(reader->sampleRate, blockSize, numChannels);
+
+  juce::int64 toSkip =
+      options.compensateLatency ? engine.getLatencySamples() : 0;
+  juce::int64 readPosition = 0;
+  juce::int64 written = 0;
+  juce::AudioBuffer<float> buffer(numChannels, blockSize);
+
+  // オートメーションはブロック毎に変化点の列にして渡す。ブロックの先頭で
+  // 反映する設定も、直前までの変化点を反映した値にしておく
+  auto settings = options.settings;
+  std::vector<VT2WAutomationPoint> points;
+  for (const auto &point : options.automation)
+    points.push_back(
+        {(int64_t)std::llround(point.seconds * reader->sampleRate),
+         point.parameter, point.value});
+
+  VT2WParameterEvents events;
+  std::vector<float *> span((size_t)numChannels);
+  size_t nextPoint = 0;
+  juce::int64 processed = 0; // 処理したサンプル数 (末尾の無音も含む)
+
+  while (written < length) {
+    const int numToRead =
+        (int)juce::jlimit<juce::int64>(0, blockSize, length - readPosition);
+
+    buffer.clear();
+    if (numToRead > 0 &&
+        !reader->read(&buffer, 0, numToRead, readPosition, true, true)) {
+      result.message = "read error";
+      return result;
+    }
+    readPosition += numToRead;
+
+    // 1 ブロックの変化点が列に入りきらなければ、区間に分けて渡される
+    VT2WAutomation::forEachSpan(
+        points.data(), points.size(), nextPoint, processed, blockSize, events,
+        [&](int spanStart, int spanLength,
+            const VT2WParameterEvents &spanEvents) {
+          for (int ch = 0; ch < numChannels; ++ch)
+            span[(size_t)ch] = buffer.getWritePointer(ch, spanStart);
+
+          engine.applySettings(settings);
+          engine.process(span.data(), numChannels, spanLength, spanEvents);
+
+          for (const auto &event : spanEvents) {
+            if (event.parameter == VT2WAutomatedParameter::Drive)
+              settings.drive = event.value;
+            else
+              settings.mix = event.value;
+          }
+        });
+
+    processed += blockSize;
+
+    const int skip = (int)std::min<juce::int64>(toSkip, blockSize);
+    toSkip -= skip;
+    const int numToWrite =
+        (int)std::min<juce::int64>(blockSize - skip, length - written);
+
+    if (numToWrite > 0 &&
+        !writer->writeFromAudioSampleBuffer(buffer, skip, numToWrite)) {
+      result.message = "write error";
+      return result;
+    }
+    written += numToWrite;
+  }
+
+  writer.reset();
+
+  result.ok = true;
+  result.audioSeconds = (double)length / reader->sampleRate;
+  result.processSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return result;
+}
+
+//==============================================================================
+/** 区間レンダー用の読み出し元 (ワーカーごとに別のリーダーを持つ) */
+class ReaderSource : public VT2WSegmentRenderer::Source {
+public:
+  explicit ReaderSource(const juce::File &file) {
+    formats.registerBasicFormats();
+    reader.reset(formats.createReaderFor(file));
+  }
+
+  bool isValid() const { return reader != nullptr; }
+
+  bool read(float *const *channels, int numChannels, int64_t position,
+            int numSamples) override {
+    return reader->read(channels, numChannels, position, numSamples);
+  }
+
+private:
+  juce::AudioFormatManager formats;
+  std::unique_ptr<juce::AudioFormatReader> reader;
+};
+
+/**
+ * 1 ファイルを区間に分けて numWorkers 本のスレッドで処理する
+ * numWorkers 個の区間をまとめて処理し、順番に書き出すのを繰り返すので、
+ * メモリはファイルの長さに依らず numWorkers 区間分で済む。
+ * レイテンシは常に補正する。
+ */
+RenderResult renderFileSegmented(const juce::File &input,
+                                 const RenderOptions &options,
+                                 juce::AudioFormatManager &formats,
+                                 int numWorkers) {
+  RenderResult result;
+  const auto start = std::chrono::steady_clock::now();
+
+  std::unique_ptr<juce::AudioFormatReader> reader(
+      formats.createReaderFor(input));
+  if (reader == nullptr) {
+    result.message = "unsupported or unreadable file";
+    return result;
+  }
+
+  auto writer = createWriter(input, options, formats, *reader, result);
+  if (writer == nullptr)
+    return result;
+
+  const int numChannels = (int)reader->numChannels;
+  const juce::int64 length = reader->lengthInSamples;
+
+  const VT2WSegmentRenderer renderer(options.settings, reader->sampleRate,
+                                     numChannels, options.blockSize);
+  const juce::int64 segmentLength =
+      std::max<juce::int64>(renderer.getMinimumSegmentLength(),
+               (juce::int64)(options.segmentSeconds * reader->sampleRate));
+  const juce::int64 numSegments =
+      std::max<juce::int64>(1, (length + segmentLength - 1) / segmentLength);
+  numWorkers = (int)std::min<juce::int64>(numWorkers, numSegments);
+
+  std::vector<std::unique_ptr<ReaderSource>> sources;
+  std::vector<juce::AudioBuffer<float>> segments;
+  for (int w = 0; w < numWorkers; ++w) {
+    sources.push_back(std::make_unique<ReaderSource>(input));
+    if (!sources.back()->isValid()) {
+      result.message = "unsupported or unreadable file";
+      return result;
+    }
+    segments.emplace_back(numChannels, (int)segmentLength);
+  }
+
+  for (juce::int64 first = 0; first < numSegments; first += numWorkers) {
+    const int numInWave = (int)std::min<juce::int64>(numWorkers,
+                                                     numSegments - first);
+    std::atomic<bool> succeeded{true};
+
+    auto work = [&](int w) {
+      // プラグインの processBlock と同じ浮動小数点環境にする
+      juce::ScopedNoDenormals noDenormals;
+
+      const juce::int64 segmentStart = (first + w) * segmentLength;
+      const juce::int64 numSamples =
+          std::min(segmentLength, length - segmentStart);
+      auto *const *channels = segments[(size_t)w].getArrayOfWritePointers();
+      if (!renderer.renderSegment(*sources[(size_t)w], length, segmentStart,
+                                  numSamples, channels))
+        succeeded = false;
+    };
+
+    std::vector<std::thread> threads;
+    for (int w = 1; w < numInWave; ++w)
+      threads.emplace_back(work, w);
+    work(0);
+    for (auto &thread : threads)
+      thread.join();
+
+    if (!succeeded) {
+      result.message = "read error";
+      return result;
+    }
+
+    for (int w = 0; w < numInWave; ++w) {
+      const juce::int64 segmentStart = (first + w) * segmentLength;
+      const int numSamples =
+          (int)std::min(segmentLength, length - segmentStart);
+      if (!writer->writeFromAudioSampleBuffer(segments[(size_t)w], 0,
+                                              numSamples)) {
+        result.message = "write error";
+        return result;
+      }
+    }
+  }
+
+  writer.reset();
+
+  result.ok = true;
+  result.audioSeconds = (double)length / reader->sampleRate;
+  result.processSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return result;
+}
+
+} // namespace
+
+//==============================================================================
+int main(int argc, char **argv) {
+  const auto options = parseOptions(argc, argv);
+  const int numFiles = options.inputs.size();
+  const int numJobs =
+      options.numJobs > 0 ? options.numJobs : juce::SystemStats::getNumCpus();
+
+  // --segments ではファイルを順番に、各ファイルを numJobs 本で処理する
+  const int numWorkers = options.segmented ? 1 : std::min(numFiles, numJobs);
+
+  std::printf("%s, drive %.1f, mix %.0f%%, quality %s, oversampling %dx "
+              "%s%s%s, %d files on %d %s\n",
+              VT2WModels::getName(options.settings.model),
+              options.settings.drive, options.settings.mix,
+              VT2WKernels::getName(options.settings.quality),
+              1 << options.settings.oversamplingLog2,
+              options.settings.oversamplingFilter ==
+                      VT2WOversamplingFilter::LinearPhaseFIR
+                  ? "fir"
+                  : "iir",
+              options.settings.adaa ? " + ADAA" : "",
+              options.settings.link ? ", linked" : "", numFiles,
+              options.segmented ? numJobs : numWorkers,
+              options.segmented ? "segment threads" : "workers");
+
+  // ファイル単位で空いたワーカーが次を取る (長さの違うファイルでも偏らない)
+  std::vector<RenderResult> results((size_t)numFiles);
+  std::atomic<int> nextFile{0};
+  std::mutex printLock;
+  const auto start = std::chrono::steady_clock::now();
+
+  auto work = [&] {
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    for (int index = nextFile++; index < numFiles; index = nextFile++) {
+      const auto &input = options.inputs.getReference(index);
+      auto &result = results[(size_t)index];
+      result = options.segmented
+                   ? renderFileSegmented(input, options, formats, numJobs)
+                   : renderFile(input, options, formats);
+
+      const std::lock_guard<std::mutex> lock(printLock);
+      if (result.ok)
+        std::printf("%-40s %9.2f s audio %9.1fx realtime -> %s\n",
+                    input.getFileName().toRawUTF8(), result.audioSeconds,
+                    result.audioSeconds / std::max(result.processSeconds, 1e-9),
+                    result.message.toRawUTF8());
+      else
+        std::printf("%-40s FAILED: %s\n", input.getFileName().toRawUTF8(),
+                    result.message.toRawUTF8());
+      std::fflush(stdout);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (int i = 1; i < numWorkers; ++i)
+    workers.emplace_back(work);
+  work();
+  for (auto &worker : workers)
+    worker.join();
+
+  const double wallSeconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+
+  double totalAudio = 0.0;
+  int numFailed = 0;
+  for (const auto &result : results) {
+    totalAudio += result.audioSeconds;
+    numFailed += result.ok ? 0 : 1;
+  }
+
+  std::printf("total %.2f s audio in %.2f s (%.1fx realtime), %d failed\n",
+              totalAudio, wallSeconds, totalAudio / std::max(wallSeconds, 1e-9),
+              numFailed);
+
+  return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,1262 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Engine Verification (EA_VT_2W_Bench --verify)
+  ==============================================================================
+*/
+
+#include "VT2WBenchFixture.h"
+
+#include "dsp/VT2WAdaptiveEngine.h"
+#include "dsp/VT2WBlockTimer.h"
+#include "dsp/VT2WMetering.h"
+#include "dsp/VT2WPresetBank.h"
+#include "dsp/VT2WStateFormat.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace VT2WBench {
+
+namespace {
+
+/**
+ * 区間並列レンダーの検証
+ * 12 秒の信号を 1.5 秒の区間 (最小長より短く、warm-up の比率が大きい) に
+ * 分けて 4 スレッドで処理し、1 区間で逐次処理した結果との最大絶対誤差が
+ * kSegmentTolerance 以下であることを確認する。
+ */
+bool verifySegments(double sampleRate) {
+  struct Case {
+    const char *name;
+    int numChannels;
+    int oversamplingLog2;
+    VT2WOversamplingFilter filter;
+    bool adaa;
+    bool link;
+  };
+
+  const auto iir = VT2WOversamplingFilter::PolyphaseIIR;
+  const auto fir = VT2WOversamplingFilter::LinearPhaseFIR;
+  const Case cases[] = {{"1x", 2, 0, iir, false, false},
+                        {"2x iir", 2, 1, iir, false, false},
+                        {"4x fir", 2, 2, fir, false, false},
+                        {"8x iir", 2, 3, iir, false, false},
+                        {"2x iir ADAA", 2, 1, iir, true, false},
+                        {"1x 6ch linked", 6, 0, iir, false, true}};
+
+  const int numSamples = int(sampleRate * 12.0);
+  const auto segmentLength = int64_t(sampleRate * 1.5);
+  const float tolerance = VT2WSegmentRenderer::kSegmentTolerance;
+  bool passed = true;
+
+  for (const auto &c : cases) {
+    VT2WSettings settings;
+    settings.drive = 7.0f;
+    settings.mix = 80.0f;
+    settings.oversamplingLog2 = c.oversamplingLog2;
+    settings.oversamplingFilter = c.filter;
+    settings.adaa = c.adaa;
+    settings.link = c.link;
+
+    const auto input = makeBurstInput(c.numChannels, sampleRate, numSamples);
+    const VT2WSegmentRenderer renderer(settings, sampleRate, c.numChannels,
+                                       509);
+
+    const auto sequential = renderSegmented(renderer, input, 1, numSamples);
+    const auto parallel = renderSegmented(renderer, input, 4, segmentLength);
+
+    const float maxError = maxAbsError(parallel, sequential);
+    const bool ok = maxError <= tolerance;
+    passed = passed && ok;
+    std::printf("segments %-14s warm-up %6lld samples, max abs error %.3g "
+                "(tolerance %.1g) %s\n",
+                c.name, (long long)renderer.getWarmUpSamples(), maxError,
+                tolerance, ok ? "OK" : "FAIL");
+  }
+
+  return passed;
+}
+
+/**
+ * ブロック計測の検証
+ * 既知の負荷率を積んで p50 / p99 / 予算超過数がビンの分解能内で合うこと、
+ * ウィンドウから外れたブロックが差し引かれること、リセットを確認する。
+ */
+bool verifyBlockTimer() {
+  auto timer = std::make_unique<VT2WBlockTimer>();
+  bool passed = true;
+
+  auto check = [&passed](const char *label, bool ok) {
+    passed = passed && ok;
+    std::printf("block timer %-34s %s\n", label, ok ? "OK" : "FAIL");
+  };
+
+  // ビン幅 (1/8 オクターブ) の半分まで
+  auto near = [](float value, float expected) {
+    return std::abs(std::log2(value / expected)) <=
+           0.5f / VT2WBlockTimer::kBinsPerOctave;
+  };
+
+  for (int i = 0; i < 1000; ++i)
+    timer->addBlock(i % 50 < 49 ? 0.2e-3 : 1.5e-3, 1.0e-3);
+
+  auto snapshot = timer->getSnapshot();
+  check("p50 / p99 / max",
+        near(snapshot.p50, 0.2f) && near(snapshot.p99, 1.5f) &&
+            snapshot.max >= 1.5f && snapshot.peak == 1.5f);
+  check("over budget count", snapshot.recentOverBudget == 20 &&
+                                 snapshot.overBudgetBlocks == 20 &&
+                                 snapshot.totalBlocks == 1000);
+
+  for (int i = 0; i < VT2WBlockTimer::kWindowSize; ++i)
+    timer->addBlock(0.05e-3, 1.0e-3);
+
+  snapshot = timer->getSnapshot();
+  check("rolling window",
+        snapshot.numBlocks == VT2WBlockTimer::kWindowSize &&
+            snapshot.recentOverBudget == 0 && near(snapshot.p99, 0.05f) &&
+            snapshot.overBudgetBlocks == 20 && snapshot.peak == 1.5f);
+
+  timer->requestReset();
+  timer->addBlock(0.1e-3, 1.0e-3);
+  snapshot = timer->getSnapshot();
+  check("reset", snapshot.numBlocks == 1 && snapshot.totalBlocks == 1 &&
+                     snapshot.overBudgetBlocks == 0 &&
+                     near(snapshot.peak, 0.1f));
+
+  // 計測自体のコスト (Scope 1 回分)
+  const int numScopes = 1 << 20;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < numScopes; ++i) {
+    const VT2WBlockTimer::Scope scope(*timer, 256, 48000.0);
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  std::printf("block timer overhead %.1f ns/block\n",
+              seconds * 1.0e9 / numScopes);
+
+  return passed;
+}
+
+//==============================================================================
+// 自動品質 (VT2WAdaptiveEngine)
+
+/**
+ * 自動品質エンジンを 256 サンプルのブロックで回す
+ * loadAt(秒, 現在のレベル) がそのブロックの負荷率を返す。
+ * levels には各ブロック処理後のレベルを積む。
+ */
+template <typename LoadFunction>
+std::vector<std::vector<float>>
+renderAdaptive(VT2WAdaptiveEngine &engine,
+               const std::vector<std::vector<float>> &input, double sampleRate,
+               LoadFunction loadAt, std::vector<int> *levels = nullptr) {
+  const int blockSize = 256;
+  auto output = input;
+  const int numSamples = int(input[0].size());
+  std::vector<float *> channels(output.size());
+
+  for (int pos = 0; pos < numSamples; pos += blockSize) {
+    const int length = std::min(blockSize, numSamples - pos);
+    for (size_t ch = 0; ch < output.size(); ++ch)
+      channels[ch] = output[ch].data() + pos;
+
+    engine.reportLoad(loadAt(pos / sampleRate, engine.getLevel()), length);
+    engine.process(channels.data(), int(channels.size()), length);
+    if (levels != nullptr)
+      levels->push_back(engine.getLevel());
+  }
+
+  return output;
+}
+
+/** レベルが変わった回数 */
+int countSwitches(const std::vector<int> &levels, size_t begin, size_t end) {
+  int count = 0;
+  for (size_t i = std::max<size_t>(begin, 1); i < end; ++i)
+    count += levels[i] != levels[i - 1] ? 1 : 0;
+  return count;
+}
+
+/** 2 階差分の最大 (クロスフェードのクリック検出用) */
+float maxSecondDifference(const std::vector<std::vector<float>> &signal) {
+  float result = 0.0f;
+  for (const auto &channel : signal)
+    for (size_t i = 2; i < channel.size(); ++i)
+      result = std::max(result, std::abs(channel[i] - 2.0f * channel[i - 1] +
+                                         channel[i - 2]));
+  return result;
+}
+
+/**
+ * 自動品質の検証
+ * - 自動モード無効・非リアルタイムでは VT2WWhiteEngine 単体と一致する
+ * - どの設定でも、下げたレベルのレイテンシはレベル 0 以下 (遅延で揃えられる)
+ * - 合成した負荷で、高負荷で 1 段下がり、負荷が戻ると上がり、往復しない
+ * - 切り替え中もクリックが出ず、切り替え後も時間軸がレベル 0 と揃っている
+ * - 止まっている間に構造を変えて prepare し直すと、新しい構造で準備した
+ *   エンジンと同じ出力になる
+ */
+bool verifyAdaptive(double sampleRate) {
+  bool passed = true;
+  auto check = [&passed](const char *label, bool ok) {
+    passed = passed && ok;
+    std::printf("adaptive %-40s %s\n", label, ok ? "OK" : "FAIL");
+  };
+
+  VT2WSettings settings;
+  settings.drive = 5.0f;
+  settings.mix = 80.0f;
+  settings.quality = VT2WSaturationQuality::Reference;
+  settings.oversamplingLog2 = 2;
+  settings.adaa = true;
+
+  const auto input = makeInput(2, sampleRate, int(sampleRate * 2.0));
+  auto overload = [](double, int) { return 0.95f; };
+
+  // 無効時・非リアルタイム時は単体エンジンと同じ出力
+  auto plain = input;
+  {
+    VT2WWhiteEngine engine;
+    engine.applySettings(settings);
+    engine.prepare(sampleRate, 256, 2);
+    std::vector<float *> channels{plain[0].data(), plain[1].data()};
+    for (int pos = 0; pos < int(input[0].size()); pos += 256) {
+      const int length = std::min(256, int(input[0].size()) - pos);
+      float *block[] = {channels[0] + pos, channels[1] + pos};
+      engine.process(block, 2, length);
+    }
+  }
+
+  for (bool offline : {false, true}) {
+    auto adaptiveSettings = settings;
+    adaptiveSettings.adaptive = offline;
+
+    VT2WAdaptiveEngine engine;
+    engine.applySettings(adaptiveSettings);
+    engine.setRealtime(!offline);
+    engine.prepare(sampleRate, 256, 2);
+
+    std::vector<int> levels;
+    const auto output =
+        renderAdaptive(engine, input, sampleRate, overload, &levels);
+    check(offline ? "non-realtime matches plain engine"
+                  : "disabled matches plain engine",
+          maxAbsError(output, plain) == 0.0f &&
+              countSwitches(levels, 0, levels.size()) == 0);
+  }
+
+  // レベルごとのレイテンシ
+  {
+    bool ok = true;
+    for (int quality = 0; quality < 3; ++quality)
+      for (int log2 = 0; log2 <= VT2WOversampler::kMaxFactorLog2; ++log2)
+        for (auto filter : {VT2WOversamplingFilter::PolyphaseIIR,
+                            VT2WOversamplingFilter::LinearPhaseFIR})
+          for (bool adaa : {false, true}) {
+            VT2WSettings user;
+            user.quality = static_cast<VT2WSaturationQuality>(quality);
+            user.oversamplingLog2 = log2;
+            user.oversamplingFilter = filter;
+            user.adaa = adaa;
+
+            VT2WAdaptiveEngine adaptive;
+            adaptive.applySettings(user);
+
+            for (int level = 0; level < VT2WAdaptiveEngine::getNumLevels(user);
+                 ++level) {
+              VT2WWhiteEngine engine;
+              engine.applySettings(
+                  VT2WAdaptiveEngine::getLevelSettings(user, level));
+              const int difference =
+                  adaptive.getLatencySamples() - engine.getLatencySamples();
+              ok = ok && difference >= 0 &&
+                   difference <= VT2WAdaptiveEngine::kMaxPadSamples &&
+                   (level > 0 || difference == 0);
+            }
+          }
+    check("lower levels never add latency", ok);
+  }
+
+  // 負荷の合成: レベル 0 / 1 / 2 ... のコストの比と、外部からの圧力
+  // (Reference 4x -> Standard 4x -> Standard 2x -> Standard 1x -> Eco 1x)
+  const float costs[] = {1.0f, 0.8f, 0.45f, 0.25f, 0.2f};
+  auto pressureAt = [](double seconds) {
+    return seconds < 10.0 ? 0.5f : seconds < 30.0 ? 0.85f : 0.3f;
+  };
+
+  {
+    auto adaptiveSettings = settings;
+    adaptiveSettings.adaptive = true;
+
+    VT2WAdaptiveEngine engine;
+    engine.applySettings(adaptiveSettings);
+    engine.prepare(sampleRate, 256, 2);
+
+    const auto longInput = makeInput(2, sampleRate, int(sampleRate * 60.0));
+    std::vector<int> levels;
+    renderAdaptive(
+        engine, longInput, sampleRate,
+        [&](double seconds, int level) {
+          return costs[level] * pressureAt(seconds);
+        },
+        &levels);
+
+    const size_t blocksPerSecond = size_t(sampleRate / 256.0);
+    const size_t at10 = 10 * blocksPerSecond, at30 = 30 * blocksPerSecond;
+    const int low = countSwitches(levels, 0, at10);
+    const int high = countSwitches(levels, at10, at30);
+    const int recovered = countSwitches(levels, at30, levels.size());
+    std::printf("adaptive governor switches %d / %d / %d, "
+                "levels %d / %d / %d\n",
+                low, high, recovered, levels[at10 - 1], levels[at30 - 1],
+                levels.back());
+    check("steps down once under pressure",
+          low == 0 && high == 1 && levels[at30 - 1] == 1);
+    check("steps back up without flip-flop",
+          recovered == 1 && levels.back() == 0);
+
+    // 1 段下げるフェードが始まった所でバウンスに入る: フェードの終わりを
+    // 待たず、その場でレベル 0 に戻り、高負荷でも下げない
+    auto stepping = input;
+    for (int pos = 0; pos + 256 <= int(stepping[0].size()); pos += 256) {
+      engine.reportLoad(0.95f, 256);
+      if (engine.getLevel() > 0)
+        break;
+      float *block[] = {stepping[0].data() + pos, stepping[1].data() + pos};
+      engine.process(block, 2, 256);
+    }
+    const bool steppedDown = engine.getLevel() > 0;
+    engine.setRealtime(false);
+    const bool immediate = engine.getLevel() == 0;
+
+    levels.clear();
+    renderAdaptive(engine, input, sampleRate, overload, &levels);
+    check("non-realtime jumps to level 0 mid-fade",
+          steppedDown && immediate &&
+              countSwitches(levels, 0, levels.size()) == 0 &&
+              levels.front() == 0);
+  }
+
+  // クリックと時間軸: 最も軽いレベルまで下げてから戻す
+  {
+    std::vector<std::vector<float>> sine(2, std::vector<float>(
+                                                size_t(sampleRate * 16.0)));
+    for (auto &channel : sine)
+      for (size_t i = 0; i < channel.size(); ++i)
+        channel[i] = float(0.5 * std::sin(6.283185307179586 * 220.0 * i /
+                                          sampleRate));
+
+    VT2WAdaptiveEngine reference;
+    reference.applySettings(settings);
+    reference.prepare(sampleRate, 256, 2);
+    const auto expected = renderAdaptive(reference, sine, sampleRate, overload);
+
+    auto adaptiveSettings = settings;
+    adaptiveSettings.adaptive = true;
+    VT2WAdaptiveEngine engine;
+    engine.applySettings(adaptiveSettings);
+    engine.prepare(sampleRate, 256, 2);
+
+    std::vector<int> levels;
+    const auto output = renderAdaptive(
+        engine, sine, sampleRate,
+        [](double seconds, int) { return seconds < 8.0 ? 0.95f : 0.05f; },
+        &levels);
+
+    const float ratio =
+        maxSecondDifference(output) / maxSecondDifference(expected);
+    const float error = maxAbsError(output, expected);
+    std::printf("adaptive max level %d, switches %d, second difference ratio "
+                "%.3f, max abs error vs level 0 %.3g\n",
+                *std::max_element(levels.begin(), levels.end()),
+                countSwitches(levels, 0, levels.size()), ratio, error);
+    check("crossfades are click-free", ratio <= 1.5f);
+    check("lower levels stay time-aligned", error <= 0.02f);
+  }
+
+  // 止まっている間の構造の変更 (プラグインは prepare の前に applySettings を
+  // 呼ぶ): 次の prepare の後は新しい構造のエンジンだけが鳴る
+  {
+    auto changed = settings;
+    changed.model = VT2WModel::Black;
+    auto calm = [](double, int) { return 0.1f; };
+
+    VT2WAdaptiveEngine engine;
+    engine.applySettings(settings);
+    engine.prepare(sampleRate, 256, 2);
+    renderAdaptive(engine, input, sampleRate, calm);
+    engine.applySettings(changed);
+    engine.prepare(sampleRate, 256, 2);
+    const auto output = renderAdaptive(engine, input, sampleRate, calm);
+
+    VT2WAdaptiveEngine fresh;
+    fresh.applySettings(changed);
+    fresh.prepare(sampleRate, 256, 2);
+    const auto expected = renderAdaptive(fresh, input, sampleRate, calm);
+
+    check("structural change then prepare",
+          maxAbsError(output, expected) == 0.0f);
+  }
+
+  // 最大ブロック長より長いブロックと 64 を超えるチャンネル数:
+  // 最大ブロック長ごとに渡したときと同じ出力になる (途中でフェードも走らせる)
+  {
+    const int numChannels = 72, maxBlock = 256, longBlock = 4 * maxBlock;
+    const auto wide = makeInput(numChannels, sampleRate, 16 * longBlock);
+    auto render = [&](int blockSize) {
+      auto output = wide;
+      VT2WAdaptiveEngine engine;
+      engine.applySettings(settings);
+      engine.prepare(sampleRate, maxBlock, numChannels);
+
+      std::vector<float *> channels(numChannels);
+      for (int pos = 0; pos < int(wide[0].size()); pos += blockSize) {
+        if (pos == 4 * longBlock) {
+          // 構造の変更 (クロスフェード) と Drive の変更 (スムーサー)
+          auto changed = settings;
+          changed.quality = VT2WSaturationQuality::Standard;
+          changed.drive = 8.0f;
+          engine.applySettings(changed);
+        }
+        for (int ch = 0; ch < numChannels; ++ch)
+          channels[ch] = output[ch].data() + pos;
+        engine.process(channels.data(), numChannels, blockSize);
+      }
+      return output;
+    };
+
+    check("long blocks on 72 channels match short blocks",
+          maxAbsError(render(longBlock), render(maxBlock)) == 0.0f);
+  }
+
+  return passed;
+}
+
+/**
+ * メーターの検証
+ * - measure のピーク / RMS がサイン波の理論値と合う
+ * - FIFO は満杯で捨てるだけ (書き手は待たない)
+ * - 別スレッド間で順序が崩れず、欠けも重複も無い
+ */
+bool verifyMetering(double sampleRate) {
+  bool passed = true;
+  auto check = [&passed](const char *label, bool ok) {
+    passed = passed && ok;
+    std::printf("metering %-40s %s\n", label, ok ? "OK" : "FAIL");
+  };
+
+  // 1kHz、振幅 0.5 のサイン (整数周期)
+  std::vector<float> left(4800), right(4800, 0.0f);
+  for (size_t i = 0; i < left.size(); ++i)
+    left[i] =
+        float(0.5 * std::sin(6.283185307179586 * 1000.0 * i / sampleRate));
+  const float *channels[] = {left.data(), right.data()};
+
+  float peak = 0.0f, rms = 0.0f;
+  VT2WMetering::measure(channels, 1, int(left.size()), peak, rms);
+  check("sine peak / rms", std::abs(peak - 0.5f) < 1.0e-3f &&
+                               std::abs(rms - 0.35355f) < 1.0e-4f);
+  VT2WMetering::measure(channels, 2, int(left.size()), peak, rms);
+  check("rms averages channels", std::abs(rms - 0.25f) < 1.0e-4f);
+
+  auto fifo = std::make_unique<VT2WMeterFifo>();
+  VT2WMeterFrame frame;
+  int numPushed = 0;
+  while (fifo->push(frame))
+    ++numPushed;
+  check("full fifo drops instead of blocking",
+        numPushed == 256 && fifo->getNumDropped() == 1);
+  while (fifo->pop(frame)) {
+  }
+
+  // 書き手と読み手を別スレッドで回す (numSamples に通し番号を入れる)
+  // 取りこぼしが無いことを見るため、ここでは満杯なら書き手が譲って再試行する
+  const int numFrames = 1 << 20;
+  std::thread producer([&fifo] {
+    VT2WMeterFrame item;
+    for (int i = 1; i <= numFrames; ++i) {
+      item.numSamples = i;
+      while (!fifo->push(item))
+        std::this_thread::yield();
+    }
+  });
+
+  int numPopped = 0, last = 0;
+  bool ordered = true;
+  while (last < numFrames) {
+    if (!fifo->pop(frame)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ordered = ordered && frame.numSamples == last + 1;
+    last = frame.numSamples;
+    ++numPopped;
+  }
+  producer.join();
+
+  check("fifo keeps order across threads",
+        ordered && numPopped == numFrames && !fifo->pop(frame));
+
+  return passed;
+}
+
+
+/**
+ * 無音スリープの検証
+ * - インパルスの出力が getTailLengthSamples 以内に閾値未満になる
+ *   (ホストのスリープ判定と、エンジン自身のスリープの前提。Black は
+ *   位相安定化オールパスの減衰を含む)
+ * - 無音の区間でスリープし、音が戻ったブロックから起きる。止めない場合との
+ *   差は閾値の 2 倍以内
+ */
+bool verifySleep(double sampleRate) {
+  struct Mode {
+    const char *name;
+    int factorLog2;
+    VT2WOversamplingFilter filter;
+    bool adaa;
+    VT2WModel model = VT2WModel::White;
+  };
+
+  const auto iir = VT2WOversamplingFilter::PolyphaseIIR;
+  const auto fir = VT2WOversamplingFilter::LinearPhaseFIR;
+  const auto black = VT2WModel::Black;
+  const Mode modes[] = {{"1x", 0, iir, false},
+                        {"1x ADAA", 0, iir, true},
+                        {"2x iir", 1, iir, false},
+                        {"4x iir", 2, iir, false},
+                        {"8x iir", 3, iir, false},
+                        {"2x iir ADAA", 1, iir, true},
+                        {"2x fir", 1, fir, false},
+                        {"8x fir", 3, fir, false},
+                        {"1x black", 0, iir, false, black},
+                        {"4x fir black", 2, fir, false, black}};
+
+  const float threshold = VT2WConstants::kSilenceThreshold;
+  bool passed = true;
+
+  for (const auto &mode : modes) {
+    auto makeEngine = [&](bool sleep) {
+      auto engine = std::make_unique<VT2WWhiteEngine>();
+      engine->setOversampling(mode.factorLog2, mode.filter);
+      engine->setAdaaEnabled(mode.adaa);
+      engine->setModel(mode.model);
+      engine->setSleepEnabled(sleep);
+      engine->setTargets(7.0f, 0.8f);
+      engine->prepare(sampleRate, 256, 2);
+      return engine;
+    };
+
+    // インパルス (フルスケール) の出力が消えるまで
+    auto engine = makeEngine(false);
+    const int tail = engine->getTailLengthSamples();
+    std::vector<float> impulse(size_t(tail + 4096), 0.0f);
+    impulse[0] = 1.0f;
+    for (size_t pos = 0; pos < impulse.size(); pos += 256) {
+      float *channel = impulse.data() + pos;
+      engine->process(&channel, 1,
+                      int(std::min<size_t>(256, impulse.size() - pos)));
+    }
+
+    int last = -1;
+    for (int i = 0; i < int(impulse.size()); ++i)
+      if (std::abs(impulse[i]) >= threshold)
+        last = i;
+
+    // 音 0.25 秒と無音 3 秒の繰り返し (ブロック長は端数が出るよう素数)
+    // エンベロープが閾値まで下がるのに 1 秒強かかる
+    const auto input =
+        makeGappedInput(2, sampleRate, int(sampleRate * 10.0), 0.25, 3.0);
+    auto awake = input, slept = input;
+    auto reference = makeEngine(false);
+    auto sleeping = makeEngine(true);
+    int sleepingBlocks = 0, numBlocks = 0;
+
+    for (int pos = 0; pos < int(input[0].size()); pos += 509) {
+      const int length = std::min(509, int(input[0].size()) - pos);
+      float *a[] = {awake[0].data() + pos, awake[1].data() + pos};
+      float *b[] = {slept[0].data() + pos, slept[1].data() + pos};
+      reference->process(a, 2, length);
+      sleeping->process(b, 2, length);
+      sleepingBlocks += sleeping->isSleeping() ? 1 : 0;
+      ++numBlocks;
+    }
+
+    const float maxError = maxAbsError(slept, awake);
+
+    // 閾値未満の入力でも Mix 0% なら Dry がそのまま出る (寝ていても)
+    const float quiet = 0.3f * threshold;
+    std::vector<std::vector<float>> dryAwake(
+        2, std::vector<float>(size_t(sampleRate * 2.0)));
+    for (auto &channel : dryAwake)
+      for (size_t i = 0; i < channel.size(); ++i)
+        channel[i] = quiet * float(std::sin(6.283185307179586 * 440.0 * i /
+                                            sampleRate));
+    auto drySlept = dryAwake;
+    auto dryReference = makeEngine(false), drySleeping = makeEngine(true);
+    dryReference->setTargets(7.0f, 0.0f);
+    drySleeping->setTargets(7.0f, 0.0f);
+    renderBlocks(*dryReference, dryAwake, 509);
+    renderBlocks(*drySleeping, drySlept, 509);
+    const float dryError = maxAbsError(drySlept, dryAwake);
+
+    const bool ok = last <= tail && sleepingBlocks > numBlocks / 2 &&
+                    maxError <= 2.0f * threshold &&
+                    drySleeping->isSleeping() && dryError <= 1.0e-3f * quiet;
+    passed = passed && ok;
+    std::printf("sleep %-12s tail %5d samples (last above threshold %5d), "
+                "asleep %3d / %3d blocks, max abs error %.3g, dry %.3g %s\n",
+                mode.name, tail, last, sleepingBlocks, numBlocks, maxError,
+                dryError, ok ? "OK" : "FAIL");
+  }
+
+  return passed;
+}
+
+//==============================================================================
+// 状態のバイナリ形式
+/**
+ * 状態のバイナリ形式の検証
+ * - 書いて読むと全項目が一致する
+ * - 1 ビットの破損・途中で切れたデータは全て失敗になる
+ * - 新しい版 (ペイロードの末尾に項目を足したもの) も知っている項目は読め、
+ *   以前の版 1 (A/B スロット無し) も読める
+ * - 範囲外・NaN の値は範囲内に丸める
+ */
+bool verifyState() {
+  namespace State = VT2WStateFormat;
+  bool passed = true;
+
+  // CRC-32 の検査値 ("123456789")
+  const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  const bool checksumOk =
+      State::computeChecksum(check, sizeof(check)) == 0xCBF43926u;
+  passed = passed && checksumOk;
+
+  std::mt19937 rng(42);
+  int roundTripFailures = 0;
+  for (int i = 0; i < 1000; ++i) {
+    const auto settings = makeRandomSettings(rng);
+    State::BankState bank;
+    bank.other = makeRandomSettings(rng);
+    bank.morph = float(i % 101);
+    bank.selectedSlot = i & 1;
+    bank.program = i % VT2WPresets::getNumFactoryPresets();
+
+    const auto data = State::write(settings, bank);
+    VT2WSettings restored;
+    State::BankState restoredBank;
+    if (State::read(data.data(), int(data.size()), restored, &restoredBank) !=
+            State::Status::Ok ||
+        settings != restored || bank.other != restoredBank.other ||
+        bank.morph != restoredBank.morph ||
+        bank.selectedSlot != restoredBank.selectedSlot ||
+        bank.program != restoredBank.program)
+      ++roundTripFailures;
+  }
+  passed = passed && roundTripFailures == 0;
+
+  const auto settings = makeRandomSettings(rng);
+  const auto data = State::write(settings);
+  int undetected = 0, unchanged = 0;
+  for (int bit = 0; bit < State::kSize * 8; ++bit) {
+    auto corrupt = data;
+    corrupt[size_t(bit / 8)] ^= uint8_t(1 << (bit % 8));
+    VT2WSettings restored = settings;
+    restored.drive = -1.0f;
+    if (State::read(corrupt.data(), int(corrupt.size()), restored) ==
+        State::Status::Ok)
+      ++undetected;
+    if (restored.drive == -1.0f)
+      ++unchanged;
+  }
+  for (int size = 0; size < State::kSize; ++size) {
+    VT2WSettings restored;
+    if (State::read(data.data(), size, restored) == State::Status::Ok)
+      ++undetected;
+  }
+  const bool corruptionOk =
+      undetected == 0 && unchanged == State::kSize * 8;
+  passed = passed && corruptionOk;
+
+  // 版とペイロードの長さを書き換え、チェックサムを付け直す
+  auto resize = [&data](int version, int payloadSize) {
+    std::vector<uint8_t> blob(data.begin(), data.end() - State::kChecksumSize);
+    blob[4] = uint8_t(version);
+    blob[6] = uint8_t(payloadSize);
+    blob.resize(size_t(State::kHeaderSize + payloadSize), 7);
+    const uint32_t crc = State::computeChecksum(blob.data(), int(blob.size()));
+    for (int i = 0; i < 4; ++i)
+      blob.push_back(uint8_t(crc >> (8 * i)));
+    return blob;
+  };
+
+  // 版 3 を想定: ペイロードの末尾に 4 バイト足したもの
+  const auto newer = resize(3, State::kPayloadSizeV2 + 4);
+  VT2WSettings forward;
+  const bool forwardOk =
+      State::read(newer.data(), int(newer.size()), forward) ==
+          State::Status::Ok &&
+      forward == settings;
+  passed = passed && forwardOk;
+
+  // 版 1 (A/B スロットの無い以前の版): 両方のスロットが同じ値になる
+  const auto older = resize(1, State::kPayloadSizeV1);
+  VT2WSettings backward;
+  State::BankState backwardBank;
+  backwardBank.morph = 50.0f;
+  const bool backwardOk =
+      State::read(older.data(), int(older.size()), backward, &backwardBank) ==
+          State::Status::Ok &&
+      backward == settings && backwardBank.other == settings &&
+      backwardBank.morph == 0.0f && backwardBank.selectedSlot == 0;
+  passed = passed && backwardOk;
+
+  // 範囲外の値
+  VT2WSettings wild;
+  wild.drive = std::numeric_limits<float>::quiet_NaN();
+  wild.mix = 1000.0f;
+  wild.oversamplingLog2 = 9;
+  const auto wildData = State::write(wild);
+  VT2WSettings clamped;
+  const bool clampOk =
+      State::read(wildData.data(), int(wildData.size()), clamped) ==
+          State::Status::Ok &&
+      clamped.drive == VT2WConstants::kDriveDefault &&
+      clamped.mix == VT2WConstants::kMixMax &&
+      clamped.oversamplingLog2 == VT2WOversampler::kMaxFactorLog2;
+  passed = passed && clampOk;
+
+  std::printf("state %d bytes: crc-32 %s, round trip %d / 1000 failed, "
+              "corruption undetected %d, newer version %s, version 1 %s, "
+              "clamping %s %s\n",
+              State::kSize, checksumOk ? "ok" : "wrong", roundTripFailures,
+              undetected, forwardOk ? "ok" : "failed",
+              backwardOk ? "ok" : "failed", clampOk ? "ok" : "failed",
+              passed ? "OK" : "FAIL");
+
+  return passed;
+}
+
+//==============================================================================
+// プリセットと A/B のモーフィング
+
+/**
+ * トリプルバッファ・補間・A/B スロットとプリセット呼び出しの検証
+ * - 読み手は常に最後に公開された値を丸ごと読む (2 スレッドで途中の値が無い)
+ * - 補間の端点は元の設定そのもので、切り替えの項目は 0.5 で移る
+ * - スロットを切り替えると編集中の値がスロットに残る
+ * - プリセットの切り替え・モーフィングで、定常状態より大きな段差が出ない
+ * - クロスフェード中に次の構造の変更が来ても段差が出ない
+ */
+bool verifyPresets(double sampleRate) {
+  bool passed = true;
+  auto check = [&passed](const char *label, bool ok) {
+    passed = passed && ok;
+    std::printf("presets %-40s %s\n", label, ok ? "OK" : "FAIL");
+  };
+
+  {
+    VT2WTripleBuffer<int> buffer;
+    bool ok = buffer.read() == 0;
+    buffer.write(1);
+    buffer.write(2);
+    ok = ok && buffer.read() == 2 && buffer.read() == 2;
+    buffer.write(3);
+    ok = ok && buffer.read() == 3;
+    check("triple buffer returns the latest value", ok);
+  }
+
+  // 書き手が全要素に同じ番号を書き続け、読み手が混ざった値を探す
+  {
+    struct Block {
+      uint32_t values[64];
+    };
+    const uint32_t numWrites = 200000;
+    auto buffer = std::make_unique<VT2WTripleBuffer<Block>>();
+
+    std::thread writer([&buffer] {
+      Block block;
+      for (uint32_t n = 1; n <= numWrites; ++n) {
+        std::fill(std::begin(block.values), std::end(block.values), n);
+        buffer->write(block);
+      }
+    });
+
+    int torn = 0, reversed = 0;
+    uint32_t last = 0;
+    while (last != numWrites) {
+      const Block &block = buffer->read();
+      for (uint32_t value : block.values)
+        torn += value != block.values[0] ? 1 : 0;
+      reversed += block.values[0] < last ? 1 : 0;
+      last = block.values[0];
+    }
+    writer.join();
+    check("triple buffer never tears across threads",
+          torn == 0 && reversed == 0);
+  }
+
+  const auto &white = VT2WPresets::getFactoryPreset(2).settings;
+  const auto &black = VT2WPresets::getFactoryPreset(6).settings;
+  {
+    const auto quarter = VT2WPresets::interpolate(white, black, 0.25f);
+    const auto threeQuarters = VT2WPresets::interpolate(white, black, 0.75f);
+    const float drive = white.drive + 0.25f * (black.drive - white.drive);
+    check("interpolation endpoints and steps",
+          VT2WPresets::interpolate(white, black, 0.0f) == white &&
+              VT2WPresets::interpolate(white, black, 1.0f) == black &&
+              std::abs(quarter.drive - drive) < 1.0e-6f &&
+              quarter.model == white.model &&
+              threeQuarters.model == black.model);
+  }
+
+  {
+    VT2WPresetBank bank;
+    const auto b = bank.selectSlot(1, white);
+    const auto a = bank.selectSlot(0, black);
+    bank.copyToOther(white);
+    check("A/B slots keep the edited values",
+          b == VT2WSettings() && a == white && bank.getOther() == white &&
+              bank.getSelectedSlot() == 0);
+  }
+
+  // 220Hz のサインを流しながら 0.25 秒ごとにプリセットを順に呼び出し、
+  // 続けて 2 秒かけて White から Black へモーフィングする
+  const int blockSize = 256;
+  const int numPresets = VT2WPresets::getNumFactoryPresets();
+  const int switchBlocks = int(0.25 * sampleRate / blockSize);
+  std::vector<std::vector<float>> sine(
+      2, std::vector<float>(size_t(switchBlocks * blockSize * numPresets)));
+  for (auto &channel : sine)
+    for (size_t i = 0; i < channel.size(); ++i)
+      channel[i] = float(
+          0.5 * std::sin(6.283185307179586 * 220.0 * i / sampleRate));
+
+  // White -> Black の 2 ブロック後にオーバーサンプリングを変える
+  // (1 つ目のクロスフェードの途中に 2 つ目の構造の変更が来る)
+  auto whiteToBlack = white;
+  whiteToBlack.model = VT2WModel::Black;
+  auto moreOversampling = whiteToBlack;
+  moreOversampling.oversamplingLog2 =
+      std::min(white.oversamplingLog2 + 1, VT2WOversampler::kMaxFactorLog2);
+
+  std::vector<VT2WSettings> steadySettings;
+  for (int index = 0; index < numPresets; ++index)
+    steadySettings.push_back(VT2WPresets::getFactoryPreset(index).settings);
+  steadySettings.push_back(whiteToBlack);
+  steadySettings.push_back(moreOversampling);
+
+  // 各設定を単独で鳴らした時の最大の 2 階差分 (先頭の立ち上がりを除く)
+  float steady = 0.0f;
+  for (const auto &steadySetting : steadySettings) {
+    VT2WAdaptiveEngine engine;
+    engine.applySettings(steadySetting);
+    engine.prepare(sampleRate, blockSize, 2);
+    auto output = renderAdaptive(engine, sine, sampleRate,
+                                 [](double, int) { return 0.1f; });
+    for (auto &channel : output)
+      channel.erase(channel.begin(), channel.begin() + blockSize);
+    steady = std::max(steady, maxSecondDifference(output));
+  }
+
+  auto renderSwitching = [&](auto settingsAt) {
+    VT2WAdaptiveEngine engine;
+    engine.applySettings(settingsAt(0));
+    engine.prepare(sampleRate, blockSize, 2);
+    int block = 0;
+    auto output = renderAdaptive(engine, sine, sampleRate, [&](double, int) {
+      engine.applySettings(settingsAt(block++));
+      return 0.1f;
+    });
+    for (auto &channel : output)
+      channel.erase(channel.begin(), channel.begin() + blockSize);
+    return maxSecondDifference(output) / steady;
+  };
+
+  const float recallRatio = renderSwitching([&](int block) {
+    return VT2WPresets::getFactoryPreset(block / switchBlocks % numPresets)
+        .settings;
+  });
+  const int morphBlocks = int(2.0 * sampleRate / blockSize);
+  const float morphRatio = renderSwitching([&](int block) {
+    return VT2WPresets::interpolate(
+        white, black, std::min(1.0f, float(block) / float(morphBlocks)));
+  });
+
+  const float overlapRatio = renderSwitching([&](int block) {
+    return block < switchBlocks       ? white
+           : block < switchBlocks + 2 ? whiteToBlack
+                                      : moreOversampling;
+  });
+
+  std::printf("presets second difference ratio: recall %.3f, morph %.3f, "
+              "overlapping recall %.3f\n",
+              recallRatio, morphRatio, overlapRatio);
+  check("preset recall is click-free", recallRatio <= 1.5f);
+  check("morphing is click-free", morphRatio <= 1.5f);
+  check("overlapping recalls are click-free", overlapRatio <= 1.5f);
+
+  return passed;
+}
+
+//==============================================================================
+// サンプル単位のオートメーション
+
+/**
+ * Drive の段差と、ホストのパラメータキューのような細かい点で描いた
+ * Mix のランプ (位置はどのブロック長の境界とも揃わないようにしてある)
+ */
+std::vector<VT2WAutomationPoint> makeAutomation(double sampleRate,
+                                               int numSamples) {
+  std::vector<VT2WAutomationPoint> points;
+  const float drives[] = {2.0f, 7.5f, 4.0f, 10.0f, 0.5f, 6.0f};
+  const int driveSpacing = int(0.37 * sampleRate);
+  for (int i = 0; i < 6 && (i + 1) * driveSpacing < numSamples; ++i)
+    points.push_back({(i + 1) * driveSpacing + 13,
+                      VT2WAutomatedParameter::Drive, drives[i]});
+
+  const int rampStart = int(0.5 * sampleRate) + 7;
+  const int rampLength = int(1.0 * sampleRate);
+  for (int offset = 0; offset <= rampLength && rampStart + offset < numSamples;
+       offset += 67)
+    points.push_back({rampStart + offset, VT2WAutomatedParameter::Mix,
+                      100.0f - 70.0f * float(offset) / float(rampLength)});
+  points.push_back(
+      {int(2.2 * sampleRate) + 3, VT2WAutomatedParameter::Mix, 100.0f});
+
+  std::stable_sort(points.begin(), points.end(),
+                   [](const auto &a, const auto &b) {
+                     return a.position < b.position;
+                   });
+  return points;
+}
+
+/**
+ * オートメーションを付けてブロック毎に処理する
+ * quantize なら以前のプラグインと同じく、ブロック内の変化をブロックの先頭で
+ * まとめて反映する (ブロック長で結果が変わる比較用)。
+ */
+template <typename Engine, typename Sample>
+void renderAutomated(Engine &engine, std::vector<std::vector<Sample>> &audio,
+                     int blockSize,
+                     const std::vector<VT2WAutomationPoint> &points,
+                     bool quantize = false) {
+  std::vector<Sample *> channels(audio.size());
+  const int numSamples = int(audio[0].size());
+  VT2WParameterEvents events;
+  size_t next = 0;
+
+  for (int pos = 0; pos < numSamples; pos += blockSize) {
+    const int length = std::min(blockSize, numSamples - pos);
+
+    if (quantize) {
+      events.clear();
+      for (; next < points.size() && points[next].position < pos + length;
+           ++next)
+        events.add(0, points[next].parameter, points[next].value);
+
+      for (size_t ch = 0; ch < audio.size(); ++ch)
+        channels[ch] = audio[ch].data() + pos;
+      engine.process(channels.data(), int(audio.size()), length, events);
+      continue;
+    }
+
+    VT2WAutomation::forEachSpan(
+        points.data(), points.size(), next, pos, length, events,
+        [&](int start, int spanLength, const VT2WParameterEvents &span) {
+          for (size_t ch = 0; ch < audio.size(); ++ch)
+            channels[ch] = audio[ch].data() + pos + start;
+          engine.process(channels.data(), int(audio.size()), spanLength,
+                         span);
+        });
+  }
+}
+
+/**
+ * サンプル単位のオートメーションの検証
+ * - 同じ変化点なら、ブロック長 32 / 512 / 4096 で出力が完全に一致する
+ *   (White の SIMD カーネル・ADAA・FIR、Black、double の経路)
+ * - 1 ブロックの変化点が列の容量を超えても捨てず、ブロック長に依らない
+ * - 変化点が無ければ、変化点無しの process と同じ出力
+ */
+bool verifyAutomation(double sampleRate) {
+  bool passed = true;
+  const int numSamples = int(sampleRate * 3.0);
+  const auto input = makeInput(2, sampleRate, numSamples);
+  const auto points = makeAutomation(sampleRate, numSamples);
+
+  struct Case {
+    const char *name;
+    VT2WModel model;
+    VT2WSaturationQuality quality;
+    int oversamplingLog2;
+    VT2WOversamplingFilter filter;
+    bool adaa;
+  };
+  const Case cases[] = {
+      {"white 1x", VT2WModel::White, VT2WSaturationQuality::Standard, 0,
+       VT2WOversamplingFilter::PolyphaseIIR, false},
+      {"white 2x adaa fir", VT2WModel::White, VT2WSaturationQuality::Standard,
+       1, VT2WOversamplingFilter::LinearPhaseFIR, true},
+      {"white reference", VT2WModel::White, VT2WSaturationQuality::Reference,
+       0, VT2WOversamplingFilter::PolyphaseIIR, false},
+      {"black 4x", VT2WModel::Black, VT2WSaturationQuality::Standard, 2,
+       VT2WOversamplingFilter::PolyphaseIIR, false},
+  };
+  const int blockSizes[] = {32, 512, 4096};
+
+  auto render = [&](const Case &c, auto &audio, int blockSize, bool quantize) {
+    VT2WSettings settings;
+    settings.model = c.model;
+    settings.quality = c.quality;
+    settings.oversamplingLog2 = c.oversamplingLog2;
+    settings.oversamplingFilter = c.filter;
+    settings.adaa = c.adaa;
+
+    auto engine = std::make_unique<VT2WAdaptiveEngine>();
+    engine->applySettings(settings);
+    engine->prepare(sampleRate, blockSize, 2);
+    renderAutomated(*engine, audio, blockSize, points, quantize);
+  };
+
+  for (const auto &c : cases) {
+    std::vector<std::vector<float>> outputs[3];
+    for (int i = 0; i < 3; ++i) {
+      outputs[i] = input;
+      render(c, outputs[i], blockSizes[i], false);
+    }
+    const float error = std::max(maxAbsError(outputs[1], outputs[0]),
+                                 maxAbsError(outputs[2], outputs[0]));
+
+    // 以前の動作 (ブロックの先頭で反映) でのブロック長による差
+    auto quantized32 = input, quantized4096 = input;
+    render(c, quantized32, 32, true);
+    render(c, quantized4096, 4096, true);
+    const float quantizedError = maxAbsError(quantized32, quantized4096);
+
+    const bool ok = error == 0.0f;
+    passed = passed && ok;
+    std::printf("automation %-18s %zu events, block 32 / 512 / 4096 max abs "
+                "error %.3g (block-start quantized %.3g) %s\n",
+                c.name, points.size(), error, quantizedError,
+                ok ? "OK" : "FAIL");
+  }
+
+  // double の経路
+  {
+    const auto source = toDouble(input);
+    std::vector<std::vector<double>> outputs[3];
+    for (int i = 0; i < 3; ++i) {
+      outputs[i] = source;
+      render(cases[1], outputs[i], blockSizes[i], false);
+    }
+    double error = 0.0;
+    for (int i = 1; i < 3; ++i)
+      for (size_t ch = 0; ch < source.size(); ++ch)
+        for (size_t n = 0; n < source[ch].size(); ++n)
+          error = std::max(error, std::abs(outputs[i][ch][n] -
+                                           outputs[0][ch][n]));
+    const bool ok = error == 0.0;
+    passed = passed && ok;
+    std::printf("automation %-18s double, block 32 / 512 / 4096 max abs "
+                "error %.3g %s\n",
+                cases[1].name, error, ok ? "OK" : "FAIL");
+  }
+
+  // 1 ブロックに列の容量を超える変化点 (3 サンプル毎、同じ位置に
+  // 容量を超えて重なる点も): 区間に分けて全て反映する
+  {
+    std::vector<VT2WAutomationPoint> dense;
+    for (int position = 0; position < numSamples; position += 3)
+      dense.push_back({position, VT2WAutomatedParameter::Drive,
+                       5.0f + 4.0f * std::sin(float(position) * 1.0e-3f)});
+    for (int i = 0; i <= VT2WParameterEvents::kCapacity; ++i)
+      dense.push_back({int64_t(sampleRate), VT2WAutomatedParameter::Mix,
+                       float(i % 101)});
+    std::stable_sort(dense.begin(), dense.end(),
+                     [](const auto &a, const auto &b) {
+                       return a.position < b.position;
+                     });
+
+    std::vector<std::vector<float>> outputs[3];
+    for (int i = 0; i < 3; ++i) {
+      outputs[i] = input;
+      VT2WWhiteEngine engine;
+      engine.prepare(sampleRate, blockSizes[i], 2);
+      renderAutomated(engine, outputs[i], blockSizes[i], dense);
+    }
+    const float error = std::max(maxAbsError(outputs[1], outputs[0]),
+                                 maxAbsError(outputs[2], outputs[0]));
+    const bool ok = error == 0.0f;
+    passed = passed && ok;
+    std::printf("automation %zu dense events, over %d per block, block 32 / "
+                "512 / 4096 max abs error %.3g %s\n",
+                dense.size(), VT2WParameterEvents::kCapacity, error,
+                ok ? "OK" : "FAIL");
+  }
+
+  // 変化点が無ければ従来の process と同じ
+  {
+    auto withEvents = input, reference = input;
+    {
+      VT2WAdaptiveEngine engine;
+      engine.prepare(sampleRate, 512, 2);
+      renderAutomated(engine, withEvents, 512, {});
+    }
+    VT2WAdaptiveEngine engine;
+    engine.prepare(sampleRate, 512, 2);
+    renderBlocks(engine, reference, 512);
+    const bool ok = maxAbsError(withEvents, reference) == 0.0f;
+    passed = passed && ok;
+    std::printf("automation no events matches plain process %s\n",
+                ok ? "OK" : "FAIL");
+  }
+
+  return passed;
+}
+
+/** レンダリング結果のハッシュ (サンプルのビット列の FNV-1a) */
+template <typename Sample>
+uint64_t hashAudio(const std::vector<std::vector<Sample>> &audio) {
+  uint64_t hash = 1469598103934665603ull;
+  for (const auto &channel : audio) {
+    const auto *bytes = reinterpret_cast<const unsigned char *>(channel.data());
+    for (size_t i = 0; i < channel.size() * sizeof(Sample); ++i)
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+/**
+ * 決定的モードの検証
+ * - 対応している全カーネル (1 レーンの移植版を含む) で、ブロック長も
+ *   カーネル毎に変えてレンダーし、出力のハッシュが全て一致する
+ *   (サンプル単位のオートメーションでランプも通す。3 チャンネルで
+ *   エンベロープのレーン処理も通す)
+ * - 通常のモード (最速のカーネル・libm) との差は丸め程度
+ */
+bool verifyDeterministic(double sampleRate) {
+  bool passed = true;
+  const int numSamples = int(sampleRate * 3.0);
+  const auto input = makeInput(3, sampleRate, numSamples);
+  const auto points = makeAutomation(sampleRate, numSamples);
+
+  struct Case {
+    const char *name;
+    VT2WModel model;
+    VT2WSaturationQuality quality;
+    int oversamplingLog2;
+    VT2WOversamplingFilter filter;
+    bool adaa;
+    bool linked;
+    bool useDouble;
+  };
+  const Case cases[] = {
+      {"white eco 1x", VT2WModel::White, VT2WSaturationQuality::Eco, 0,
+       VT2WOversamplingFilter::PolyphaseIIR, false, false, false},
+      {"white 2x adaa fir", VT2WModel::White, VT2WSaturationQuality::Standard,
+       1, VT2WOversamplingFilter::LinearPhaseFIR, true, false, false},
+      {"white 4x linked", VT2WModel::White, VT2WSaturationQuality::Standard,
+       2, VT2WOversamplingFilter::PolyphaseIIR, false, true, false},
+      {"white reference", VT2WModel::White, VT2WSaturationQuality::Reference,
+       0, VT2WOversamplingFilter::PolyphaseIIR, true, false, false},
+      {"black 2x", VT2WModel::Black, VT2WSaturationQuality::Standard, 1,
+       VT2WOversamplingFilter::PolyphaseIIR, false, false, false},
+      {"white 2x adaa double", VT2WModel::White,
+       VT2WSaturationQuality::Standard, 1,
+       VT2WOversamplingFilter::PolyphaseIIR, true, false, true},
+  };
+  const int blockSizes[] = {509, 32, 4096, 64, 1000};
+
+  auto render = [&](const Case &c, auto &audio, VT2WKernelIsa isa,
+                    bool deterministic, int blockSize) {
+    VT2WSettings settings;
+    settings.model = c.model;
+    settings.quality = c.quality;
+    settings.oversamplingLog2 = c.oversamplingLog2;
+    settings.oversamplingFilter = c.filter;
+    settings.adaa = c.adaa;
+    settings.link = c.linked;
+
+    auto engine = std::make_unique<VT2WWhiteEngine>();
+    engine->setKernel(isa);
+    engine->setDeterministic(deterministic);
+    engine->applySettings(settings);
+    engine->prepare(sampleRate, blockSize, int(audio.size()));
+    renderAutomated(*engine, audio, blockSize, points);
+  };
+
+  auto check = [&](const Case &c, const auto &source) {
+    uint64_t firstHash = 0;
+    int numKernels = 0;
+    bool match = true;
+    auto deterministicOutput = source;
+
+    for (auto isa : kAllIsas) {
+      if (!VT2WKernels::isSupported(isa))
+        continue;
+
+      auto output = source;
+      render(c, output, isa, true,
+             blockSizes[numKernels % int(std::size(blockSizes))]);
+      const uint64_t hash = hashAudio(output);
+
+      if (numKernels == 0) {
+        firstHash = hash;
+        deterministicOutput = output;
+      }
+      match = match && hash == firstHash;
+      ++numKernels;
+    }
+
+    auto normal = source;
+    const auto *best = VT2WKernels::getBestAvailable();
+    render(c, normal, best != nullptr ? best->isa : VT2WKernelIsa::Scalar,
+           false, 512);
+    double error = 0.0;
+    for (size_t ch = 0; ch < source.size(); ++ch)
+      for (size_t i = 0; i < source[ch].size(); ++i)
+        error = std::max(error, std::abs(double(normal[ch][i]) -
+                                         double(deterministicOutput[ch][i])));
+
+    const bool ok = match && error <= VT2WKernels::kAdaaTolerance;
+    passed = passed && ok;
+    std::printf("deterministic %-20s %d kernels, hash %016llx %s, vs normal "
+                "max abs error %.3g %s\n",
+                c.name, numKernels, (unsigned long long)firstHash,
+                match ? "match" : "DIFFER", error, ok ? "OK" : "FAIL");
+  };
+
+  for (const auto &c : cases) {
+    if (c.useDouble)
+      check(c, toDouble(input));
+    else
+      check(c, input);
+  }
+
+  return passed;
+}
+
+
+} // namespace
+
+bool verifyEngine(double sampleRate) {
+  bool passed = verifySegments(sampleRate);
+  passed &= verifyBlockTimer();
+  passed &= verifyAdaptive(sampleRate);
+  passed &= verifyMetering(sampleRate);
+  passed &= verifySleep(sampleRate);
+  passed &= verifyState();
+  passed &= verifyPresets(sampleRate);
+  passed &= verifyAutomation(sampleRate);
+  passed &= verifyDeterministic(sampleRate);
+  return passed;
+}
+
+} // namespace VT2WBench
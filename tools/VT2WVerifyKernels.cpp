@@ -0,0 +1,602 @@
+/*
+  ==============================================================================
+    VT-2W White - EMU AUDIO
+    Kernel Verification (EA_VT_2W_Bench --verify)
+  ==============================================================================
+*/
+
+#include "VT2WBenchFixture.h"
+
+#include "dsp/VT2WAdaptiveEngine.h"
+
+#include <cmath>
+#include <cstdio>
+
+namespace VT2WBench {
+
+namespace {
+
+//==============================================================================
+// 検証: 全カーネルの出力をスカラー (リファレンス) 経路と比較する
+struct RenderSettings {
+  VT2WKernelIsa isa;
+  VT2WSaturationQuality quality;
+  bool adaa = false;
+  bool linked = false;
+  int oversamplingLog2 = 0;
+};
+
+void renderWith(const RenderSettings &settings,
+                std::vector<std::vector<float>> &audio, double sampleRate,
+                int blockSize) {
+  const int numChannels = int(audio.size());
+  const int numSamples = int(audio[0].size());
+
+  VT2WWhiteEngine engine;
+  engine.setKernel(settings.isa);
+  engine.setQuality(settings.quality);
+  engine.setAdaaEnabled(settings.adaa);
+  engine.setEnvelopeLinked(settings.linked);
+  engine.setOversampling(settings.oversamplingLog2,
+                         VT2WOversamplingFilter::PolyphaseIIR);
+  engine.prepare(sampleRate, blockSize, numChannels);
+
+  std::vector<float *> channels(numChannels);
+
+  int blockIndex = 0;
+  for (int pos = 0; pos < numSamples; pos += blockSize, ++blockIndex) {
+    float phase = 0.07f * float(blockIndex);
+    engine.setTargets(5.0f + 5.0f * std::sin(phase),
+                      0.5f + 0.5f * std::cos(phase));
+
+    for (int ch = 0; ch < numChannels; ++ch)
+      channels[ch] = audio[ch].data() + pos;
+
+    engine.process(channels.data(), numChannels,
+                   std::min(blockSize, numSamples - pos));
+  }
+}
+
+/**
+ * tanh 近似の検証
+ * ±kTanhVerifiedRange を密にサンプリングし、double の tanh に対する最大絶対
+ * 誤差が kTanhMaxError 以下であること、出力が単調非減少であることを確認する。
+ */
+bool verifyTanh(const char *label, VT2WSaturationQuality quality,
+                const std::vector<float> &x, const std::vector<float> &y) {
+  const float bound = VT2WKernels::kTanhMaxError[static_cast<int>(quality)];
+  double maxError = 0.0;
+  size_t nonMonotonic = 0;
+
+  for (size_t i = 0; i < x.size(); ++i) {
+    maxError = std::max(maxError,
+                        std::abs(double(y[i]) - std::tanh(double(x[i]))));
+    if (i > 0 && y[i] < y[i - 1])
+      ++nonMonotonic;
+  }
+
+  const bool ok = maxError <= bound && nonMonotonic == 0;
+  std::printf("tanh %-9s %-8s max abs error %.3g (bound %.1g), "
+              "monotonic %s  %s\n",
+              VT2WKernels::getName(quality), label, maxError, double(bound),
+              nonMonotonic == 0 ? "yes" : "NO", ok ? "OK" : "FAIL");
+  return ok;
+}
+
+//==============================================================================
+// オーバーサンプリングの検証
+
+/** Goertzel で 1 周波数成分の振幅を求める (start 以降) */
+double toneAmplitude(const std::vector<float> &x, int start, double frequency,
+                     double sampleRate) {
+  const double w = 6.283185307179586 * frequency / sampleRate;
+  const double coefficient = 2.0 * std::cos(w);
+  double s1 = 0.0, s2 = 0.0;
+
+  for (size_t i = size_t(start); i < x.size(); ++i) {
+    const double s0 = x[i] + coefficient * s1 - s2;
+    s2 = s1;
+    s1 = s0;
+  }
+
+  const double power = s1 * s1 + s2 * s2 - coefficient * s1 * s2;
+  return 2.0 * std::sqrt(std::max(power, 0.0)) / double(x.size() - start);
+}
+
+/** モノラル信号をパラメータ固定で処理する */
+std::vector<float> renderOversampled(const std::vector<float> &input,
+                                     int factorLog2,
+                                     VT2WOversamplingFilter filter,
+                                     bool adaa, float drive, float mix,
+                                     int blockSize, double sampleRate,
+                                     int &latency) {
+  VT2WWhiteEngine engine;
+  engine.setOversampling(factorLog2, filter);
+  engine.setAdaaEnabled(adaa);
+  engine.prepare(sampleRate, blockSize);
+  engine.setTargets(drive, mix);
+  latency = engine.getLatencySamples();
+
+  auto output = input;
+  const int numSamples = int(output.size());
+
+  for (int pos = 0; pos < numSamples; pos += blockSize) {
+    float *channel = output.data() + pos;
+    engine.process(&channel, 1, std::min(blockSize, numSamples - pos));
+  }
+
+  return output;
+}
+
+/**
+ * - Dry (Mix 0) の 1kHz サインが、報告したレイテンシ分ずらした入力と一致する
+ * - ブロック長を変えても出力が同じ (ホストのバッファ分割に依らない)
+ * - 15kHz を強くドライブした時、3 次倍音 (45kHz) の折り返し (3kHz) が
+ *   1x より kMinAliasRejectionDb 以上下がる
+ */
+bool verifyOversampling() {
+  constexpr double kLatencyTolerance = 1.0e-3;
+  constexpr double kMinAliasRejectionDb = 40.0;
+
+  const double sampleRate = 48000.0;
+  const int numSamples = 48000;
+  const int settle = numSamples / 4;
+  const double twoPi = 6.283185307179586;
+  bool passed = true;
+
+  std::vector<float> sine(numSamples), loud(numSamples);
+  for (int i = 0; i < numSamples; ++i) {
+    sine[i] = float(0.5 * std::sin(twoPi * 1000.0 * i / sampleRate));
+    loud[i] = float(std::sin(twoPi * 15000.0 * i / sampleRate));
+  }
+
+  int latency = 0;
+  const auto baseline =
+      renderOversampled(loud, 0, VT2WOversamplingFilter::PolyphaseIIR, false,
+                        10.0f, 1.0f, 512, sampleRate, latency);
+  const double baselineAlias =
+      toneAmplitude(baseline, settle, 3000.0, sampleRate);
+
+  for (auto filter : {VT2WOversamplingFilter::PolyphaseIIR,
+                      VT2WOversamplingFilter::LinearPhaseFIR}) {
+    for (int factorLog2 = 1; factorLog2 <= 3; ++factorLog2) {
+      const auto dry = renderOversampled(sine, factorLog2, filter, false, 0.0f,
+                                         0.0f, 509, sampleRate, latency);
+
+      double latencyError = 0.0;
+      for (int i = settle; i < numSamples; ++i)
+        latencyError = std::max(
+            latencyError, std::abs(double(dry[i]) - sine[i - latency]));
+
+      int otherLatency = 0;
+      const auto wet = renderOversampled(loud, factorLog2, filter, false,
+                                         10.0f, 1.0f, 509, sampleRate, latency);
+      const auto wetSplit = renderOversampled(loud, factorLog2, filter, false,
+                                              10.0f, 1.0f, 64, sampleRate,
+                                              otherLatency);
+
+      float splitError = 0.0f;
+      for (int i = 0; i < numSamples; ++i)
+        splitError = std::max(splitError, std::abs(wet[i] - wetSplit[i]));
+
+      const double rejectionDb =
+          20.0 * std::log10(baselineAlias /
+                            std::max(toneAmplitude(wet, settle, 3000.0,
+                                                   sampleRate),
+                                     1.0e-12));
+
+      const bool ok = latencyError <= kLatencyTolerance && splitError == 0.0f &&
+                      rejectionDb >= kMinAliasRejectionDb;
+      passed = passed && ok;
+      std::printf("oversampling %dx %s latency %d, dry error %.3g "
+                  "(tolerance %.1g), block split error %.3g, "
+                  "alias rejection %.1f dB  %s\n",
+                  1 << factorLog2, getFilterName(filter), latency,
+                  latencyError, kLatencyTolerance, double(splitError),
+                  rejectionDb, ok ? "OK" : "FAIL");
+    }
+  }
+
+  // ADAA の半サンプル遅延も含めて、報告したレイテンシで Dry が揃う
+  // (Dry は 2 点平均を通るので、内部レートでの cos(ω/2) の減衰を見込む)
+  for (int factorLog2 = 0; factorLog2 <= 3; ++factorLog2) {
+    const auto dry = renderOversampled(sine, factorLog2,
+                                       VT2WOversamplingFilter::PolyphaseIIR,
+                                       true, 0.0f, 0.0f, 509, sampleRate,
+                                       latency);
+    const double droop =
+        std::cos(0.5 * twoPi * 1000.0 / (sampleRate * (1 << factorLog2)));
+
+    double latencyError = 0.0;
+    for (int i = settle; i < numSamples; ++i)
+      latencyError = std::max(
+          latencyError, std::abs(double(dry[i]) - droop * sine[i - latency]));
+
+    const bool ok = latencyError <= kLatencyTolerance;
+    passed = passed && ok;
+    std::printf("oversampling %dx iir ADAA latency %d, dry error %.3g "
+                "(tolerance %.1g)  %s\n",
+                1 << factorLog2, latency, latencyError, kLatencyTolerance,
+                ok ? "OK" : "FAIL");
+  }
+
+  return passed;
+}
+
+/**
+ * 多チャンネル
+ * - 3 / 6 / 12 チャンネル (レーンの端数あり) で SIMD カーネルがスカラー経路と
+ *   一致する (リンク有り・無し)
+ * - リンク無しの 12 チャンネルは、同じ信号をステレオ 6 インスタンスで
+ *   処理した結果と一致する (2x オーバーサンプリング込み)
+ */
+bool verifyMultichannel(const std::vector<std::vector<float>> &source,
+                        double sampleRate) {
+  const float tolerance = VT2WKernels::kSimdTolerance;
+  bool passed = true;
+
+  for (int numChannels : {3, 6, 12}) {
+    for (bool linked : {false, true}) {
+      std::vector<std::vector<float>> input(numChannels);
+      for (int ch = 0; ch < numChannels; ++ch)
+        input[ch] = source[ch % source.size()];
+
+      // チャンネル毎に違う信号になるようにずらす
+      for (int ch = 0; ch < numChannels; ++ch)
+        std::rotate(input[ch].begin(), input[ch].begin() + 97 * ch,
+                    input[ch].end());
+
+      auto reference = input;
+      renderWith({VT2WKernelIsa::Scalar, VT2WSaturationQuality::Reference,
+                  false, linked},
+                 reference, sampleRate, 509);
+
+      for (auto isa : kAllIsas) {
+        if (isa == VT2WKernelIsa::Scalar || !VT2WKernels::isSupported(isa))
+          continue;
+
+        auto output = input;
+        renderWith({isa, VT2WSaturationQuality::Standard, false, linked},
+                   output, sampleRate, 509);
+
+        const float maxError = maxAbsError(output, reference);
+        const bool ok = maxError <= tolerance;
+        passed = passed && ok;
+        std::printf("channels %-2d %-8s %-8s max abs error %.3g "
+                    "(tolerance %.1g) %s\n",
+                    numChannels, linked ? "linked" : "unlinked",
+                    VT2WKernels::getName(isa), maxError, tolerance,
+                    ok ? "OK" : "FAIL");
+      }
+    }
+  }
+
+  std::vector<std::vector<float>> input(12);
+  for (int ch = 0; ch < 12; ++ch) {
+    input[ch] = source[ch % source.size()];
+    std::rotate(input[ch].begin(), input[ch].begin() + 97 * ch,
+                input[ch].end());
+  }
+
+  const auto best = VT2WKernels::getBestAvailable();
+  const RenderSettings settings{
+      best != nullptr ? best->isa : VT2WKernelIsa::Scalar,
+      VT2WSaturationQuality::Standard, false, false, 1};
+
+  auto combined = input;
+  renderWith(settings, combined, sampleRate, 509);
+
+  auto separate = input;
+  for (int pair = 0; pair < 6; ++pair) {
+    std::vector<std::vector<float>> stereo{separate[2 * pair],
+                                           separate[2 * pair + 1]};
+    renderWith(settings, stereo, sampleRate, 509);
+    separate[2 * pair] = stereo[0];
+    separate[2 * pair + 1] = stereo[1];
+  }
+
+  const float maxError = maxAbsError(combined, separate);
+  const bool ok = maxError <= tolerance;
+  passed = passed && ok;
+  std::printf("channels 12 vs 6 stereo instances (2x iir) max abs error %.3g "
+              "(tolerance %.1g) %s\n",
+              maxError, tolerance, ok ? "OK" : "FAIL");
+
+  return passed;
+}
+
+/**
+ * float と double の経路の比較
+ * - 同じ設定のリファレンス経路 (std::tanh) とは float の丸め誤差の範囲で一致
+ *   (オーバーサンプリング・ADAA・リンク・自動品質のラッパーを含む)
+ * - 1x で Mix 0 なら double の入力がビット単位でそのまま出る
+ *   (float では 24bit 仮数に丸められる)
+ */
+bool verifyPrecision(double sampleRate) {
+  struct Mode {
+    const char *name;
+    int factorLog2;
+    VT2WOversamplingFilter filter;
+    bool adaa;
+    bool linked;
+  };
+
+  const auto iir = VT2WOversamplingFilter::PolyphaseIIR;
+  const auto fir = VT2WOversamplingFilter::LinearPhaseFIR;
+  const Mode modes[] = {{"1x", 0, iir, false, false},
+                        {"1x ADAA", 0, iir, true, false},
+                        {"1x linked", 0, iir, false, true},
+                        {"2x iir", 1, iir, false, false},
+                        {"8x iir", 3, iir, false, false},
+                        {"4x iir ADAA", 2, iir, true, false},
+                        {"2x fir", 1, fir, false, false},
+                        {"8x fir", 3, fir, false, false}};
+
+  // ±2 までスイープ (サチュレーションが深くかかる所まで)
+  const int numSamples = int(sampleRate);
+  auto input = makeInput(2, sampleRate, numSamples);
+  for (auto &channel : input)
+    for (int i = 0; i < numSamples; ++i)
+      channel[i] *= 2.0f * float(i) / float(numSamples);
+
+  const float tolerance = 2.0e-6f;
+  bool passed = true;
+
+  for (const auto &mode : modes) {
+    VT2WSettings settings;
+    settings.drive = 7.0f;
+    settings.mix = 80.0f;
+    settings.quality = VT2WSaturationQuality::Reference;
+    settings.oversamplingLog2 = mode.factorLog2;
+    settings.oversamplingFilter = mode.filter;
+    settings.adaa = mode.adaa;
+    settings.link = mode.linked;
+
+    auto singleEngine = std::make_unique<VT2WWhiteEngine>();
+    auto doubleEngine = std::make_unique<VT2WWhiteEngine>();
+    auto adaptiveEngine = std::make_unique<VT2WAdaptiveEngine>();
+    singleEngine->applySettings(settings);
+    doubleEngine->applySettings(settings);
+    adaptiveEngine->applySettings(settings);
+    singleEngine->prepare(sampleRate, 512, 2);
+    doubleEngine->prepare(sampleRate, 512, 2);
+    adaptiveEngine->prepare(sampleRate, 512, 2);
+
+    auto single = input;
+    auto precise = toDouble(input);
+    auto wrapped = toDouble(input);
+    renderBlocks(*singleEngine, single, 509);
+    renderBlocks(*doubleEngine, precise, 509);
+    renderBlocks(*adaptiveEngine, wrapped, 509);
+
+    double maxError = 0.0, wrapperError = 0.0;
+    for (size_t ch = 0; ch < single.size(); ++ch)
+      for (int i = 0; i < numSamples; ++i) {
+        maxError = std::max(maxError, std::abs(precise[ch][i] - single[ch][i]));
+        wrapperError = std::max(wrapperError,
+                                std::abs(wrapped[ch][i] - precise[ch][i]));
+      }
+
+    const bool ok = maxError <= tolerance && wrapperError == 0.0;
+    passed = passed && ok;
+    std::printf("precision %-12s float vs double max abs error %.3g "
+                "(tolerance %.1g), adaptive wrapper %.3g %s\n",
+                mode.name, maxError, tolerance, wrapperError,
+                ok ? "OK" : "FAIL");
+  }
+
+  // Mix 0 の素通し: float に無い桁 (2^-40) を足した信号
+  std::vector<std::vector<double>> dry = toDouble(input);
+  for (auto &channel : dry)
+    for (auto &sample : channel)
+      sample += std::ldexp(1.0, -40);
+
+  auto passthrough = dry;
+  auto rounded = dry;
+  VT2WWhiteEngine engine;
+  engine.setTargets(7.0f, 0.0f);
+  engine.prepare(sampleRate, 512, 2);
+  renderBlocks(engine, passthrough, 509);
+
+  std::vector<std::vector<float>> single(2);
+  for (int ch = 0; ch < 2; ++ch)
+    single[ch].assign(dry[ch].begin(), dry[ch].end());
+  VT2WWhiteEngine singleEngine;
+  singleEngine.setTargets(7.0f, 0.0f);
+  singleEngine.prepare(sampleRate, 512, 2);
+  renderBlocks(singleEngine, single, 509);
+
+  double doubleError = 0.0, floatError = 0.0;
+  for (int ch = 0; ch < 2; ++ch)
+    for (int i = 0; i < numSamples; ++i) {
+      doubleError =
+          std::max(doubleError, std::abs(passthrough[ch][i] - dry[ch][i]));
+      floatError = std::max(floatError, std::abs(single[ch][i] - dry[ch][i]));
+    }
+
+  const bool ok = doubleError == 0.0;
+  passed = passed && ok;
+  std::printf("precision mix 0 passthrough: double error %.3g, "
+              "float error %.3g %s\n",
+              doubleError, floatError, ok ? "OK" : "FAIL");
+
+  return passed;
+}
+
+//==============================================================================
+// モデル (ステージのパイプライン) と手書きのループの比較
+/**
+ * モデルの検証
+ * - White / Black のパイプラインが手書きのループと一致する
+ *   (Drive・Mix 一定、1x、リンク無し)
+ * - Black の Mix 0 は入力をそのまま出す (オールパスが Dry に漏れない)
+ * - Black は ADAA の設定を無視し、ADAA の遅延も足さない
+ *   (自動品質のラッパーが報告するレイテンシ・テールとも一致する)
+ */
+bool verifyModels(double sampleRate) {
+  const int numSamples = int(sampleRate);
+  auto input = makeInput(2, sampleRate, numSamples);
+  for (auto &channel : input)
+    for (int i = 0; i < numSamples; ++i)
+      channel[i] *= 2.0f * float(i) / float(numSamples);
+
+  const float tolerance = 1.0e-6f;
+  bool passed = true;
+
+  for (auto model : {VT2WModel::White, VT2WModel::Black})
+    for (float drive : {0.0f, 2.0f, 10.0f}) {
+      auto reference = input;
+      renderHandWritten(model, reference, drive, 0.8f, sampleRate);
+
+      auto output = input;
+      auto engine = makeModelEngine(model, drive, 0.8f, sampleRate, 509);
+      renderBlocks(*engine, output, 509);
+
+      const float maxError = maxAbsError(output, reference);
+      const bool ok = maxError <= tolerance;
+      passed = passed && ok;
+      std::printf("model %-5s drive %4.1f pipeline vs hand-written loop "
+                  "max abs error %.3g (tolerance %.1g) %s\n",
+                  VT2WModels::getName(model), drive, maxError, tolerance,
+                  ok ? "OK" : "FAIL");
+    }
+
+  // Black の Mix 0
+  {
+    auto output = input;
+    auto engine =
+        makeModelEngine(VT2WModel::Black, 7.0f, 0.0f, sampleRate, 509);
+    renderBlocks(*engine, output, 509);
+
+    const float maxError = maxAbsError(output, input);
+    const bool ok = maxError == 0.0f;
+    passed = passed && ok;
+    std::printf("model Black mix 0 passthrough max abs error %.3g %s\n",
+                maxError, ok ? "OK" : "FAIL");
+  }
+
+  // ADAA の設定とレイテンシ・テール (2x IIR)
+  for (auto model : {VT2WModel::White, VT2WModel::Black}) {
+    VT2WSettings settings;
+    settings.model = model;
+    settings.oversamplingLog2 = 1;
+    settings.adaa = true;
+
+    VT2WWhiteEngine engine, plain;
+    VT2WAdaptiveEngine adaptive;
+    engine.applySettings(settings);
+    settings.adaa = false;
+    plain.applySettings(settings);
+    settings.adaa = true;
+    adaptive.applySettings(settings);
+    engine.prepare(sampleRate, 512, 2);
+    plain.prepare(sampleRate, 512, 2);
+    adaptive.prepare(sampleRate, 512, 2);
+
+    const bool adaaIgnored = engine.getLatencySamples() ==
+                             plain.getLatencySamples();
+    const bool ok =
+        adaaIgnored == !VT2WModels::supportsAdaa(model) &&
+        adaptive.getLatencySamples() == engine.getLatencySamples() &&
+        adaptive.getTailLengthSamples() == engine.getTailLengthSamples();
+    passed = passed && ok;
+    std::printf("model %-5s 2x iir ADAA latency %d (without ADAA %d), "
+                "tail %d, adaptive wrapper %d / %d %s\n",
+                VT2WModels::getName(model), engine.getLatencySamples(),
+                plain.getLatencySamples(), engine.getTailLengthSamples(),
+                adaptive.getLatencySamples(), adaptive.getTailLengthSamples(),
+                ok ? "OK" : "FAIL");
+  }
+
+  return passed;
+}
+
+} // namespace
+
+bool verifyKernels(double sampleRate, int numSamples) {
+  bool passed = true;
+
+  //============================================================================
+  // tanh 近似単体
+  const int numPoints = 1 << 21;
+  const float range = VT2WKernels::kTanhVerifiedRange;
+  std::vector<float> x(numPoints + 1), y(numPoints + 1);
+  for (int i = 0; i <= numPoints; ++i)
+    x[i] = -range + 2.0f * range * float(i) / float(numPoints);
+
+  for (int i = 0; i <= numPoints; ++i)
+    y[i] = std::tanh(x[i]);
+  passed &= verifyTanh("libm", VT2WSaturationQuality::Reference, x, y);
+
+  for (auto isa : kAllIsas) {
+    auto *ops = VT2WKernels::getOps(isa);
+    if (ops == nullptr)
+      continue;
+
+    for (int tier = 0; tier < kNumApproximateQualities; ++tier) {
+      ops->tanh[tier](x.data(), y.data(), numPoints + 1);
+      passed &= verifyTanh(ops->name, static_cast<VT2WSaturationQuality>(tier),
+                           x, y);
+    }
+  }
+
+  //============================================================================
+  // エンジン出力: Standard の SIMD カーネルとスカラー経路の比較
+  // 振幅 ±4 までスイープしたテスト信号 (ブロック長は端数処理も通るよう素数)
+  auto input = makeInput(2, sampleRate, numSamples);
+  for (auto &channel : input)
+    for (int i = 0; i < numSamples; ++i)
+      channel[i] *= 4.0f * float(i) / float(numSamples);
+
+  // ADAA はスカラー経路が double で差分商を求めるリファレンス
+  for (bool adaa : {false, true}) {
+    auto reference = input;
+    renderWith({VT2WKernelIsa::Scalar, VT2WSaturationQuality::Reference, adaa},
+               reference, sampleRate, 509);
+
+    const char *mode = adaa ? "ADAA" : "";
+    const float tolerance =
+        adaa ? VT2WKernels::kAdaaTolerance : VT2WKernels::kSimdTolerance;
+
+    for (auto isa : kAllIsas) {
+      if (isa == VT2WKernelIsa::Scalar || !VT2WKernels::isSupported(isa))
+        continue;
+
+      for (auto quality : kAllQualities) {
+        if (quality == VT2WSaturationQuality::Reference)
+          continue;
+
+        auto output = input;
+        renderWith({isa, quality, adaa}, output, sampleRate, 509);
+
+        float maxError = 0.0f;
+        for (size_t ch = 0; ch < output.size(); ++ch)
+          for (int i = 0; i < numSamples; ++i)
+            maxError = std::max(maxError,
+                                std::abs(output[ch][i] - reference[ch][i]));
+
+        if (quality == VT2WSaturationQuality::Standard) {
+          const bool ok = maxError <= tolerance;
+          passed = passed && ok;
+          std::printf("engine %-8s %-9s %-4s max abs error %.3g "
+                      "(tolerance %.1g) %s\n",
+                      VT2WKernels::getName(isa), VT2WKernels::getName(quality),
+                      mode, maxError, tolerance, ok ? "OK" : "FAIL");
+        } else {
+          std::printf("engine %-8s %-9s %-4s max abs error %.3g\n",
+                      VT2WKernels::getName(isa), VT2WKernels::getName(quality),
+                      mode, maxError);
+        }
+      }
+    }
+  }
+
+  passed &= verifyMultichannel(input, sampleRate);
+  passed &= verifyOversampling();
+  passed &= verifyPrecision(sampleRate);
+  passed &= verifyModels(sampleRate);
+
+  return passed;
+}
+
+} // namespace VT2WBench